@@ -1,26 +1,26 @@
 /*
- * 环境监测器 - ILI9488显示版本
+ * 环境监测器 - ILI9488 / ST7306 显示版本
  * 
  * 功能：
  * - AHT20温湿度传感器数据采集
  * - BMP280气压、温度、海拔数据采集
- * - ILI9488 3.5寸彩色显示屏显示
+ * - ILI9488 3.5寸彩色显示屏或 ST7306 4.2寸反射式显示屏显示（ENV_MONITOR_USE_ST7306 选择）
  * - 数据局部刷新，避免全屏刷新
  * - 参考图片样式的界面设计
  *
  * 硬件配置：
- * - ILI9488 TFT-LCD显示屏 (3.5寸, 320x480分辨率)
+ * - ILI9488 TFT-LCD显示屏 (3.5寸, 320x480分辨率) 或 ST7306 反射式显示屏 (4.2寸, 300x400, 4级灰度)
  * - AHT20温湿度传感器 (I2C地址: 0x38)
  * - BMP280气压传感器 (I2C地址: 0x77)
  *
- * 引脚连接：
- * ILI9488显示屏 (SPI0):
- *   Pico GPIO20  -> ILI9488 DC (数据/命令)
- *   Pico GPIO15  -> ILI9488 RST (复位)
- *   Pico GPIO16 -> ILI9488 BL (背光)
- *   Pico GPIO17 -> ILI9488 CS (片选)
- *   Pico GPIO18 -> ILI9488 SCK (时钟)
- *   Pico GPIO19 -> ILI9488 MOSI (数据)
+ * 引脚连接（两种显示屏共用同一组SPI0引脚，ST7306 没有背光引脚）：
+ * 显示屏 (SPI0):
+ *   Pico GPIO20 -> DC (数据/命令)
+ *   Pico GPIO15 -> RST (复位)
+ *   Pico GPIO16 -> BL (背光，仅ILI9488)
+ *   Pico GPIO17 -> CS (片选)
+ *   Pico GPIO18 -> SCK (时钟)
+ *   Pico GPIO19 -> MOSI (数据)
  *
  * 传感器 (I2C1):
  *   Pico GPIO6 -> SDA
@@ -34,8 +34,14 @@
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
 #include "hardware/display/ili9488_driver.hpp"
+#include "hardware/display/st7306_driver.hpp"
 #include "config/ili9488_config.hpp"
 #include "EnvironmentalMonitor.hpp"
+#include "EventLoop.hpp"
+#include "AsyncTask.hpp"
+#include "StartupOrchestrator.hpp"
+#include "hardware/input/input_latency.hpp"
+#include "pico/stdio_usb.h"
 
 // I2C配置
 #define I2C_PORT i2c1
@@ -48,6 +54,8 @@
 #define ATH20_INIT_CMD         0xBE
 #define ATH20_SOFT_RESET_CMD   0xBA
 #define ATH20_START_TEST_CMD   0xAC
+#define ATH20_MEASURE_MS       80      // 测量命令到数据就绪的时间
+#define ATH20_BUSY_TIMEOUT_MS  100     // 数据就绪后忙标志的最长等待
 
 // BMP280传感器配置
 #define BMP280_SLAVE_ADDRESS   0x77
@@ -135,9 +143,46 @@ static int32_t bmp280RawTemperature = 0;
 #define FILTER_NUM 5
 #define FILTER_A 0.1f
 
+// 调度配置
+#define SENSOR_PERIOD_MS 1000    // 传感器采样周期
+#define STATS_PERIOD_MS  10000   // 循环统计输出周期
+
+// 启动步骤截止时间
+#define BOOT_USB_WAIT_MS         2000    // 等待USB串口连接（不阻塞启动）
+#define BOOT_LCD_DEADLINE_MS     1500    // 显示屏复位与唤醒（ILI9488约620ms，ST7306约160ms）
+#define BOOT_UI_DEADLINE_MS      2000    // 界面首次绘制
+#define BOOT_AHT20_DEADLINE_MS   3000    // AHT20上电与校准（约540ms，重试最多约7s）
+#define BOOT_BMP280_DEADLINE_MS  100     // BMP280读取校准参数
+
+// 显示面板：0 = ILI9488（320x480 彩色），1 = ST7306（300x400 反射式，接在同一组SPI引脚上）
+#ifndef ENV_MONITOR_USE_ST7306
+#define ENV_MONITOR_USE_ST7306 0
+#endif
+
+#if ENV_MONITOR_USE_ST7306
+using Panel = st7306::ST7306Driver;
+#define PANEL_NAME "ST7306"
+#define PANEL_DESC "ST7306 4.2寸反射式 (300x400)"
+
+static Panel g_lcd(ILI9488_DC_PIN, ILI9488_RST_PIN, ILI9488_CS_PIN, ILI9488_SCK_PIN, ILI9488_MOSI_PIN);
+#else
+using Panel = ili9488::ILI9488Driver;
+#define PANEL_NAME "ILI9488"
+#define PANEL_DESC "ILI9488 3.5寸 (320x480)"
+
+static Panel g_lcd = ILI9488_GET_SPI_CONFIG();
+#endif
+
+// 显示屏初始化序列：复位与唤醒的等待期间让出CPU
+using PanelInitTask = Panel::InitTask;
+
 // 全局对象
-ili9488::ILI9488Driver* g_lcd_driver = nullptr;
-environmental_monitor::EnvironmentalMonitor* g_env_monitor = nullptr;
+Panel* g_lcd_driver = &g_lcd;
+environmental_monitor::EnvironmentalMonitor<Panel>* g_env_monitor = nullptr;
+event_loop::TaskScheduler* g_scheduler = nullptr;
+event_loop::StartupOrchestrator* g_boot = nullptr;
+int g_serial_source = event_loop::EventLoop::INVALID_ID;
+bool g_aht20_ready = false;
 
 // 延时函数
 void delay_ms(uint32_t ms) {
@@ -199,31 +244,24 @@ uint8_t ATH20_Read_Cal_Enable() {
     return 0;
 }
 
-// AHT20读取温湿度数据
-void ATH20_Read_CTdata(uint32_t *ct) {
+// AHT20发送测量命令（数据约 ATH20_MEASURE_MS 后就绪）
+bool ATH20_Start_Measure() {
     uint8_t tmp[2] = {0x33, 0x00};
-    uint8_t data[10];
-    uint16_t cnt = 0;
-    
-    // 发送测量命令
     if (i2c_write_register(ATH20_SLAVE_ADDRESS, ATH20_START_TEST_CMD, tmp, 2) != 0) {
         printf("[AHT20] 发送测量命令失败\n");
-        ct[0] = 0;
-        ct[1] = 0;
-        return;
-    }
-    delay_ms(75);
-    
-    // 等待忙状态结束
-    while ((ATH20_Read_Status() & 0x80) == 0x80) {
-        delay_ms(1);
-        if (cnt++ >= 100) {
-            printf("[AHT20] 等待忙状态超时\n");
-            ct[0] = 0;
-            ct[1] = 0;
-            return;
-        }
+        return false;
     }
+    return true;
+}
+
+// AHT20测量是否仍在进行
+bool ATH20_Is_Busy() {
+    return (ATH20_Read_Status() & 0x80) == 0x80;
+}
+
+// AHT20读取测量结果（调用前须等待忙状态结束）
+void ATH20_Fetch_CTdata(uint32_t *ct) {
+    uint8_t data[10];
     
     // 读取数据
     if (i2c_read_register(ATH20_SLAVE_ADDRESS, 0x00, data, 7) == 0) {
@@ -398,8 +436,207 @@ uint8_t BMP280_Init() {
     return bmp280_id;
 }
 
-// 初始化硬件
-bool initialize_hardware() {
+// 检查AHT20校准状态并启动测量
+// @return true 测量已启动，false 校准失败或命令发送失败（本轮使用替代值）
+bool aht20_begin_measurement() {
+    uint8_t cal_retry = 0;
+    while (ATH20_Read_Cal_Enable() == 0 && cal_retry < 3) {
+        printf("[AHT20] 校准状态检查失败，重试 %d/3\n", cal_retry + 1);
+        ATH20_Init();
+        delay_ms(100);
+        cal_retry++;
+    }
+    
+    if (cal_retry >= 3) {
+        printf("[AHT20] 校准失败，使用默认值\n");
+        return false;
+    }
+    return ATH20_Start_Measure();
+}
+
+// 读取传感器数据并刷新显示
+void read_sensors_and_update(bool aht20_measuring) {
+    environmental_monitor::SensorData sensor_data;
+    
+    // 读取AHT20温湿度数据
+    uint32_t CT_data[2] = {0, 0};
+    if (aht20_measuring) {
+        ATH20_Fetch_CTdata(CT_data);
+    }
+    
+    // 读取BMP280数据（先读取，因为温度卡片需要BMP280温度）
+    float P, T, ALT;
+    BMP280GetData(&P, &T, &ALT);
+    sensor_data.bmp280_pressure = P;
+    sensor_data.bmp280_temperature = T;
+    sensor_data.bmp280_altitude = ALT;
+    
+    // 转换AHT20数据 - 使用原始demo.cpp的方法
+    if (CT_data[0] > 0 && CT_data[1] > 0) {
+        // 使用原始demo.cpp的转换公式
+        sensor_data.aht20_humidity = CT_data[0] * 1000.0f / 1024.0f / 1024.0f;  // 湿度值
+        sensor_data.aht20_temperature = CT_data[1] * 200.0f * 10.0f / 1024.0f / 1024.0f - 50.0f;  // 温度值
+        printf("[AHT20] 转换后: 湿度=%.1f%%, 温度=%.1f°C\n", 
+               sensor_data.aht20_humidity, sensor_data.aht20_temperature);
+    } else {
+        // 使用BMP280温度作为AHT20温度的替代值，湿度设为50%
+        sensor_data.aht20_humidity = 50.0f;
+        sensor_data.aht20_temperature = sensor_data.bmp280_temperature;
+        printf("[AHT20] 数据无效，使用BMP280温度作为替代值\n");
+    }
+    
+    printf("[BMP280] 压力=%.4fhPa, 温度=%.1f°C, 海拔=%.1fm\n", P, T, ALT);
+    
+    // 更新显示
+    g_env_monitor->update_sensor_data(sensor_data);
+    
+    // 打印调试信息
+    printf("[DATA] AHT20: %.1f°C, %.1f%% | BMP280: %.1f°C, %.4fhPa, %.1fm\n",
+           sensor_data.aht20_temperature, sensor_data.aht20_humidity,
+           sensor_data.bmp280_temperature, sensor_data.bmp280_pressure, sensor_data.bmp280_altitude);
+}
+
+// AHT20初始化任务：上电、初始化命令与校准等待期间让出CPU
+class Aht20InitTask : public event_loop::Task {
+protected:
+    void run() override {
+        TASK_BEGIN();
+        TASK_DELAY_MS(40);
+        
+        // 发送初始化命令
+        i2c_write_register(ATH20_SLAVE_ADDRESS, ATH20_INIT_CMD, init_cmd_, 2);
+        TASK_DELAY_MS(500);
+        
+        // 等待校准完成
+        count_ = 0;
+        while (ATH20_Read_Cal_Enable() == 0) {
+            i2c_write_register(ATH20_SLAVE_ADDRESS, ATH20_SOFT_RESET_CMD, NULL, 0);
+            TASK_DELAY_MS(200);
+            
+            i2c_write_register(ATH20_SLAVE_ADDRESS, ATH20_INIT_CMD, init_cmd_, 2);
+            
+            count_++;
+            if (count_ >= 10) {
+                TASK_FAIL();
+            }
+            TASK_DELAY_MS(500);
+        }
+        TASK_END();
+    }
+
+private:
+    uint8_t init_cmd_[2] = {0x08, 0x00};
+    uint8_t count_ = 0;
+};
+
+// BMP280初始化任务（只有I2C读写，没有等待）
+class Bmp280InitTask : public event_loop::Task {
+protected:
+    void run() override {
+        TASK_BEGIN();
+        if (BMP280_Init() != 0x58) {
+            printf("[HARDWARE] BMP280传感器初始化失败\n");
+            TASK_FAIL();
+        }
+        TASK_END();
+    }
+};
+
+// USB串口等待任务：与启动步骤并行，连接后打印版本信息
+class UsbWaitTask : public event_loop::Task {
+protected:
+    void run() override {
+        TASK_BEGIN();
+        deadline_us_ = clock_us() + BOOT_USB_WAIT_MS * 1000ull;
+        TASK_AWAIT(stdio_usb_connected() || clock_us() >= deadline_us_, 10);
+        if (!stdio_usb_connected()) {
+            TASK_EXIT();
+        }
+        
+        printf("=== 环境监测器 - " PANEL_NAME "显示版本 ===\n");
+        printf("版本: v1.0.0\n");
+        printf("显示屏: " PANEL_DESC "\n");
+        printf("传感器: AHT20 + BMP280\n");
+        printf("====================================\n");
+        
+        // 启动先于串口连接完成时补打时间线
+        if (g_boot && g_boot->finished()) {
+            g_boot->print_timeline();
+        }
+        TASK_END();
+    }
+
+private:
+    uint64_t deadline_us_ = 0;
+};
+
+// 界面任务：显示屏就绪后绘制界面，数值显示占位符直到首次采样
+class UiInitTask : public event_loop::Task {
+protected:
+    void run() override {
+        TASK_BEGIN();
+        // 设置显示屏参数
+#if !ENV_MONITOR_USE_ST7306
+        g_lcd_driver->setBacklightBrightness(204);  // 80%亮度 (255 * 0.8 = 204)
+        g_lcd_driver->setDisplayMode(ili9488::DisplayMode::Night);
+#endif
+        
+        // 初始化环境监测显示模块
+        g_env_monitor = new environmental_monitor::EnvironmentalMonitor<Panel>(g_lcd_driver);
+        g_env_monitor->initialize_display();
+        TASK_END();
+    }
+};
+
+// 传感器任务：启动测量 → 等待数据就绪 → 读取并刷新显示 → 等到下一周期
+class SensorTask : public event_loop::Task {
+protected:
+    void run() override {
+        TASK_BEGIN();
+        for (;;) {
+            period_start_us_ = clock_us();
+            measuring_ = g_aht20_ready && aht20_begin_measurement();
+            if (measuring_) {
+                TASK_DELAY_MS(ATH20_MEASURE_MS);
+                busy_polls_ = 0;
+                TASK_AWAIT(!ATH20_Is_Busy() || ++busy_polls_ > ATH20_BUSY_TIMEOUT_MS, 1);
+                if (busy_polls_ > ATH20_BUSY_TIMEOUT_MS) {
+                    printf("[AHT20] 等待忙状态超时\n");
+                    measuring_ = false;
+                }
+            }
+            read_sensors_and_update(measuring_);
+            if (!first_frame_logged_) {
+                first_frame_logged_ = true;
+                printf("[Boot] 首帧数据 %lu ms\n", (unsigned long)(clock_us() / 1000));
+            }
+            
+            elapsed_us_ = clock_us() - period_start_us_;
+            TASK_DELAY_MS(elapsed_us_ < SENSOR_PERIOD_MS * 1000ull
+                          ? (SENSOR_PERIOD_MS * 1000ull - elapsed_us_) / 1000 : 0);
+        }
+        TASK_END();
+    }
+
+private:
+    uint64_t period_start_us_ = 0;
+    uint64_t elapsed_us_ = 0;
+    uint16_t busy_polls_ = 0;
+    bool measuring_ = false;
+    bool first_frame_logged_ = false;
+};
+
+static UsbWaitTask g_usb_wait;
+static PanelInitTask g_lcd_init(g_lcd);
+static UiInitTask g_ui_init;
+static Aht20InitTask g_aht20_init;
+static Bmp280InitTask g_bmp280_init;
+static SensorTask g_sensor_task;
+
+int main() {
+    // 初始化串口（不再等待串口稳定，USB连接作为可选启动步骤与其他步骤并行）
+    stdio_init_all();
+    
     printf("[HARDWARE] 开始初始化硬件...\n");
     
     // 初始化I2C
@@ -420,128 +657,59 @@ bool initialize_hardware() {
         printf("[HARDWARE] BMP280传感器未检测到 (地址: 0x%02X)\n", BMP280_SLAVE_ADDRESS);
     }
     
-    // 初始化ILI9488显示屏
-    printf("[HARDWARE] 初始化ILI9488显示屏...\n");
-    g_lcd_driver = new ili9488::ILI9488Driver(ILI9488_GET_SPI_CONFIG());
-    if (!g_lcd_driver->initialize()) {
-        printf("[HARDWARE] LCD初始化失败\n");
-        return false;
-    }
-    
-    // 设置显示屏参数
-    g_lcd_driver->setBacklightBrightness(204);  // 80%亮度 (255 * 0.8 = 204)
-    g_lcd_driver->setDisplayMode(ili9488::DisplayMode::Night);
-    printf("[HARDWARE] ILI9488显示屏初始化完成\n");
-    
-    // 初始化环境监测显示模块
-    printf("[HARDWARE] 初始化环境监测显示模块...\n");
-    g_env_monitor = new environmental_monitor::EnvironmentalMonitor(g_lcd_driver);
-    g_env_monitor->initialize_display();
-    printf("[HARDWARE] 环境监测显示模块初始化完成\n");
-    
-    // 初始化AHT20传感器
-    printf("[HARDWARE] 初始化AHT20传感器...\n");
-    uint8_t ret = ATH20_Init();
-    if (ret == 0) {
-        printf("[HARDWARE] AHT20传感器初始化失败\n");
-        g_env_monitor->show_error("AHT20初始化失败");
-        return false;
-    }
-    printf("[HARDWARE] AHT20传感器初始化完成\n");
-    
-    // 初始化BMP280传感器
-    printf("[HARDWARE] 初始化BMP280传感器...\n");
-    ret = BMP280_Init();
-    if (ret != 0x58) {
-        printf("[HARDWARE] BMP280传感器初始化失败\n");
-        g_env_monitor->show_error("BMP280初始化失败");
-        return false;
-    }
-    printf("[HARDWARE] BMP280传感器初始化完成\n");
-    
-    printf("[HARDWARE] 所有硬件初始化完成\n");
-    return true;
-}
-
-int main() {
-    // 初始化串口
-    stdio_init_all();
-    
-    // 等待串口稳定
-    delay_ms(2000);
-    
-    printf("=== 环境监测器 - ILI9488显示版本 ===\n");
-    printf("版本: v1.0.0\n");
-    printf("显示屏: ILI9488 3.5寸 (320x480)\n");
-    printf("传感器: AHT20 + BMP280\n");
-    printf("====================================\n");
-    
-    // 初始化硬件
-    if (!initialize_hardware()) {
-        printf("[FATAL ERROR] 硬件初始化失败\n");
-        while (1) {
-            sleep_ms(1000);
-        }
-    }
-    
-    printf("[MAIN] 开始主循环...\n");
-    
-    // 主循环
-    while (1) {
-        environmental_monitor::SensorData sensor_data;
-        
-        // 读取AHT20温湿度数据
-        uint32_t CT_data[2];
-        uint8_t cal_retry = 0;
-        while (ATH20_Read_Cal_Enable() == 0 && cal_retry < 3) {
-            printf("[AHT20] 校准状态检查失败，重试 %d/3\n", cal_retry + 1);
-            ATH20_Init();
-            delay_ms(100);
-            cal_retry++;
-        }
-        
-        if (cal_retry >= 3) {
-            printf("[AHT20] 校准失败，使用默认值\n");
-            CT_data[0] = 0;
-            CT_data[1] = 0;
-        } else {
-            ATH20_Read_CTdata(CT_data);
+    printf("[MAIN] 开始事件循环...\n");
+    
+    // 事件循环：无事可做时WFE睡眠到下一个截止时间
+    event_loop::PicoLoopPlatform platform;
+    event_loop::EventLoop loop(platform);
+    
+    // 任务：初始化与采样中的等待都挂起任务而不是忙等
+    event_loop::TaskScheduler scheduler(loop);
+    g_scheduler = &scheduler;
+    
+    // 启动步骤：显示屏复位/唤醒与AHT20校准互不依赖，等待时间相互重叠
+    event_loop::StartupOrchestrator boot(loop, scheduler);
+    g_boot = &boot;
+    int lcd = boot.add_step("lcd", g_lcd_init, BOOT_LCD_DEADLINE_MS);
+    boot.add_step("ui", g_ui_init, BOOT_UI_DEADLINE_MS, event_loop::StartupOrchestrator::dep(lcd));
+    int aht20 = boot.add_step("aht20", g_aht20_init, BOOT_AHT20_DEADLINE_MS, 0, false);
+    boot.add_step("bmp280", g_bmp280_init, BOOT_BMP280_DEADLINE_MS);
+    
+    scheduler.spawn(g_usb_wait);
+    boot.start([&boot, aht20](bool ok) {
+        if (!ok) {
+            printf("[FATAL ERROR] 硬件初始化失败: %s\n", boot.first_failure());
+            if (g_env_monitor) {
+                g_env_monitor->show_error(std::string(boot.first_failure()) + "初始化失败");
+            }
+            return;
         }
         
-        // 读取BMP280数据（先读取，因为温度卡片需要BMP280温度）
-        float P, T, ALT;
-        BMP280GetData(&P, &T, &ALT);
-        sensor_data.bmp280_pressure = P;
-        sensor_data.bmp280_temperature = T;
-        sensor_data.bmp280_altitude = ALT;
-        
-        // 转换AHT20数据 - 使用原始demo.cpp的方法
-        if (CT_data[0] > 0 && CT_data[1] > 0) {
-            // 使用原始demo.cpp的转换公式
-            sensor_data.aht20_humidity = CT_data[0] * 1000.0f / 1024.0f / 1024.0f;  // 湿度值
-            sensor_data.aht20_temperature = CT_data[1] * 200.0f * 10.0f / 1024.0f / 1024.0f - 50.0f;  // 温度值
-            printf("[AHT20] 转换后: 湿度=%.1f%%, 温度=%.1f°C\n", 
-                   sensor_data.aht20_humidity, sensor_data.aht20_temperature);
-        } else {
-            // 使用BMP280温度作为AHT20温度的替代值，湿度设为50%
-            sensor_data.aht20_humidity = 50.0f;
-            sensor_data.aht20_temperature = sensor_data.bmp280_temperature;
-            printf("[AHT20] 数据无效，使用BMP280温度作为替代值\n");
+        // AHT20缺失时使用BMP280温度作为替代值
+        g_aht20_ready = boot.status(aht20) == event_loop::StartupOrchestrator::StepStatus::DONE;
+        if (!g_aht20_ready) {
+            printf("[HARDWARE] AHT20传感器不可用，使用BMP280温度作为替代值\n");
         }
-        
-        printf("[BMP280] 压力=%.4fhPa, 温度=%.1f°C, 海拔=%.1fm\n", P, T, ALT);
-        
-        // 更新显示
-        g_env_monitor->update_sensor_data(sensor_data);
-        
-        // 打印调试信息
-        printf("[DATA] AHT20: %.1f°C, %.1f%% | BMP280: %.1f°C, %.4fhPa, %.1fm\n",
-               sensor_data.aht20_temperature, sensor_data.aht20_humidity,
-               sensor_data.bmp280_temperature, sensor_data.bmp280_pressure, sensor_data.bmp280_altitude);
-        
-        // 延时1秒
-        delay_ms(1000);
-    }
+        printf("[HARDWARE] 所有硬件初始化完成\n");
+        g_scheduler->spawn(g_sensor_task);
+    });
+    
+    // 统计输出
+    loop.add_timer(STATS_PERIOD_MS, STATS_PERIOD_MS, [&loop]() {
+        loop.print_stats();
+        loop.reset_stats();
+    });
+    
+    // 串口命令事件源：有字符到达时由stdio回调唤醒循环，不再轮询
+    // 'T' 开关刷新延迟追踪，'L' 打印，'R' 清空
+    g_serial_source = loop.add_source([]() {
+        hardware::input::InputLatency::poll_serial();
+    });
+    stdio_set_chars_available_callback([](void* param) {
+        static_cast<event_loop::EventLoop*>(param)->signal(g_serial_source);
+    }, &loop);
+    
+    loop.run();
     
     return 0;
 }
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "EventLoop.hpp"
+#include <cstdint>
+
+namespace event_loop {
+
+class TaskScheduler;
+
+/**
+ * @brief 任务事件 - 由中断（SPI/DMA完成等）置位，唤醒等待它的任务
+ */
+class TaskEvent {
+public:
+    explicit TaskEvent(TaskScheduler* scheduler = nullptr) : scheduler_(scheduler), fired_(false) {}
+
+    void bind(TaskScheduler* scheduler) { scheduler_ = scheduler; }
+
+    /**
+     * @brief 置位并通知调度器（中断安全）
+     */
+    void set();
+
+    /**
+     * @brief 取走事件（置位时返回 true 并清除）
+     */
+    bool take() {
+        if (!fired_) {
+            return false;
+        }
+        fired_ = false;
+        return true;
+    }
+
+    bool is_set() const { return fired_; }
+
+private:
+    TaskScheduler* scheduler_;
+    volatile bool fired_;
+};
+
+/**
+ * @brief 无栈协作任务（C++17 protothread）
+ *
+ * 任务体写在 run() 中，用 TASK_BEGIN/TASK_END 包围，等待点：
+ * - TASK_DELAY_MS(ms)          定时器
+ * - TASK_AWAIT(cond, poll_ms)  条件成立前每 poll_ms 重新检查（如I2C设备忙标志）
+ * - TASK_AWAIT_EVENT(event)    等待 TaskEvent（SPI/DMA完成中断）
+ * - TASK_YIELD()               让出一轮
+ * TASK_EXIT() 提前结束任务，TASK_FAIL() 以失败结束（failed() 返回 true）。
+ *
+ * 任务对象本身就是协程帧，由调用方静态分配，不使用堆。
+ * 跨等待点的变量必须是成员变量（局部变量在等待后不保留），
+ * 同一行不能写两个等待宏，run() 内不能再嵌套 switch 包住等待点。
+ */
+class Task {
+public:
+    enum class State : uint8_t {
+        READY,          // 可立即运行
+        WAIT_TIME,      // 等待到 wake_us
+        WAIT_EVENT,     // 等待事件
+        DONE            // 已结束
+    };
+
+    Task() { restart(); }
+    virtual ~Task() = default;
+
+    /**
+     * @brief 运行到下一个等待点或结束
+     */
+    void resume() {
+        state_ = State::READY;
+        run();
+    }
+
+    /**
+     * @brief 重置到起点（任务结束后可再次 spawn）
+     */
+    void restart() {
+        resume_point_ = 0;
+        state_ = State::READY;
+        wake_us_ = 0;
+        event_ = nullptr;
+        failed_ = false;
+    }
+
+    State state() const { return state_; }
+    bool done() const { return state_ == State::DONE; }
+    bool failed() const { return failed_; }
+    uint64_t wake_us() const { return wake_us_; }
+
+    // 可以运行（就绪、到时或事件已置位）
+    bool runnable(uint64_t now_us) const {
+        switch (state_) {
+            case State::READY:      return true;
+            case State::WAIT_TIME:  return now_us >= wake_us_;
+            case State::WAIT_EVENT: return event_->is_set();
+            default:                return false;
+        }
+    }
+
+protected:
+    virtual void run() = 0;
+
+    // 当前时间（time_us_64），等待时长从发出等待时算起
+    static uint64_t clock_us();
+
+    void wait_until(uint64_t wake_us) {
+        state_ = State::WAIT_TIME;
+        wake_us_ = wake_us;
+    }
+
+    void wait_event(TaskEvent& event) {
+        state_ = State::WAIT_EVENT;
+        event_ = &event;
+    }
+
+    void finish() {
+        state_ = State::DONE;
+        resume_point_ = -1;
+    }
+
+    void fail() {
+        failed_ = true;
+        finish();
+    }
+
+    int resume_point_;      // 恢复位置（__LINE__）
+
+private:
+    State state_;
+    uint64_t wake_us_;
+    TaskEvent* event_;
+    bool failed_;
+};
+
+#define TASK_BEGIN() switch (resume_point_) { case 0:
+
+#define TASK_END() [[fallthrough]]; default: break; } finish(); return
+
+#define TASK_EXIT() do { finish(); return; } while (0)
+
+#define TASK_FAIL() do { fail(); return; } while (0)
+
+#define TASK_YIELD() \
+    do { resume_point_ = __LINE__; return; case __LINE__:; } while (0)
+
+#define TASK_DELAY_MS(ms) \
+    do { wait_until(clock_us() + static_cast<uint64_t>(ms) * 1000); \
+         resume_point_ = __LINE__; return; case __LINE__:; } while (0)
+
+#define TASK_AWAIT(cond, poll_ms) \
+    do { resume_point_ = __LINE__; [[fallthrough]]; case __LINE__: \
+         if (!(cond)) { wait_until(clock_us() + static_cast<uint64_t>(poll_ms) * 1000); return; } } while (0)
+
+#define TASK_AWAIT_EVENT(event) \
+    do { resume_point_ = __LINE__; [[fallthrough]]; case __LINE__: \
+         if (!(event).take()) { wait_event(event); return; } } while (0)
+
+/**
+ * @brief 任务调度器 - 在 EventLoop 上运行任务
+ *
+ * 到时的任务由一个单次定时器唤醒，事件由事件源唤醒；所有任务都在等待时循环睡眠。
+ */
+class TaskScheduler {
+public:
+    static constexpr int MAX_TASKS = 8;
+
+    using DoneHandler = std::function<void(Task&)>;
+
+    explicit TaskScheduler(EventLoop& loop);
+
+    /**
+     * @brief 启动任务（下一轮开始运行）
+     * @return false 任务槽已满
+     */
+    bool spawn(Task& task);
+
+    /**
+     * @brief 取消未结束的任务（不会触发结束回调）
+     * @return false 任务不在调度器中
+     */
+    bool cancel(Task& task);
+
+    /**
+     * @brief 设置任务结束回调（任务移出调度器后调用，可在其中 spawn 新任务）
+     */
+    void set_done_handler(DoneHandler handler) { done_handler_ = std::move(handler); }
+
+    /**
+     * @brief 通知有事件置位（中断安全）
+     */
+    void notify() { loop_.signal(source_id_); }
+
+    // 未结束的任务数
+    int active() const { return task_count_; }
+
+private:
+    EventLoop& loop_;
+    Task* tasks_[MAX_TASKS];
+    int task_count_;
+    int source_id_;
+    int timer_id_;
+    DoneHandler done_handler_;
+
+    void run_ready();
+    void schedule();
+};
+
+/**
+ * @brief 不经过事件循环直接运行任务到结束（初始化阶段使用，等待时睡眠）
+ */
+void run_blocking(Task& task);
+
+} // namespace event_loop
@@ -2,7 +2,11 @@
 
 #include <string>
 #include <cstdint>
+#include <memory>
+#include "hardware/display/display_surface.hpp"
 #include "hardware/display/ili9488_driver.hpp"
+#include "hardware/display/st7306_driver.hpp"
+#include "fonts/hybrid_font_renderer.hpp"
 #include "config/ili9488_colors.hpp"
 
 namespace environmental_monitor {
@@ -17,23 +21,24 @@ struct SensorData {
     float average_temperature;  // 平均温度 (°C)
 };
 
-// 显示区域定义
+// 显示区域定义（按 320x480 设计，其他尺寸的卡片宽度与间距按屏幕计算）
 struct DisplayAreas {
     // 标题区域
     static constexpr uint16_t TITLE_Y = 20;
     static constexpr uint16_t TITLE_HEIGHT = 40;
-    
+
     // 数据卡片区域
     static constexpr uint16_t CARD_START_Y = 80;
     static constexpr uint16_t CARD_HEIGHT = 80;
     static constexpr uint16_t CARD_SPACING = 20;
     static constexpr uint16_t CARD_MARGIN_X = 20;
     static constexpr uint16_t CARD_WIDTH = 280; // 320 - 2 * 20
-    
+    static constexpr uint8_t CARD_COUNT = 4;
+
     // 平均温度区域
     static constexpr uint16_t AVERAGE_Y = 420;
     static constexpr uint16_t AVERAGE_HEIGHT = 40;
-    
+
     // 数值显示区域（每个卡片内）
     static constexpr uint16_t VALUE_X = 20;
     static constexpr uint16_t VALUE_Y_OFFSET = 30;  // 从25调整为30，下调5个像素
@@ -41,51 +46,96 @@ struct DisplayAreas {
     static constexpr uint16_t STATUS_X = 200;
 };
 
+// 首次采样前的占位显示
+#define ENV_MONITOR_PLACEHOLDER_VALUE   "--"
+#define ENV_MONITOR_PLACEHOLDER_STATUS  "Wait"
+
+/**
+ * @brief 环境监测仪表盘
+ * @tparam Surface 显示表面（见 display_surface.hpp），ILI9488Driver 或 ST7306Driver
+ *
+ * 颜色按 RGB666 设计，由 Surface::fromRGB666 转换为面板颜色；
+ * 每次更新只推送改动过的行（flushRegion）。
+ */
+template<typename Surface>
 class EnvironmentalMonitor {
+    static_assert(hardware::display::is_display_surface_v<Surface>,
+                  "EnvironmentalMonitor 需要实现显示表面接口的显示驱动");
+
 public:
-    EnvironmentalMonitor(ili9488::ILI9488Driver* display);
+    using Color = typename Surface::Color;
+
+    EnvironmentalMonitor(Surface* display);
     ~EnvironmentalMonitor() = default;
-    
-    // 初始化显示界面
+
+    // 初始化显示界面（首次采样前数值显示占位符）
     void initialize_display();
-    
+
     // 更新传感器数据（支持局部刷新）
     void update_sensor_data(const SensorData& new_data);
-    
+
     // 单独更新某个传感器数据
     void update_temperature(float temperature);
     void update_humidity(float humidity);
     void update_pressure(float pressure);
     void update_altitude(float altitude);
-    
+
     // 显示错误信息
     void show_error(const std::string& error_msg);
-    
+
     // 清除错误显示
     void clear_error();
 
 private:
-    ili9488::ILI9488Driver* display_;
+    // 按屏幕尺寸计算的卡片布局（320x480 时与 DisplayAreas 一致）
+    static constexpr uint16_t CARD_WIDTH = Surface::LCD_WIDTH - 2 * DisplayAreas::CARD_MARGIN_X;
+    static constexpr uint16_t CARD_PITCH = (Surface::LCD_HEIGHT - DisplayAreas::CARD_START_Y) / DisplayAreas::CARD_COUNT;
+    static constexpr uint16_t CARD_HEIGHT = CARD_PITCH - 8 < DisplayAreas::CARD_HEIGHT ? CARD_PITCH - 8 : DisplayAreas::CARD_HEIGHT;
+
+    Surface* display_;
     SensorData current_data_;
     bool data_initialized_;
-    
+    std::unique_ptr<hybrid_font::FontManager<Surface>> fonts_;
+
+    // 面板颜色
+    Color background_;
+    Color title_color_;
+    Color border_color_;
+    Color label_color_;
+    Color value_color_;
+    Color normal_color_;
+    Color alert_color_;
+    Color placeholder_color_;
+
+    // 待推送的行范围
+    uint16_t dirty_y0_;
+    uint16_t dirty_y1_;
+
     // 绘制函数
     void draw_title();
     void draw_card_background(uint16_t y, uint16_t height);
-    void draw_sensor_card(uint16_t y, const std::string& sensor_name, 
-                         const std::string& measurement, float value, 
+    void draw_sensor_card(uint16_t y, const std::string& sensor_name,
+                         const std::string& measurement, const std::string& value_str,
                          const std::string& unit, const std::string& status = "Normal");
-    
+
     // 局部刷新函数
-    void refresh_value_area(uint16_t card_y, float old_value, float new_value, 
+    void refresh_value_area(uint16_t card_y, float old_value, float new_value,
                            const std::string& unit, uint8_t precision = 1);
-    void refresh_status_area(uint16_t card_y, const std::string& old_status, 
+    void refresh_status_area(uint16_t card_y, const std::string& old_status,
                            const std::string& new_status);
-    
+
     // 工具函数
     std::string format_value(float value, uint8_t precision = 1);
     uint16_t get_card_y_position(uint8_t card_index);
-    void fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color);
+    void fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, Color color);
+    void draw_text(uint16_t x, uint16_t y, const std::string& text, Color color);
+    uint16_t text_width(const std::string& text) const;
+    uint16_t line_height() const;
+    void mark_dirty(uint16_t y, uint16_t height);
+    void flush();
 };
 
+extern template class EnvironmentalMonitor<ili9488::ILI9488Driver>;
+extern template class EnvironmentalMonitor<st7306::ST7306Driver>;
+
 } // namespace environmental_monitor
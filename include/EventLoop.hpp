@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace event_loop {
+
+/**
+ * @brief 事件循环的平台接口（时钟 + 空闲等待）
+ *
+ * 固件使用 PicoLoopPlatform；主机测试提供虚拟时钟实现，
+ * 在 sleep_until 中推进时间并按脚本注入中断。
+ */
+class LoopPlatform {
+public:
+    virtual ~LoopPlatform() = default;
+
+    // 单调时间（微秒）
+    virtual uint64_t now_us() = 0;
+
+    // 空闲等待，直到截止时间或任一中断/事件（允许提前返回）
+    virtual void sleep_until(uint64_t deadline_us) = 0;
+};
+
+/**
+ * @brief RP2040 平台：time_us_64 + WFE 睡眠
+ *
+ * 中断中调用 EventLoop::signal 会执行 SEV，即使信号发生在检查与 WFE 之间，
+ * 事件寄存器也会让 WFE 立即返回，不会丢失唤醒。
+ */
+class PicoLoopPlatform : public LoopPlatform {
+public:
+    uint64_t now_us() override;
+    void sleep_until(uint64_t deadline_us) override;
+};
+
+using TimerCallback = std::function<void()>;
+using SourceHandler = std::function<void()>;
+
+/**
+ * @brief 循环统计（自上次 reset_stats 起）
+ */
+struct LoopStats {
+    uint64_t elapsed_us;        // 统计窗口时长
+    uint64_t busy_us;           // 执行回调的时间
+    uint32_t wakeups;           // 从睡眠中醒来的次数
+    uint32_t timer_dispatches;  // 定时器回调次数
+    uint32_t source_dispatches; // 事件源回调次数
+    uint32_t timer_overruns;    // 周期定时器错过截止时间的次数
+
+    // 循环利用率（0.1% 为单位）
+    uint32_t utilization_permille() const {
+        return elapsed_us ? static_cast<uint32_t>(busy_us * 1000 / elapsed_us) : 0;
+    }
+
+    // 每秒唤醒次数（0.01 为单位）
+    uint32_t wakeups_per_sec_x100() const {
+        return elapsed_us ? static_cast<uint32_t>(static_cast<uint64_t>(wakeups) * 100000000ull / elapsed_us) : 0;
+    }
+};
+
+/**
+ * @brief 单线程事件循环（reactor）
+ *
+ * - 定时器：单次或周期，按截止时间分发（传感器采样、统计输出等）
+ * - 事件源：GPIO/I2C/DMA 完成中断或输入事件调用 signal(id)，循环在主上下文中调用其处理函数
+ * - 无事可做时睡眠到最近的截止时间，期间任何中断都会唤醒
+ */
+class EventLoop {
+public:
+    static constexpr int MAX_TIMERS = 8;
+    static constexpr int MAX_SOURCES = 32;
+    static constexpr int INVALID_ID = -1;
+
+    explicit EventLoop(LoopPlatform& platform);
+
+    /**
+     * @brief 添加定时器
+     * @param delay_ms 首次触发延迟
+     * @param period_ms 周期（0 = 单次）
+     * @param callback 回调
+     * @return 定时器ID（槽位 | 代数 << 8），已满时返回 INVALID_ID
+     * @details 槽位在定时器结束后复用，代数使旧ID不会误取消占用同一槽位的新定时器
+     */
+    int add_timer(uint32_t delay_ms, uint32_t period_ms, TimerCallback callback);
+
+    /**
+     * @brief 取消定时器（可在回调中调用）
+     * @details 已结束或已取消的定时器ID被忽略，即使其槽位已被新定时器占用
+     */
+    void cancel_timer(int id);
+
+    /**
+     * @brief 注册事件源
+     * @return 事件源ID，已满时返回 INVALID_ID
+     */
+    int add_source(SourceHandler handler);
+
+    /**
+     * @brief 标记事件源就绪（中断安全）
+     * @details 分发前的多次信号合并为一次回调，处理函数应取完该事件源的全部数据（如清空FIFO）
+     */
+    void signal(int id);
+
+    /**
+     * @brief 处理一轮：分发就绪事件源和到期定时器，无事可做时睡眠
+     */
+    void run_once();
+
+    /**
+     * @brief 运行直到 stop()
+     */
+    void run();
+    void stop() { running_ = false; }
+
+    uint64_t now_us() { return platform_.now_us(); }
+
+    LoopStats stats();
+    void reset_stats();
+
+    /**
+     * @brief 打印统计
+     */
+    void print_stats();
+
+private:
+    struct Timer {
+        uint64_t deadline_us;
+        uint32_t period_us;
+        bool active;
+        uint8_t generation;     // 每次分配槽位时递增
+        TimerCallback callback;
+    };
+
+    LoopPlatform& platform_;
+    Timer timers_[MAX_TIMERS];
+    SourceHandler sources_[MAX_SOURCES];
+    int source_count_;
+    volatile uint32_t pending_;
+    bool running_;
+
+    LoopStats stats_;
+    uint64_t stats_start_us_;
+
+    uint32_t take_pending();
+    bool dispatch_sources();
+    bool dispatch_timers(uint64_t now_us);
+    uint64_t next_deadline() const;
+};
+
+} // namespace event_loop
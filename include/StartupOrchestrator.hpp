@@ -0,0 +1,96 @@
+#pragma once
+
+#include "AsyncTask.hpp"
+#include <cstdint>
+#include <functional>
+
+namespace event_loop {
+
+/**
+ * @brief 启动编排器 - 按依赖顺序运行启动步骤，互不依赖的步骤并行
+ *
+ * 每个步骤是一个 Task（复位/校准等等待写成 TASK_DELAY_MS，不占用CPU），
+ * 依赖全部完成后才启动，并有从启动时算起的截止时间：
+ * - 步骤以 TASK_FAIL() 结束为失败，超过截止时间被取消为超时
+ * - 必需步骤失败或超时，其后继被跳过，启动失败
+ * - 可选步骤失败或超时不阻塞后继（如某个传感器缺失）
+ * 全部步骤结束后打印启动时间线并调用完成回调。
+ */
+class StartupOrchestrator {
+public:
+    static constexpr int MAX_STEPS = 8;
+    static constexpr int INVALID_ID = -1;
+
+    enum class StepStatus : uint8_t {
+        PENDING,        // 等待依赖
+        RUNNING,        // 运行中
+        DONE,           // 完成
+        FAILED,         // 失败
+        TIMED_OUT,      // 超过截止时间
+        SKIPPED         // 必需的依赖未完成
+    };
+
+    using CompleteCallback = std::function<void(bool ok)>;
+
+    StartupOrchestrator(EventLoop& loop, TaskScheduler& scheduler);
+
+    /**
+     * @brief 添加步骤（start 之前调用）
+     * @param name 步骤名（时间线输出用）
+     * @param task 步骤任务
+     * @param deadline_ms 截止时间（从步骤启动算起）
+     * @param deps 依赖步骤的掩码（dep(id) 组合）
+     * @param required 是否必需
+     * @return 步骤ID，已满时返回 INVALID_ID
+     */
+    int add_step(const char* name, Task& task, uint32_t deadline_ms,
+                 uint32_t deps = 0, bool required = true);
+
+    static uint32_t dep(int id) { return id >= 0 ? 1u << id : 0; }
+
+    /**
+     * @brief 开始启动，结束后调用 on_complete（ok = 所有必需步骤完成）
+     */
+    void start(CompleteCallback on_complete);
+
+    bool finished() const { return finished_; }
+    StepStatus status(int id) const { return steps_[id].status; }
+
+    // 第一个未完成的必需步骤名，没有时返回 nullptr
+    const char* first_failure() const;
+
+    /**
+     * @brief 打印启动时间线（时间从上电算起）
+     */
+    void print_timeline() const;
+
+private:
+    struct Step {
+        const char* name;
+        Task* task;
+        uint32_t deps;
+        uint32_t deadline_ms;
+        bool required;
+        StepStatus status;
+        uint64_t start_us;
+        uint64_t end_us;
+    };
+
+    EventLoop& loop_;
+    TaskScheduler& scheduler_;
+    Step steps_[MAX_STEPS];
+    int step_count_;
+    int timer_id_;
+    bool finished_;
+    uint64_t start_us_;
+    CompleteCallback on_complete_;
+
+    void on_task_done(Task& task);
+    void on_deadline();
+    void launch_ready();
+    void arm_deadline();
+    void check_complete();
+    void end_step(Step& step, StepStatus status);
+};
+
+} // namespace event_loop
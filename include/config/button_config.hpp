@@ -44,6 +44,35 @@
 // 按键释放时的GPIO电平
 #define BUTTON_RELEASED_LEVEL   1       // 按键释放时为高电平
 
+// === 中断采样配置 ===
+
+// 按键输入方式（1=GPIO边沿中断+时间戳FIFO，0=主循环轮询gpio_get）
+#ifndef BUTTON_USE_EDGE_IRQ
+#define BUTTON_USE_EDGE_IRQ     1
+#endif
+
+// 边沿FIFO容量（2的幂）- 主循环停顿期间可缓存的边沿数
+#ifndef BUTTON_EDGE_FIFO_SIZE
+#define BUTTON_EDGE_FIFO_SIZE   32
+#endif
+
+// 按键事件队列容量（2的幂）- 渲染较慢时可排队的事件数
+#ifndef BUTTON_EVENT_QUEUE_SIZE
+#define BUTTON_EVENT_QUEUE_SIZE 16
+#endif
+
+// === 延迟追踪配置 ===
+
+// 输入到显示延迟追踪（1=编译进追踪代码，运行时默认关闭，0=完全移除）
+#ifndef INPUT_LATENCY_TRACE
+#define INPUT_LATENCY_TRACE     1
+#endif
+
+// 输入分发后超过此时间仍未刷新屏幕则视为无对应刷新，丢弃该样本（毫秒）
+#ifndef INPUT_LATENCY_TIMEOUT_MS
+#define INPUT_LATENCY_TIMEOUT_MS 2000
+#endif
+
 // === 调试配置 ===
 
 // 按键事件调试开关（0=关闭，1=开启）
@@ -54,6 +54,7 @@
 #define MICROSD_SPI_FREQ_SLOW_COMPAT     (200 * 1000)       // 兼容性慢速频率
 #define MICROSD_SPI_FREQ_FAST_COMPAT     (20 * 1000 * 1000) // 兼容性快速频率
 #define MICROSD_SPI_FREQ_FAST_HIGH       (50 * 1000 * 1000) // 高速频率
+#define MICROSD_SPI_FREQ_FAST_MIN        (4 * 1000 * 1000)  // 自适应降频下限
 
 // MicroSD 配置标志
 #define MICROSD_USE_INTERNAL_PULLUP     true    // 默认使用内部上拉电阻
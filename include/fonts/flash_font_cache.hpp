@@ -48,6 +48,9 @@ public:
     // 从Flash中读取字符位图数据
     std::vector<uint8_t> get_char_bitmap(uint16_t char_code) const;
     
+    // 字符位图在Flash中的地址（XIP直接读取，不复制），未初始化时返回nullptr
+    const uint8_t* get_char_data(uint16_t char_code) const;
+    
     // 验证Flash中的字体文件头
     bool verify_font_header() const;
     
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "fonts/hybrid_font_system.hpp"
+#include "hardware/display/display_surface.hpp"
 #include <string>
 #include <memory>
 
@@ -61,6 +62,25 @@ public:
      */
     void draw_string(DisplayDriver& display, int x, int y, const char* text, bool color);
     
+    /**
+     * @brief 绘制彩色字符串（显示驱动需实现显示表面接口，每个字形一次 blitMono）
+     * @param display 显示驱动实例
+     * @param x X坐标
+     * @param y Y坐标
+     * @param text UTF-8字符串
+     * @param fg 前景色（面板原生颜色）
+     * @param bg 背景色，字形单元内的0位画背景色
+     */
+    template<typename D = DisplayDriver>
+    void draw_text(DisplayDriver& display, int x, int y, const char* text,
+                   typename D::Color fg, typename D::Color bg);
+    
+    /**
+     * @brief 绘制彩色字符串（透明背景）
+     */
+    template<typename D = DisplayDriver>
+    void draw_text(DisplayDriver& display, int x, int y, const char* text, typename D::Color fg);
+    
     /**
      * @brief 计算字符串显示宽度
      * @param text 字符串
@@ -105,6 +125,13 @@ private:
     void draw_flash_char(DisplayDriver& display, int x, int y, 
                         const std::vector<uint8_t>& bitmap, bool color);
     
+    /**
+     * @brief 按字形整块绘制字符串
+     * @param bg 背景色，nullptr 为透明
+     */
+    template<typename Color>
+    void blit_text(DisplayDriver& display, int x, int y, const char* text, Color fg, const Color* bg);
+    
     std::shared_ptr<IFontDataSource> font_source_;
 };
 
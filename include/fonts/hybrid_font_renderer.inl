@@ -85,6 +85,58 @@ void FontRenderer<DisplayDriver>::draw_string(DisplayDriver& display, int x, int
     // printf("[FontRenderer] draw_string: 字符串渲染完成\n");
 }
 
+template<typename DisplayDriver>
+template<typename D>
+void FontRenderer<DisplayDriver>::draw_text(DisplayDriver& display, int x, int y, const char* text,
+                                           typename D::Color fg, typename D::Color bg) {
+    static_assert(hardware::display::is_display_surface_v<D>, "draw_text 需要显示表面接口");
+    blit_text(display, x, y, text, fg, &bg);
+}
+
+template<typename DisplayDriver>
+template<typename D>
+void FontRenderer<DisplayDriver>::draw_text(DisplayDriver& display, int x, int y, const char* text,
+                                           typename D::Color fg) {
+    static_assert(hardware::display::is_display_surface_v<D>, "draw_text 需要显示表面接口");
+    blit_text(display, x, y, text, fg, static_cast<const typename D::Color*>(nullptr));
+}
+
+template<typename DisplayDriver>
+template<typename Color>
+void FontRenderer<DisplayDriver>::blit_text(DisplayDriver& display, int x, int y, const char* text,
+                                           Color fg, const Color* bg) {
+    if (!font_source_ || !font_source_->is_valid() || !text) {
+        return;
+    }
+    
+    int current_x = x;
+    const char* str = text;
+    
+    while (*str) {
+        uint32_t char_code = decode_utf8_char(str);
+        if (char_code == 0) {
+            break;
+        }
+        
+        // ASCII字符 8x16（每行1字节），其他字符 16x16（每行2字节），都是高位在前
+        bool ascii = char_code >= FontConfig::ASCII_START && char_code <= FontConfig::ASCII_END;
+        int width = ascii ? FontConfig::ASCII_FONT_WIDTH : FontConfig::FLASH_FONT_WIDTH;
+        int height = ascii ? FontConfig::ASCII_FONT_HEIGHT : FontConfig::FLASH_FONT_HEIGHT;
+        
+        // 直接从字体数据（内置表或XIP Flash）blit，不为每个字形复制位图
+        const uint8_t* bitmap = font_source_->get_char_data(char_code);
+        if (bitmap && current_x >= 0 && y >= 0) {
+            uint16_t stride = (width + 7) / 8;
+            if (bg) {
+                display.blitMono(current_x, y, width, height, bitmap, stride, fg, *bg);
+            } else {
+                display.blitMono(current_x, y, width, height, bitmap, stride, fg);
+            }
+        }
+        current_x += width;
+    }
+}
+
 template<typename DisplayDriver>
 int FontRenderer<DisplayDriver>::calculate_string_width(const std::string& text) const {
     return calculate_string_width(text.c_str());
@@ -41,6 +41,13 @@ public:
      */
     virtual std::vector<uint8_t> get_char_bitmap(uint32_t char_code) const = 0;
     
+    /**
+     * @brief 获取字符位图数据的地址（直接指向字体数据，不复制）
+     * @param char_code Unicode字符代码
+     * @return 位图数据指针（get_bytes_per_char 字节），如果字符不支持则返回nullptr
+     */
+    virtual const uint8_t* get_char_data(uint32_t char_code) const = 0;
+    
     /**
      * @brief 检查是否支持指定字符
      * @param char_code Unicode字符代码
@@ -90,6 +97,7 @@ public:
     
     // IFontDataSource接口实现
     std::vector<uint8_t> get_char_bitmap(uint32_t char_code) const override;
+    const uint8_t* get_char_data(uint32_t char_code) const override;
     bool is_char_supported(uint32_t char_code) const override;
     int get_font_width() const override;
     int get_font_height() const override;
@@ -125,6 +133,7 @@ public:
     
     // IFontDataSource接口实现
     std::vector<uint8_t> get_char_bitmap(uint32_t char_code) const override;
+    const uint8_t* get_char_data(uint32_t char_code) const override;
     bool is_char_supported(uint32_t char_code) const override;
     int get_font_width() const override;
     int get_font_height() const override;
@@ -175,6 +184,7 @@ public:
     
     // IFontDataSource接口实现
     std::vector<uint8_t> get_char_bitmap(uint32_t char_code) const override;
+    const uint8_t* get_char_data(uint32_t char_code) const override;
     bool is_char_supported(uint32_t char_code) const override;
     int get_font_width() const override;
     int get_font_height() const override;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "fonts/hybrid_font_system.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace hybrid_font {
+
+/**
+ * @brief 分页排版参数 (文本区尺寸与字体度量)
+ * 默认值与 FontConfig 一致；fingerprint() 覆盖全部字段，任一项变化都会使已保存的分页索引失效
+ */
+struct TextLayout {
+    uint16_t width = 320;                                   // 文本区宽度 (像素)
+    uint16_t height = 480;                                  // 文本区高度 (像素)
+    uint8_t line_height = FontConfig::FLASH_FONT_HEIGHT;    // 行高 (含行距)
+    uint8_t ascii_width = FontConfig::ASCII_FONT_WIDTH;     // 可打印ASCII字符宽度
+    uint8_t wide_width = FontConfig::FLASH_FONT_WIDTH;      // 其他字符宽度 (CJK等)
+
+    /**
+     * @brief 字符宽度，规则与 FontRenderer::calculate_string_width 相同
+     */
+    int char_width(uint32_t char_code) const {
+        return (char_code >= FontConfig::ASCII_START && char_code <= FontConfig::ASCII_END)
+               ? ascii_width : wide_width;
+    }
+
+    int lines_per_page() const {
+        int lines = line_height ? height / line_height : 0;
+        return lines > 0 ? lines : 1;
+    }
+
+    /**
+     * @brief 排版参数与断行规则版本的指纹
+     */
+    uint32_t fingerprint() const;
+};
+
+/**
+ * @brief 流式分页器
+ * 按块输入UTF-8文本 (UTF-8序列可跨块)，每确定一页的起始字节偏移就回调一次。
+ * 断行与 FontRenderer::draw_string 的排版一致：按字符宽度累加，放不下时在该字符前换行；
+ * '\n' 强制换行，'\r' 和无效字节不占宽度。
+ */
+class PageBreaker {
+public:
+    using PageCallback = std::function<void(size_t page_start)>;
+
+    explicit PageBreaker(const TextLayout& layout = TextLayout());
+
+    /**
+     * @brief 从页起始偏移处重新开始 (用于从已保存的索引末尾继续扫描)
+     */
+    void reset(size_t page_start);
+
+    /**
+     * @brief 输入下一块文本
+     * @param on_page 新页起始偏移回调 (不包括 reset() 时的起始页)
+     */
+    void feed(const uint8_t* data, size_t length, const PageCallback& on_page);
+
+    /**
+     * @brief 下一个输入字节的文件偏移
+     */
+    size_t offset() const { return offset_; }
+
+private:
+    TextLayout layout_;
+    int lines_per_page_;
+    size_t offset_;
+    size_t char_start_;     // 当前UTF-8序列的起始偏移
+    uint32_t char_code_;    // 正在解码的码点
+    uint8_t pending_;       // 还需要的续字节数
+    int x_;                 // 当前行已用宽度
+    int line_;              // 当前页内行号
+
+    void put_char(uint32_t char_code, size_t start, const PageCallback& on_page);
+    void begin_line(size_t line_start, const PageCallback& on_page);
+};
+
+} // namespace hybrid_font
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace hardware {
+namespace display {
+
+/**
+ * @brief 显示表面接口（模板概念）
+ *
+ * 仪表盘与字体渲染按此接口编写，ILI9488（RGB666直写）与 ST7306（2bpp帧缓冲）
+ * 各自用最快的原生路径实现。工程为 C++17，没有 concepts，用 is_display_surface
+ * 在编译期检查。一个显示表面类型 S 需要提供：
+ *
+ * - S::Color                         面板原生颜色类型
+ * - S::LCD_WIDTH / S::LCD_HEIGHT     尺寸
+ * - S::fromRGB666(uint32_t)          RGB666 转换为原生颜色
+ * - fillSpan(x, y, len, color)       水平线段
+ * - fillRect(x, y, w, h, color)      矩形
+ * - blitMono(x, y, w, h, bits, stride, fg, bg)
+ *                                    1bpp位图（每行 stride 字节，高位在前），0 位画 bg
+ * - blitMono(x, y, w, h, bits, stride, fg)
+ *                                    同上，0 位透明
+ * - writeWindow(x, y, w, h, pixels)  按行写入 w*h 个原生颜色
+ * - flushRegion(x, y, w, h)          把区域推送到屏幕（直写面板只记一帧；帧缓冲面板
+ *                                    只推送区域内已改动的部分，可能按控制器的地址粒度向外扩展）
+ *
+ * 超出屏幕的部分在右、下边缘裁剪。
+ */
+template<typename S, typename = void>
+struct is_display_surface : std::false_type {};
+
+template<typename S>
+struct is_display_surface<S, std::void_t<
+    typename S::Color,
+    decltype(S::LCD_WIDTH),
+    decltype(S::LCD_HEIGHT),
+    decltype(S::fromRGB666(uint32_t())),
+    decltype(std::declval<S&>().fillSpan(uint16_t(), uint16_t(), uint16_t(), std::declval<typename S::Color>())),
+    decltype(std::declval<S&>().fillRect(uint16_t(), uint16_t(), uint16_t(), uint16_t(),
+                                         std::declval<typename S::Color>())),
+    decltype(std::declval<S&>().blitMono(uint16_t(), uint16_t(), uint16_t(), uint16_t(),
+                                         std::declval<const uint8_t*>(), uint16_t(),
+                                         std::declval<typename S::Color>(), std::declval<typename S::Color>())),
+    decltype(std::declval<S&>().blitMono(uint16_t(), uint16_t(), uint16_t(), uint16_t(),
+                                         std::declval<const uint8_t*>(), uint16_t(),
+                                         std::declval<typename S::Color>())),
+    decltype(std::declval<S&>().writeWindow(uint16_t(), uint16_t(), uint16_t(), uint16_t(),
+                                            std::declval<const typename S::Color*>())),
+    decltype(std::declval<S&>().flushRegion(uint16_t(), uint16_t(), uint16_t(), uint16_t()))
+>> : std::true_type {};
+
+template<typename S>
+inline constexpr bool is_display_surface_v = is_display_surface<S>::value;
+
+/**
+ * @brief 把矩形裁剪到屏幕内
+ * @return false 矩形完全在屏幕外或为空
+ */
+inline bool clip_rect(uint16_t x, uint16_t y, uint16_t& w, uint16_t& h,
+                      uint16_t screen_w, uint16_t screen_h) {
+    if (x >= screen_w || y >= screen_h || w == 0 || h == 0) {
+        return false;
+    }
+    if (w > screen_w - x) {
+        w = screen_w - x;
+    }
+    if (h > screen_h - y) {
+        h = screen_h - y;
+    }
+    return true;
+}
+
+} // namespace display
+} // namespace hardware
@@ -5,6 +5,8 @@
 #include <string_view>
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
+#include "AsyncTask.hpp"
+#include "hardware/display/display_surface.hpp"
 
 namespace ili9488 {
 
@@ -48,7 +50,22 @@ public:
                   uint8_t sck_pin, uint8_t mosi_pin, uint8_t bl_pin, uint32_t spi_speed_hz = 40000000);
     ~ILI9488Driver();
 
-    // 初始化函数
+    /**
+     * @brief 初始化序列任务（复位、软件复位、退出睡眠等共约620ms等待）
+     *
+     * 交给 TaskScheduler 运行时，等待期间可以并行初始化传感器；
+     * initialize() 用同一序列阻塞运行。
+     */
+    class InitTask : public event_loop::Task {
+    public:
+        explicit InitTask(ILI9488Driver& driver) : driver_(driver) {}
+    protected:
+        void run() override;
+    private:
+        ILI9488Driver& driver_;
+    };
+
+    // 初始化函数（阻塞）
     bool initialize();
     void clear();
     void display();
@@ -113,6 +130,21 @@ public:
     void setScreenPowerState(bool on);  // 设置屏幕开关状态
     bool getScreenPowerState() const;   // 获取屏幕开关状态
 
+    // ==================== 显示表面接口（display_surface.hpp） ====================
+    // 直写面板：每个操作设置一次窗口后连续写入像素，不经过逐像素命令
+    using Color = uint32_t;     // RGB666
+
+    static constexpr Color fromRGB666(uint32_t color666) { return color666; }
+
+    void fillSpan(uint16_t x, uint16_t y, uint16_t len, Color color);
+    void fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color color);
+    void blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  const uint8_t* bits, uint16_t stride, Color fg, Color bg);
+    void blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  const uint8_t* bits, uint16_t stride, Color fg);
+    void writeWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Color* pixels);
+    void flushRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
 private:
     void writeCommand(uint8_t cmd);
     void writeData(uint8_t data);
@@ -146,7 +178,9 @@ private:
 
     // 私有辅助函数
     void setAddress();
-    void initILI9488();
+    void setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+    void setupHardware();
+    void initRegisters();
     void updateDisplayMode();
 };
 
@@ -4,6 +4,8 @@
 #include <cstring>
 #include <string_view>
 #include "pico/stdlib.h"
+#include "AsyncTask.hpp"
+#include "hardware/display/display_surface.hpp"
 
 namespace st7306 {
 
@@ -38,10 +40,28 @@ public:
     ST7306Driver(uint dc_pin, uint res_pin, uint cs_pin, uint sclk_pin, uint sdin_pin);
     ~ST7306Driver();
 
-    // 初始化函数
+    /**
+     * @brief 初始化序列任务（复位、退出睡眠、清RAM共约160ms等待）
+     *
+     * 交给 TaskScheduler 运行时，等待期间可以并行初始化传感器；
+     * initialize() 用同一序列阻塞运行。
+     */
+    class InitTask : public event_loop::Task {
+    public:
+        explicit InitTask(ST7306Driver& driver) : driver_(driver) {}
+    protected:
+        void run() override;
+    private:
+        ST7306Driver& driver_;
+    };
+
+    // 初始化函数（阻塞）
     void initialize();
     void clear();
+    // 推送自上次推送以来改动过的矩形（按面板列/行地址对齐），没有改动时不传输
     void display();
+    // 标记整屏需要推送（面板RAM内容未知时使用）
+    void invalidate();
 
     // 绘图函数
     void drawPixel(uint16_t x, uint16_t y, bool color);
@@ -85,6 +105,27 @@ public:
     // 初始化状态检查
     bool is_initialized() const;
 
+    // ==================== 显示表面接口（display_surface.hpp） ====================
+    // 帧缓冲面板：绘制只改缓冲区（0°旋转时按字节写入），flushRegion 只推送区域内已改动的部分，
+    // 区域外的改动留到下一次 display()/flushRegion
+    using Color = uint8_t;      // 2bpp灰度，COLOR_WHITE ~ COLOR_BLACK
+
+    // 亮度量化为4级灰度（0x00为白）
+    static constexpr Color fromRGB666(uint32_t color666) {
+        return static_cast<Color>(3 - (((((color666 >> 16) & 0xFC) * 77 +
+                                          ((color666 >> 8) & 0xFC) * 150 +
+                                          (color666 & 0xFC) * 29) >> 8) >> 6));
+    }
+
+    void fillSpan(uint16_t x, uint16_t y, uint16_t len, Color color);
+    void fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color color);
+    void blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  const uint8_t* bits, uint16_t stride, Color fg, Color bg);
+    void blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  const uint8_t* bits, uint16_t stride, Color fg);
+    void writeWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Color* pixels);
+    void flushRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
 private:
     void writeCommand(uint8_t cmd);
     void writeData(uint8_t data);
@@ -110,9 +151,33 @@ private:
     
     bool initialized_ = false;  // 初始化状态标志
 
+    // 列地址 0x05~0x36 共50个，每个列地址对应3个缓冲区字节（6列像素）
+    static constexpr uint8_t COLUMN_ADDRESS_START = 0x05;
+    static constexpr uint8_t BYTES_PER_COLUMN_ADDRESS = 3;
+
+    // 待推送的矩形（缓冲区单位：列为字节，每字节2列像素；行为缓冲区行，每行2行像素）
+    // dirty_col0_ > dirty_col1_ 表示没有改动
+    uint8_t dirty_col0_ = LCD_DATA_WIDTH;
+    uint8_t dirty_col1_ = 0;
+    uint8_t dirty_row0_ = LCD_DATA_HEIGHT;
+    uint8_t dirty_row1_ = 0;
+
     // 私有辅助函数
-    void setAddress();
-    void initST7306();
+    void setAddress(uint8_t col0, uint8_t col1, uint8_t row0, uint8_t row1);
+    // 推送缓冲区矩形（列为字节，按列地址向外对齐），发送完成后记一帧
+    void pushWindow(uint8_t col0, uint8_t col1, uint8_t row0, uint8_t row1);
+    void markDirty(uint8_t col0, uint8_t col1, uint8_t row0, uint8_t row1);
+    void fillSpanRaw(uint16_t x, uint16_t y, uint16_t len, uint8_t color);
+    // 0°旋转下按字节合成一行单色位图；opaque 为 false 时0位保持原样
+    void blitMonoRowRaw(uint16_t x, uint16_t y, uint16_t w, const uint8_t* src,
+                        uint8_t fg, uint8_t bg, bool opaque);
+    void surfacePoint(uint16_t x, uint16_t y, uint8_t color);
+    // 当前旋转下的逻辑宽高（90°/270°时宽高互换）
+    uint16_t surfaceWidth() const;
+    uint16_t surfaceHeight() const;
+    void initPowerSettings();      // 退出睡眠前：电压、时序、行数
+    void initPanelSettings();      // 退出睡眠后：数据格式、地址窗口、开启显示
+    void resetAddressWindow();
     void updateDisplayMode();
 };
 
@@ -15,6 +15,7 @@
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "config/button_config.hpp"
+#include "hardware/input/button/button_edge_capture.hpp"
 #include <stdint.h>
 
 namespace hardware {
@@ -64,6 +65,12 @@ private:
     
     // 事件队列（简单实现）
     ButtonManagerEvent pending_event_;
+    
+    // 边沿中断模式
+    bool edge_irq_;
+    EdgeDebouncer screen_power_edges_;
+    EdgeDebouncer page_up_edges_;
+    EdgeDebouncer page_down_edges_;
 
 public:
     /**
@@ -122,6 +129,17 @@ private:
      * @return true 按键刚刚按下，false 未按下或防抖中
      */
     bool isButtonJustPressed(uint8_t pin, bool current_state, bool& last_state, uint32_t& last_time);
+    
+    /**
+     * @brief 边沿中断模式的更新：消费边沿FIFO，按时间戳判定短按/长按
+     */
+    void updateFromEdges();
+    
+    /**
+     * @brief 取出下一个可转换为事件的手势
+     * @return true 已产生待处理事件
+     */
+    bool takeGesture();
 };
 
 } // namespace input
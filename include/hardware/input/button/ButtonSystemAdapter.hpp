@@ -11,7 +11,9 @@
 #define BUTTON_SYSTEM_ADAPTER_HPP
 
 #include "hardware/input/button/EnhancedButtonManager.hpp"
-#include "hardware/input/joystick/joystick.hpp"
+#include "hardware/input/joystick/joystick_controller.hpp"
+#include "hardware/input/button/input_event_queue.hpp"
+#include "hardware/input/input_latency.hpp"
 #include <functional>
 #include <memory>
 
@@ -50,6 +52,10 @@ enum class UnifiedInputEvent {
  * 提供合适的事件映射
  */
 class ButtonSystemAdapter {
+public:
+    using EventQueue = InputEventQueue<UnifiedInputEvent, BUTTON_EVENT_QUEUE_SIZE>;
+    using EventEntry = EventQueue::Entry;
+
 private:
     std::unique_ptr<EnhancedButtonManager> button_manager_;
     JoystickController* joystick_controller_;
@@ -64,7 +70,11 @@ private:
     JoystickDirection last_joystick_direction_;
     ButtonState last_joystick_button_;
     
-    // 防连发计时
+    // 统一事件队列
+    EventQueue events_;
+    
+    // 摇杆防连发计时（仅抑制摇杆在延迟内重复的同一事件）
+    UnifiedInputEvent last_joystick_event_;
     uint32_t last_event_time_;
     uint32_t repeat_delay_ms_;
 
@@ -110,11 +120,39 @@ public:
     void update();
     
     /**
-     * @brief 设置防连发延迟时间
+     * @brief 设置摇杆防连发延迟时间
      * @param ms 延迟时间（毫秒）
      */
     void set_repeat_delay(uint32_t ms) { repeat_delay_ms_ = ms; }
     
+    /**
+     * @brief 取出全部排队事件（未设置回调时使用）
+     *
+     * 连续的可合并事件（翻页、上下导航）合并为一个条目，count 为次数，
+     * 渲染较慢时可以直接前进 count 步而不是逐个重放。
+     * @param handler 处理函数 void(const EventEntry&)
+     * @return 处理的条目数
+     */
+    template <typename Handler>
+    size_t drain_events(Handler&& handler) {
+        return events_.drain([&handler](const EventEntry& entry) {
+            InputLatency::input_dispatched(entry.time_ms);
+            handler(entry);
+        });
+    }
+    
+    /**
+     * @brief 设置事件类型是否合并
+     */
+    void set_event_coalescing(UnifiedInputEvent event, bool enabled) { events_.set_coalescing(event, enabled); }
+    
+    /**
+     * @brief 事件队列统计
+     */
+    uint32_t get_event_overflows() const { return events_.overflow_count(); }
+    uint32_t get_events_coalesced() const { return events_.coalesced_count(); }
+    uint32_t get_event_high_water() const { return events_.high_water(); }
+    
     /**
      * @brief 获取增强按键管理器
      * @return 按键管理器指针
@@ -130,16 +168,22 @@ public:
 private:
     /**
      * @brief 处理增强按键事件
-     * @param button_event 按键事件
+     * @param entry 按键事件条目
      */
-    void handle_button_event(EnhancedButtonEvent button_event);
+    void handle_button_event(const EnhancedButtonManager::EventEntry& entry);
     
     /**
-     * @brief 处理摇杆事件
-     * @param direction 摇杆方向
+     * @brief 处理摇杆方向事件（PRESS受防连发限制，REPEAT为引擎的加速连发，直接转发）
+     * @param event 方向引擎事件
+     */
+    void handle_joystick_event(const ::JoystickEvent& event);
+    
+    /**
+     * @brief 处理摇杆按钮状态
      * @param button_state 摇杆按钮状态
+     * @param time_ms 采样时间
      */
-    void handle_joystick_event(JoystickDirection direction, ButtonState button_state);
+    void handle_joystick_button(ButtonState button_state, uint32_t time_ms);
     
     /**
      * @brief 将增强按键事件转换为统一输入事件
@@ -157,16 +201,18 @@ private:
     UnifiedInputEvent joystick_event_to_unified(JoystickDirection direction, ButtonState button_state);
     
     /**
-     * @brief 触发统一输入事件
+     * @brief 触发统一输入事件（入队）
      * @param event 要触发的事件
+     * @param source 事件来源
+     * @param time_ms 事件时间
      */
-    void trigger_unified_event(UnifiedInputEvent event);
+    void trigger_unified_event(UnifiedInputEvent event, InputSource source, uint32_t time_ms);
     
     /**
-     * @brief 检查是否可以触发事件（防连发）
+     * @brief 检查摇杆事件是否可以触发（防连发）
      * @return true 可以触发，false 需要等待
      */
-    bool can_trigger_event();
+    bool can_trigger_joystick_event(UnifiedInputEvent event, uint32_t time_ms);
 };
 
 // === 便利函数 ===
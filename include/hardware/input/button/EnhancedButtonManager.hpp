@@ -18,6 +18,8 @@
 #include "hardware/gpio.h"
 #include "config/button_config.hpp"
 #include "config/button_mapping_new.hpp"
+#include "hardware/input/button/button_edge_capture.hpp"
+#include "hardware/input/button/input_event_queue.hpp"
 #include <stdint.h>
 #include <functional>
 
@@ -50,7 +52,7 @@ enum class EnhancedButtonEvent {
 /**
  * @brief 按键状态结构
  */
-struct ButtonState {
+struct ButtonTrackState {
     bool pressed;           // 当前是否按下
     bool last_pressed;      // 上次是否按下
     uint32_t press_time;    // 按下时间戳
@@ -62,6 +64,10 @@ struct ButtonState {
  * @brief 增强按键管理器类
  */
 class EnhancedButtonManager {
+public:
+    using EventQueue = InputEventQueue<EnhancedButtonEvent, BUTTON_EVENT_QUEUE_SIZE>;
+    using EventEntry = EventQueue::Entry;
+
 private:
     // 硬件引脚
     uint8_t up_pin_;      // GPIO8 - 上键
@@ -69,9 +75,9 @@ private:
     uint8_t screen_pin_;  // GPIO14 - 屏幕按键
     
     // 按键状态
-    ButtonState up_button_;
-    ButtonState down_button_;
-    ButtonState screen_button_;
+    ButtonTrackState up_button_;
+    ButtonTrackState down_button_;
+    ButtonTrackState screen_button_;
     
     // 时间配置
     uint32_t debounce_time_ms_;
@@ -82,10 +88,16 @@ private:
     ButtonFunctionMapping current_mapping_;
     
     // 事件队列
-    EnhancedButtonEvent pending_event_;
+    EventQueue events_;
     
     // 回调函数
     std::function<void(EnhancedButtonEvent)> event_callback_;
+    
+    // 边沿中断模式
+    bool edge_irq_;
+    EdgeDebouncer up_edges_;
+    EdgeDebouncer down_edges_;
+    EdgeDebouncer screen_edges_;
 
 public:
     /**
@@ -128,11 +140,36 @@ public:
     void update();
     
     /**
-     * @brief 获取下一个按键事件
+     * @brief 获取下一个按键事件（逐个取出，不合并）
      * @return 按键事件
      */
     EnhancedButtonEvent get_next_event();
     
+    /**
+     * @brief 取出下一个事件条目（含来源和时间戳，不合并）
+     * @return false 队列为空
+     */
+    bool pop_event(EventEntry& entry) { return events_.pop(entry, false); }
+    
+    /**
+     * @brief 取出全部排队事件，可合并类型的连续事件合并为一个条目（count为次数）
+     * @param handler 处理函数 void(const EventEntry&)
+     * @return 处理的条目数
+     */
+    template <typename Handler>
+    size_t drain_events(Handler&& handler) { return events_.drain(handler); }
+    
+    /**
+     * @brief 设置事件类型在 drain_events 时是否合并（默认合并 PAGE_UP/PAGE_DOWN/NAV_UP/NAV_DOWN）
+     */
+    void set_event_coalescing(EnhancedButtonEvent event, bool enabled) { events_.set_coalescing(event, enabled); }
+    
+    /**
+     * @brief 事件队列统计
+     */
+    uint32_t get_event_overflows() const { return events_.overflow_count(); }
+    uint32_t get_events_coalesced() const { return events_.coalesced_count(); }
+    
     /**
      * @brief 检查是否有待处理的事件
      * @return true 有事件，false 无事件
@@ -148,13 +185,23 @@ public:
      * @brief 设置长按时间阈值
      * @param ms 长按时间（毫秒）
      */
-    void set_long_press_time(uint32_t ms) { long_press_ms_ = ms; }
+    void set_long_press_time(uint32_t ms) {
+        long_press_ms_ = ms;
+        up_edges_.set_long_press_time(ms);
+        down_edges_.set_long_press_time(ms);
+        screen_edges_.set_long_press_time(ms);
+    }
     
     /**
      * @brief 设置防抖时间
      * @param ms 防抖时间（毫秒）
      */
-    void set_debounce_time(uint32_t ms) { debounce_time_ms_ = ms; }
+    void set_debounce_time(uint32_t ms) {
+        debounce_time_ms_ = ms;
+        up_edges_.set_debounce_time(ms);
+        down_edges_.set_debounce_time(ms);
+        screen_edges_.set_debounce_time(ms);
+    }
     
     /**
      * @brief 获取按键状态调试信息
@@ -176,18 +223,20 @@ private:
      * @param pin GPIO引脚号
      * @param current_time 当前时间戳
      */
-    void update_button_state(ButtonState& button, uint8_t pin, uint32_t current_time);
+    void update_button_state(ButtonTrackState& button, uint8_t pin, uint32_t current_time);
     
     /**
      * @brief 处理按键事件
      * @param button 按键状态结构
      * @param single_function 短按功能
      * @param long_function 长按功能
+     * @param source 事件来源
      * @param current_time 当前时间戳
      */
-    void process_button_event(const ButtonState& button, 
+    void process_button_event(const ButtonTrackState& button, 
                              ButtonFunction single_function,
                              ButtonFunction long_function,
+                             InputSource source,
                              uint32_t current_time);
     
     /**
@@ -200,8 +249,30 @@ private:
     /**
      * @brief 触发事件
      * @param event 要触发的事件
+     * @param source 事件来源
+     * @param time_ms 输入发生时间 (to_ms_since_boot 时基)：边沿模式为中断时间戳，轮询模式为采样时间
+     */
+    void trigger_event(EnhancedButtonEvent event, InputSource source, uint32_t time_ms);
+    
+    /**
+     * @brief 边沿中断模式的更新：消费边沿FIFO，按时间戳判定短按/长按
+     */
+    void update_from_edges();
+    
+    /**
+     * @brief 三个按键的防抖器都推进到 time_us，并分发已确定的手势
+     */
+    void settle_edges(uint32_t time_us);
+    
+    /**
+     * @brief 将单个按键积累的手势转换为事件
+     * @param press_only true 按下即触发短按功能（屏幕键），false 释放时判定短按/长按
      */
-    void trigger_event(EnhancedButtonEvent event);
+    void dispatch_gestures(EdgeDebouncer& edges,
+                           ButtonFunction single_function,
+                           ButtonFunction long_function,
+                           InputSource source,
+                           bool press_only);
 };
 
 } // namespace input
@@ -9,6 +9,7 @@
 
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
+#include "hardware/input/button/button_edge_capture.hpp"
 #include <stdint.h>
 
 namespace button {
@@ -52,6 +53,10 @@ private:
     uint32_t key2_last_change_;  // 按键2最后状态变化时间
     
     bool led_enabled_;           // LED指示是否启用
+    
+    bool edge_irq_;              // 是否使用边沿中断
+    hardware::input::EdgeDebouncer key1_edges_;
+    hardware::input::EdgeDebouncer key2_edges_;
 
 public:
     /**
@@ -190,6 +195,17 @@ private:
      * @return true 超过防抖时间，false 未超过
      */
     bool is_debounce_ready(uint32_t last_change_time) const;
+    
+    /**
+     * @brief 边沿中断模式的更新：每个update每个按键最多变化一次，短于循环周期的按键也能被看到
+     */
+    void update_from_edges();
+    
+    /**
+     * @brief 取出一个改变按键状态的手势
+     * @return true 状态已变化
+     */
+    bool apply_gesture(hardware::input::EdgeDebouncer& edges, ButtonState& state, const char* name);
 };
 
 } // namespace button
@@ -0,0 +1,158 @@
+/**
+ * @file button_edge_capture.hpp
+ * @brief 按键边沿中断采样 - GPIO中断记录边沿与时间戳，防抖和长按判定在主循环侧完成
+ * @version 1.0.0
+ *
+ * 中断只做一件事：把 (引脚, 电平, time_us_32()) 写入无锁单生产者/单消费者FIFO。
+ * 按键空闲时不占用CPU；主循环无论多慢，短于循环周期的按键也不会丢失，
+ * 按下时长按边沿时间戳计算，与主循环节拍无关。
+ */
+
+#ifndef BUTTON_EDGE_CAPTURE_HPP
+#define BUTTON_EDGE_CAPTURE_HPP
+
+#include "pico/stdlib.h"
+#include "config/button_config.hpp"
+#include <stdint.h>
+
+namespace hardware {
+namespace input {
+
+/**
+ * @brief 中断记录的一个原始边沿
+ */
+struct ButtonEdge {
+    uint32_t time_us;   // 边沿时间 (time_us_32)
+    uint8_t pin;        // GPIO引脚
+    bool level;         // 边沿后的电平
+
+    // 边沿后按键是否按下：电平不是 BUTTON_RELEASED_LEVEL 即按下
+    bool pressed() const { return level != BUTTON_RELEASED_LEVEL; }
+};
+
+/**
+ * @brief GPIO边沿采样器（全局单例，所有按键共用一个FIFO）
+ *
+ * 同一时刻只应有一个按键管理器消费FIFO。
+ */
+class ButtonEdgeCapture {
+public:
+    /**
+     * @brief 为引脚启用双边沿中断
+     * @param pin_mask 引脚位掩码，可多次调用追加引脚
+     * @return true 成功
+     */
+    static bool attach(uint32_t pin_mask);
+
+    /**
+     * @brief 取出最早的边沿
+     * @return false FIFO为空
+     */
+    static bool pop(ButtonEdge& edge);
+
+    /**
+     * @brief FIFO满时丢弃的边沿数
+     */
+    static uint32_t dropped() { return dropped_; }
+
+    static bool is_attached(uint8_t pin) { return (pin_mask_ >> pin) & 1u; }
+
+private:
+    static ButtonEdge fifo_[BUTTON_EDGE_FIFO_SIZE];
+    static volatile uint32_t head_;     // 中断写入
+    static volatile uint32_t tail_;     // 主循环读取
+    static volatile uint32_t dropped_;
+    static uint32_t pin_mask_;
+
+    static void irq_handler();
+};
+
+/**
+ * @brief 把 time_us_32() 时间戳换算到 to_ms_since_boot() 时基
+ *
+ * time_us_32 约71分钟回绕一次，不能直接除以1000；按距今的经过时间换算，时间戳须在71分钟以内。
+ */
+inline uint32_t edge_time_to_ms(uint32_t time_us) {
+    uint64_t now_us = time_us_64();
+    uint32_t age_us = static_cast<uint32_t>(now_us) - time_us;
+    return static_cast<uint32_t>((now_us - age_us) / 1000);
+}
+
+/**
+ * @brief 按键手势
+ */
+struct ButtonGesture {
+    enum Type : uint8_t {
+        PRESS,          // 按下（防抖后）
+        LONG_PRESS,     // 按住达到长按时间
+        CLICK,          // 未达长按时间即释放（短按）
+        RELEASE         // 长按后释放
+    };
+
+    Type type;
+    uint32_t time_us;       // 手势发生时间（由边沿时间戳推算）
+    uint32_t duration_us;   // 已按住时长（PRESS为0）
+};
+
+/**
+ * @brief 基于边沿时间戳的防抖与长按判定（纯逻辑，不访问硬件）
+ *
+ * 电平变化后保持 debounce 时间不再跳变才算有效，有效变化的时间取该串抖动的第一个边沿，
+ * 因此按下/释放时间不受抖动和主循环延迟影响。长按按时间戳判定：主循环错过长按时刻时，
+ * 释放前仍会先补发 LONG_PRESS。
+ */
+class EdgeDebouncer {
+public:
+    static constexpr int QUEUE_SIZE = 4;
+
+    EdgeDebouncer(uint32_t debounce_ms = BUTTON_DEBOUNCE_TIME,
+                  uint32_t long_press_ms = BUTTON_LONG_PRESS_MS);
+
+    /**
+     * @brief 以当前电平复位
+     */
+    void reset(bool pressed, uint32_t now_us);
+
+    /**
+     * @brief 输入一个原始边沿（按时间顺序）
+     */
+    void push(bool pressed, uint32_t time_us);
+
+    /**
+     * @brief 按当前时间推进：确认已稳定的电平变化、检测长按
+     */
+    void poll(uint32_t now_us);
+
+    /**
+     * @brief 取出最早的手势
+     */
+    bool pop(ButtonGesture& gesture);
+
+    bool has_gesture() const { return count_ > 0; }
+    bool is_pressed() const { return stable_; }
+
+    void set_debounce_time(uint32_t ms) { debounce_us_ = ms * 1000; }
+    void set_long_press_time(uint32_t ms) { long_press_us_ = ms * 1000; }
+
+private:
+    uint32_t debounce_us_;
+    uint32_t long_press_us_;
+    bool stable_;               // 防抖后的状态
+    bool raw_;                  // 最后一个边沿后的电平
+    bool burst_;                // 有未确认的抖动串
+    uint32_t burst_start_us_;   // 抖动串第一个边沿时间
+    uint32_t last_edge_us_;
+    uint32_t press_us_;
+    bool long_sent_;
+    ButtonGesture queue_[QUEUE_SIZE];
+    uint8_t head_;
+    uint8_t count_;
+
+    void settle(uint32_t now_us);
+    void emit(ButtonGesture::Type type, uint32_t time_us, uint32_t duration_us);
+};
+
+} // namespace input
+} // namespace hardware
+
+#endif // BUTTON_EDGE_CAPTURE_HPP
@@ -0,0 +1,158 @@
+/**
+ * @file input_event_queue.hpp
+ * @brief 输入事件环形队列 - 有界、无锁（单生产者/单消费者），支持按事件类型合并
+ * @version 1.0.0
+ *
+ * 取代单槽位的 pending_event_：连续的快速输入（长按自动连发、重绘期间的按键）排队而不是互相覆盖。
+ * 合并在消费侧进行：取出事件时，紧随其后的同类型可合并事件并入同一条目并累加 count，
+ * 例如 N 个排队的 PAGE_DOWN 合并为一次“前进 N 页”，慢速渲染只需重绘一次。
+ */
+
+#ifndef INPUT_EVENT_QUEUE_HPP
+#define INPUT_EVENT_QUEUE_HPP
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace hardware {
+namespace input {
+
+/**
+ * @brief 事件来源
+ */
+enum class InputSource : uint8_t {
+    BUTTON_UP = 0,      // 上键 (GPIO8)
+    BUTTON_DOWN,        // 下键 (GPIO9)
+    BUTTON_SCREEN,      // 屏幕键 (GPIO14)
+    JOYSTICK,           // 摇杆方向
+    JOYSTICK_BUTTON,    // 摇杆按钮
+};
+
+/**
+ * @brief 输入事件环形队列
+ * @tparam EventT 事件枚举类型（取值需小于32，用作合并掩码的位号）
+ * @tparam N 容量，必须是2的幂
+ */
+template <typename EventT, size_t N>
+class InputEventQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "队列容量必须是2的幂");
+
+public:
+    struct Entry {
+        EventT type;
+        InputSource source;     // 第一个事件的来源
+        uint16_t count;         // 合并的事件数
+        uint32_t time_ms;       // 第一个事件的时间
+    };
+
+    InputEventQueue() : head_(0), tail_(0), coalesce_mask_(0),
+                        overflows_(0), coalesced_(0), high_water_(0) {}
+
+    /**
+     * @brief 入队（生产者）
+     * @return false 队列已满，事件被丢弃并计入 overflow_count()
+     */
+    bool push(EventT type, InputSource source, uint32_t time_ms) {
+        uint32_t head = head_;
+        uint32_t used = head - tail_;
+        if (used >= N) {
+            overflows_++;
+            return false;
+        }
+        entries_[head & (N - 1)] = Entry{type, source, 1, time_ms};
+        __dmb();
+        head_ = head + 1;
+        if (used + 1 > high_water_) {
+            high_water_ = used + 1;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 出队（消费者）
+     * @param coalesce true 时把紧随其后的同类型可合并事件并入本条目
+     * @return false 队列为空
+     */
+    bool pop(Entry& entry, bool coalesce = true) {
+        uint32_t tail = tail_;
+        if (tail == head_) {
+            return false;
+        }
+        __dmb();
+        entry = entries_[tail & (N - 1)];
+        tail++;
+
+        if (coalesce && is_coalescing(entry.type)) {
+            while (tail != head_) {
+                __dmb();
+                const Entry& next = entries_[tail & (N - 1)];
+                if (next.type != entry.type || entry.count == UINT16_MAX) {
+                    break;
+                }
+                entry.count++;
+                coalesced_++;
+                tail++;
+            }
+        }
+
+        __dmb();
+        tail_ = tail;
+        return true;
+    }
+
+    /**
+     * @brief 取出全部事件（合并后）交给处理函数
+     * @return 处理的条目数
+     */
+    template <typename Handler>
+    size_t drain(Handler&& handler) {
+        size_t handled = 0;
+        Entry entry;
+        while (pop(entry)) {
+            handler(entry);
+            handled++;
+        }
+        return handled;
+    }
+
+    /**
+     * @brief 设置某事件类型是否在出队时合并
+     */
+    void set_coalescing(EventT type, bool enabled) {
+        uint32_t bit = 1u << static_cast<uint32_t>(type);
+        coalesce_mask_ = enabled ? (coalesce_mask_ | bit) : (coalesce_mask_ & ~bit);
+    }
+
+    bool is_coalescing(EventT type) const {
+        return (coalesce_mask_ >> static_cast<uint32_t>(type)) & 1u;
+    }
+
+    /**
+     * @brief 丢弃所有排队事件（消费者）
+     */
+    void clear() { tail_ = head_; }
+
+    bool empty() const { return head_ == tail_; }
+    size_t size() const { return head_ - tail_; }
+    static constexpr size_t capacity() { return N; }
+
+    uint32_t overflow_count() const { return overflows_; }     // 队列满丢弃的事件数
+    uint32_t coalesced_count() const { return coalesced_; }    // 被合并的事件数
+    uint32_t high_water() const { return high_water_; }        // 最大排队深度
+
+private:
+    Entry entries_[N];
+    volatile uint32_t head_;    // 生产者写入
+    volatile uint32_t tail_;    // 消费者读取
+    uint32_t coalesce_mask_;
+    uint32_t overflows_;
+    uint32_t coalesced_;
+    uint32_t high_water_;
+};
+
+} // namespace input
+} // namespace hardware
+
+#endif // INPUT_EVENT_QUEUE_HPP
@@ -0,0 +1,128 @@
+/**
+ * @file input_latency.hpp
+ * @brief 输入到显示延迟追踪 - 从按键边沿/摇杆采样到屏幕最后一个SPI字节发出的时间直方图
+ * @version 1.0.0
+ *
+ * 起点：ButtonSystemAdapter 把 UnifiedInputEvent 交给应用时，带上事件的采样时间戳
+ * （按键为边沿中断时间，摇杆为方向首次被采样到的时间）。
+ * 终点：显示驱动 display() 返回前（spi_write_blocking 等待移位完成，即最后一个字节已发出）。
+ * 同一次刷新前的多个输入只计最早的一个；超时未刷新的输入被丢弃并计数。
+ *
+ * 串口命令（poll_serial 在主循环或串口事件源中调用）：
+ *   'L' 打印 p50/p95/p99  'R' 清空统计  'T' 开关追踪
+ */
+
+#ifndef INPUT_LATENCY_HPP
+#define INPUT_LATENCY_HPP
+
+#include "pico/stdlib.h"
+#include "config/button_config.hpp"
+#include <stdint.h>
+
+namespace hardware {
+namespace input {
+
+/**
+ * @brief 对数-线性直方图（每个2的幂区间8个桶，相对误差不超过12.5%）
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 3;
+    static constexpr int MAX_EXPONENT = 23;     // 超过 2^24 us (约16秒) 的样本计入最后一个桶
+    static constexpr int BUCKET_COUNT = (MAX_EXPONENT - 1) * (1 << SUB_BITS);
+
+    LatencyHistogram() { reset(); }
+
+    void reset();
+    void record(uint32_t value_us);
+
+    /**
+     * @brief 百分位数（桶上界）
+     * @param percent 1-100
+     * @return 延迟（微秒），无样本时为0
+     */
+    uint32_t percentile(uint32_t percent) const;
+
+    uint32_t count() const { return count_; }
+    uint32_t min() const { return count_ ? min_ : 0; }
+    uint32_t max() const { return max_; }
+    uint32_t mean() const { return count_ ? static_cast<uint32_t>(sum_ / count_) : 0; }
+
+    static int bucket_of(uint32_t value_us);
+    static uint32_t bucket_lower(int bucket);
+
+private:
+    uint32_t buckets_[BUCKET_COUNT];
+    uint32_t count_;
+    uint32_t min_;
+    uint32_t max_;
+    uint64_t sum_;
+};
+
+/**
+ * @brief 延迟追踪器（全局单例）
+ */
+class InputLatency {
+public:
+    static void set_enabled(bool enabled);
+    static bool is_enabled() { return enabled_; }
+
+    /**
+     * @brief 输入事件交给应用处理（在处理函数之前调用）
+     * @param capture_ms 事件采样时间 (to_ms_since_boot)
+     */
+    static void input_dispatched(uint32_t capture_ms) {
+#if INPUT_LATENCY_TRACE
+        if (enabled_) {
+            mark_input(capture_ms);
+        }
+#else
+        (void)capture_ms;
+#endif
+    }
+
+    /**
+     * @brief 一次屏幕更新的最后一个SPI字节已发出（由显示驱动调用）
+     */
+    static void frame_presented() {
+#if INPUT_LATENCY_TRACE
+        if (enabled_) {
+            mark_frame(time_us_32());
+        }
+#endif
+    }
+
+    static void reset();
+
+    static const LatencyHistogram& histogram() { return histogram_; }
+    static uint32_t expired() { return expired_; }      // 超时未刷新而丢弃的输入数
+    static uint32_t merged() { return merged_; }        // 并入同一次刷新的后续输入数
+
+    /**
+     * @brief 通过串口打印统计
+     */
+    static void print_report();
+
+    /**
+     * @brief 非阻塞读取USB串口命令，取完所有已到达的字符
+     * @details 可直接作为 stdio chars_available 事件源的处理函数（回调只在新数据到达时触发一次）
+     * @return true 至少处理了一个命令
+     */
+    static bool poll_serial();
+
+private:
+    static LatencyHistogram histogram_;
+    static bool enabled_;
+    static bool pending_;
+    static uint32_t pending_us_;
+    static uint32_t expired_;
+    static uint32_t merged_;
+
+    static void mark_input(uint32_t capture_ms);
+    static void mark_frame(uint32_t now_us);
+};
+
+} // namespace input
+} // namespace hardware
+
+#endif // INPUT_LATENCY_HPP
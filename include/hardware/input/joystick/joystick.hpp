@@ -57,6 +57,15 @@ struct JoystickDebounceConfig {
 
 typedef enum { ADC_8BIT_RESULT = 0, ADC_16BIT_RESULT } adc_mode_t;
 
+/**
+ * @brief One batched joystick poll
+ */
+struct JoystickSample {
+    int16_t offset_x;   // x-axis 12bits mapped value
+    int16_t offset_y;   // y-axis 12bits mapped value
+    uint8_t button;     // 0 press, 1 no press
+};
+
 /**
  * @brief Joystick control API
  */
@@ -241,6 +250,15 @@ public:
      */
     void get_joy_adc_8bits_value_xy(uint8_t *adc_x, uint8_t *adc_y);
 
+    /**
+     * @brief Read x/y 12bits mapped values and the button in one pass
+     * @details X and Y come from a single 4-byte burst of the offset register,
+     *          so a poll is two I2C transactions instead of three.
+     * @param sample output sample, left unchanged on failure
+     * @return true success, false I2C error
+     */
+    bool read_sample(JoystickSample *sample);
+
 private:
     i2c_inst_t *_i2c_port;
     uint8_t _addr;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "joystick.hpp"
+#include "joystick_direction_engine.hpp"
 #include "pico/stdlib.h"
 #include <functional>
 
@@ -60,6 +61,14 @@ public:
      */
     void setDirectionCallback(DirectionCallback callback);
     
+    /**
+     * @brief 取出一个方向事件（PRESS/REPEAT/RELEASE，带时间戳）
+     * @details 设置了方向回调时事件在update()中直接交给回调，此处不再有事件
+     * @param event 输出事件
+     * @return true 取到事件，false 无事件
+     */
+    bool pollEvent(::JoystickEvent& event);
+    
     /**
      * @brief 设置按钮事件回调函数
      * @param callback 回调函数
@@ -97,10 +106,16 @@ public:
     
     /**
      * @brief 设置稳定计数要求
-     * @param count 稳定计数（默认3）
+     * @param count 稳定计数（默认3，按10ms轮询换算为稳定窗口时间）
      */
     void setStableCount(uint8_t count);
     
+    /**
+     * @brief 设置方向引擎配置（滞回、稳定窗口、自动连发）
+     * @param config 引擎配置
+     */
+    void setEngineConfig(const JoystickEngineConfig& config);
+    
     /**
      * @brief 获取底层摇杆对象引用
      * @return 摇杆对象引用
@@ -110,14 +125,10 @@ public:
 private:
     Joystick& joystick_;
     
-    // 配置参数
-    uint16_t threshold_;
-    uint8_t stable_count_required_;
+    // 方向引擎（整数滞回判定 + 按时间的稳定窗口 + 自动连发）
+    JoystickDirectionEngine engine_;
     
     // 状态变量
-    int previous_direction_;
-    uint8_t stable_count_;
-    int last_reported_direction_;
     bool last_button_pressed_;
     
     // 回调函数
@@ -126,14 +137,15 @@ private:
     
     // LED控制相关
     bool led_enabled_;
+    uint32_t led_color_;        // 最后写入LED寄存器的颜色（LED_COLOR_UNKNOWN表示未知）
+    
+    static constexpr uint32_t LED_COLOR_UNKNOWN = 0xFFFFFFFF;
+    static constexpr uint32_t STABLE_COUNT_POLL_MS = 10;   // setStableCount 换算用的轮询周期
     
     /**
-     * @brief 判断摇杆方向
-     * @param offset_x X轴偏移值
-     * @param offset_y Y轴偏移值
-     * @return 方向枚举
+     * @brief 写LED寄存器，颜色未变化时跳过I2C写入
      */
-    JoystickDirection determineDirection(int16_t offset_x, int16_t offset_y);
+    void writeLEDColor(uint32_t color);
     
     /**
      * @brief 处理方向变化
@@ -141,6 +153,11 @@ private:
      */
     void handleDirectionChange(JoystickDirection new_direction);
     
+    /**
+     * @brief 把引擎事件交给方向回调（PRESS和REPEAT）
+     */
+    void dispatchEvent(const ::JoystickEvent& event);
+    
     /**
      * @brief 处理按钮事件
      * @param button_value 按钮值
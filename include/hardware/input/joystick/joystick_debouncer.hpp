@@ -3,6 +3,7 @@
 
 #include <pico/stdlib.h>
 #include "hardware/input/joystick/joystick.hpp"
+#include "hardware/input/joystick/joystick_direction_engine.hpp"
 
 // 注意：JoystickDebounceConfig, JoystickDirection, ButtonState 已在 joystick.hpp 中定义
 
@@ -54,22 +55,20 @@ public:
 
 private:
     JoystickDebounceConfig _config;
-    JoystickDirection _current_direction;
-    JoystickDirection _last_direction;
+    JoystickDirectionEngine _engine;    // shared direction logic (hysteresis + time-based stability)
     ButtonState _current_button_state;
     ButtonState _last_button_state;
-    uint8_t _direction_stable_count;
     uint32_t _last_button_time;
     bool _button_event_occurred;
     bool _direction_changed;
 
     /**
-     * @brief Determine direction from ADC values
-     * @param x_adc x-axis ADC value
-     * @param y_adc y-axis ADC value
-     * @return JoystickDirection
+     * @brief Convert the legacy debounce config to an engine config
+     * @details threshold enters a direction, deadzone is the hysteresis release level,
+     *          stable_count_required is converted to a window at a 10ms poll period.
+     *          Auto-repeat is disabled: this class only reports direction changes.
      */
-    JoystickDirection determine_direction(uint16_t x_adc, uint16_t y_adc);
+    static JoystickEngineConfig to_engine_config(const JoystickDebounceConfig& config);
 };
 
 #endif 
\ No newline at end of file
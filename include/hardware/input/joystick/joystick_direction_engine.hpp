@@ -0,0 +1,102 @@
+#ifndef _JOYSTICK_DIRECTION_ENGINE_H_
+#define _JOYSTICK_DIRECTION_ENGINE_H_
+
+#include "hardware/input/joystick/joystick.hpp"
+#include <stdint.h>
+
+/**
+ * @brief 方向引擎配置（偏移值以中心为0）
+ */
+struct JoystickEngineConfig {
+    int16_t press_threshold = 1800;         // 进入方向所需的主轴偏移
+    int16_t release_threshold = 1440;       // 保持方向所需的主轴偏移（滞回下限，默认为进入阈值的80%）
+    uint8_t axis_ratio_q4 = 24;             // 主轴需大于副轴 × ratio/16（24 = 1.5倍），否则视为斜向不确定
+    uint16_t stable_ms = 30;                // 稳定窗口：候选方向持续该时间后确认
+    bool predictive = true;                 // 同一候选方向连续两次向外增大时提前确认
+    uint16_t repeat_delay_ms = 400;         // 按住后首次连发延迟（0 = 不连发）
+    uint16_t repeat_interval_ms = 150;      // 初始连发间隔
+    uint16_t repeat_min_interval_ms = 40;   // 加速后的最小连发间隔
+    uint8_t repeat_accel_percent = 80;      // 每次连发后间隔乘以 percent/100
+};
+
+/**
+ * @brief 方向事件
+ */
+struct JoystickEvent {
+    enum Type : uint8_t {
+        PRESS,      // 进入方向
+        REPEAT,     // 按住方向的自动连发
+        RELEASE     // 离开方向（回中或换向）
+    };
+
+    Type type;
+    JoystickDirection direction;
+    uint32_t time_ms;       // 事件时间：PRESS/RELEASE 为该状态首次被采样到的时间，REPEAT 为计划时间
+    uint16_t repeat;        // 第几次连发（PRESS 为0）
+};
+
+/**
+ * @brief 摇杆方向引擎 - 纯整数运算，不访问硬件
+ *
+ * 统一 Joystick、JoystickDebouncer 和 JoystickController 的方向判定：
+ * - 滞回：进入方向需超过 press_threshold，保持方向只需不低于 release_threshold，阈值附近不再闪烁
+ * - 稳定窗口按时间而非轮询次数计算，延迟与轮询频率无关
+ * - 按住方向时自动连发，间隔逐次缩短到 repeat_min_interval_ms（快速滚动列表）
+ */
+class JoystickDirectionEngine {
+public:
+    static constexpr int QUEUE_SIZE = 8;
+
+    explicit JoystickDirectionEngine(const JoystickEngineConfig& config = JoystickEngineConfig());
+
+    void set_config(const JoystickEngineConfig& config) { _config = config; }
+    const JoystickEngineConfig& config() const { return _config; }
+
+    /**
+     * @brief 回到中心状态并清空事件
+     */
+    void reset(uint32_t now_ms);
+
+    /**
+     * @brief 输入一次采样
+     * @param offset_x X轴偏移（负为左）
+     * @param offset_y Y轴偏移（负为上）
+     * @param now_ms 采样时间
+     */
+    void update(int16_t offset_x, int16_t offset_y, uint32_t now_ms);
+
+    /**
+     * @brief 取出最早的事件
+     */
+    bool pop(JoystickEvent& event);
+
+    /**
+     * @brief 当前确认的方向
+     */
+    JoystickDirection direction() const { return _stable; }
+
+    /**
+     * @brief 单次采样的方向判定（含相对当前方向的滞回）
+     */
+    JoystickDirection classify(int16_t offset_x, int16_t offset_y) const;
+
+private:
+    JoystickEngineConfig _config;
+    JoystickDirection _stable;
+    JoystickDirection _candidate;
+    uint32_t _candidate_since;
+    int32_t _candidate_peak;        // 候选方向上的最大偏移
+    uint8_t _rises;                 // 候选方向上连续向外增大的采样次数
+    uint32_t _next_repeat;
+    uint32_t _repeat_interval;
+    uint16_t _repeat_count;
+
+    JoystickEvent _queue[QUEUE_SIZE];
+    uint8_t _head;
+    uint8_t _count;
+
+    void commit(JoystickDirection direction, uint32_t time_ms);
+    void emit(JoystickEvent::Type type, JoystickDirection direction, uint32_t time_ms, uint16_t repeat);
+};
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file listing_arena.hpp
+ * @brief 目录枚举用的线性(bump)分配器与定长目录项
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "ff.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace MicroSD {
+
+/**
+ * @brief 定长目录项 - 不含任何堆分配的 std::string
+ * 文件名缓冲区大小与FatFs的FILINFO::fname一致，长文件名不会被截断
+ */
+struct DirEntry {
+    char name[FF_LFN_BUF + 1];  // 文件名 (GBK编码)
+    FSIZE_t size;               // 文件大小 (字节)
+    uint8_t attributes;         // 文件属性 (AM_xxx)
+
+    bool is_directory() const { return (attributes & AM_DIR) != 0; }
+
+    void assign(const FILINFO& fno) {
+        strncpy(name, fno.fname, sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+        size = fno.fsize;
+        attributes = fno.fattrib;
+    }
+};
+
+/**
+ * @brief 一次目录枚举的结果视图
+ * entries 指向 ListingArena 内部连续存放的目录项，生命周期与arena的分配标记一致
+ */
+struct DirListing {
+    DirEntry* entries = nullptr;
+    size_t count = 0;
+    bool truncated = false;     // arena空间不足时为true，只返回了前count项
+
+    DirEntry* begin() const { return entries; }
+    DirEntry* end() const { return entries + count; }
+};
+
+/**
+ * @brief 线性(bump)分配器
+ * 在调用者提供的缓冲区上顺序分配，只能整体或按标记回退，不单独释放。
+ * 用于目录项、DIR/FIL等FatFs对象，避免枚举大目录时的堆碎片和不定长分配。
+ */
+class ListingArena {
+private:
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t used_;
+    size_t peak_;
+
+public:
+    ListingArena(void* buffer, size_t capacity)
+        : buffer_(static_cast<uint8_t*>(buffer)), capacity_(capacity), used_(0), peak_(0) {}
+
+    // 禁用拷贝 (多个arena共享同一缓冲区会互相覆盖)
+    ListingArena(const ListingArena&) = delete;
+    ListingArena& operator=(const ListingArena&) = delete;
+
+    /**
+     * @brief 分配原始内存
+     * @return 对齐后的内存指针，空间不足时返回nullptr
+     */
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer_);
+        uintptr_t cur = (base + used_ + (align - 1)) & ~(uintptr_t)(align - 1);
+        size_t offset = cur - base;
+        if (offset > capacity_ || size > capacity_ - offset) {
+            return nullptr;
+        }
+        used_ = offset + size;
+        if (used_ > peak_) {
+            peak_ = used_;
+        }
+        return buffer_ + offset;
+    }
+
+    /**
+     * @brief 分配并默认构造一个对象 (仅用于平凡析构的类型，回退时不调用析构函数)
+     */
+    template<typename T>
+    T* create() {
+        void* p = allocate(sizeof(T), alignof(T));
+        return p ? new (p) T() : nullptr;
+    }
+
+    // 分配标记，用于作用域式回退
+    size_t mark() const { return used_; }
+    void rewind(size_t mark) { if (mark <= used_) used_ = mark; }
+    void reset() { used_ = 0; }
+
+    size_t used() const { return used_; }
+    size_t capacity() const { return capacity_; }
+    size_t remaining() const { return capacity_ - used_; }
+    size_t peak() const { return peak_; }
+};
+
+/**
+ * @brief 自带存储的arena，可放在静态区或栈上
+ * @tparam N 缓冲区字节数
+ */
+template<size_t N>
+class StaticListingArena : public ListingArena {
+private:
+    alignas(std::max_align_t) uint8_t storage_[N];
+
+public:
+    StaticListingArena() : ListingArena(storage_, N) {}
+};
+
+} // namespace MicroSD
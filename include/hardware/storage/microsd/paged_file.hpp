@@ -0,0 +1,135 @@
+/**
+ * @file paged_file.hpp
+ * @brief 分页文件视图 - 以固定大小页缓存只读访问大文件 (类似内存映射)
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "hardware/storage/microsd/rw_sd.hpp"
+#include <string>
+
+// 页大小 (字节)，需为扇区大小的整数倍，读页时FatFs直接多块读入页缓冲区
+#ifndef PAGED_FILE_PAGE_SIZE
+#define PAGED_FILE_PAGE_SIZE (4 * 1024)
+#endif
+
+// 页缓存的页数 (占用 PAGED_FILE_PAGE_COUNT * PAGED_FILE_PAGE_SIZE 字节RAM)
+#ifndef PAGED_FILE_PAGE_COUNT
+#define PAGED_FILE_PAGE_COUNT 8
+#endif
+
+// 沿翻页方向预读的页数，需小于 PAGED_FILE_PAGE_COUNT - 1
+#ifndef PAGED_FILE_READAHEAD
+#define PAGED_FILE_READAHEAD 2
+#endif
+
+// 快速定位表大小 (DWORD)，文件碎片过多时退回普通定位
+#ifndef PAGED_FILE_CLMT_SIZE
+#define PAGED_FILE_CLMT_SIZE 64
+#endif
+
+namespace MicroSD {
+
+static_assert(PAGED_FILE_PAGE_SIZE % 512 == 0, "页大小需为扇区大小的整数倍");
+static_assert(PAGED_FILE_READAHEAD < PAGED_FILE_PAGE_COUNT - 1, "预读页数过多会挤掉当前页");
+
+/**
+ * @brief 页缓存统计
+ */
+struct PagedFileStats {
+    uint32_t hits = 0;              // 访问的页已在缓存中
+    uint32_t faults = 0;            // 缺页，访问时同步读卡
+    uint32_t readahead_loads = 0;   // poll() 预读的页数
+    uint32_t readahead_hits = 0;    // 预读的页被首次访问 (翻页无需等待)
+    uint32_t evictions = 0;         // LRU淘汰次数
+};
+
+/**
+ * @brief 分页文件视图
+ * 文件按页号缓存在 PAGED_FILE_PAGE_COUNT 个页缓冲区中，LRU淘汰。
+ * 访问时根据页号变化判断翻页方向，主循环空闲时调用 poll() 沿该方向预读，
+ * 预读跟得上时向后/向前翻页都不再等待SD卡。
+ * 对象内含全部页缓冲区 (默认32KB)，应静态分配。文件以只读方式打开，打开期间不应被修改。
+ */
+class PagedFileView {
+public:
+    /**
+     * @brief 文件内容窗口，指向页缓冲区
+     * 指针在下一次 window()/read()/poll()/close() 调用前有效
+     */
+    struct Window {
+        const char* data = nullptr;
+        size_t offset = 0;      // 窗口起始的文件偏移
+        size_t length = 0;      // 有效字节数，不跨越页边界
+    };
+
+private:
+    struct Page {
+        uint32_t index;         // 页号
+        uint32_t length;        // 有效字节数 (文件末页可能不满)
+        uint32_t last_used;     // LRU时间戳
+        bool valid;
+        bool prefetched;        // 预读后尚未被访问
+    };
+
+    RWSD* sd_;
+    RWSD::FileHandle file_;
+    DWORD clmt_[PAGED_FILE_CLMT_SIZE];
+    size_t size_;
+    Page pages_[PAGED_FILE_PAGE_COUNT];
+    alignas(4) uint8_t data_[PAGED_FILE_PAGE_COUNT][PAGED_FILE_PAGE_SIZE];
+    uint32_t tick_;
+    uint32_t current_page_;     // 最近访问的页 (预读不会淘汰)
+    int direction_;             // 翻页方向: 1 向后, -1 向前
+    PagedFileStats stats_;
+
+    uint32_t page_count() const {
+        return static_cast<uint32_t>((size_ + PAGED_FILE_PAGE_SIZE - 1) / PAGED_FILE_PAGE_SIZE);
+    }
+    int find_page(uint32_t index) const;
+    int choose_slot() const;
+    Result<int> load_page(uint32_t index);
+    Result<int> access_page(uint32_t index);
+
+public:
+    explicit PagedFileView(RWSD& sd);
+    ~PagedFileView();
+
+    PagedFileView(const PagedFileView&) = delete;
+    PagedFileView& operator=(const PagedFileView&) = delete;
+
+    /**
+     * @brief 打开文件 (只读，尽量启用快速定位)，清空页缓存
+     */
+    Result<void> open(const std::string& path);
+    void close();
+
+    bool is_open() const { return file_.is_open(); }
+    size_t size() const { return size_; }
+
+    /**
+     * @brief 获取从offset开始的连续内容
+     * 窗口在页边界截断，跨页内容需以 offset + length 再次调用
+     * @param max_length 最多返回的字节数
+     * @return offset超出文件末尾时返回长度为0的窗口
+     */
+    Result<Window> window(size_t offset, size_t max_length = PAGED_FILE_PAGE_SIZE);
+
+    /**
+     * @brief 复制 [offset, offset + buffer.size()) 的内容，可跨页
+     * @return 实际复制的字节数 (到文件末尾为止)
+     */
+    Result<size_t> read(size_t offset, Span<uint8_t> buffer);
+
+    /**
+     * @brief 后台预读：在主循环空闲时调用，每次最多读入一页
+     * @return true 仍有待预读的页
+     */
+    bool poll();
+
+    const PagedFileStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = PagedFileStats(); }
+};
+
+} // namespace MicroSD
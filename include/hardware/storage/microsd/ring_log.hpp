@@ -0,0 +1,83 @@
+/**
+ * @file ring_log.hpp
+ * @brief 掉电安全的环形日志文件 (格式见 ring_log_format.hpp)
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "hardware/storage/microsd/rw_sd.hpp"
+#include "hardware/storage/microsd/ring_log_format.hpp"
+#include <functional>
+#include <string>
+
+namespace MicroSD {
+namespace ring_log {
+
+/**
+ * @brief 环形日志
+ * 文件只在创建时预分配一次，之后所有写入都是槽位内的原位覆盖：
+ * 每次 flush() 恰好写一个数据扇区，不修改FAT和目录项，卡写满后自动覆盖最旧的槽位。
+ */
+class RingLog {
+private:
+    RWSD* sd_;
+    RWSD::FileHandle file_;
+    RingInfo info_;
+    RingHead recovery_;
+    uint8_t block_[SLOT_SIZE];
+    uint8_t pending_[SLOT_PAYLOAD_SIZE];    // 尚未提交的记录
+    uint16_t pending_count_;
+    uint32_t next_seq_;
+    uint32_t flushes_;
+
+    Result<void> create(const std::string& path);
+    Result<void> recover();
+    bool read_slot(uint32_t slot, SlotView& view);
+
+public:
+    explicit RingLog(RWSD& sd);
+    ~RingLog();
+
+    RingLog(const RingLog&) = delete;
+    RingLog& operator=(const RingLog&) = delete;
+
+    /**
+     * @brief 打开环形日志；文件不存在或参数不符时重新创建
+     * 打开已有文件时用二分查找恢复写入位置，读取 O(log slot_count) 个扇区
+     * @param slot_count 槽位数 (文件大小 = (slot_count + 1) * 512)
+     * @param record_size 每条记录的字节数 (1..492)
+     */
+    Result<void> open(const std::string& path, uint32_t slot_count, uint16_t record_size);
+
+    /**
+     * @brief 追加一条记录 (record_size字节)，当前槽位写满时自动提交
+     */
+    Result<void> append(const void* record);
+
+    /**
+     * @brief 提交未写入的记录：写入下一个槽位并同步，恰好一次扇区写入
+     */
+    Result<void> flush();
+
+    /**
+     * @brief 提交并关闭 (不更新目录项)
+     */
+    void close();
+
+    /**
+     * @brief 从最旧到最新遍历已提交的记录
+     * @param visitor 参数为记录指针和所在槽位序号，返回false提前结束
+     * @return 访问的记录数
+     */
+    Result<size_t> read_all(const std::function<bool(const uint8_t* record, uint32_t seq)>& visitor);
+
+    bool is_open() const { return file_.is_open(); }
+    const RingInfo& info() const { return info_; }
+    const RingHead& recovery() const { return recovery_; }     // 最近一次打开时的恢复结果
+    uint32_t next_seq() const { return next_seq_; }
+    uint32_t flush_count() const { return flushes_; }
+};
+
+} // namespace ring_log
+} // namespace MicroSD
@@ -0,0 +1,100 @@
+/**
+ * @file ring_log_format.hpp
+ * @brief 环形日志文件格式 - 槽位编解码与启动时头部定位 (不依赖FatFs/Pico SDK，可在主机上编译)
+ * @version 1.0.0
+ *
+ * 文件大小在创建时固定: 块0为文件头，块1..N为N个512字节槽位。
+ * 序号为seq的扇区总是写入槽位 seq % N，每次flush写一个新槽位，从不原位改写已提交的槽位，
+ * 因此掉电时最多丢失正在写入的那个扇区中尚未提交的记录。
+ *
+ * 槽位 (小端):
+ *   0  u32 魔数 'RLSL'   4  u32 文件ID   8  u32 序号
+ *   12 u16 记录数        14 u16 记录大小
+ *   16 记录[]            508 u32 CRC32 (覆盖0..507)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace MicroSD {
+namespace ring_log {
+
+constexpr size_t SLOT_SIZE = 512;
+constexpr size_t SLOT_HEADER_SIZE = 16;
+constexpr size_t SLOT_CRC_OFFSET = SLOT_SIZE - 4;
+constexpr size_t SLOT_PAYLOAD_SIZE = SLOT_CRC_OFFSET - SLOT_HEADER_SIZE;   // 492
+constexpr uint16_t FORMAT_VERSION = 1;
+
+constexpr uint32_t HEADER_MAGIC = 0x52444852;  // "RHDR"
+constexpr uint32_t SLOT_MAGIC = 0x4C534C52;    // "RLSL"
+
+/**
+ * @brief 环形日志参数 (写入文件头)
+ */
+struct RingInfo {
+    uint32_t slot_count = 0;
+    uint16_t record_size = 0;
+    uint32_t file_id = 0;
+
+    bool is_valid() const {
+        return slot_count >= 2 && record_size > 0 && record_size <= SLOT_PAYLOAD_SIZE;
+    }
+    size_t records_per_slot() const { return record_size ? SLOT_PAYLOAD_SIZE / record_size : 0; }
+};
+
+/**
+ * @brief 已解码的槽位
+ */
+struct SlotView {
+    uint32_t seq = 0;
+    uint16_t count = 0;
+    const uint8_t* records = nullptr;   // 指向槽位缓冲区内的第一条记录
+};
+
+/**
+ * @brief 启动恢复结果
+ */
+struct RingHead {
+    bool empty = true;          // 没有任何有效槽位
+    uint32_t head_slot = 0;     // 最新槽位
+    uint32_t head_seq = 0;      // 最新槽位的序号
+    uint32_t oldest_slot = 0;   // 最旧的有效槽位
+    uint32_t valid_slots = 0;   // 有效槽位数
+    uint32_t probes = 0;        // 读取的槽位数 (恢复代价)
+};
+
+void encode_header(const RingInfo& info, uint8_t* block);
+bool decode_header(const uint8_t* block, RingInfo& info);
+
+/**
+ * @brief 编码槽位
+ * @param records count*record_size 字节的记录
+ */
+void encode_slot(const RingInfo& info, uint32_t seq, const uint8_t* records, uint16_t count,
+                 uint8_t* block);
+
+/**
+ * @brief 校验并解码槽位
+ * @return 魔数/文件ID/CRC不匹配，或序号与槽位位置不符时返回false
+ */
+bool decode_slot(const RingInfo& info, uint32_t slot, const uint8_t* block, SlotView& view);
+
+/**
+ * @brief 读取一个槽位的序号
+ * @return 槽位无效 (未写过、属于旧文件或写入时掉电) 时返回false
+ */
+using SlotSeqReader = std::function<bool(uint32_t slot, uint32_t& seq)>;
+
+/**
+ * @brief 用二分查找定位最新槽位，读取次数为 O(log N)
+ *
+ * 有效槽位满足 seq - slot 为常数的最长前缀即为本圈已写部分，其末尾即为头部。
+ * 只有最后一次写入可能损坏：若槽位0损坏 (回绕时掉电)，以槽位1为基准。
+ */
+RingHead locate_head(uint32_t slot_count, const SlotSeqReader& read_seq);
+
+} // namespace ring_log
+} // namespace MicroSD
@@ -7,13 +7,95 @@
 #pragma once
 
 #include "hardware/storage/microsd/storage_device.hpp"
+#include "hardware/storage/microsd/listing_arena.hpp"
 #include "config/spi_config.hpp"
 #include "ff.h"
+#include <functional>
 #include <memory>
 #include <vector>
 
+// list_directory_tree 默认重载使用的静态arena大小 (字节)，只有用到该重载时才占用RAM
+#ifndef RWSD_TREE_ARENA_SIZE
+#define RWSD_TREE_ARENA_SIZE (16 * 1024)
+#endif
+
+// copy_file 默认中转缓冲区大小 (字节)，需为扇区大小的整数倍以便FatFs直接多块传输
+#ifndef RWSD_COPY_BUFFER_SIZE
+#define RWSD_COPY_BUFFER_SIZE (8 * 1024)
+#endif
+
+// read_file_chunk 打开句柄缓存的槽位数 (每个FIL约占 FF_MAX_SS + 40 字节)
+#ifndef RWSD_HANDLE_CACHE_SLOTS
+#define RWSD_HANDLE_CACHE_SLOTS 4
+#endif
+
+// 句柄缓存默认同时保持打开的文件数 (可运行时调整，不超过槽位数)
+#ifndef RWSD_HANDLE_CACHE_DEFAULT_LIMIT
+#define RWSD_HANDLE_CACHE_DEFAULT_LIMIT 2
+#endif
+
+// 写句柄登记表的桶数：按路径散列，桶内有写句柄打开时该桶的路径不进入句柄缓存
+#ifndef RWSD_WRITER_BUCKETS
+#define RWSD_WRITER_BUCKETS 16
+#endif
+
+// 目录树遍历时的最大路径长度 (字节，含结尾'\0')
+#ifndef RWSD_TREE_PATH_MAX
+#define RWSD_TREE_PATH_MAX 512
+#endif
+
+// 延迟挂载：initialize() 只注册卷，首次访问或 poll_background() 时才读取引导扇区
+#ifndef RWSD_LAZY_MOUNT
+#define RWSD_LAZY_MOUNT 1
+#endif
+
+// 后台空闲簇统计每步读取的FAT扇区数
+#ifndef RWSD_FREE_SCAN_SECTORS
+#define RWSD_FREE_SCAN_SECTORS 8
+#endif
+
+// 统计期间FAT被修改导致重新开始的次数上限，超过后一次性调用 f_getfree
+#ifndef RWSD_FREE_SCAN_MAX_RESTARTS
+#define RWSD_FREE_SCAN_MAX_RESTARTS 3
+#endif
+
+// 自适应时钟：挂载后由 poll_background() 从 MICROSD_SPI_FREQ_FAST_HIGH 起逐级降频，直到校验扇区读回一致
+// (协商前以兼容时钟运行；initialize() 本身不访问文件系统)
+#ifndef RWSD_ADAPTIVE_CLOCK
+#define RWSD_ADAPTIVE_CLOCK 1
+#endif
+
+// 按卡CID保存已验证时钟的文件，下次启动直接从该时钟开始验证
+#ifndef RWSD_CLOCK_PROFILE_PATH
+#define RWSD_CLOCK_PROFILE_PATH "/.sdclock"
+#endif
+
 namespace MicroSD {
 
+/**
+ * @brief 只读句柄缓存统计
+ */
+struct HandleCacheStats {
+    uint32_t hits = 0;           // 命中已打开的句柄
+    uint32_t misses = 0;         // 需要重新 f_open
+    uint32_t evictions = 0;      // LRU淘汰次数
+    uint32_t invalidations = 0;  // 因写入/重命名/删除而关闭的句柄数
+    uint32_t bypasses = 0;       // 路径上有写句柄打开，绕过缓存直接打开
+};
+
+/**
+ * @brief 启动耗时分解 (微秒)
+ */
+struct StartupTiming {
+    uint32_t spi_init_us = 0;       // SPI/GPIO初始化
+    uint32_t card_init_us = 0;      // disk_initialize (CMD0/ACMD41等)
+    uint32_t mount_us = 0;          // f_mount (延迟挂载时为实际挂载耗时)
+    uint32_t clock_us = 0;          // 时钟协商 (含读取时钟配置文件，在 poll_background() 中完成，不计入启动)
+    uint32_t total_us = 0;          // initialize() 总耗时
+    uint32_t free_scan_us = 0;      // 后台空闲簇统计累计耗时 (不计入启动)
+    uint32_t free_scan_steps = 0;   // 后台统计步数
+};
+
 /**
  * @brief 可读写SD卡类 - 生产级实现
  * 支持完整的读写操作，针对Pico内存有限的情况进行优化
@@ -22,21 +104,79 @@ class RWSD : public StorageDevice {
 private:
     MicroSD::SPIConfig config_;
     FATFS fs_;
-    uint8_t fs_type_;
     bool is_initialized_;
     
-    // RAII资源管理
-    std::unique_ptr<DIR> current_dir_;
+    // 后台空闲簇统计状态 (结果写入 fs_.free_clst，之后由FatFs在分配/释放簇时增量维护)
+    struct FreeSpaceScan {
+        DWORD next_cluster;     // 下一个待检查的簇号
+        DWORD free_count;       // 已统计的空闲簇数
+        uint32_t generation;    // 开始统计时的FAT修改计数
+        uint8_t restarts;
+        bool active;
+    };
+    mutable FreeSpaceScan free_scan_;
+    mutable StartupTiming timing_;
+    static uint32_t fat_generation_;    // FAT可能被修改时递增
+    
+    // 时钟配置文件记录的卡CID和时钟 (0表示尚未保存)
+    uint8_t card_cid_[16];
+    uint32_t profile_clock_;
+    bool clock_negotiated_;             // 后台时钟协商已完成
+    
     std::string current_path_;
     
+    // read_file_chunk 的只读句柄LRU缓存 (路径 -> 已打开的FIL及其当前位置)
+    struct CachedHandle {
+        FIL file;
+        std::string path;       // 规范化并折叠大小写后的路径
+        uint32_t last_used;     // LRU时间戳
+        uint32_t generation;    // 打开时所在写句柄桶的代数
+        bool is_open;
+    };
+    mutable CachedHandle handle_cache_[RWSD_HANDLE_CACHE_SLOTS];
+    mutable uint32_t handle_cache_tick_;
+    mutable HandleCacheStats handle_cache_stats_;
+    size_t handle_cache_limit_;
+    
+    // 写句柄登记：FileHandle 以写模式打开/关闭时更新所在桶 (FileHandle 不持有 RWSD，故为静态)
+    struct WriterBucket {
+        uint32_t generation;    // 写句柄打开或关闭时递增，缓存句柄的代数不一致即失效
+        uint16_t writers;       // 当前打开的写句柄数
+    };
+    static WriterBucket writer_buckets_[RWSD_WRITER_BUCKETS];
+    static size_t writer_bucket(const std::string& key);
+    
     // 私有方法
     void initialize_spi();
     void deinitialize_spi();
     Result<void> mount_filesystem();
     void unmount_filesystem();
+    Result<void> ensure_mounted() const;
+    bool free_space_scan_step() const;
+    static void note_fat_change() { fat_generation_++; }
+    void negotiate_clock();
+    uint32_t load_clock_profile();
+    void save_clock_profile(uint32_t clock_hz);
     ErrorCode fresult_to_error_code(FRESULT fr) const;
     
+    FIL* acquire_cached_handle(const std::string& path, FRESULT& fr) const;
+    void release_cached_handle(CachedHandle& slot) const;
+    void invalidate_cached_handle(const std::string& path) const;
+    void invalidate_all_cached_handles();
+    
+    struct TreeWalkContext;
+    Result<void> walk_level(TreeWalkContext& ctx, size_t path_len, int depth) const;
+    
 public:
+    /**
+     * @brief 目录树访问器
+     * @param entry 当前目录项
+     * @param depth 深度 (起始目录的直接子项为0)
+     * @param is_last 是否为同级最后一项
+     * @return false 提前结束遍历
+     */
+    using TreeVisitor = std::function<bool(const DirEntry& entry, int depth, bool is_last)>;
+
     /**
      * @brief 构造函数
      * @param config SPI配置，如果不提供则使用默认配置
@@ -73,9 +213,34 @@ public:
     
     /**
      * @brief 获取SD卡容量信息
+     * 空闲空间尚未统计完成时会同步完成统计 (大容量FAT32卡可能耗时数秒)，
+     * 可先用 is_free_space_known() 判断
      */
     Result<std::pair<size_t, size_t>> get_capacity() const override;
     
+    /**
+     * @brief 空闲空间是否已知 (FSINFO可信或后台统计已完成)
+     */
+    bool is_free_space_known() const;
+    
+    /**
+     * @brief 后台任务：在主循环空闲时调用
+     * 依次完成延迟挂载、时钟协商、扇区缓存定时写回和分步空闲簇统计，每次调用只做一小步
+     * @return true 仍有后台工作未完成
+     */
+    bool poll_background();
+    
+    /**
+     * @brief 获取当前SPI快速时钟 (Hz)
+     * 传输错误反复出现时会在运行中降频，错误计数见 pico_fatfs_get_link_stats()
+     */
+    uint32_t get_spi_clock() const;
+    
+    /**
+     * @brief 获取启动耗时分解
+     */
+    const StartupTiming& get_startup_timing() const { return timing_; }
+    
     // === 目录操作 ===
     
     /**
@@ -85,12 +250,45 @@ public:
     
     /**
      * @brief 递归列出目录树结构
+     * 使用 RWSD_TREE_ARENA_SIZE 大小的静态arena (不可重入，也不能在其他遍历的访问器中调用)
      * @param path 起始路径，默认为根目录
      * @param max_depth 最大递归深度，默认为10
      * @return 树形结构字符串
      */
     Result<std::string> list_directory_tree(const std::string& path = "", int max_depth = 10) const;
     
+    /**
+     * @brief 递归列出目录树结构，目录项和遍历状态放在调用者提供的arena中
+     * 每项一行：起始目录的直接子项无前缀，更深的项以两个空格开头，每层祖先加 "│   " 或 "    "，
+     * 再加 "├── " 或 "└── "；随后是 "📁 " 或 "📄 " 和名称，非空文件附加 " (n B)"、" (n KB)" 或 " (n MB)"。
+     * 有子目录因arena空间不足未展开时，最后追加一行 "[arena空间不足，目录树不完整]"。
+     * @param path 起始路径
+     * @param arena 临时arena，返回时恢复到调用前的分配标记
+     * @param max_depth 最大递归深度
+     * @return 树形结构字符串
+     */
+    Result<std::string> list_directory_tree(const std::string& path, ListingArena& arena, int max_depth = 10) const;
+    
+    /**
+     * @brief 列出目录内容到arena (不产生堆分配)
+     * @param path 目录路径
+     * @param arena 目录项存放的arena，结果在arena回退前有效
+     * @return 目录项视图，arena空间不足时truncated为true
+     */
+    Result<DirListing> list_directory_into(const std::string& path, ListingArena& arena) const;
+    
+    /**
+     * @brief 递归遍历目录树，逐项回调访问器 (不构建中间字符串)
+     * 每层目录项在arena中排序(目录优先、按名称)；某层放不下时该层退化为目录原始顺序流式输出
+     * @param path 起始路径
+     * @param arena 临时arena，遍历结束后恢复到调用前的分配标记
+     * @param visitor 访问器
+     * @param max_depth 最大递归深度
+     * @return true 完整遍历；false 有子目录因arena空间不足被跳过 (其余项照常访问)
+     */
+    Result<bool> walk_directory_tree(const std::string& path, ListingArena& arena,
+                                     const TreeVisitor& visitor, int max_depth = 10) const;
+    
     /**
      * @brief 创建目录
      */
@@ -124,6 +322,17 @@ public:
     Result<std::vector<uint8_t>> read_file_chunk(const std::string& path, 
                                                  size_t offset, size_t size) const override;
     
+    /**
+     * @brief 读取文件块到调用者缓冲区 (不分配内存)
+     * @param path 文件路径
+     * @param offset 文件内偏移
+     * @param buffer 目标缓冲区，最多读取buffer.size()字节
+     * @return 实际读取的字节数，到达文件尾时小于buffer.size()
+     * @note 路径有写句柄打开时不使用句柄缓存，读到的是该写句柄最近一次 flush() 后的内容
+     */
+    Result<size_t> read_file_chunk_into(const std::string& path, size_t offset,
+                                        Span<uint8_t> buffer) const;
+    
     /**
      * @brief 读取文本文件
      */
@@ -160,12 +369,26 @@ public:
     Result<void> rename(const std::string& old_path, const std::string& new_path);
     
     /**
-     * @brief 复制文件
+     * @brief 复制文件 (流式，使用 RWSD_COPY_BUFFER_SIZE 大小的临时中转缓冲区)
+     * @param preallocate 是否先用f_expand为目标文件分配连续簇
      */
-    Result<void> copy_file(const std::string& src_path, const std::string& dst_path);
+    Result<void> copy_file(const std::string& src_path, const std::string& dst_path,
+                           bool preallocate = true);
+    
+    /**
+     * @brief 复制文件 (流式，使用调用者提供的中转缓冲区)
+     * @param buffer 中转缓冲区，大小向下取整到扇区(FF_MAX_SS)整数倍，至少一个扇区
+     * @param preallocate 是否先用f_expand为目标文件分配连续簇，空间不连续时自动退回普通分配
+     * @return 源和目标为同一文件 (路径不区分大小写) 时返回INVALID_PARAMETER，不打开任何文件
+     */
+    Result<void> copy_file(const std::string& src_path, const std::string& dst_path,
+                           Span<uint8_t> buffer, bool preallocate = true);
     
     /**
      * @brief 同步文件系统
+     * 写回扇区缓存中的全部脏扇区并等待卡片编程完成。启用 PICO_FATFS_WRITE_CACHE 时
+     * f_close 不写回扇区缓存，未显式同步的数据由 poll_background() 在
+     * PICO_FATFS_CACHE_FLUSH_MS 后写回 (见 sector_cache.h 的持久化约定)。
      */
     Result<void> sync() override;
     
@@ -178,11 +401,13 @@ public:
     private:
         FIL file_;
         bool is_open_;
+        bool fast_seek_;
+        int writer_bucket_;     // 写模式打开时登记的桶，-1 表示未登记
         std::string path_;
         std::string mode_;
         
     public:
-        FileHandle() : is_open_(false) {}
+        FileHandle() : is_open_(false), fast_seek_(false), writer_bucket_(-1) {}
         ~FileHandle() { close(); }
         
         // 禁用拷贝
@@ -191,6 +416,7 @@ public:
         
         // 支持移动
         FileHandle(FileHandle&& other) noexcept;
+        FileHandle& operator=(FileHandle&& other) noexcept;
         
         bool is_open() const { return is_open_; }
         const std::string& get_path() const { return path_; }
@@ -198,13 +424,33 @@ public:
         
         // 文件操作
         Result<void> open(const std::string& path, const std::string& mode);
+        
+        /**
+         * @brief 打开文件并尝试启用快速定位，表不够大时退回普通定位模式
+         * @param clmt 簇链映射表缓冲区 (见 enable_fast_seek)
+         */
+        Result<void> open(const std::string& path, const std::string& mode, Span<DWORD> clmt);
         void close();
         
+        /**
+         * @brief 启用FatFs快速定位 (簇链映射表CLMT)
+         * 启用后 seek() 直接查表定位，不再沿FAT链逐簇查找。
+         * 仅适用于只读打开的文件：快速定位模式下文件不能被扩展。
+         * @param clmt 调用者提供的表缓冲区，生命周期需覆盖本句柄；
+         *             每个不连续片段占2个DWORD，另加2个DWORD头尾
+         * @return 实际使用的DWORD数；表太小时返回错误，error_message中给出所需大小，句柄保持普通模式
+         */
+        Result<size_t> enable_fast_seek(Span<DWORD> clmt);
+        void disable_fast_seek();
+        bool is_fast_seek() const { return fast_seek_; }
+        
         // 读取操作
         Result<std::vector<uint8_t>> read(size_t size);
+        Result<size_t> read_into(Span<uint8_t> buffer);
         Result<size_t> read_text(std::string& text, size_t max_size);
         
         // 写入操作
+        Result<size_t> write(Span<const uint8_t> data);
         Result<size_t> write(const std::vector<uint8_t>& data);
         Result<size_t> write(const std::string& text);
         Result<size_t> write_line(const std::string& line);
@@ -215,8 +461,26 @@ public:
         Result<size_t> size() const;
         
         // 文件控制
+        /**
+         * @brief f_sync 并写回扇区缓存 (持久化点)
+         */
         Result<void> flush();
+        
+        /**
+         * @brief 只写回数据扇区并同步卡，不更新目录项 (文件大小/修改时间)
+         * 用于预分配文件内的原位覆盖写：每次只产生数据扇区写入，FAT和目录在创建后不再改动。
+         * 若自上次 flush() 以来文件大小或簇链有变化，目录项更新保留，由 flush()/close() 写入。
+         */
+        Result<void> sync_data();
         Result<void> truncate(size_t size);
+        
+        /**
+         * @brief 为空文件预分配连续空间 (f_expand)
+         * 文件大小随即变为size，之后的写入只覆盖数据扇区，不再修改FAT链
+         * @param size 预分配字节数
+         * @return 连续空间不足时返回DISK_FULL，文件保持为空
+         */
+        Result<void> preallocate(size_t size);
     };
     
     /**
@@ -224,6 +488,24 @@ public:
      */
     Result<FileHandle> open_file(const std::string& path, const std::string& mode);
     
+    // === 句柄缓存 ===
+    
+    /**
+     * @brief 设置同时保持打开的只读句柄数 (0 表示关闭缓存)
+     * @param limit 上限，超过 RWSD_HANDLE_CACHE_SLOTS 时取槽位数
+     */
+    void set_handle_cache_limit(size_t limit);
+    
+    /**
+     * @brief 获取句柄缓存统计
+     */
+    const HandleCacheStats& get_handle_cache_stats() const { return handle_cache_stats_; }
+    
+    /**
+     * @brief 清零句柄缓存统计
+     */
+    void reset_handle_cache_stats() { handle_cache_stats_ = HandleCacheStats(); }
+    
     // === 高级功能 ===
     
     /**
@@ -0,0 +1,126 @@
+/**
+ * @file sensor_log.hpp
+ * @brief 追加式二进制传感器日志 - SD卡读写 (格式见 sensor_log_format.hpp)
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "hardware/storage/microsd/rw_sd.hpp"
+#include "hardware/storage/microsd/sensor_log_format.hpp"
+#include <functional>
+#include <string>
+
+// 新日志文件默认预分配的连续空间 (字节)，用完后按需扩展
+#ifndef SENSOR_LOG_PREALLOCATE_SIZE
+#define SENSOR_LOG_PREALLOCATE_SIZE (4 * 1024 * 1024)
+#endif
+
+namespace MicroSD {
+namespace sensor_log {
+
+/**
+ * @brief 日志写入器
+ * 整个记录期间保持同一个文件句柄打开，数据只以整块写入。
+ * 未封块的当前块保存在RAM中，flush() 时原位写入部分块，之后继续追加会覆盖同一块。
+ */
+class SensorLogWriter {
+private:
+    RWSD* sd_;
+    RWSD::FileHandle file_;
+    Schema schema_;
+    DataBlockEncoder encoder_;
+    IndexBuilder index_;
+    uint8_t scratch_[BLOCK_SIZE];   // 文件头/索引块编码缓冲区
+    uint32_t block_;                // 当前数据块号
+    uint64_t last_time_ms_;
+    uint32_t samples_;
+    uint32_t blocks_written_;
+    bool has_samples_;
+
+    Result<void> write_block(uint32_t block_number, const uint8_t* data);
+    Result<void> seal_current_block();
+
+public:
+    explicit SensorLogWriter(RWSD& sd);
+    ~SensorLogWriter();
+
+    SensorLogWriter(const SensorLogWriter&) = delete;
+    SensorLogWriter& operator=(const SensorLogWriter&) = delete;
+
+    /**
+     * @brief 创建新日志文件并写入文件头
+     * @param schema 通道定义；file_id/created_ms 为0时自动生成
+     * @param preallocate 预分配字节数 (f_expand)，0表示不预分配
+     */
+    Result<void> open(const std::string& path, const Schema& schema,
+                      size_t preallocate = SENSOR_LOG_PREALLOCATE_SIZE);
+
+    /**
+     * @brief 追加一个样本 (时间戳必须不减)
+     * 只有块写满时才访问SD卡
+     */
+    Result<void> append(const Sample& sample);
+
+    /**
+     * @brief 将当前部分块写入并同步到卡
+     */
+    Result<void> flush();
+
+    /**
+     * @brief 刷新、截掉未使用的预分配空间并关闭
+     */
+    Result<void> close();
+
+    bool is_open() const { return file_.is_open(); }
+    const Schema& schema() const { return schema_; }
+    uint32_t sample_count() const { return samples_; }
+    uint32_t blocks_written() const { return blocks_written_; }
+};
+
+/**
+ * @brief 日志读取器
+ * 时间范围查询先在索引块上二分定位起始数据块，再顺序解码，不扫描整个文件。
+ */
+class SensorLogReader {
+private:
+    RWSD* sd_;
+    RWSD::FileHandle file_;
+    Schema schema_;
+    uint8_t block_buf_[BLOCK_SIZE];
+    IndexEntry entries_[MAX_INDEX_INTERVAL];
+    uint32_t end_block_;            // 第一个无效块号
+    uint32_t blocks_read_;
+
+    bool read_block(uint32_t block_number);
+    bool is_valid_block(uint32_t block_number);
+    uint32_t find_end_block(uint32_t file_blocks);
+    uint32_t find_start_block(uint64_t from_ms);
+
+public:
+    explicit SensorLogReader(RWSD& sd);
+
+    SensorLogReader(const SensorLogReader&) = delete;
+    SensorLogReader& operator=(const SensorLogReader&) = delete;
+
+    /**
+     * @brief 打开日志文件，校验文件头并定位有效数据末尾
+     */
+    Result<void> open(const std::string& path);
+    void close();
+
+    /**
+     * @brief 按时间范围读取样本
+     * @param visitor 每个样本调用一次，返回false提前结束
+     * @return 访问的样本数
+     */
+    Result<size_t> query(uint64_t from_ms, uint64_t to_ms,
+                         const std::function<bool(const Sample&)>& visitor);
+
+    const Schema& schema() const { return schema_; }
+    uint32_t end_block() const { return end_block_; }
+    uint32_t blocks_read() const { return blocks_read_; }   // 用于观察查询代价
+};
+
+} // namespace sensor_log
+} // namespace MicroSD
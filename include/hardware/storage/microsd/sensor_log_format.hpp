@@ -0,0 +1,216 @@
+/**
+ * @file sensor_log_format.hpp
+ * @brief 追加式二进制传感器日志格式 - 编解码 (不依赖FatFs/Pico SDK，可在主机上编译)
+ * @version 1.0.0
+ *
+ * 文件由512字节块组成，块号即文件内偏移/512:
+ *   块0          文件头: 魔数、版本、通道schema、文件ID、CRC
+ *   块1..        数据块与索引块交替: 每 index_interval 个数据块后跟一个索引块
+ *
+ * 数据块 (小端):
+ *   0  u32 魔数 'SLDB'     4  u32 文件ID      8  u32 块号
+ *   12 u64 首样本时间(ms)  20 u16 样本数      22 u16 保留
+ *   24 i32 首样本值[通道数]
+ *   ..  定长记录: u16 时间增量(ms) + i16 值增量[通道数] (相对上一样本)
+ *   508 u32 CRC32 (覆盖0..507)
+ * 索引块:
+ *   0  u32 魔数 'SLIX'     4  u32 文件ID      8  u32 块号
+ *   12 u16 条目数          14 u16 保留
+ *   16 条目[]: u32 数据块号 + u64 该块首样本时间
+ *   508 u32 CRC32
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MicroSD {
+namespace sensor_log {
+
+constexpr size_t BLOCK_SIZE = 512;
+constexpr uint16_t FORMAT_VERSION = 1;
+constexpr size_t MAX_CHANNELS = 8;
+constexpr size_t CHANNEL_NAME_LEN = 12;     // 含结尾'\0'
+
+constexpr uint32_t HEADER_MAGIC = 0x474F4C53;  // "SLOG"
+constexpr uint32_t DATA_MAGIC = 0x42444C53;    // "SLDB"
+constexpr uint32_t INDEX_MAGIC = 0x58494C53;   // "SLIX"
+
+constexpr size_t DATA_HEADER_SIZE = 24;
+constexpr size_t INDEX_HEADER_SIZE = 16;
+constexpr size_t INDEX_ENTRY_SIZE = 12;
+constexpr size_t CRC_OFFSET = BLOCK_SIZE - 4;
+constexpr size_t MAX_INDEX_INTERVAL = (CRC_OFFSET - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;  // 41
+constexpr uint8_t DEFAULT_INDEX_INTERVAL = 32;
+
+/**
+ * @brief 通道描述：物理值 = 记录值 / scale
+ */
+struct ChannelInfo {
+    char name[CHANNEL_NAME_LEN];    // 通道名，如 "temp"
+    int32_t scale;                  // 定点比例，如100表示0.01精度
+};
+
+/**
+ * @brief 文件schema (写入文件头)
+ */
+struct Schema {
+    uint8_t channel_count = 0;
+    uint8_t index_interval = DEFAULT_INDEX_INTERVAL;    // 每多少个数据块写一个索引块
+    uint32_t sample_period_ms = 0;                      // 标称采样周期，仅供参考
+    uint32_t file_id = 0;                               // 区分预分配空间里的旧数据
+    uint64_t created_ms = 0;
+    ChannelInfo channels[MAX_CHANNELS] = {};
+
+    /**
+     * @brief 添加一个通道
+     * @return 通道已满时返回false
+     */
+    bool add_channel(const char* name, int32_t scale);
+
+    bool is_valid() const;
+
+    // 每个数据块能容纳的样本数 (含块头中的首样本)
+    size_t samples_per_block() const;
+};
+
+/**
+ * @brief 一个样本：时间戳 + 各通道定点值
+ */
+struct Sample {
+    uint64_t time_ms = 0;
+    int32_t values[MAX_CHANNELS] = {};
+};
+
+/**
+ * @brief 一个索引条目
+ */
+struct IndexEntry {
+    uint32_t block;
+    uint64_t first_time_ms;
+};
+
+/**
+ * @brief 计算CRC32 (IEEE 802.3，反射多项式0xEDB88320)
+ * @param crc 上一段的结果，用于分段计算
+ */
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+// 块布局: 块号是否为索引块 (块0为文件头)
+inline bool is_index_block(uint32_t block, uint8_t index_interval) {
+    return block > 0 && (block - 1) % (index_interval + 1u) == index_interval;
+}
+
+// 第group个索引块的块号
+inline uint32_t index_block_number(uint32_t group, uint8_t index_interval) {
+    return 1 + group * (index_interval + 1u) + index_interval;
+}
+
+/**
+ * @brief 编码/解码文件头块
+ */
+void encode_header(const Schema& schema, uint8_t* block);
+bool decode_header(const uint8_t* block, Schema& schema);
+
+/**
+ * @brief 检查块的魔数、文件ID、块号和CRC
+ */
+bool verify_block(const uint8_t* block, uint32_t magic, uint32_t file_id, uint32_t block_number);
+
+/**
+ * @brief 数据块编码器
+ * 在内部512字节缓冲区上追加定长增量记录，块满或增量超出16位时拒绝追加，
+ * 调用者封块后重新开始。封块前可多次 seal() 得到当前部分块的镜像。
+ */
+class DataBlockEncoder {
+private:
+    uint8_t block_[BLOCK_SIZE];
+    const Schema* schema_;
+    Sample last_;
+    uint16_t count_;
+    size_t capacity_;
+
+public:
+    DataBlockEncoder() : schema_(nullptr), count_(0), capacity_(0) {}
+
+    /**
+     * @brief 开始一个新数据块
+     */
+    void begin(const Schema& schema, uint32_t block_number);
+
+    /**
+     * @brief 追加样本
+     * @return 块已满、时间倒退、时间增量超过65535ms或值增量超出int16时返回false
+     */
+    bool append(const Sample& sample);
+
+    /**
+     * @brief 写入样本数和CRC，返回完整块镜像 (BLOCK_SIZE字节)
+     */
+    const uint8_t* seal();
+
+    uint16_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ >= capacity_; }
+    uint64_t first_time() const;
+};
+
+/**
+ * @brief 数据块解码器 - 逐个还原样本，不分配内存
+ */
+class DataBlockDecoder {
+private:
+    const uint8_t* block_;
+    const Schema* schema_;
+    Sample current_;
+    uint16_t count_;
+    uint16_t index_;
+
+public:
+    DataBlockDecoder() : block_(nullptr), schema_(nullptr), count_(0), index_(0) {}
+
+    /**
+     * @brief 绑定一个数据块 (调用者保证缓冲区在解码期间有效)
+     * @return 校验失败时返回false
+     */
+    bool open(const uint8_t* block, const Schema& schema, uint32_t block_number);
+
+    /**
+     * @brief 取下一个样本
+     * @return 块内样本已取完时返回false
+     */
+    bool next(Sample& sample);
+
+    uint16_t count() const { return count_; }
+    uint64_t first_time() const;
+};
+
+/**
+ * @brief 索引块构建器 - 记录每个数据块的首样本时间
+ */
+class IndexBuilder {
+private:
+    IndexEntry entries_[MAX_INDEX_INTERVAL];
+    size_t count_;
+
+public:
+    IndexBuilder() : count_(0) {}
+
+    void add(uint32_t block, uint64_t first_time_ms);
+    void reset() { count_ = 0; }
+    size_t count() const { return count_; }
+
+    void encode(const Schema& schema, uint32_t block_number, uint8_t* block) const;
+};
+
+/**
+ * @brief 解码索引块
+ * @param entries 至少 MAX_INDEX_INTERVAL 个元素
+ * @return 条目数，校验失败时返回0
+ */
+size_t decode_index(const uint8_t* block, const Schema& schema, uint32_t block_number,
+                    IndexEntry* entries);
+
+} // namespace sensor_log
+} // namespace MicroSD
@@ -6,10 +6,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace MicroSD {
 
@@ -38,13 +43,48 @@ struct FileInfo {
     size_t size;               // 文件大小 (字节)
     bool is_directory;         // 是否为目录
     uint8_t attributes;        // 文件属性
+    uint32_t modified = 0;     // 修改时间 (FAT日期 << 16 | FAT时间)
     
     // C++17结构化绑定支持
     auto tie() const { return std::tie(name, full_path, size, is_directory, attributes); }
 };
 
+/**
+ * @brief 连续内存视图 (C++17下std::span的最小替代)
+ * 不持有内存，只记录指针和元素个数，用于读写调用者提供的缓冲区
+ */
+template<typename T>
+class Span {
+private:
+    T* data_;
+    size_t size_;
+
+public:
+    constexpr Span() : data_(nullptr), size_(0) {}
+    constexpr Span(T* data, size_t size) : data_(data), size_(size) {}
+    template<size_t N>
+    constexpr Span(T (&array)[N]) : data_(array), size_(N) {}
+    template<size_t N>
+    constexpr Span(std::array<std::remove_const_t<T>, N>& array) : data_(array.data()), size_(N) {}
+    Span(std::vector<std::remove_const_t<T>>& vec) : data_(vec.data()), size_(vec.size()) {}
+
+    constexpr T* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr T& operator[](size_t i) const { return data_[i]; }
+    constexpr T* begin() const { return data_; }
+    constexpr T* end() const { return data_ + size_; }
+
+    constexpr Span subspan(size_t offset, size_t count = SIZE_MAX) const {
+        if (offset > size_) offset = size_;
+        if (count > size_ - offset) count = size_ - offset;
+        return Span(data_ + offset, count);
+    }
+};
+
 /**
  * @brief 结果模板类 - 现代C++错误处理方式
+ * 成功值按移动语义构造和取出，大对象(如std::vector)在传递过程中不产生额外拷贝
  */
 template<typename T>
 class Result {
@@ -63,10 +103,16 @@ public:
     bool is_error() const { return !is_ok(); }
     ErrorCode error_code() const { return error_code_; }
     const std::string& error_message() const { return error_message_; }
-    const T& operator*() const { return value_.value(); }
-    T& operator*() { return value_.value(); }
+    const T& operator*() const & { return value_.value(); }
+    T& operator*() & { return value_.value(); }
+    T&& operator*() && { return std::move(value_.value()); }
     const T* operator->() const { return &value_.value(); }
     T* operator->() { return &value_.value(); }
+
+    /**
+     * @brief 移出成功值 (调用后Result中的值处于已移动状态)
+     */
+    T take() { return std::move(value_.value()); }
 };
 
 // void类型的完全特化
@@ -0,0 +1,109 @@
+/**
+ * @file text_page_index.hpp
+ * @brief 文本文件分页索引 - 后台扫描一次，页起始偏移保存在文本文件旁
+ * @version 1.0.0
+ *
+ * 索引文件 (<文本路径>.pidx，小端):
+ *   0  u32 魔数 'PIDX'     4  u16 版本        6  u16 保留
+ *   8  u32 文本文件大小    12 u32 文本修改时间 16 u32 排版指纹
+ *   20 u32 已保存页数      24 u32 标志 (bit0: 扫描完成)
+ *   28 u32 CRC32 (覆盖0..27)
+ *   32 u32 页起始偏移[页数] (第0页为0)
+ * 文本大小/修改时间或排版指纹不符时索引作废并重新扫描。
+ * 扫描中途关机后，从最后保存的页起始处继续。
+ * 写入索引失败时停止扫描并删除索引文件，下次打开时重新扫描。
+ */
+
+#pragma once
+
+#include "hardware/storage/microsd/rw_sd.hpp"
+#include "fonts/text_layout.hpp"
+#include <string>
+
+// 后台扫描每次 poll() 读取的字节数
+#ifndef TEXT_INDEX_SCAN_CHUNK
+#define TEXT_INDEX_SCAN_CHUNK 1024
+#endif
+
+// 每积累多少页写入一次索引文件
+#ifndef TEXT_INDEX_FLUSH_PAGES
+#define TEXT_INDEX_FLUSH_PAGES 64
+#endif
+
+namespace MicroSD {
+
+class TextPageIndex {
+public:
+    static constexpr uint32_t MAGIC = 0x58444950;   // "PIDX"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;
+
+    explicit TextPageIndex(RWSD& sd);
+    ~TextPageIndex();
+
+    TextPageIndex(const TextPageIndex&) = delete;
+    TextPageIndex& operator=(const TextPageIndex&) = delete;
+
+    /**
+     * @brief 打开文本文件的分页索引，已有索引有效时直接使用 (必要时从中断处继续扫描)
+     * @param text_path 文本文件路径，索引保存为 text_path + ".pidx"
+     * @param layout 当前屏幕与字体度量
+     */
+    Result<void> open(const std::string& text_path,
+                      const hybrid_font::TextLayout& layout = hybrid_font::TextLayout());
+
+    /**
+     * @brief 写入未保存的页并关闭
+     */
+    void close();
+
+    /**
+     * @brief 后台扫描：在主循环空闲时调用，每次处理 TEXT_INDEX_SCAN_CHUNK 字节
+     * @return true 扫描尚未完成；索引写入失败后返回false，is_failed() 为true
+     */
+    bool poll();
+
+    /**
+     * @brief 第page页的起始字节偏移，已扫描的页为O(1) (读索引文件的一个条目)
+     * @param wait 该页尚未扫描到时同步扫描，否则返回错误
+     */
+    Result<size_t> page_offset(uint32_t page, bool wait = false);
+
+    /**
+     * @brief 包含offset的页号 (书签按字节偏移恢复)，对已扫描部分二分查找
+     */
+    Result<uint32_t> page_of(size_t offset);
+
+    bool is_open() const { return index_.is_open(); }
+    bool is_complete() const { return complete_; }
+    bool is_failed() const { return failed_; }                              // 索引写入失败，已作废
+    uint32_t page_count() const { return saved_pages_ + pending_count_; }    // 目前已知的页数
+    size_t text_size() const { return text_size_; }
+    size_t scanned_bytes() const { return breaker_.offset(); }
+
+private:
+    RWSD* sd_;
+    RWSD::FileHandle text_;
+    RWSD::FileHandle index_;
+    hybrid_font::PageBreaker breaker_;
+    size_t text_size_;
+    uint32_t text_modified_;
+    uint32_t fingerprint_;
+    uint32_t saved_pages_;          // 已写入索引文件的页数
+    uint32_t pending_[TEXT_INDEX_FLUSH_PAGES];
+    uint32_t pending_count_;
+    bool complete_;
+    bool failed_;
+    std::string index_path_;
+    uint8_t chunk_[TEXT_INDEX_SCAN_CHUNK];
+
+    bool load_existing(const std::string& index_path);
+    Result<void> create(const std::string& index_path);
+    Result<void> write_header();
+    Result<void> flush_pending();
+    Result<uint32_t> read_entry(uint32_t page);
+    void add_page(size_t page_start);
+    void abandon(const Result<void>& error);
+};
+
+} // namespace MicroSD
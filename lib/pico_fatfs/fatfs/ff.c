@@ -4204,6 +4204,67 @@ FRESULT f_sync (
 	LEAVE_FF(fs, res);
 }
 
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Synchronize the File Data Only                                        */
+/*-----------------------------------------------------------------------*/
+/* Writes back the file data buffer and syncs the drive without updating
+/  the directory entry. For in-place overwrites of a pre-allocated file.
+/  The pending entry update is dropped only if the entry on the volume
+/  already holds the current start cluster and size; otherwise FA_MODIFIED
+/  is kept and f_sync/f_close will still write the entry. */
+
+FRESULT f_sync_data (
+	FIL* fp		/* Open file to be synced */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+	int current;
+
+
+	res = validate(&fp->obj, &fs);	/* Check validity of the file object */
+	if (res == FR_OK) {
+#if !FF_FS_TINY
+		if (fp->flag & FA_DIRTY) {	/* Write-back cached data if needed */
+			if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) LEAVE_FF(fs, FR_DISK_ERR);
+			fp->flag &= (BYTE)~FA_DIRTY;
+		}
+#endif
+		if (disk_ioctl(fs->pdrv, CTRL_SYNC, 0) != RES_OK) LEAVE_FF(fs, FR_DISK_ERR);
+		if (fp->flag & FA_MODIFIED) {	/* Is the directory entry still up to date? (only the modified time may differ) */
+			current = 0;
+#if FF_FS_EXFAT
+			if (fs->fs_type == FS_EXFAT) {
+				DIR dj;
+				DEF_NAMBUF
+
+				INIT_NAMBUF(fs);
+				res = load_obj_xdir(&dj, &fp->obj);
+				if (res == FR_OK) {
+					current = fs->dirbuf[XDIR_GenFlags] == (fp->obj.stat | 1)
+						&& ld_dword(fs->dirbuf + XDIR_FstClus) == fp->obj.sclust
+						&& ld_qword(fs->dirbuf + XDIR_FileSize) == fp->obj.objsize;
+				}
+				FREE_NAMBUF();
+			} else
+#endif
+			{
+				res = move_window(fs, fp->dir_sect);
+				if (res == FR_OK) {
+					current = ld_clust(fs, fp->dir_ptr) == fp->obj.sclust
+						&& ld_dword(fp->dir_ptr + DIR_FileSize) == (DWORD)fp->obj.objsize;
+				}
+			}
+			if (current) fp->flag &= (BYTE)~FA_MODIFIED;	/* f_close need not rewrite the entry */
+		}
+	}
+
+	LEAVE_FF(fs, res);
+}
+
 #endif /* !FF_FS_READONLY */
 
 
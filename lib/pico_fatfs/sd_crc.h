@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * CRC kernels for SD SPI mode (table driven, no hardware dependency)
+ *   CRC7:  x^7 + x^3 + 1, command packets (token + argument, 5 bytes)
+ *   CRC16: CRC-16-CCITT x^16 + x^12 + x^5 + 1, initial value 0, data blocks
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* Calculate CRC7 of a command packet
+*
+* @param[in] buf the bytes to cover
+* @param[in] len number of bytes
+*
+* @return 7 bit CRC (send as (crc << 1) | 1)
+*/
+uint8_t sd_crc7(const uint8_t* buf, size_t len);
+
+/**
+* Continue CRC16 over more bytes
+*
+* @param[in] crc CRC of the preceding bytes (0 to start)
+* @param[in] buf the bytes to cover
+* @param[in] len number of bytes
+*
+* @return updated CRC
+*/
+uint16_t sd_crc16_update(uint16_t crc, const uint8_t* buf, size_t len);
+
+/**
+* Calculate CRC16 of a data block
+*
+* @param[in] buf the data block
+* @param[in] len number of bytes
+*
+* @return 16 bit CRC (sent MSB first after the block)
+*/
+static inline uint16_t sd_crc16(const uint8_t* buf, size_t len)
+{
+    return sd_crc16_update(0, buf, len);
+}
+
+#ifdef __cplusplus
+}
+#endif
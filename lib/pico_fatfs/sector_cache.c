@@ -0,0 +1,237 @@
+#include "sector_cache.h"
+#include "tf_card_async.h"
+
+#include "pico/stdlib.h"
+
+#include <string.h>
+
+#if PICO_FATFS_WRITE_CACHE
+
+typedef struct {
+    LBA_t    sector;
+    uint32_t last_used;     // LRU tick
+    uint32_t dirty_since;   // [ms] time of the first write after the last write-back
+    bool     valid;
+    bool     dirty;
+} cache_slot_t;
+
+static cache_slot_t _slots[PICO_FATFS_CACHE_SECTORS];
+static uint32_t _data32[PICO_FATFS_CACHE_SECTORS][512 / 4];  // word aligned for DMA
+static uint32_t _tick = 0;
+static pico_fatfs_cache_stats_t _stats;
+
+static inline uint32_t _millis(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static inline BYTE* slot_data(int i)
+{
+    return (BYTE*) _data32[i];
+}
+
+/* Synchronous card access through the block request queue */
+static DRESULT card_io(pico_fatfs_io_op_t op, BYTE* buff, BYTE* const* blocks, LBA_t sector, UINT count)
+{
+    pico_fatfs_io_req_t req = {
+        .op = op,
+        .buff = buff,
+        .blocks = blocks,
+        .sector = sector,
+        .count = count
+    };
+    if (!pico_fatfs_io_submit(&req)) return req.result;
+    return pico_fatfs_io_wait(&req);
+}
+
+static int find_slot(LBA_t sector)
+{
+    for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+        if (_slots[i].valid && _slots[i].sector == sector) return i;
+    }
+    return -1;
+}
+
+/* Get a slot for a new sector: free slot, else LRU clean slot, else write back all and take LRU */
+static int alloc_slot(void)
+{
+    int lru = -1;
+    for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+        if (!_slots[i].valid) return i;
+        if (!_slots[i].dirty && (lru < 0 || _slots[i].last_used < _slots[lru].last_used)) lru = i;
+    }
+    if (lru >= 0) return lru;
+
+    if (pico_fatfs_cache_flush() != RES_OK) return -1;     /* Memory pressure: all slots dirty */
+    for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+        if (lru < 0 || _slots[i].last_used < _slots[lru].last_used) lru = i;
+    }
+    return lru;
+}
+
+DRESULT pico_fatfs_cache_read(BYTE* buff, LBA_t sector, UINT count)
+{
+    UINT cached = 0;
+    for (UINT k = 0; k < count; k++) {
+        if (find_slot(sector + k) >= 0) cached++;
+    }
+
+    if (cached < count) {   /* Read the whole range in one transfer, then overlay newer cached data */
+        DRESULT res = card_io(PICO_FATFS_IO_READ, buff, NULL, sector, count);
+        if (res != RES_OK) return res;
+        _stats.read_misses += count - cached;
+    }
+
+    for (UINT k = 0; k < count && cached; k++) {
+        int i = find_slot(sector + k);
+        if (i < 0) continue;
+        memcpy(buff + k * 512, slot_data(i), 512);
+        _slots[i].last_used = ++_tick;
+        _stats.read_hits++;
+        cached--;
+    }
+
+    return RES_OK;  /* Write-back is left to pico_fatfs_cache_poll(); its errors are not read errors */
+}
+
+DRESULT pico_fatfs_cache_write(const BYTE* buff, LBA_t sector, UINT count)
+{
+    if (count >= PICO_FATFS_CACHE_BYPASS_SECTORS) {
+        /* Large transfer: already multi-block, write through and drop superseded slots */
+        for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+            if (_slots[i].valid && _slots[i].sector >= sector && _slots[i].sector < sector + count) {
+                _slots[i].valid = false;
+                _slots[i].dirty = false;
+            }
+        }
+        DRESULT res = card_io(PICO_FATFS_IO_WRITE, (BYTE*) buff, NULL, sector, count);
+        _stats.card_writes++;
+        if (res == RES_OK) _stats.bytes_written += count * 512;
+        return res;
+    }
+
+    for (UINT k = 0; k < count; k++) {
+        int i = find_slot(sector + k);
+        if (i >= 0) {
+            _stats.write_hits++;
+        } else {
+            _stats.write_misses++;
+            i = alloc_slot();
+            if (i < 0) return RES_ERROR;
+            _slots[i].sector = sector + k;
+            _slots[i].valid = true;
+            _slots[i].dirty = false;
+        }
+        memcpy(slot_data(i), buff + k * 512, 512);
+        if (!_slots[i].dirty) {
+            _slots[i].dirty = true;
+            _slots[i].dirty_since = _millis();
+        }
+        _slots[i].last_used = ++_tick;
+    }
+
+    return pico_fatfs_cache_poll();
+}
+
+DRESULT pico_fatfs_cache_flush(void)
+{
+    int order[PICO_FATFS_CACHE_SECTORS];
+    BYTE* blocks[PICO_FATFS_CACHE_SECTORS];
+    int n = 0;
+
+    for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+        if (_slots[i].valid && _slots[i].dirty) order[n++] = i;
+    }
+    if (n == 0) return RES_OK;
+
+    /* Sort dirty slots by LBA (insertion sort, n is small) */
+    for (int a = 1; a < n; a++) {
+        int v = order[a];
+        int b = a - 1;
+        while (b >= 0 && _slots[order[b]].sector > _slots[v].sector) {
+            order[b + 1] = order[b];
+            b--;
+        }
+        order[b + 1] = v;
+    }
+
+    _stats.flushes++;
+    DRESULT res = RES_OK;
+    int start = 0;
+    while (start < n) {
+        /* Merge a run of adjacent sectors into one multi-block write */
+        LBA_t first = _slots[order[start]].sector;
+        int len = 1;
+        while (start + len < n && _slots[order[start + len]].sector == first + len) len++;
+
+        for (int k = 0; k < len; k++) blocks[k] = slot_data(order[start + k]);
+        DRESULT r = card_io(PICO_FATFS_IO_WRITE, NULL, blocks, first, len);
+        _stats.card_writes++;
+        if (r == RES_OK) {
+            if (len > 1) _stats.coalesced_writes++;
+            _stats.bytes_written += len * 512;
+            for (int k = 0; k < len; k++) _slots[order[start + k]].dirty = false;
+        } else {
+            res = r;    /* Keep dirty for retry */
+        }
+        start += len;
+    }
+    return res;
+}
+
+DRESULT pico_fatfs_cache_poll(void)
+{
+    uint32_t now = _millis();
+    for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+        if (_slots[i].valid && _slots[i].dirty && now - _slots[i].dirty_since >= PICO_FATFS_CACHE_FLUSH_MS) {
+            return pico_fatfs_cache_flush();
+        }
+    }
+    return RES_OK;
+}
+
+void pico_fatfs_cache_invalidate(void)
+{
+    pico_fatfs_cache_flush();
+    for (int i = 0; i < PICO_FATFS_CACHE_SECTORS; i++) {
+        _slots[i].valid = false;
+        _slots[i].dirty = false;
+    }
+}
+
+void pico_fatfs_cache_get_stats(pico_fatfs_cache_stats_t* stats)
+{
+    *stats = _stats;
+}
+
+void pico_fatfs_cache_reset_stats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+#else  /* PICO_FATFS_WRITE_CACHE */
+
+DRESULT pico_fatfs_cache_flush(void)
+{
+    return RES_OK;
+}
+
+DRESULT pico_fatfs_cache_poll(void)
+{
+    return RES_OK;
+}
+
+void pico_fatfs_cache_invalidate(void)
+{
+}
+
+void pico_fatfs_cache_get_stats(pico_fatfs_cache_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+void pico_fatfs_cache_reset_stats(void)
+{
+}
+
+#endif /* PICO_FATFS_WRITE_CACHE */
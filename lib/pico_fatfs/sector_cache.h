@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ff.h"
+#include "diskio.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Write-back sector cache between FatFs and the SD card
+ *   disk_write() stores small writes in an N-sector LRU cache with dirty
+ *   tracking. Dirty sectors are written back sorted by LBA, adjacent sectors
+ *   merged into one multi-block CMD25 transfer. Write-back happens on an
+ *   explicit pico_fatfs_cache_flush(), from pico_fatfs_cache_poll() when the
+ *   oldest dirty sector is older than PICO_FATFS_CACHE_FLUSH_MS, and when no
+ *   clean slot is left.
+ *   disk_read() returns cached data for sectors that are in the cache and
+ *   never reports write-back errors.
+ *
+ * Durability contract (only when PICO_FATFS_WRITE_CACHE is 1)
+ *   disk_ioctl(CTRL_SYNC) only waits for the card and does NOT write back the
+ *   cache, so f_sync() and f_close() no longer make data durable. Data reaches
+ *   the card only on pico_fatfs_cache_flush(), on an expired
+ *   pico_fatfs_cache_poll(), or when the cache runs out of clean slots. A user
+ *   enabling the cache must call pico_fatfs_cache_poll() periodically and
+ *   pico_fatfs_cache_flush() at every point that has to survive a power loss
+ *   (RWSD does both: poll_background(), sync() and FileHandle::flush()).
+ *   This is what lets a log that closes its file after every record avoid a
+ *   write-back per record. With the cache disabled (default) f_sync() and
+ *   f_close() keep the standard FatFs meaning.
+ */
+
+/* Enable write-back sector cache (1: Enable, 0: Disable)
+   Opt-in: see the durability contract above before enabling */
+#ifndef PICO_FATFS_WRITE_CACHE
+#define PICO_FATFS_WRITE_CACHE          0
+#endif
+
+/* Number of 512-byte sectors in the cache */
+#ifndef PICO_FATFS_CACHE_SECTORS
+#define PICO_FATFS_CACHE_SECTORS        8
+#endif
+
+/* Write back dirty sectors older than this [ms] */
+#ifndef PICO_FATFS_CACHE_FLUSH_MS
+#define PICO_FATFS_CACHE_FLUSH_MS       1000
+#endif
+
+/* Writes of this many sectors or more bypass the cache */
+#ifndef PICO_FATFS_CACHE_BYPASS_SECTORS
+#define PICO_FATFS_CACHE_BYPASS_SECTORS 4
+#endif
+
+typedef struct _pico_fatfs_cache_stats_t {
+    uint32_t read_hits;         // sectors read from the cache
+    uint32_t read_misses;       // sectors read from the card
+    uint32_t write_hits;        // writes absorbed by an already cached sector
+    uint32_t write_misses;      // writes which needed a new slot
+    uint32_t flushes;           // write-back passes
+    uint32_t card_writes;       // write commands issued to the card (CMD24/CMD25)
+    uint32_t coalesced_writes;  // multi-block writes built from 2 or more cached sectors
+    uint32_t bytes_written;     // bytes written to the card
+} pico_fatfs_cache_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* Read sector(s) through the cache (called by disk_read)
+*
+* @param[out] buff the data buffer
+* @param[in] sector the start sector (LBA)
+* @param[in] count the number of sectors
+*
+* @return result of the card read
+*/
+DRESULT pico_fatfs_cache_read(BYTE* buff, LBA_t sector, UINT count);
+
+/**
+* Write sector(s) through the cache (called by disk_write)
+*
+* @param[in] buff the data to write
+* @param[in] sector the start sector (LBA)
+* @param[in] count the number of sectors
+*
+* @return result of the write (write-back errors are reported by a later call)
+*/
+DRESULT pico_fatfs_cache_write(const BYTE* buff, LBA_t sector, UINT count);
+
+/**
+* Write back all dirty sectors
+*
+* @return RES_OK if all dirty sectors were written
+*/
+DRESULT pico_fatfs_cache_flush(void);
+
+/**
+* Write back dirty sectors if the oldest one has expired
+* Call periodically from the main loop (RWSD::poll_background() does).
+* Also run by pico_fatfs_cache_write().
+*
+* @return RES_OK if nothing was due or the write-back succeeded
+*/
+DRESULT pico_fatfs_cache_poll(void);
+
+/**
+* Write back and drop all cached sectors (e.g. before re-initializing the card)
+*/
+void pico_fatfs_cache_invalidate(void);
+
+/**
+* Get cache counters
+*
+* @param[out] stats the counters
+*/
+void pico_fatfs_cache_get_stats(pico_fatfs_cache_stats_t* stats);
+
+/**
+* Clear cache counters
+*/
+void pico_fatfs_cache_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -50,6 +50,22 @@ const uint8_t WRITE_COUNT = 2;
 
 // Read pass count.
 const uint8_t READ_COUNT = 2;
+
+// Size of the bounce buffer for the copy test (multiple of 512 so that
+// FatFs transfers whole sectors with CMD18/CMD25).
+const size_t COPY_BUF_SIZE = 8192;
+
+// Copy pass count.
+const uint8_t COPY_COUNT = 2;
+
+// Chunk size for the chunked read test (reopen per chunk vs. kept-open handle).
+const size_t CHUNK_SIZE = 4096;
+
+// Number of 512-byte reads at random offsets for the fast seek test.
+const uint32_t RANDOM_READ_COUNT = 500;
+
+// Cluster link map table size for the fast seek test (in DWORDs).
+const size_t CLMT_SIZE = 64;
 //==============================================================================
 // End of configuration constants.
 //------------------------------------------------------------------------------
@@ -60,6 +76,9 @@ const uint32_t FILE_SIZE = 1000000UL*FILE_SIZE_MB;
 uint32_t buf32[(BUF_SIZE + 3)/4];
 uint8_t* buf = (uint8_t*)buf32;
 
+uint32_t copy_buf32[COPY_BUF_SIZE/4];
+uint8_t* copy_buf = (uint8_t*)copy_buf32;
+
 stringstream ssof;
 
 static bool _check_pico_w()
@@ -174,15 +193,16 @@ int benchmark(pico_fatfs_spi_config_t config)
     while (uart_is_readable(uart0)) {
         uart_getc(uart0);
     }
-    cout << "Type any character to start (*: Auto select from SPI / SPI PIO, p: SPI PIO)" << endl;
+    cout << "Type any character to start (*: Auto select from SPI / SPI PIO, p: SPI PIO, n: no DMA, q: SPI PIO without DMA)" << endl;
     while (!uart_is_readable_within_us(uart0, 1000)) {};
 
     int chr;
     while ((chr = getchar_timeout_us(0)) == PICO_ERROR_TIMEOUT) {}
 
-    if (chr == 'p') {
+    if (chr == 'p' || chr == 'q') {
         _config.spi_inst = NULL;
     }
+    pico_fatfs_set_dma_enabled(chr != 'n' && chr != 'q');
 
     ss << "=====================" << endl;
     ss << "== pico_fatfs_test ==" << endl;
@@ -217,6 +237,7 @@ int benchmark(pico_fatfs_spi_config_t config)
        << pico_fatfs_get_clk_slow_freq() / 1e3 << " KHz, clk_fast: " << setw(5) << setprecision(2)
        << pico_fatfs_get_clk_fast_freq() / 1e6 << " MHz" << endl;
     ss << "mount ok" << endl;
+    ss << "DMA transfer: " << (pico_fatfs_is_dma_active() ? "on" : "off") << endl;
 
     switch (fs.fs_type) {
         case FS_FAT12:
@@ -388,6 +409,162 @@ int benchmark(pico_fatfs_spi_config_t config)
         flush_stream(ss);
     }
 
+    ss << endl;
+    ss << "Starting copy test, please wait." << endl << endl;
+    ss << "COPY_BUF_SIZE = " << COPY_BUF_SIZE << " bytes" << endl;
+    ss << "copy speed" << endl;
+    ss << "speed,prealloc" << endl;
+    ss << "KB/Sec," << endl;
+    flush_stream(ss);
+
+    // do copy test (bench.dat -> bench_cp.dat)
+    for (uint8_t nTest = 0; nTest < COPY_COUNT; nTest++) {
+        FIL dst;
+        fr = f_rewind(&fil);
+        if (fr != FR_OK) {
+            cout << "rewind failed " << fr << endl;
+            _error_blink(11);
+        }
+        fr = f_open(&dst, "bench_cp.dat", FA_WRITE | FA_CREATE_ALWAYS);
+        if (fr != FR_OK) {
+            cout << "open error " << fr << endl;
+            _error_blink(11);
+        }
+        t = to_ms_since_boot(get_absolute_time());
+        bool expanded = PRE_ALLOCATE && f_expand(&dst, f_size(&fil), 1) == FR_OK;
+        uint32_t copied = 0;
+        while (true) {
+            fr = f_read(&fil, copy_buf, COPY_BUF_SIZE, &br);
+            if (fr != FR_OK) {
+                cout << "read failed " << fr << endl;
+                _error_blink(12);
+            }
+            if (br == 0) break;
+            fr = f_write(&dst, copy_buf, br, &bw);
+            if (fr != FR_OK || bw != br) {
+                cout << "write failed " << fr << " " << bw << endl;
+                _error_blink(12);
+            }
+            copied += bw;
+            _toggle_led();
+        }
+        fr = f_close(&dst);
+        if (fr != FR_OK) {
+            cout << "close failed " << fr << endl;
+            _error_blink(12);
+        }
+        t = to_ms_since_boot(get_absolute_time()) - t;
+        s = copied;
+        ss << fixed << setprecision(4) << setw(7) << s/t << ", " << (expanded ? "yes" : "no") << endl;
+        flush_stream(ss);
+    }
+    f_unlink("bench_cp.dat");
+
+    ss << endl;
+    ss << "Starting chunked read test, please wait." << endl << endl;
+    ss << "CHUNK_SIZE = " << CHUNK_SIZE << " bytes" << endl;
+    ss << "chunked read speed" << endl;
+    ss << "speed,mode" << endl;
+    ss << "KB/Sec," << endl;
+    flush_stream(ss);
+
+    // do chunked read test: open/lseek/close per chunk vs. one kept-open handle
+    for (int mode = 0; mode < 2; mode++) {
+        bool reopen = (mode == 0);
+        FIL chunk_fil;
+        fr = f_open(&chunk_fil, "bench.dat", FA_READ);
+        if (fr != FR_OK) {
+            cout << "open error " << fr << endl;
+            _error_blink(13);
+        }
+        FSIZE_t fsize = f_size(&chunk_fil);
+        if (reopen) f_close(&chunk_fil);
+        t = to_ms_since_boot(get_absolute_time());
+        for (FSIZE_t ofs = 0; ofs < fsize; ofs += CHUNK_SIZE) {
+            if (reopen) {
+                fr = f_open(&chunk_fil, "bench.dat", FA_READ);
+                if (fr == FR_OK) fr = f_lseek(&chunk_fil, ofs);
+            } else if (f_tell(&chunk_fil) != ofs) {
+                fr = f_lseek(&chunk_fil, ofs);
+            }
+            if (fr == FR_OK) fr = f_read(&chunk_fil, copy_buf, CHUNK_SIZE, &br);
+            if (reopen) f_close(&chunk_fil);
+            if (fr != FR_OK) {
+                cout << "chunk read failed " << fr << endl;
+                _error_blink(14);
+            }
+            _toggle_led();
+        }
+        if (!reopen) f_close(&chunk_fil);
+        t = to_ms_since_boot(get_absolute_time()) - t;
+        s = fsize;
+        ss << fixed << setprecision(4) << setw(7) << s/t << ", " << (reopen ? "reopen" : "cached") << endl;
+        flush_stream(ss);
+    }
+
+    ss << endl;
+    ss << "Starting random read test, please wait." << endl << endl;
+    ss << "RANDOM_READ_COUNT = " << RANDOM_READ_COUNT << endl;
+    ss << "random read speed and latency" << endl;
+    ss << "speed,max,min,avg,mode" << endl;
+    ss << "KB/Sec,usec,usec,usec," << endl;
+    flush_stream(ss);
+
+    // do random read test: normal f_lseek (FAT chain walk) vs. fast seek (CLMT)
+    for (int mode = 0; mode < 2; mode++) {
+        bool fast = (mode == 1);
+        DWORD clmt[CLMT_SIZE];
+        FIL rnd_fil;
+        fr = f_open(&rnd_fil, "bench.dat", FA_READ);
+        if (fr != FR_OK) {
+            cout << "open error " << fr << endl;
+            _error_blink(15);
+        }
+        if (fast) {
+            clmt[0] = CLMT_SIZE;
+            rnd_fil.cltbl = clmt;
+            fr = f_lseek(&rnd_fil, CREATE_LINKMAP);
+            if (fr != FR_OK) {
+                // table too small (fragmented file): fall back to normal seek
+                ss << "CLMT needs " << clmt[0] << " DWORDs, fast seek disabled" << endl;
+                rnd_fil.cltbl = NULL;
+                fast = false;
+            }
+        }
+        FSIZE_t blocks = f_size(&rnd_fil) / BUF_SIZE;
+        uint32_t seed = 12345;  // same offsets for both modes
+        maxLatency = 0;
+        minLatency = 9999999;
+        totalLatency = 0;
+        t = to_ms_since_boot(get_absolute_time());
+        for (uint32_t i = 0; i < RANDOM_READ_COUNT; i++) {
+            seed = seed * 1103515245u + 12345u;
+            FSIZE_t ofs = (FSIZE_t)((seed >> 8) % blocks) * BUF_SIZE;
+            uint32_t m = to_us_since_boot(get_absolute_time());
+            fr = f_lseek(&rnd_fil, ofs);
+            if (fr == FR_OK) fr = f_read(&rnd_fil, buf, BUF_SIZE, &br);
+            if (fr != FR_OK || br != BUF_SIZE) {
+                cout << "random read failed " << fr << " " << br << endl;
+                _error_blink(16);
+            }
+            m = to_us_since_boot(get_absolute_time()) - m;
+            totalLatency += m;
+            if (maxLatency < m) {
+                maxLatency = m;
+            }
+            if (minLatency > m) {
+                minLatency = m;
+            }
+            if (i % 10 == 0) _toggle_led();
+        }
+        t = to_ms_since_boot(get_absolute_time()) - t;
+        f_close(&rnd_fil);
+        s = (float)RANDOM_READ_COUNT * BUF_SIZE;
+        ss << fixed << setprecision(4) << setw(7) << s/t << ", " << maxLatency << ", " << minLatency << ", "
+           << totalLatency/RANDOM_READ_COUNT << ", " << (fast ? "fastseek" : "normal") << endl;
+        flush_stream(ss);
+    }
+
     cout << endl << "Done" << endl;
 
     cout << "Save log to file? (y/n): " << flush;
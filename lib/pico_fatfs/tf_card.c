@@ -1,10 +1,17 @@
 #include "tf_card.h"
+#include "tf_card_async.h"
+#include "sector_cache.h"
+#include "sd_crc.h"
 
 #include "ff.h"
 #include "diskio.h"
 #include "pio_spi.h"
 
 #include "pico/stdlib.h"
+#include <string.h>
+#if PICO_FATFS_USE_DMA
+#include "hardware/dma.h"
+#endif
 
 /*--------------------------------------------------------------------------
    SPI and Pin selection
@@ -47,6 +54,7 @@ static pico_fatfs_spi_config_t _config = {
 #define CMD38   (38)        /* ERASE */
 #define CMD55   (55)        /* APP_CMD */
 #define CMD58   (58)        /* READ_OCR */
+#define CMD59   (59)        /* CRC_ON_OFF */
 
 /* MMC card type flags (MMC_GET_TYPE) */
 #define CT_MMC         0x01            /* MMC ver 3 */
@@ -99,8 +107,28 @@ static pio_spi_inst_t _pio_spi = {
 static io_rw_32* _reg_clkdiv = NULL;
 static io_rw_32  _pio_clkdiv_slow = 4096 << 16;
 static io_rw_32  _pio_clkdiv_fast =  256 << 16;
+static uint      _pio_f_clk_sys = 0;    // clk_sys in KHz, measured in pico_fatfs_init_spi_pio()
 #define PIO_CLKDIV_LIMIT (0x00018000)  // fractional div x1.5 (6 system clock syscles per 1 SCK cycle)
 
+/* Link error counters and adaptive clock state */
+static pico_fatfs_link_stats_t _link_stats;
+static uint8_t _io_error_run = 0;       // consecutive failed attempts
+static bool _clk_negotiating = false;   // no retry / step down while verifying a clock
+
+/* CRC mode (CMD59), requested / enabled on the card */
+static bool _crc_enabled = PICO_FATFS_USE_CRC;
+static bool _crc_active = false;
+
+#if PICO_FATFS_USE_DMA
+/* DMA channel pair for data blocks (claimed in pico_fatfs_init_spi) */
+static int  _dma_tx = -1;
+static int  _dma_rx = -1;
+static bool _dma_enabled = true;
+static void (*_dma_wait_hook)(void) = NULL;
+static const uint8_t _dma_fill = 0xFF;  // TX source for reads
+static uint8_t _dma_sink;               // RX sink for writes
+#endif
+
 static inline uint32_t _millis(void)
 {
     return to_ms_since_boot(get_absolute_time());
@@ -164,6 +192,7 @@ static void pico_fatfs_init_spi_pio(void)
     _pio_spi.cs_pin = _config.pin_cs;
 
     uint f_clk_sys = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_SYS);
+    _pio_f_clk_sys = f_clk_sys;
 
     uint offset = pio_add_program(_pio_spi.pio, &spi_cpha0_program);
     pio_spi_init(_pio_spi.pio, _pio_spi.sm, offset,
@@ -188,6 +217,114 @@ static void pico_fatfs_init_spi_pio(void)
     _config.clk_slow = (uint64_t) f_clk_sys * 1000 * 256 / (_pio_clkdiv_slow / 256)  / 4;
 }
 
+/* CLKDIV register value for the highest SCK frequency not above freq */
+static uint32_t pio_clkdiv_for(uint freq)
+{
+    uint64_t div = ((uint64_t) _pio_f_clk_sys * 1000 * 65536 / 4 + freq - 1) / freq;
+    div = (div + 0xff) & 0xffffff00;
+    if (div < PIO_CLKDIV_LIMIT) div = PIO_CLKDIV_LIMIT;
+    return (uint32_t) div;
+}
+
+/* Change the fast clock; takes effect immediately if the card runs at the fast clock */
+static uint apply_clk_fast(uint freq)
+{
+    if (Stat & STA_NOINIT) {
+        _config.clk_fast = freq;    /* Applied by disk_initialize() */
+    } else if (_config.spi_inst != NULL) {
+        _config.clk_fast = spi_set_baudrate(_config.spi_inst, freq);
+    } else if (_reg_clkdiv != NULL) {
+        _pio_clkdiv_fast = pio_clkdiv_for(freq);
+        /* Round up so that the reported frequency maps back to the same divider (saved clock profiles do not drift) */
+        _config.clk_fast = ((uint64_t) _pio_f_clk_sys * 1000 * 65536 / 4 + _pio_clkdiv_fast - 1) / _pio_clkdiv_fast;
+        *_reg_clkdiv = _pio_clkdiv_fast;
+    }
+    return _config.clk_fast;
+}
+
+/* Lower the fast clock to 3/4 after repeated transfer errors */
+static void clk_step_down(void)
+{
+    if (_config.clk_fast <= PICO_FATFS_CLK_FAST_MIN) return;
+    uint freq = _config.clk_fast / 4 * 3;
+    if (freq < PICO_FATFS_CLK_FAST_MIN) freq = PICO_FATFS_CLK_FAST_MIN;
+    apply_clk_fast(freq);
+    _link_stats.clk_steps++;
+}
+
+#if PICO_FATFS_USE_DMA
+static void dma_init_channels(void)
+{
+    if (_dma_tx < 0) _dma_tx = dma_claim_unused_channel(false);
+    if (_dma_rx < 0) _dma_rx = dma_claim_unused_channel(false);
+}
+
+static inline bool dma_ready(void)
+{
+    return _dma_enabled && _dma_tx >= 0 && _dma_rx >= 0;
+}
+
+/* Full duplex transfer by DMA; both FIFOs are paced by DREQ, RX completes last */
+static void dma_transfer(
+    const uint8_t* src, bool src_incr,  /* TX source */
+    uint8_t* dst, bool dst_incr,        /* RX destination */
+    UINT len,
+    uint16_t* crc                       /* CRC16 of the payload by the DMA sniffer, or NULL */
+)
+{
+    volatile void* tx_reg;
+    const volatile void* rx_reg;
+    uint tx_dreq, rx_dreq;
+
+    if (_config.spi_inst != NULL) {
+        tx_reg  = &spi_get_hw(_config.spi_inst)->dr;
+        rx_reg  = &spi_get_hw(_config.spi_inst)->dr;
+        tx_dreq = spi_get_dreq(_config.spi_inst, true);
+        rx_dreq = spi_get_dreq(_config.spi_inst, false);
+    } else {
+        // 8 bit accesses on FIFO, same as pio_spi_write8_read8_blocking()
+        tx_reg  = &_pio_spi.pio->txf[_pio_spi.sm];
+        rx_reg  = &_pio_spi.pio->rxf[_pio_spi.sm];
+        tx_dreq = pio_get_dreq(_pio_spi.pio, _pio_spi.sm, true);
+        rx_dreq = pio_get_dreq(_pio_spi.pio, _pio_spi.sm, false);
+    }
+
+    dma_channel_config c = dma_channel_get_default_config(_dma_rx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, dst_incr);
+    channel_config_set_dreq(&c, rx_dreq);
+    channel_config_set_sniff_enable(&c, crc != NULL && dst_incr);
+    dma_channel_configure(_dma_rx, &c, dst, rx_reg, len, false);
+
+    c = dma_channel_get_default_config(_dma_tx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, src_incr);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, tx_dreq);
+    channel_config_set_sniff_enable(&c, crc != NULL && src_incr);
+    dma_channel_configure(_dma_tx, &c, tx_reg, src, len, false);
+
+    if (crc) {  /* Sniff the channel that carries the payload */
+        dma_sniffer_enable(dst_incr ? _dma_rx : _dma_tx, DMA_SNIFF_CTRL_CALC_VALUE_CRC16, false);
+        dma_sniffer_set_data_accumulator(0);
+    }
+    dma_start_channel_mask((1u << _dma_tx) | (1u << _dma_rx));
+    while (dma_channel_is_busy(_dma_rx)) {
+        if (_dma_wait_hook) {
+            _dma_wait_hook();
+        } else {
+            tight_loop_contents();
+        }
+    }
+    __compiler_memory_barrier();
+    if (crc) {
+        *crc = (uint16_t) dma_sniffer_get_data_accumulator();
+        dma_sniffer_disable();
+    }
+}
+#endif
+
 /* Initialize SPI */
 void pico_fatfs_init_spi(void)
 {
@@ -217,6 +354,10 @@ void pico_fatfs_init_spi(void)
     //gpio_set_drive_strength(_config.pin_mosi, PADS_BANK0_GPIO0_DRIVE_VALUE_4MA); // 2mA, 4mA (default), 8mA, 12mA
     //gpio_set_slew_rate(_config.pin_mosi, 0); // 0: SLOW (default), 1: FAST
 
+#if PICO_FATFS_USE_DMA
+    dma_init_channels();
+#endif
+
     gpio_init(_config.pin_cs);
     gpio_disable_pulls(_config.pin_cs);
     //gpio_set_drive_strength(_config.pin_cs, PADS_BANK0_GPIO0_DRIVE_VALUE_4MA); // 2mA, 4mA (default), 8mA, 12mA
@@ -272,10 +413,19 @@ BYTE xchg_spi (
 static
 void rcvr_spi_multi (
     BYTE* buff,     /* Pointer to data buffer */
-    UINT btr        /* Number of bytes to receive (even number) */
+    UINT btr,       /* Number of bytes to receive (even number) */
+    uint16_t* crc   /* CRC16 of the received bytes, or NULL */
 )
 {
     uint8_t* b = (uint8_t *) buff;
+#if PICO_FATFS_USE_DMA
+    if (btr >= PICO_FATFS_DMA_MIN_LEN && dma_ready()) {
+        dma_transfer(&_dma_fill, false, b, true, btr, PICO_FATFS_CRC_DMA_SNIFF ? crc : NULL);
+        if (PICO_FATFS_CRC_DMA_SNIFF || crc == NULL) return;
+        *crc = sd_crc16(b, btr);
+        return;
+    }
+#endif
     if (_config.spi_inst != NULL) {
         spi_read_blocking(_config.spi_inst, 0xff, b, btr);
     } else {
@@ -283,6 +433,18 @@ void rcvr_spi_multi (
         for (int i = 0; i < btr; i++) { src[i] = 0xff; }
         pio_spi_write8_read8_blocking(&_pio_spi, src, b, btr);
     }
+    if (crc) *crc = sd_crc16(b, btr);
+}
+
+/* Receive the CRC16 trailing a data block; 1:OK (or CRC mode off), 0:Mismatch */
+static
+int rcvr_crc (
+    uint16_t crc    /* CRC16 calculated over the received block */
+)
+{
+    uint16_t rx = (uint16_t) (xchg_spi(0xFF) << 8);
+    rx |= xchg_spi(0xFF);
+    return (!_crc_active || rx == crc) ? 1 : 0;
 }
 
 
@@ -358,8 +520,12 @@ int rcvr_datablock (    /* 1:OK, 0:Error */
     } while (token == 0xFF && _millis() < t + timeout);
     if(token != 0xFE) return 0;     /* Function fails if invalid DataStart token or timeout */
 
-    rcvr_spi_multi(buff, btr);      /* Store trailing data to the buffer */
-    xchg_spi(0xFF); xchg_spi(0xFF);         /* Discard CRC */
+    uint16_t crc = 0;
+    rcvr_spi_multi(buff, btr, _crc_active ? &crc : NULL);   /* Store trailing data to the buffer */
+    if (!rcvr_crc(crc)) {               /* Check CRC */
+        _link_stats.crc_errors++;
+        return 0;
+    }
 
     return 1;                       /* Function succeeded */
 }
@@ -375,7 +541,7 @@ BYTE send_cmd (     /* Return value: R1 resp (bit7==1:Failed to send) */
     DWORD arg       /* Argument */
 )
 {
-    BYTE n, res;
+    BYTE n, res, pkt[6];
 
 
     if (cmd & 0x80) {   /* Send a CMD55 prior to ACMD<n> */
@@ -391,15 +557,13 @@ BYTE send_cmd (     /* Return value: R1 resp (bit7==1:Failed to send) */
     }
 
     /* Send command packet */
-    xchg_spi(0x40 | cmd);               /* Start + command index */
-    xchg_spi((BYTE)(arg >> 24));        /* Argument[31..24] */
-    xchg_spi((BYTE)(arg >> 16));        /* Argument[23..16] */
-    xchg_spi((BYTE)(arg >> 8));         /* Argument[15..8] */
-    xchg_spi((BYTE)arg);                /* Argument[7..0] */
-    n = 0x01;                           /* Dummy CRC + Stop */
-    if (cmd == CMD0) n = 0x95;          /* Valid CRC for CMD0(0) */
-    if (cmd == CMD8) n = 0x87;          /* Valid CRC for CMD8(0x1AA) */
-    xchg_spi(n);
+    pkt[0] = 0x40 | cmd;                /* Start + command index */
+    pkt[1] = (BYTE)(arg >> 24);         /* Argument[31..24] */
+    pkt[2] = (BYTE)(arg >> 16);         /* Argument[23..16] */
+    pkt[3] = (BYTE)(arg >> 8);          /* Argument[15..8] */
+    pkt[4] = (BYTE)arg;                 /* Argument[7..0] */
+    pkt[5] = (BYTE)(sd_crc7(pkt, 5) << 1) | 0x01;  /* CRC7 + Stop (checked by the card in CRC mode) */
+    for (n = 0; n < 6; n++) xchg_spi(pkt[n]);
 
     /* Receive command resp */
     if (cmd == CMD12) xchg_spi(0xFF);   /* Diacard following one byte when CMD12 */
@@ -432,6 +596,7 @@ DSTATUS disk_initialize (
 
 
     if (drv) return STA_NOINIT;         /* Supports only drive 0 */
+    if (!(Stat & STA_NOINIT)) pico_fatfs_cache_invalidate();   /* Re-initialize: write back before resetting the card */
     pico_fatfs_init_spi();              /* Initialize SPI */
     sleep_ms(10);
 
@@ -463,6 +628,10 @@ DSTATUS disk_initialize (
                 ty = 0;
         }
     }
+    _crc_active = false;
+    if (ty && _crc_enabled) {   /* Enable CRC check on the card */
+        _crc_active = (send_cmd(CMD59, 1) == 0);
+    }
     CardType = ty;  /* Card type */
     deselect();
 
@@ -493,44 +662,6 @@ DSTATUS disk_status (
 
 
 
-/*-----------------------------------------------------------------------*/
-/* Read sector(s)                                                        */
-/*-----------------------------------------------------------------------*/
-
-DRESULT disk_read (
-    BYTE drv,       /* Physical drive number (0) */
-    BYTE* buff,     /* Pointer to the data buffer to store read data */
-    LBA_t sector,   /* Start sector number (LBA) */
-    UINT count      /* Number of sectors to read (1..128) */
-)
-{
-    if (drv || !count) return RES_PARERR;       /* Check parameter */
-    if (Stat & STA_NOINIT) return RES_NOTRDY;   /* Check if drive is ready */
-
-    if (!(CardType & CT_BLOCK)) sector *= 512;  /* LBA ot BA conversion (byte addressing cards) */
-
-    if (count == 1) {   /* Single sector read */
-        if ((send_cmd(CMD17, sector) == 0)  /* READ_SINGLE_BLOCK */
-            && rcvr_datablock(buff, 512)) {
-            count = 0;
-        }
-    }
-    else {              /* Multiple sector read */
-        if (send_cmd(CMD18, sector) == 0) { /* READ_MULTIPLE_BLOCK */
-            do {
-                if (!rcvr_datablock(buff, 512)) break;
-                buff += 512;
-            } while (--count);
-            send_cmd(CMD12, 0);             /* STOP_TRANSMISSION */
-        }
-    }
-    deselect();
-
-    return count ? RES_ERROR : RES_OK;  /* Return result */
-}
-
-
-
 #if !FF_FS_READONLY && !FF_FS_NORTC
 /* get the current time */
 __attribute__((weak))
@@ -545,10 +676,20 @@ DWORD get_fattime (void)
 static
 void xmit_spi_multi (
     const BYTE* buff,       /* Pointer to data buffer */
-    UINT btx        /* Number of bytes to transmit (even number) */
+    UINT btx,       /* Number of bytes to transmit (even number) */
+    uint16_t* crc   /* CRC16 of the transmitted bytes, or NULL */
 )
 {
     const uint8_t* b = (const uint8_t *) buff;
+#if PICO_FATFS_USE_DMA
+    if (btx >= PICO_FATFS_DMA_MIN_LEN && dma_ready()) {
+        dma_transfer(b, true, &_dma_sink, false, btx, PICO_FATFS_CRC_DMA_SNIFF ? crc : NULL);
+        if (PICO_FATFS_CRC_DMA_SNIFF || crc == NULL) return;
+        *crc = sd_crc16(b, btx);
+        return;
+    }
+#endif
+    if (crc) *crc = sd_crc16(b, btx);  /* Before sending: the card needs it right after the block */
     if (_config.spi_inst != NULL) {
         spi_write_blocking(_config.spi_inst, b, btx);
     } else {
@@ -557,29 +698,341 @@ void xmit_spi_multi (
 }
 
 /*-----------------------------------------------------------------------*/
-/* Transmit a data packet to the MMC                                     */
+/* Transmit a data packet to the MMC (card must be ready)                */
 /*-----------------------------------------------------------------------*/
 
 static
-int xmit_datablock (    /* 1:OK, 0:Error */
+BYTE xmit_datablock_ready ( /* Data response: 0x05:Accepted, 0x0B:CRC error, other:Error */
     const BYTE* buff, /* 512 byte data block to be transmitted */
     BYTE token /* Data/Stop token */
 )
 {
-    BYTE resp;
-    if (!wait_ready(500)) return 0;
+    uint16_t crc = 0xFFFF;
     xchg_spi(token); /* Xmit data token */
     if (token != 0xFD) { /* Is data token */
-        xmit_spi_multi(buff, 512); /* Xmit the data block to the MMC */
-        xchg_spi(0xFF); /* CRC (Dummy) */
-        xchg_spi(0xFF);
-        resp = xchg_spi(0xFF); /* Reveive data response */
-        if ((resp & 0x1F) != 0x05) /* If not accepted, return with error */
-            return 0;
+        xmit_spi_multi(buff, 512, _crc_active ? &crc : NULL); /* Xmit the data block to the MMC */
+        xchg_spi((BYTE)(crc >> 8)); /* CRC (dummy 0xFFFF if CRC mode is off) */
+        xchg_spi((BYTE)crc);
+        return xchg_spi(0xFF) & 0x1F; /* Reveive data response */
     }
-    return 1;
+    return 0x05;
 }
+#endif
 
+
+/*-----------------------------------------------------------------------*/
+/* Asynchronous block request queue                                      */
+/*-----------------------------------------------------------------------*/
+
+/* Request phases */
+#define IO_PHASE_START      0   /* Not started yet */
+#define IO_PHASE_READY      1   /* Waiting for card ready before the command */
+#define IO_PHASE_TOKEN      2   /* Waiting for DataStart token (read) */
+#define IO_PHASE_BUSY       3   /* Waiting for card ready before next block / stop token (write) */
+
+static pico_fatfs_io_req_t* _io_head = NULL;
+static pico_fatfs_io_req_t* _io_tail = NULL;
+
+static void io_complete(pico_fatfs_io_req_t* req, DRESULT res)
+{
+    deselect();
+    if (res == RES_OK) _io_error_run = 0;
+    _io_head = req->next;
+    if (_io_head == NULL) _io_tail = NULL;
+    req->next = NULL;
+    req->result = res;
+    req->done = true;
+    if (req->callback) req->callback(req, res);
+}
+
+/* Current 512-byte block of the request */
+static inline BYTE* io_block(pico_fatfs_io_req_t* req)
+{
+    return req->blocks ? req->blocks[req->count - req->remain] : req->buff;
+}
+
+/* Transfer error: stop the transfer, step the clock down if errors persist and retry from the failed block */
+static void io_fail(pico_fatfs_io_req_t* req, uint32_t* counter)
+{
+    (*counter)++;
+    if (req->multi) {
+        if (req->op == PICO_FATFS_IO_READ) {
+            send_cmd(CMD12, 0);         /* STOP_TRANSMISSION */
+        } else {
+            xchg_spi(0xFD);             /* STOP_TRAN token */
+            xchg_spi(0xFF);
+            wait_ready(500);
+        }
+        req->multi = false;
+    }
+    deselect();
+
+    if (_clk_negotiating) {
+        io_complete(req, RES_ERROR);
+        return;
+    }
+    if (++_io_error_run >= PICO_FATFS_CLK_STEP_ERRORS) {
+        _io_error_run = 0;
+        clk_step_down();
+    }
+    if (req->retries < PICO_FATFS_IO_RETRIES) {
+        req->retries++;
+        _link_stats.retries++;
+        req->phase = IO_PHASE_START;    /* Blocks already transferred are kept */
+        return;
+    }
+    _link_stats.failed++;
+    io_complete(req, RES_ERROR);
+}
+
+/* Error counter for a rejected command (R1 bit 3: command CRC error) */
+static inline uint32_t* io_cmd_counter(BYTE r1)
+{
+    return (!(r1 & 0x80) && (r1 & 0x08)) ? &_link_stats.crc_errors : &_link_stats.cmd_errors;
+}
+
+/* Error counter for a rejected data block (data response 0x0B: CRC error) */
+static inline uint32_t* io_write_counter(BYTE resp)
+{
+    return resp == 0x0B ? &_link_stats.crc_errors : &_link_stats.write_errors;
+}
+
+/* Clock a few bytes while the card holds DO low; 1:Ready, 0:Busy, -1:Timeout */
+static int io_probe_ready(pico_fatfs_io_req_t* req, uint32_t timeout)
+{
+    for (int i = 0; i < PICO_FATFS_IO_PROBE_BYTES; i++) {
+        if (xchg_spi(0xFF) == 0xFF) return 1;
+    }
+    return (_millis() - req->t_start >= timeout) ? -1 : 0;
+}
+
+/* Issue the read/write command once the card is ready; a retry resumes at the first untransferred block */
+static void io_issue_command(pico_fatfs_io_req_t* req)
+{
+    LBA_t sector = req->sector + (req->count - req->remain);
+    DWORD addr = (CardType & CT_BLOCK) ? (DWORD)sector : (DWORD)sector * 512;  /* LBA ==> BA conversion (byte addressing cards) */
+    bool multi = req->remain > 1;
+
+    BYTE res;
+
+    req->multi = false;
+    if (req->op == PICO_FATFS_IO_READ) {
+        res = send_cmd(multi ? CMD18 : CMD17, addr);    /* READ_SINGLE_BLOCK / READ_MULTIPLE_BLOCK */
+        if (res != 0) {
+            io_fail(req, io_cmd_counter(res));
+            return;
+        }
+        req->multi = multi;
+        req->t_start = _millis();
+        req->phase = IO_PHASE_TOKEN;
+        return;
+    }
+
+#if FF_FS_READONLY == 0
+    if (multi && (CardType & CT_SDC)) send_cmd(ACMD23, req->remain);   /* Predefine number of sectors */
+    res = send_cmd(multi ? CMD25 : CMD24, addr);                        /* WRITE_BLOCK / WRITE_MULTIPLE_BLOCK */
+    if (res != 0) {
+        io_fail(req, io_cmd_counter(res));
+        return;
+    }
+    req->multi = multi;
+    res = xmit_datablock_ready(io_block(req), multi ? 0xFC : 0xFE);
+    if (res != 0x05) {
+        io_fail(req, io_write_counter(res));
+        return;
+    }
+    if (!req->blocks) req->buff += 512;
+    if (--req->remain == 0 && !multi) {
+        /* Card programs the block in background; next request waits for ready */
+        io_complete(req, RES_OK);
+        return;
+    }
+    req->t_start = _millis();
+    req->phase = IO_PHASE_BUSY;
+#else
+    io_complete(req, RES_PARERR);
+#endif
+}
+
+bool pico_fatfs_io_submit(pico_fatfs_io_req_t* req)
+{
+    req->done = false;
+    req->next = NULL;
+    req->phase = IO_PHASE_START;
+    req->remain = req->count;
+    req->retries = 0;
+    req->multi = false;
+
+    if (req->op != PICO_FATFS_IO_SYNC && (!req->count || (req->buff == NULL && req->blocks == NULL))) {
+        req->result = RES_PARERR;
+        return false;
+    }
+    if (Stat & STA_NOINIT) {
+        req->result = RES_NOTRDY;
+        return false;
+    }
+#if FF_FS_READONLY == 0
+    if (req->op == PICO_FATFS_IO_WRITE && (Stat & STA_PROTECT)) {
+        req->result = RES_WRPRT;
+        return false;
+    }
+#else
+    if (req->op == PICO_FATFS_IO_WRITE) {
+        req->result = RES_PARERR;
+        return false;
+    }
+#endif
+
+    if (_io_tail) {
+        _io_tail->next = req;
+    } else {
+        _io_head = req;
+    }
+    _io_tail = req;
+    return true;
+}
+
+bool pico_fatfs_io_poll(void)
+{
+    pico_fatfs_io_req_t* req = _io_head;
+    if (req == NULL) return false;
+
+    int ready;
+    BYTE token;
+
+    switch (req->phase) {
+    case IO_PHASE_START:
+        CS_LOW();       /* Set CS# low */
+        xchg_spi(0xFF); /* Dummy clock (force DO enabled) */
+        req->t_start = _millis();
+        req->phase = IO_PHASE_READY;
+        /* fall through */
+
+    case IO_PHASE_READY:
+        ready = io_probe_ready(req, 500);
+        if (ready == 0) break;
+        if (ready < 0) {    /* Card stuck busy: a disk error, not an uninitialized drive */
+            io_complete(req, RES_ERROR);
+            break;
+        }
+        if (req->op == PICO_FATFS_IO_SYNC) {
+            io_complete(req, RES_OK);
+        } else {
+            io_issue_command(req);
+        }
+        break;
+
+    case IO_PHASE_TOKEN:
+        for (int i = 0; i < PICO_FATFS_IO_PROBE_BYTES; i++) {
+            token = xchg_spi(0xFF);
+            if (token == 0xFF) continue;
+            if (token != 0xFE) break;   /* Invalid DataStart token */
+
+            uint16_t crc = 0;
+            rcvr_spi_multi(io_block(req), 512, _crc_active ? &crc : NULL); /* Store trailing data to the buffer */
+            if (!rcvr_crc(crc)) {   /* Corrupted block: retry from this block */
+                io_fail(req, &_link_stats.crc_errors);
+                return pico_fatfs_io_busy();
+            }
+            if (!req->blocks) req->buff += 512;
+            if (--req->remain == 0) {
+                if (req->multi) send_cmd(CMD12, 0);    /* STOP_TRANSMISSION */
+                io_complete(req, RES_OK);
+            } else {
+                req->t_start = _millis();   /* Next block */
+            }
+            return pico_fatfs_io_busy();
+        }
+        if (token != 0xFF || _millis() - req->t_start >= 200) {    /* Error or timeout of 200ms */
+            io_fail(req, &_link_stats.token_errors);
+        }
+        break;
+
+#if FF_FS_READONLY == 0
+    case IO_PHASE_BUSY:
+        ready = io_probe_ready(req, 500);
+        if (ready == 0) break;
+        if (ready < 0) {
+            io_complete(req, RES_ERROR);
+            break;
+        }
+        if (req->remain == 0) {
+            xmit_datablock_ready(0, 0xFD);  /* STOP_TRAN token */
+            io_complete(req, RES_OK);
+            break;
+        }
+        token = xmit_datablock_ready(io_block(req), 0xFC);
+        if (token != 0x05) {
+            io_fail(req, io_write_counter(token));
+            break;
+        }
+        if (!req->blocks) req->buff += 512;
+        req->remain--;
+        req->t_start = _millis();
+        break;
+#endif
+
+    default:
+        io_complete(req, RES_ERROR);
+        break;
+    }
+
+    return pico_fatfs_io_busy();
+}
+
+bool pico_fatfs_io_busy(void)
+{
+    return _io_head != NULL;
+}
+
+DRESULT pico_fatfs_io_wait(pico_fatfs_io_req_t* req)
+{
+    while (!req->done) {
+        pico_fatfs_io_poll();
+    }
+    return req->result;
+}
+
+/* Complete all pending requests before accessing the card directly */
+static void io_drain(void)
+{
+    while (pico_fatfs_io_poll()) {
+        tight_loop_contents();
+    }
+}
+
+
+/*-----------------------------------------------------------------------*/
+/* Read sector(s)                                                        */
+/*-----------------------------------------------------------------------*/
+
+DRESULT disk_read (
+    BYTE drv,       /* Physical drive number (0) */
+    BYTE* buff,     /* Pointer to the data buffer to store read data */
+    LBA_t sector,   /* Start sector number (LBA) */
+    UINT count      /* Number of sectors to read (1..128) */
+)
+{
+    if (drv || !count) return RES_PARERR;       /* Check parameter */
+
+#if PICO_FATFS_WRITE_CACHE
+    if (Stat & STA_NOINIT) return RES_NOTRDY;   /* Check if drive is ready */
+    return pico_fatfs_cache_read(buff, sector, count);
+#else
+    pico_fatfs_io_req_t req = {
+        .op = PICO_FATFS_IO_READ,
+        .buff = buff,
+        .sector = sector,
+        .count = count
+    };
+    if (!pico_fatfs_io_submit(&req)) return req.result;
+
+    return pico_fatfs_io_wait(&req);
+#endif
+}
+
+
+#if FF_FS_READONLY == 0
 /*-----------------------------------------------------------------------*/
 /* Write sector(s)                                                       */
 /*-----------------------------------------------------------------------*/
@@ -592,32 +1045,22 @@ DRESULT disk_write (
 )
 {
     if (drv || !count) return RES_PARERR;       /* Check parameter */
+
+#if PICO_FATFS_WRITE_CACHE
     if (Stat & STA_NOINIT) return RES_NOTRDY;   /* Check drive status */
     if (Stat & STA_PROTECT) return RES_WRPRT;   /* Check write protect */
-
-    if (!(CardType & CT_BLOCK)) sector *= 512;  /* LBA ==> BA conversion (byte addressing cards) */
-
-    if (!_select()) return RES_NOTRDY;
-
-    if (count == 1) {   /* Single sector write */
-        if ((send_cmd(CMD24, sector) == 0)  /* WRITE_BLOCK */
-            && xmit_datablock(buff, 0xFE)) {
-            count = 0;
-        }
-    }
-    else {              /* Multiple sector write */
-        if (CardType & CT_SDC) send_cmd(ACMD23, count); /* Predefine number of sectors */
-        if (send_cmd(CMD25, sector) == 0) { /* WRITE_MULTIPLE_BLOCK */
-            do {
-                if (!xmit_datablock(buff, 0xFC)) break;
-                buff += 512;
-            } while (--count);
-            if (!xmit_datablock(0, 0xFD)) count = 1;    /* STOP_TRAN token */
-        }
-    }
-    deselect();
-
-    return count ? RES_ERROR : RES_OK;  /* Return result */
+    return pico_fatfs_cache_write(buff, sector, count);
+#else
+    pico_fatfs_io_req_t req = {
+        .op = PICO_FATFS_IO_WRITE,
+        .buff = (BYTE*) buff,   /* only read from for writes */
+        .sector = sector,
+        .count = count
+    };
+    if (!pico_fatfs_io_submit(&req)) return req.result;
+
+    return pico_fatfs_io_wait(&req);
+#endif
 }
 #endif
 
@@ -633,19 +1076,27 @@ DRESULT disk_ioctl (
 )
 {
     DRESULT res;
-    BYTE n, csd[16];
+    BYTE n, csd[16], sds[64];
     DWORD* dp, st, ed, csize;
 
 
     if (drv) return RES_PARERR;                 /* Check parameter */
     if (Stat & STA_NOINIT) return RES_NOTRDY;   /* Check if drive is ready */
 
+    if (cmd == CTRL_SYNC) {     /* Wait for end of internal write process of the drive */
+        /* Cached sectors are written back by pico_fatfs_cache_flush() / _poll(), not on every f_sync / f_close
+           (see the durability contract in sector_cache.h; without the cache nothing is pending here) */
+        pico_fatfs_io_req_t req = { .op = PICO_FATFS_IO_SYNC };
+        if (!pico_fatfs_io_submit(&req)) return req.result;
+        return pico_fatfs_io_wait(&req) == RES_OK ? RES_OK : RES_ERROR;
+    }
+
+    if (cmd == CTRL_TRIM) pico_fatfs_cache_invalidate();    /* Erased sectors must not be written back later */
+    io_drain();     /* Other controls access the card directly */
+
     res = RES_ERROR;
 
     switch (cmd) {
-    case CTRL_SYNC :        /* Wait for end of internal write process of the drive */
-        if (_select()) res = RES_OK;
-        break;
 
     case GET_SECTOR_COUNT : /* Get drive capacity in unit of sector (DWORD) */
         if ((send_cmd(CMD9, 0) == 0) && rcvr_datablock(csd, 16)) {
@@ -665,9 +1116,8 @@ DRESULT disk_ioctl (
         if (CardType & CT_SD2) {    /* SDC ver 2.00 */
             if (send_cmd(ACMD13, 0) == 0) { /* Read SD status */
                 xchg_spi(0xFF);
-                if (rcvr_datablock(csd, 16)) {              /* Read partial block */
-                    for (n = 64 - 16; n; n--) xchg_spi(0xFF);   /* Purge trailing data */
-                    *(DWORD*)buff = 16UL << (csd[10] >> 4);
+                if (rcvr_datablock(sds, 64)) {              /* Whole block, CRC covers all 64 bytes */
+                    *(DWORD*)buff = 16UL << (sds[10] >> 4);
                     res = RES_OK;
                 }
             }
@@ -683,6 +1133,12 @@ DRESULT disk_ioctl (
         }
         break;
 
+    case MMC_GET_CID :  /* Read CID (16 bytes) */
+        if (send_cmd(CMD10, 0) == 0 && rcvr_datablock(buff, 16)) {
+            res = RES_OK;
+        }
+        break;
+
     case CTRL_TRIM :    /* Erase a block of sectors (used when _USE_ERASE == 1) */
         if (!(CardType & CT_SDC)) break;                /* Check if the card is SDC */
         if (disk_ioctl(drv, MMC_GET_CSD, csd)) break;   /* Get CSD */
@@ -778,3 +1234,117 @@ uint pico_fatfs_get_clk_fast_freq(void)
 {
     return _config.clk_fast;
 }
+
+uint pico_fatfs_set_clk_fast_freq(uint freq)
+{
+    io_drain();
+    if (freq < _config.clk_slow) freq = _config.clk_slow;
+    return apply_clk_fast(freq);
+}
+
+/* Read the verify sector and hash it (FNV-1a) */
+static bool clk_verify_read(BYTE* buff, uint32_t* hash)
+{
+    pico_fatfs_io_req_t req = {
+        .op = PICO_FATFS_IO_READ,
+        .buff = buff,
+        .sector = PICO_FATFS_CLK_VERIFY_SECTOR,
+        .count = 1
+    };
+    if (!pico_fatfs_io_submit(&req) || pico_fatfs_io_wait(&req) != RES_OK) return false;
+
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 512; i++) {
+        h = (h ^ buff[i]) * 16777619u;
+    }
+    *hash = h;
+    return true;
+}
+
+uint pico_fatfs_negotiate_clk_fast(uint max_freq, uint min_freq)
+{
+    BYTE buff[512];
+    uint32_t ref, hash;
+    bool ok;
+    int n;
+
+    if (Stat & STA_NOINIT) return 0;
+    if (min_freq > max_freq) min_freq = max_freq;
+    io_drain();
+    _clk_negotiating = true;
+
+    FCLK_SLOW();                            /* Reference read at the initialization clock */
+    ok = clk_verify_read(buff, &ref);
+
+    uint freq = max_freq;
+    while (ok) {
+        uint actual = apply_clk_fast(freq);
+        for (n = 0; n < PICO_FATFS_CLK_VERIFY_READS; n++) {
+            if (!clk_verify_read(buff, &hash) || hash != ref) break;
+        }
+        if (n == PICO_FATFS_CLK_VERIFY_READS) break;    /* Every read matched the reference */
+
+        _link_stats.clk_steps++;
+        if (actual <= min_freq) {
+            ok = false;
+            break;
+        }
+        freq = actual / 4 * 3;
+        if (freq < min_freq) freq = min_freq;
+    }
+
+    _clk_negotiating = false;
+    _io_error_run = 0;
+    if (!ok) {
+        apply_clk_fast(min_freq);
+        return 0;
+    }
+    return _config.clk_fast;
+}
+
+void pico_fatfs_set_crc_enabled(bool enabled)
+{
+    _crc_enabled = enabled;
+}
+
+bool pico_fatfs_is_crc_active(void)
+{
+    return _crc_active;
+}
+
+void pico_fatfs_get_link_stats(pico_fatfs_link_stats_t* stats)
+{
+    *stats = _link_stats;
+}
+
+void pico_fatfs_reset_link_stats(void)
+{
+    memset(&_link_stats, 0, sizeof(_link_stats));
+}
+
+void pico_fatfs_set_dma_enabled(bool enabled)
+{
+#if PICO_FATFS_USE_DMA
+    _dma_enabled = enabled;
+#else
+    (void) enabled;
+#endif
+}
+
+bool pico_fatfs_is_dma_active(void)
+{
+#if PICO_FATFS_USE_DMA
+    return dma_ready();
+#else
+    return false;
+#endif
+}
+
+void pico_fatfs_set_dma_wait_hook(void (*hook)(void))
+{
+#if PICO_FATFS_USE_DMA
+    _dma_wait_hook = hook;
+#else
+    (void) hook;
+#endif
+}
@@ -29,6 +29,71 @@
 #define SPI_PIO_DEFAULT_PIO (pio0)
 #define SPI_PIO_DEFAULT_SM  (0)
 
+/*
+ * DMA transfer for data blocks
+ *   1: sector payloads are moved by a TX/RX DMA channel pair (SPI and SPI PIO)
+ *   0: CPU blocking transfer only
+ *   Transfers shorter than PICO_FATFS_DMA_MIN_LEN bytes always use the CPU.
+ */
+#ifndef PICO_FATFS_USE_DMA
+#define PICO_FATFS_USE_DMA      1
+#endif
+#ifndef PICO_FATFS_DMA_MIN_LEN
+#define PICO_FATFS_DMA_MIN_LEN  32
+#endif
+
+/*
+ * CRC mode
+ *   1: CMD59 enables CRC checking on the card at disk_initialize(). Commands carry
+ *      CRC7 and data blocks CRC16-CCITT; a corrupted block counts as a transfer
+ *      error (see retry policy below). Can be switched with pico_fatfs_set_crc_enabled().
+ *   0: dummy CRC, received CRC is ignored
+ *   PICO_FATFS_CRC_DMA_SNIFF: let the DMA sniffer calculate CRC16 of DMA transfers
+ *   (0: table driven calculation by the CPU after/before the transfer)
+ */
+#ifndef PICO_FATFS_USE_CRC
+#define PICO_FATFS_USE_CRC      1
+#endif
+#ifndef PICO_FATFS_CRC_DMA_SNIFF
+#define PICO_FATFS_CRC_DMA_SNIFF    1
+#endif
+
+/*
+ * Retry policy and adaptive fast clock
+ *   A request that fails with a bad command response, DataStart token, data
+ *   response or CRC is retried from the failed block up to PICO_FATFS_IO_RETRIES times.
+ *   After PICO_FATFS_CLK_STEP_ERRORS consecutive failed attempts the fast clock
+ *   is lowered to 3/4 (not below PICO_FATFS_CLK_FAST_MIN) before retrying.
+ *   pico_fatfs_negotiate_clk_fast() verifies a clock by reading
+ *   PICO_FATFS_CLK_VERIFY_SECTOR PICO_FATFS_CLK_VERIFY_READS times and comparing
+ *   with a reference read at clk_slow.
+ */
+#ifndef PICO_FATFS_IO_RETRIES
+#define PICO_FATFS_IO_RETRIES           3
+#endif
+#ifndef PICO_FATFS_CLK_STEP_ERRORS
+#define PICO_FATFS_CLK_STEP_ERRORS      2
+#endif
+#ifndef PICO_FATFS_CLK_FAST_MIN
+#define PICO_FATFS_CLK_FAST_MIN         (4 * MHZ)
+#endif
+#ifndef PICO_FATFS_CLK_VERIFY_SECTOR
+#define PICO_FATFS_CLK_VERIFY_SECTOR    0
+#endif
+#ifndef PICO_FATFS_CLK_VERIFY_READS
+#define PICO_FATFS_CLK_VERIFY_READS     4
+#endif
+
+typedef struct _pico_fatfs_link_stats_t {
+    uint32_t cmd_errors;    // command rejected or not answered
+    uint32_t token_errors;  // invalid or missing DataStart token (read)
+    uint32_t write_errors;  // data block not accepted (write)
+    uint32_t crc_errors;    // CRC mismatch on a received block or reported by the card
+    uint32_t retries;       // attempts repeated after an error
+    uint32_t failed;        // requests failed after all retries
+    uint32_t clk_steps;     // fast clock step downs (runtime and negotiation)
+} pico_fatfs_link_stats_t;
+
 typedef struct _pico_fatfs_spi_config_t {
     spi_inst_t* spi_inst;  // spi0 or spi1
     uint        clk_slow;
@@ -86,6 +151,81 @@ uint pico_fatfs_get_clk_slow_freq(void);
 */
 uint pico_fatfs_get_clk_fast_freq(void);
 
+/**
+* Change clk_fast at run time
+* Takes effect immediately if the card is initialized, otherwise at disk_initialize().
+*
+* @param[in] freq requested frequency in Hz (not below clk_slow)
+*
+* @return actual frequency in Hz (the highest available not above freq)
+*/
+uint pico_fatfs_set_clk_fast_freq(uint freq);
+
+/**
+* Find the highest reliable clk_fast
+* Starting at max_freq, the verify sector is read repeatedly and compared with a
+* reference read at clk_slow; on mismatch or error the clock is lowered to 3/4.
+* Must be called after disk_initialize().
+*
+* @param[in] max_freq first frequency to try in Hz
+* @param[in] min_freq lowest frequency to try in Hz
+*
+* @return negotiated frequency in Hz, 0 if no frequency passed (clk_fast is left at min_freq)
+*/
+uint pico_fatfs_negotiate_clk_fast(uint max_freq, uint min_freq);
+
+/**
+* Enable or disable CRC mode
+* Takes effect at the next disk_initialize().
+*
+* @param[in] enabled true to send CMD59 and check CRC16 of data blocks
+*/
+void pico_fatfs_set_crc_enabled(bool enabled);
+
+/**
+* Check if CRC mode is enabled on the card
+*
+* @return true if CMD59 was accepted in the last disk_initialize()
+*/
+bool pico_fatfs_is_crc_active(void);
+
+/**
+* Get link error counters
+*
+* @param[out] stats the counters since boot or the last reset
+*/
+void pico_fatfs_get_link_stats(pico_fatfs_link_stats_t* stats);
+
+/**
+* Reset link error counters
+*/
+void pico_fatfs_reset_link_stats(void);
+
+/**
+* Enable or disable DMA transfer at run time
+* Has no effect when built with PICO_FATFS_USE_DMA == 0.
+*
+* @param[in] enabled true to use DMA for data blocks (default), false for CPU blocking transfer
+*/
+void pico_fatfs_set_dma_enabled(bool enabled);
+
+/**
+* Check if data blocks are transferred by DMA
+* DMA channels are claimed in disk_initialize(); false if none were available.
+*
+* @return true if DMA is enabled and the channels are claimed
+*/
+bool pico_fatfs_is_dma_active(void);
+
+/**
+* Set a hook called repeatedly while a DMA block transfer is in progress
+* The hook lets the CPU do other work while a sector streams.
+* It must return quickly and must not access the SD card SPI bus.
+*
+* @param[in] hook the function to call, or NULL to spin
+*/
+void pico_fatfs_set_dma_wait_hook(void (*hook)(void));
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
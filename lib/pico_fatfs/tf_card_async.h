@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ff.h"
+#include "diskio.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Asynchronous block request queue for the SD card
+ *   Requests are processed in FIFO order by a state machine that is advanced
+ *   by pico_fatfs_io_poll(). While the card is busy (waiting for the data token
+ *   or for internal programming after a write) each poll only clocks a few
+ *   bytes and returns, so the caller can keep the display and input running.
+ *   disk_read() / disk_write() / disk_ioctl(CTRL_SYNC) are synchronous wrappers
+ *   which submit a request and poll until it completes.
+ */
+
+/* Number of bytes clocked per poll while waiting for the card */
+#ifndef PICO_FATFS_IO_PROBE_BYTES
+#define PICO_FATFS_IO_PROBE_BYTES   8
+#endif
+
+typedef enum {
+    PICO_FATFS_IO_READ = 0,     /* Read sector(s) (CMD17 / CMD18) */
+    PICO_FATFS_IO_WRITE,        /* Write sector(s) (CMD24 / ACMD23 + CMD25) */
+    PICO_FATFS_IO_SYNC          /* Wait until the card finishes internal programming */
+} pico_fatfs_io_op_t;
+
+typedef struct _pico_fatfs_io_req_t pico_fatfs_io_req_t;
+
+/* Completion callback; called from pico_fatfs_io_poll() */
+typedef void (*pico_fatfs_io_cb_t)(pico_fatfs_io_req_t* req, DRESULT result);
+
+struct _pico_fatfs_io_req_t {
+    pico_fatfs_io_op_t op;
+    BYTE*       buff;       // read destination / write source (512 * count bytes)
+    BYTE* const* blocks;    // optional scatter list of count 512-byte blocks; overrides buff if not NULL
+    LBA_t       sector;     // start sector (LBA)
+    UINT        count;      // number of sectors
+    pico_fatfs_io_cb_t callback;    // may be NULL
+    void*       user;       // user context for the callback
+
+    /* managed by the queue */
+    volatile bool done;
+    DRESULT     result;
+    UINT        remain;
+    uint8_t     phase;
+    uint8_t     retries;    // attempts repeated after transfer errors
+    bool        multi;      // multiple block command in progress
+    uint32_t    t_start;
+    pico_fatfs_io_req_t* next;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* Submit a block request
+* The request object and its buffer must stay valid until it completes.
+*
+* @param[in] req the request (op, buff, sector, count, callback and user must be set)
+*
+* @return true if queued, false if rejected (req->result holds the reason, callback is not called)
+*/
+bool pico_fatfs_io_submit(pico_fatfs_io_req_t* req);
+
+/**
+* Advance the request state machine by one bounded step
+* Call from the main loop; completion callbacks are invoked from here.
+*
+* @return true if requests are still pending
+*/
+bool pico_fatfs_io_poll(void);
+
+/**
+* Check if requests are pending
+*
+* @return true if the queue is not empty
+*/
+bool pico_fatfs_io_busy(void);
+
+/**
+* Poll until a request completes
+*
+* @param[in] req the submitted request
+*
+* @return result of the request
+*/
+DRESULT pico_fatfs_io_wait(pico_fatfs_io_req_t* req);
+
+#ifdef __cplusplus
+}
+#endif
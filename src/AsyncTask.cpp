@@ -0,0 +1,120 @@
+#include "AsyncTask.hpp"
+#include "pico/stdlib.h"
+#include <cstdio>
+
+namespace event_loop {
+
+uint64_t Task::clock_us() {
+    return time_us_64();
+}
+
+void TaskEvent::set() {
+    fired_ = true;
+    if (scheduler_) {
+        scheduler_->notify();
+    }
+}
+
+TaskScheduler::TaskScheduler(EventLoop& loop)
+    : loop_(loop), task_count_(0), timer_id_(EventLoop::INVALID_ID) {
+    source_id_ = loop_.add_source([this]() { run_ready(); });
+}
+
+bool TaskScheduler::spawn(Task& task) {
+    if (task_count_ == MAX_TASKS) {
+        printf("[TaskScheduler] 任务槽已满 (%d)\n", MAX_TASKS);
+        return false;
+    }
+    tasks_[task_count_++] = &task;
+    notify();
+    return true;
+}
+
+bool TaskScheduler::cancel(Task& task) {
+    for (int i = 0; i < task_count_; i++) {
+        if (tasks_[i] == &task) {
+            for (int j = i + 1; j < task_count_; j++) {
+                tasks_[j - 1] = tasks_[j];
+            }
+            task_count_--;
+            schedule();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::run_ready() {
+    uint64_t now_us = loop_.now_us();
+    for (int i = 0; i < task_count_; i++) {
+        if (tasks_[i]->runnable(now_us)) {
+            tasks_[i]->resume();
+            now_us = loop_.now_us();
+        }
+    }
+
+    // 移除已结束的任务（保持启动顺序）
+    Task* finished[MAX_TASKS];
+    int finished_count = 0;
+    int kept = 0;
+    for (int i = 0; i < task_count_; i++) {
+        if (tasks_[i]->done()) {
+            finished[finished_count++] = tasks_[i];
+        } else {
+            tasks_[kept++] = tasks_[i];
+        }
+    }
+    task_count_ = kept;
+
+    // 回调可能 spawn 新任务，移除完成后再调用
+    if (done_handler_) {
+        for (int i = 0; i < finished_count; i++) {
+            done_handler_(*finished[i]);
+        }
+    }
+
+    schedule();
+}
+
+void TaskScheduler::schedule() {
+    loop_.cancel_timer(timer_id_);
+    timer_id_ = EventLoop::INVALID_ID;
+
+    uint64_t now_us = loop_.now_us();
+    uint64_t wake_us = UINT64_MAX;
+    for (int i = 0; i < task_count_; i++) {
+        Task* task = tasks_[i];
+        if (task->runnable(now_us)) {
+            // 让出或事件已到：下一轮继续，其间事件循环可以处理其他事件
+            notify();
+            return;
+        }
+        if (task->state() == Task::State::WAIT_TIME && task->wake_us() < wake_us) {
+            wake_us = task->wake_us();
+        }
+    }
+    if (wake_us != UINT64_MAX) {
+        uint32_t delay_ms = static_cast<uint32_t>((wake_us - now_us + 999) / 1000);
+        timer_id_ = loop_.add_timer(delay_ms, 0, [this]() {
+            // 单次定时器触发后已释放，其槽位可能在 run_ready 中被其他定时器复用
+            timer_id_ = EventLoop::INVALID_ID;
+            run_ready();
+        });
+    }
+}
+
+void run_blocking(Task& task) {
+    task.resume();
+    while (!task.done()) {
+        uint64_t now_us = time_us_64();
+        if (task.runnable(now_us)) {
+            task.resume();
+        } else if (task.state() == Task::State::WAIT_TIME) {
+            sleep_us(task.wake_us() - now_us);
+        } else {
+            tight_loop_contents();
+        }
+    }
+}
+
+} // namespace event_loop
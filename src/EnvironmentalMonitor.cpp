@@ -1,120 +1,158 @@
 #include "EnvironmentalMonitor.hpp"
+#include "fonts/st73xx_font.hpp"
 #include <cstdio>
 #include <cstring>
 #include <cmath>
 
 namespace environmental_monitor {
 
-EnvironmentalMonitor::EnvironmentalMonitor(ili9488::ILI9488Driver* display)
-    : display_(display), data_initialized_(false) {
+template<typename Surface>
+EnvironmentalMonitor<Surface>::EnvironmentalMonitor(Surface* display)
+    : display_(display), data_initialized_(false),
+      background_(Surface::fromRGB666(ili9488_colors::rgb666::BLACK)),
+      title_color_(Surface::fromRGB666(ili9488_colors::rgb666::LIGHT_BLUE)),
+      border_color_(Surface::fromRGB666(ili9488_colors::rgb666::GRAY_30)),
+      label_color_(Surface::fromRGB666(ili9488_colors::rgb666::GRAY_70)),
+      value_color_(Surface::fromRGB666(ili9488_colors::rgb666::LIGHT_BLUE)),
+      normal_color_(Surface::fromRGB666(ili9488_colors::rgb666::GREEN)),
+      alert_color_(Surface::fromRGB666(ili9488_colors::rgb666::RED)),
+      placeholder_color_(Surface::fromRGB666(ili9488_colors::rgb666::GRAY_70)),
+      dirty_y0_(UINT16_MAX), dirty_y1_(0) {
     // 初始化传感器数据
     current_data_ = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 }
 
-void EnvironmentalMonitor::initialize_display() {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::initialize_display() {
     if (!display_) {
         printf("[ENV_MONITOR] 显示驱动为空，无法初始化显示！\n");
         return;
     }
-    
+
     printf("[ENV_MONITOR] 开始初始化显示界面...\n");
-    
-    // 设置显示模式为夜间模式（深色背景，浅色文字）
-    printf("[ENV_MONITOR] 设置显示模式为夜间模式...\n");
-    display_->setDisplayMode(ili9488::DisplayMode::Night);
-    
+
+    // 字体管理器（失败时回退到内置8x16字体）
+    if (!fonts_) {
+        fonts_ = std::make_unique<hybrid_font::FontManager<Surface>>();
+        if (!fonts_->is_valid()) {
+            printf("[ENV_MONITOR] 字体管理器初始化失败，回退到简单字体\n");
+        }
+    }
+
     // 清屏并填充深色背景
     printf("[ENV_MONITOR] 清屏并填充黑色背景...\n");
-    display_->fillScreenRGB666(ili9488_colors::rgb666::BLACK);
-    
+    fill_rect(0, 0, Surface::LCD_WIDTH, Surface::LCD_HEIGHT, background_);
+
     // 绘制标题
     printf("[ENV_MONITOR] 绘制标题...\n");
     draw_title();
-    
+
     // 绘制4个传感器数据卡片（移除第一个区块，改为中文显示）
+    // 还没有数据时显示占位符，首次 update_sensor_data 时替换
     printf("[ENV_MONITOR] 绘制传感器数据卡片...\n");
-    draw_sensor_card(get_card_y_position(0), "温度", "", 0.0f, "°C", "Normal");
-    draw_sensor_card(get_card_y_position(1), "湿度", "", 0.0f, "%", "Normal");
-    draw_sensor_card(get_card_y_position(2), "气压", "", 0.0f, "hPa", "Normal");
-    draw_sensor_card(get_card_y_position(3), "海拔", "", 0.0f, "m", "Normal");
-    
+    bool has_data = data_initialized_;
+    const char* status = has_data ? "Normal" : ENV_MONITOR_PLACEHOLDER_STATUS;
+    draw_sensor_card(get_card_y_position(0), "温度", "",
+                     has_data ? format_value(current_data_.bmp280_temperature, 1) : ENV_MONITOR_PLACEHOLDER_VALUE,
+                     "°C", status);
+    draw_sensor_card(get_card_y_position(1), "湿度", "",
+                     has_data ? format_value(current_data_.aht20_humidity, 1) : ENV_MONITOR_PLACEHOLDER_VALUE,
+                     "%", status);
+    draw_sensor_card(get_card_y_position(2), "气压", "",
+                     has_data ? format_value(current_data_.bmp280_pressure, 0) : ENV_MONITOR_PLACEHOLDER_VALUE,
+                     "hPa", status);
+    draw_sensor_card(get_card_y_position(3), "海拔", "",
+                     has_data ? format_value(current_data_.bmp280_altitude, 1) : ENV_MONITOR_PLACEHOLDER_VALUE,
+                     "m", status);
+
     // 刷新显示
-    printf("[ENV_MONITOR] 调用display()刷新显示...\n");
-    display_->display();
-    
+    printf("[ENV_MONITOR] 推送整屏...\n");
+    flush();
+
     printf("[ENV_MONITOR] 显示界面初始化完成\n");
 }
 
-void EnvironmentalMonitor::update_sensor_data(const SensorData& new_data) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::update_sensor_data(const SensorData& new_data) {
     if (!display_) {
         printf("[ENV_MONITOR] 显示驱动为空！\n");
         return;
     }
-    
+
     printf("[ENV_MONITOR] 更新传感器数据: AHT20_T=%.1f°C, AHT20_H=%.1f%%, BMP280_T=%.1f°C, BMP280_P=%.4fhPa, 平均=%.2f°C\n",
-           new_data.aht20_temperature, new_data.aht20_humidity, 
+           new_data.aht20_temperature, new_data.aht20_humidity,
            new_data.bmp280_temperature, new_data.bmp280_pressure, new_data.average_temperature);
-    
+
     // 更新温度（使用BMP280温度作为主要温度显示）
     if (!data_initialized_ || fabs(new_data.bmp280_temperature - current_data_.bmp280_temperature) > 0.1f) {
         printf("[ENV_MONITOR] 更新温度: %.1f°C\n", new_data.bmp280_temperature);
         update_temperature(new_data.bmp280_temperature);
     }
-    
+
     // 更新湿度
     if (!data_initialized_ || fabs(new_data.aht20_humidity - current_data_.aht20_humidity) > 0.1f) {
         printf("[ENV_MONITOR] 更新湿度: %.1f%%\n", new_data.aht20_humidity);
         update_humidity(new_data.aht20_humidity);
     }
-    
+
     // 更新气压
     if (!data_initialized_ || fabs(new_data.bmp280_pressure - current_data_.bmp280_pressure) > 0.01f) {
         printf("[ENV_MONITOR] 更新气压: %.4fhPa\n", new_data.bmp280_pressure);
         update_pressure(new_data.bmp280_pressure);
     }
-    
+
     // 更新海拔
     if (!data_initialized_ || fabs(new_data.bmp280_altitude - current_data_.bmp280_altitude) > 0.1f) {
         printf("[ENV_MONITOR] 更新海拔: %.1fm\n", new_data.bmp280_altitude);
         update_altitude(new_data.bmp280_altitude);
     }
-    
+
+    // 首次数据：占位状态换为正常
+    if (!data_initialized_) {
+        for (uint8_t i = 0; i < DisplayAreas::CARD_COUNT; i++) {
+            refresh_status_area(get_card_y_position(i), ENV_MONITOR_PLACEHOLDER_STATUS, "Normal");
+        }
+    }
+
     // 保存当前数据
     current_data_ = new_data;
     data_initialized_ = true;
-    
-    // 刷新显示
-    printf("[ENV_MONITOR] 调用display()刷新显示\n");
-    display_->display();
+
+    // 只推送改动过的行
+    flush();
 }
 
-void EnvironmentalMonitor::update_temperature(float temperature) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::update_temperature(float temperature) {
     if (!display_) return;
-    
+
     uint16_t card_y = get_card_y_position(0);
     refresh_value_area(card_y, current_data_.bmp280_temperature, temperature, "°C", 1);
     current_data_.bmp280_temperature = temperature;
 }
 
-void EnvironmentalMonitor::update_humidity(float humidity) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::update_humidity(float humidity) {
     if (!display_) return;
-    
+
     uint16_t card_y = get_card_y_position(1);
     refresh_value_area(card_y, current_data_.aht20_humidity, humidity, "%", 1);
     current_data_.aht20_humidity = humidity;
 }
 
-void EnvironmentalMonitor::update_pressure(float pressure) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::update_pressure(float pressure) {
     if (!display_) return;
-    
+
     uint16_t card_y = get_card_y_position(2);
     refresh_value_area(card_y, current_data_.bmp280_pressure, pressure, "hPa", 0);  // 气压使用整数显示
     current_data_.bmp280_pressure = pressure;
 }
 
-void EnvironmentalMonitor::update_altitude(float altitude) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::update_altitude(float altitude) {
     if (!display_) return;
-    
+
     uint16_t card_y = get_card_y_position(3);
     refresh_value_area(card_y, current_data_.bmp280_altitude, altitude, "m", 1);
     current_data_.bmp280_altitude = altitude;
@@ -122,111 +160,113 @@ void EnvironmentalMonitor::update_altitude(float altitude) {
 
 
 
-void EnvironmentalMonitor::show_error(const std::string& error_msg) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::show_error(const std::string& error_msg) {
     if (!display_) return;
-    
+
     // 在屏幕中央显示错误信息
-    uint16_t error_y = 240; // 屏幕中央
-    fill_rect(0, error_y - 20, 320, 40, ili9488_colors::rgb666::BLACK);
-    display_->drawString(10, error_y, error_msg.c_str(), ili9488_colors::rgb666::RED);
-    display_->display();
+    uint16_t error_y = Surface::LCD_HEIGHT / 2; // 屏幕中央
+    fill_rect(0, error_y - 20, Surface::LCD_WIDTH, 40, background_);
+    draw_text(10, error_y, error_msg, alert_color_);
+    flush();
 }
 
-void EnvironmentalMonitor::clear_error() {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::clear_error() {
     if (!display_) return;
-    
+
     // 重新绘制整个界面
     initialize_display();
 }
 
-void EnvironmentalMonitor::draw_title() {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::draw_title() {
     // 绘制标题
-    display_->drawString(60, DisplayAreas::TITLE_Y, "ENVIRONMENTAL MONITOR", 
-                        ili9488_colors::rgb666::LIGHT_BLUE);
-    
+    draw_text(60, DisplayAreas::TITLE_Y, "ENVIRONMENTAL MONITOR", title_color_);
+
     // 绘制分隔线
-    for (uint16_t x = DisplayAreas::CARD_MARGIN_X; x < 320 - DisplayAreas::CARD_MARGIN_X; x++) {
-        display_->drawPixelRGB666(x, DisplayAreas::TITLE_Y + 30, ili9488_colors::rgb666::LIGHT_BLUE);
-    }
+    display_->fillSpan(DisplayAreas::CARD_MARGIN_X, DisplayAreas::TITLE_Y + 30, CARD_WIDTH, title_color_);
 }
 
-void EnvironmentalMonitor::draw_card_background(uint16_t y, uint16_t height) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::draw_card_background(uint16_t y, uint16_t height) {
     // 绘制卡片背景（深灰色边框）
-    fill_rect(DisplayAreas::CARD_MARGIN_X - 2, y - 2, 
-              DisplayAreas::CARD_WIDTH + 4, height + 4, 
-              ili9488_colors::rgb666::GRAY_30);
-    
+    fill_rect(DisplayAreas::CARD_MARGIN_X - 2, y - 2,
+              CARD_WIDTH + 4, height + 4,
+              border_color_);
+
     // 绘制卡片内部（黑色背景）
-    fill_rect(DisplayAreas::CARD_MARGIN_X, y, 
-              DisplayAreas::CARD_WIDTH, height, 
-              ili9488_colors::rgb666::BLACK);
+    fill_rect(DisplayAreas::CARD_MARGIN_X, y,
+              CARD_WIDTH, height,
+              background_);
 }
 
-void EnvironmentalMonitor::draw_sensor_card(uint16_t y, const std::string& sensor_name, 
-                                           const std::string& measurement, float value, 
-                                           const std::string& unit, const std::string& status) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::draw_sensor_card(uint16_t y, const std::string& sensor_name,
+                                                     const std::string& measurement, const std::string& value_str,
+                                                     const std::string& unit, const std::string& status) {
     // 绘制卡片背景
-    draw_card_background(y, DisplayAreas::CARD_HEIGHT);
-    
-    // 计算中文标签的居中位置（假设每个中文字符宽度为16像素）
-    uint16_t label_width = sensor_name.length() * 16;  // 中文字符宽度
-    uint16_t label_x = DisplayAreas::CARD_MARGIN_X + (DisplayAreas::CARD_WIDTH - label_width) / 2;
-    
+    draw_card_background(y, CARD_HEIGHT);
+
+    // 计算标签的居中位置
+    uint16_t label_width = text_width(sensor_name);
+    uint16_t label_x = DisplayAreas::CARD_MARGIN_X + (CARD_WIDTH - label_width) / 2;
+
     // 绘制传感器名称（居中显示）
-    display_->drawString(label_x, y + 5, 
-                        sensor_name.c_str(), ili9488_colors::rgb666::GRAY_70);
-    
+    draw_text(label_x, y + 5, sensor_name, label_color_);
+
     // 绘制测量类型（小字体）- 只有当measurement不为空时才绘制
     if (!measurement.empty()) {
-        display_->drawString(DisplayAreas::CARD_MARGIN_X + 10, y + 20, 
-                            measurement.c_str(), ili9488_colors::rgb666::GRAY_70);
+        draw_text(DisplayAreas::CARD_MARGIN_X + 10, y + 20, measurement, label_color_);
     }
-    
+
     // 绘制数值和单位（大字体，单位跟在数值后面）
-    std::string value_str = format_value(value, (unit == "hPa") ? 0 : 2);  // 气压显示整数，其他显示2位小数
     std::string value_with_unit = value_str + unit;  // 将数值和单位组合
-    display_->drawString(DisplayAreas::CARD_MARGIN_X + DisplayAreas::VALUE_X, 
-                        y + DisplayAreas::VALUE_Y_OFFSET, 
-                        value_with_unit.c_str(), ili9488_colors::rgb666::LIGHT_BLUE);
-    
-    // 绘制状态
-    display_->drawString(DisplayAreas::CARD_MARGIN_X + DisplayAreas::STATUS_X, 
-                        y + DisplayAreas::VALUE_Y_OFFSET, 
-                        status.c_str(), ili9488_colors::rgb666::GREEN);
+    draw_text(DisplayAreas::CARD_MARGIN_X + DisplayAreas::VALUE_X,
+              y + DisplayAreas::VALUE_Y_OFFSET,
+              value_with_unit, value_color_);
+
+    // 绘制状态（占位状态用灰色）
+    draw_text(DisplayAreas::CARD_MARGIN_X + DisplayAreas::STATUS_X,
+              y + DisplayAreas::VALUE_Y_OFFSET,
+              status, (status == "Normal") ? normal_color_ : placeholder_color_);
 }
 
 
 
-void EnvironmentalMonitor::refresh_value_area(uint16_t card_y, float old_value, float new_value, 
-                                             const std::string& unit, uint8_t precision) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::refresh_value_area(uint16_t card_y, float old_value, float new_value,
+                                                       const std::string& unit, uint8_t precision) {
     // 清除数值区域（扩大清除区域以包含单位）
-    fill_rect(DisplayAreas::CARD_MARGIN_X + DisplayAreas::VALUE_X, 
-              card_y + DisplayAreas::VALUE_Y_OFFSET - 5, 
-              120, 20, ili9488_colors::rgb666::BLACK);  // 扩大宽度以包含单位
-    
+    fill_rect(DisplayAreas::CARD_MARGIN_X + DisplayAreas::VALUE_X,
+              card_y + DisplayAreas::VALUE_Y_OFFSET - 5,
+              120, 20, background_);  // 扩大宽度以包含单位
+
     // 绘制新数值和单位
     std::string value_str = format_value(new_value, precision);
     std::string value_with_unit = value_str + unit;  // 将数值和单位组合
-    display_->drawString(DisplayAreas::CARD_MARGIN_X + DisplayAreas::VALUE_X, 
-                        card_y + DisplayAreas::VALUE_Y_OFFSET, 
-                        value_with_unit.c_str(), ili9488_colors::rgb666::LIGHT_BLUE);
+    draw_text(DisplayAreas::CARD_MARGIN_X + DisplayAreas::VALUE_X,
+              card_y + DisplayAreas::VALUE_Y_OFFSET,
+              value_with_unit, value_color_);
 }
 
-void EnvironmentalMonitor::refresh_status_area(uint16_t card_y, const std::string& old_status, 
-                                              const std::string& new_status) {
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::refresh_status_area(uint16_t card_y, const std::string& old_status,
+                                                        const std::string& new_status) {
     // 清除状态区域
-    fill_rect(DisplayAreas::CARD_MARGIN_X + DisplayAreas::STATUS_X, 
-              card_y + DisplayAreas::VALUE_Y_OFFSET - 5, 
-              60, 20, ili9488_colors::rgb666::BLACK);
-    
+    fill_rect(DisplayAreas::CARD_MARGIN_X + DisplayAreas::STATUS_X,
+              card_y + DisplayAreas::VALUE_Y_OFFSET - 5,
+              60, 20, background_);
+
     // 绘制新状态
-    uint32_t status_color = (new_status == "Normal") ? ili9488_colors::rgb666::GREEN : ili9488_colors::rgb666::RED;
-    display_->drawString(DisplayAreas::CARD_MARGIN_X + DisplayAreas::STATUS_X, 
-                        card_y + DisplayAreas::VALUE_Y_OFFSET, 
-                        new_status.c_str(), status_color);
+    Color status_color = (new_status == "Normal") ? normal_color_ : alert_color_;
+    draw_text(DisplayAreas::CARD_MARGIN_X + DisplayAreas::STATUS_X,
+              card_y + DisplayAreas::VALUE_Y_OFFSET,
+              new_status, status_color);
 }
 
-std::string EnvironmentalMonitor::format_value(float value, uint8_t precision) {
+template<typename Surface>
+std::string EnvironmentalMonitor<Surface>::format_value(float value, uint8_t precision) {
     char buffer[16];
     if (precision == 0) {
         // 简单截断到整数，不做4舍5入
@@ -243,16 +283,70 @@ std::string EnvironmentalMonitor::format_value(float value, uint8_t precision) {
     return std::string(buffer);
 }
 
-uint16_t EnvironmentalMonitor::get_card_y_position(uint8_t card_index) {
-    return DisplayAreas::CARD_START_Y + card_index * (DisplayAreas::CARD_HEIGHT + DisplayAreas::CARD_SPACING);
+template<typename Surface>
+uint16_t EnvironmentalMonitor<Surface>::get_card_y_position(uint8_t card_index) {
+    return DisplayAreas::CARD_START_Y + card_index * CARD_PITCH;
+}
+
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, Color color) {
+    display_->fillRect(x, y, width, height, color);
+    mark_dirty(y, height);
 }
 
-void EnvironmentalMonitor::fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
-    for (uint16_t row = 0; row < height; row++) {
-        for (uint16_t col = 0; col < width; col++) {
-            display_->drawPixelRGB666(x + col, y + row, color);
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::draw_text(uint16_t x, uint16_t y, const std::string& text, Color color) {
+    // 文字都画在背景色上，整块写入字形单元
+    if (fonts_ && fonts_->is_valid()) {
+        fonts_->get_renderer().draw_text(*display_, x, y, text.c_str(), color, background_);
+    } else {
+        for (char c : text) {
+            display_->blitMono(x, y, font::FONT_WIDTH, font::FONT_HEIGHT,
+                               font::get_char_data(c), 1, color, background_);
+            x += font::FONT_WIDTH;
         }
     }
+    mark_dirty(y, line_height());
 }
 
+template<typename Surface>
+uint16_t EnvironmentalMonitor<Surface>::text_width(const std::string& text) const {
+    if (fonts_ && fonts_->is_valid()) {
+        return fonts_->get_string_width(text);
+    }
+    return text.length() * font::FONT_WIDTH;
+}
+
+template<typename Surface>
+uint16_t EnvironmentalMonitor<Surface>::line_height() const {
+    // 当前字体的行高：混合字体取ASCII与Flash字体中较高者
+    if (fonts_ && fonts_->is_valid()) {
+        return fonts_->get_font_source().get_font_height();
+    }
+    return font::FONT_HEIGHT;
+}
+
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::mark_dirty(uint16_t y, uint16_t height) {
+    if (y < dirty_y0_) {
+        dirty_y0_ = y;
+    }
+    if (y + height > dirty_y1_) {
+        dirty_y1_ = y + height;
+    }
+}
+
+template<typename Surface>
+void EnvironmentalMonitor<Surface>::flush() {
+    if (dirty_y0_ >= dirty_y1_) {
+        return;
+    }
+    display_->flushRegion(0, dirty_y0_, Surface::LCD_WIDTH, dirty_y1_ - dirty_y0_);
+    dirty_y0_ = UINT16_MAX;
+    dirty_y1_ = 0;
+}
+
+template class EnvironmentalMonitor<ili9488::ILI9488Driver>;
+template class EnvironmentalMonitor<st7306::ST7306Driver>;
+
 } // namespace environmental_monitor
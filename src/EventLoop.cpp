@@ -0,0 +1,194 @@
+#include "EventLoop.hpp"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <cstdio>
+
+namespace event_loop {
+
+// ==================== PicoLoopPlatform ====================
+
+uint64_t PicoLoopPlatform::now_us() {
+    return time_us_64();
+}
+
+void PicoLoopPlatform::sleep_until(uint64_t deadline_us) {
+    // 由定时器硬件闹钟唤醒；任何中断或 SEV 都会提前返回
+    best_effort_wfe_or_timeout(from_us_since_boot(deadline_us));
+}
+
+// ==================== EventLoop ====================
+
+static_assert(EventLoop::MAX_TIMERS <= 0x100, "定时器ID低8位为槽位");
+
+EventLoop::EventLoop(LoopPlatform& platform)
+    : platform_(platform), source_count_(0), pending_(0), running_(false) {
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        timers_[i].active = false;
+        timers_[i].generation = 0;
+    }
+    reset_stats();
+}
+
+int EventLoop::add_timer(uint32_t delay_ms, uint32_t period_ms, TimerCallback callback) {
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (!timers_[i].active) {
+            timers_[i].deadline_us = platform_.now_us() + static_cast<uint64_t>(delay_ms) * 1000;
+            timers_[i].period_us = period_ms * 1000;
+            timers_[i].callback = std::move(callback);
+            timers_[i].active = true;
+            timers_[i].generation++;
+            return i | (timers_[i].generation << 8);
+        }
+    }
+    printf("[EventLoop] 定时器已满 (%d)\n", MAX_TIMERS);
+    return INVALID_ID;
+}
+
+void EventLoop::cancel_timer(int id) {
+    if (id < 0) {
+        return;
+    }
+    int slot = id & 0xFF;
+    if (slot < MAX_TIMERS && timers_[slot].generation == static_cast<uint8_t>(id >> 8)) {
+        timers_[slot].active = false;
+    }
+}
+
+int EventLoop::add_source(SourceHandler handler) {
+    if (source_count_ == MAX_SOURCES) {
+        printf("[EventLoop] 事件源已满 (%d)\n", MAX_SOURCES);
+        return INVALID_ID;
+    }
+    sources_[source_count_] = std::move(handler);
+    return source_count_++;
+}
+
+void EventLoop::signal(int id) {
+    if (id < 0 || id >= source_count_) {
+        return;
+    }
+    // 中断与主循环都可能修改 pending_，读-改-写需关中断
+    uint32_t irq_state = save_and_disable_interrupts();
+    pending_ = pending_ | (1u << id);
+    restore_interrupts(irq_state);
+    __sev();
+}
+
+uint32_t EventLoop::take_pending() {
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t pending = pending_;
+    pending_ = 0;
+    restore_interrupts(irq_state);
+    return pending;
+}
+
+bool EventLoop::dispatch_sources() {
+    uint32_t pending = take_pending();
+    if (!pending) {
+        return false;
+    }
+    while (pending) {
+        int id = __builtin_ctz(pending);
+        pending &= pending - 1;
+        sources_[id]();
+        stats_.source_dispatches++;
+    }
+    return true;
+}
+
+bool EventLoop::dispatch_timers(uint64_t now_us) {
+    // 每个到期定时器本轮最多执行一次，按截止时间先后分发
+    uint32_t done = 0;
+    bool dispatched = false;
+    for (;;) {
+        int next = -1;
+        for (int i = 0; i < MAX_TIMERS; i++) {
+            if (timers_[i].active && !(done & (1u << i)) && timers_[i].deadline_us <= now_us &&
+                (next < 0 || timers_[i].deadline_us < timers_[next].deadline_us)) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            return dispatched;
+        }
+        done |= 1u << next;
+        dispatched = true;
+
+        Timer& timer = timers_[next];
+        if (timer.period_us) {
+            timer.deadline_us += timer.period_us;
+            if (timer.deadline_us <= now_us) {
+                // 错过整周期时不补发，从当前时间重新计时
+                timer.deadline_us = now_us + timer.period_us;
+                stats_.timer_overruns++;
+            }
+        } else {
+            timer.active = false;
+        }
+        // 回调可能取消或添加定时器，先复制
+        TimerCallback callback = timer.callback;
+        callback();
+        stats_.timer_dispatches++;
+    }
+}
+
+uint64_t EventLoop::next_deadline() const {
+    uint64_t deadline = UINT64_MAX;
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (timers_[i].active && timers_[i].deadline_us < deadline) {
+            deadline = timers_[i].deadline_us;
+        }
+    }
+    return deadline;
+}
+
+void EventLoop::run_once() {
+    uint64_t start_us = platform_.now_us();
+    bool worked = dispatch_sources();
+    worked = dispatch_timers(platform_.now_us()) || worked;
+    uint64_t end_us = platform_.now_us();
+    if (worked) {
+        stats_.busy_us += end_us - start_us;
+    }
+
+    // 回调期间有新信号时不睡眠
+    if (pending_) {
+        return;
+    }
+    uint64_t deadline = next_deadline();
+    if (deadline > end_us) {
+        platform_.sleep_until(deadline);
+        stats_.wakeups++;
+    }
+}
+
+void EventLoop::run() {
+    running_ = true;
+    while (running_) {
+        run_once();
+    }
+}
+
+LoopStats EventLoop::stats() {
+    LoopStats snapshot = stats_;
+    snapshot.elapsed_us = platform_.now_us() - stats_start_us_;
+    return snapshot;
+}
+
+void EventLoop::reset_stats() {
+    stats_ = LoopStats{0, 0, 0, 0, 0, 0};
+    stats_start_us_ = platform_.now_us();
+}
+
+void EventLoop::print_stats() {
+    LoopStats s = stats();
+    uint32_t util = s.utilization_permille();
+    uint32_t wakeups = s.wakeups_per_sec_x100();
+    printf("[EventLoop] 利用率 %lu.%lu%%  唤醒 %lu.%02lu 次/秒  定时器 %lu  事件源 %lu  超时 %lu\n",
+           (unsigned long)(util / 10), (unsigned long)(util % 10),
+           (unsigned long)(wakeups / 100), (unsigned long)(wakeups % 100),
+           (unsigned long)s.timer_dispatches, (unsigned long)s.source_dispatches,
+           (unsigned long)s.timer_overruns);
+}
+
+} // namespace event_loop
@@ -0,0 +1,192 @@
+#include "StartupOrchestrator.hpp"
+#include <cstdio>
+
+namespace event_loop {
+
+static const char* status_name(StartupOrchestrator::StepStatus status) {
+    switch (status) {
+        case StartupOrchestrator::StepStatus::PENDING:   return "等待";
+        case StartupOrchestrator::StepStatus::RUNNING:   return "运行中";
+        case StartupOrchestrator::StepStatus::DONE:      return "完成";
+        case StartupOrchestrator::StepStatus::FAILED:    return "失败";
+        case StartupOrchestrator::StepStatus::TIMED_OUT: return "超时";
+        case StartupOrchestrator::StepStatus::SKIPPED:   return "跳过";
+    }
+    return "?";
+}
+
+StartupOrchestrator::StartupOrchestrator(EventLoop& loop, TaskScheduler& scheduler)
+    : loop_(loop), scheduler_(scheduler), step_count_(0),
+      timer_id_(EventLoop::INVALID_ID), finished_(false), start_us_(0) {
+}
+
+int StartupOrchestrator::add_step(const char* name, Task& task, uint32_t deadline_ms,
+                                  uint32_t deps, bool required) {
+    if (step_count_ == MAX_STEPS) {
+        printf("[Boot] 启动步骤已满 (%d)\n", MAX_STEPS);
+        return INVALID_ID;
+    }
+    Step& step = steps_[step_count_];
+    step.name = name;
+    step.task = &task;
+    step.deps = deps;
+    step.deadline_ms = deadline_ms;
+    step.required = required;
+    step.status = StepStatus::PENDING;
+    step.start_us = 0;
+    step.end_us = 0;
+    return step_count_++;
+}
+
+void StartupOrchestrator::start(CompleteCallback on_complete) {
+    on_complete_ = std::move(on_complete);
+    start_us_ = loop_.now_us();
+    scheduler_.set_done_handler([this](Task& task) { on_task_done(task); });
+    launch_ready();
+    check_complete();
+}
+
+const char* StartupOrchestrator::first_failure() const {
+    for (int i = 0; i < step_count_; i++) {
+        if (steps_[i].required && steps_[i].status != StepStatus::DONE) {
+            return steps_[i].name;
+        }
+    }
+    return nullptr;
+}
+
+void StartupOrchestrator::end_step(Step& step, StepStatus status) {
+    step.status = status;
+    step.end_us = loop_.now_us();
+    printf("[Boot] %s %s (%lu ms)\n", step.name, status_name(status),
+           (unsigned long)((step.end_us - step.start_us) / 1000));
+}
+
+void StartupOrchestrator::on_task_done(Task& task) {
+    for (int i = 0; i < step_count_; i++) {
+        Step& step = steps_[i];
+        if (step.task == &task && step.status == StepStatus::RUNNING) {
+            end_step(step, task.failed() ? StepStatus::FAILED : StepStatus::DONE);
+            launch_ready();
+            check_complete();
+            return;
+        }
+    }
+}
+
+void StartupOrchestrator::on_deadline() {
+    timer_id_ = EventLoop::INVALID_ID;
+    uint64_t now_us = loop_.now_us();
+    for (int i = 0; i < step_count_; i++) {
+        Step& step = steps_[i];
+        if (step.status == StepStatus::RUNNING &&
+            now_us - step.start_us >= static_cast<uint64_t>(step.deadline_ms) * 1000) {
+            scheduler_.cancel(*step.task);
+            end_step(step, StepStatus::TIMED_OUT);
+        }
+    }
+    launch_ready();
+    check_complete();
+}
+
+void StartupOrchestrator::launch_ready() {
+    // 跳过步骤会让其后继也被跳过，重复直到没有变化
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < step_count_; i++) {
+            Step& step = steps_[i];
+            if (step.status != StepStatus::PENDING) {
+                continue;
+            }
+            bool ready = true;
+            bool blocked = false;
+            for (int d = 0; d < step_count_; d++) {
+                if (!(step.deps & dep(d))) {
+                    continue;
+                }
+                StepStatus dep_status = steps_[d].status;
+                if (dep_status == StepStatus::PENDING || dep_status == StepStatus::RUNNING) {
+                    ready = false;
+                } else if (dep_status != StepStatus::DONE && steps_[d].required) {
+                    blocked = true;
+                }
+            }
+            if (blocked) {
+                step.start_us = loop_.now_us();
+                end_step(step, StepStatus::SKIPPED);
+                changed = true;
+            } else if (ready) {
+                step.start_us = loop_.now_us();
+                step.task->restart();
+                if (scheduler_.spawn(*step.task)) {
+                    step.status = StepStatus::RUNNING;
+                } else {
+                    end_step(step, StepStatus::FAILED);
+                    changed = true;
+                }
+            }
+        }
+    }
+    arm_deadline();
+}
+
+void StartupOrchestrator::arm_deadline() {
+    loop_.cancel_timer(timer_id_);
+    timer_id_ = EventLoop::INVALID_ID;
+
+    uint64_t deadline_us = UINT64_MAX;
+    for (int i = 0; i < step_count_; i++) {
+        const Step& step = steps_[i];
+        if (step.status == StepStatus::RUNNING) {
+            uint64_t step_deadline = step.start_us + static_cast<uint64_t>(step.deadline_ms) * 1000;
+            if (step_deadline < deadline_us) {
+                deadline_us = step_deadline;
+            }
+        }
+    }
+    if (deadline_us != UINT64_MAX) {
+        uint64_t now_us = loop_.now_us();
+        uint32_t delay_ms = deadline_us > now_us ? static_cast<uint32_t>((deadline_us - now_us + 999) / 1000) : 0;
+        timer_id_ = loop_.add_timer(delay_ms, 0, [this]() { on_deadline(); });
+    }
+}
+
+void StartupOrchestrator::check_complete() {
+    if (finished_) {
+        return;
+    }
+    for (int i = 0; i < step_count_; i++) {
+        if (steps_[i].status == StepStatus::PENDING || steps_[i].status == StepStatus::RUNNING) {
+            return;
+        }
+    }
+    finished_ = true;
+    loop_.cancel_timer(timer_id_);
+    timer_id_ = EventLoop::INVALID_ID;
+
+    print_timeline();
+    if (on_complete_) {
+        on_complete_(first_failure() == nullptr);
+    }
+}
+
+void StartupOrchestrator::print_timeline() const {
+    printf("[Boot] 启动时间线（上电后 ms）:\n");
+    for (int i = 0; i < step_count_; i++) {
+        const Step& step = steps_[i];
+        if (step.status == StepStatus::PENDING) {
+            printf("[Boot]   %-10s %6s\n", step.name, status_name(step.status));
+            continue;
+        }
+        uint64_t end_us = step.status == StepStatus::RUNNING ? loop_.now_us() : step.end_us;
+        printf("[Boot]   %-10s %6lu -> %6lu  %6lu ms  %s%s\n", step.name,
+               (unsigned long)(step.start_us / 1000), (unsigned long)(end_us / 1000),
+               (unsigned long)((end_us - step.start_us) / 1000), status_name(step.status),
+               step.required ? "" : "（可选）");
+    }
+    uint64_t now_us = loop_.now_us();
+    printf("[Boot] 启动耗时 %lu ms\n", (unsigned long)((now_us - start_us_) / 1000));
+}
+
+} // namespace event_loop
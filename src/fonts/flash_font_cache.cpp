@@ -50,10 +50,28 @@ int FlashFontCache::get_font_size() const {
 
 // 从Flash中读取字符位图数据
 std::vector<uint8_t> FlashFontCache::get_char_bitmap(uint16_t char_code) const {
-    if (!initialized_) {
+    const uint8_t* bitmap_data = get_char_data(char_code);
+    if (!bitmap_data) {
         return std::vector<uint8_t>();
     }
     
+    size_t bytes_per_char = (font_size_ == 16) ? BYTES_PER_CHAR_16 : BYTES_PER_CHAR_24;
+    std::vector<uint8_t> bitmap(bytes_per_char);
+    
+    // 复制数据
+    for (size_t i = 0; i < bytes_per_char; i++) {
+        bitmap[i] = bitmap_data[i];
+    }
+    
+    return bitmap;
+}
+
+// 字符位图在Flash中的地址
+const uint8_t* FlashFontCache::get_char_data(uint16_t char_code) const {
+    if (!initialized_) {
+        return nullptr;
+    }
+    
     // 获取字符在字体文件中的偏移
     uint32_t char_offset = get_char_offset(static_cast<uint32_t>(char_code));
     if (char_offset == UINT32_MAX) {
@@ -64,17 +82,7 @@ std::vector<uint8_t> FlashFontCache::get_char_bitmap(uint16_t char_code) const {
     // 计算字节偏移
     size_t bytes_per_char = (font_size_ == 16) ? BYTES_PER_CHAR_16 : BYTES_PER_CHAR_24;
     uint32_t byte_offset = sizeof(FontHeader) + char_offset * bytes_per_char;
-    
-    // 从Flash中读取数据
-    const uint8_t* bitmap_data = flash_data_ + byte_offset;
-    std::vector<uint8_t> bitmap(bytes_per_char);
-    
-    // 复制数据
-    for (size_t i = 0; i < bytes_per_char; i++) {
-        bitmap[i] = bitmap_data[i];
-    }
-    
-    return bitmap;
+    return flash_data_ + byte_offset;
 }
 
 // 验证Flash中的字体文件头
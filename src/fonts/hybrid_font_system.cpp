@@ -26,6 +26,13 @@ std::vector<uint8_t> ASCIIFontSource::get_char_bitmap(uint32_t char_code) const
     return bitmap;
 }
 
+const uint8_t* ASCIIFontSource::get_char_data(uint32_t char_code) const {
+    if (!is_char_supported(char_code)) {
+        return nullptr;
+    }
+    return get_ascii_font_data(static_cast<uint8_t>(char_code));
+}
+
 bool ASCIIFontSource::is_char_supported(uint32_t char_code) const {
     return char_code >= FontConfig::ASCII_START && char_code <= FontConfig::ASCII_END;
 }
@@ -80,6 +87,14 @@ std::vector<uint8_t> FlashFontSource::get_char_bitmap(uint32_t char_code) const
     return cache_.get_char_bitmap(static_cast<uint16_t>(char_code));
 }
 
+const uint8_t* FlashFontSource::get_char_data(uint32_t char_code) const {
+    if (!initialized_) {
+        return nullptr;
+    }
+    
+    return cache_.get_char_data(static_cast<uint16_t>(char_code));
+}
+
 bool FlashFontSource::is_char_supported(uint32_t char_code) const {
     if (!initialized_) {
         return false;
@@ -164,6 +179,18 @@ std::vector<uint8_t> HybridFontSource::get_char_bitmap(uint32_t char_code) const
     }
 }
 
+const uint8_t* HybridFontSource::get_char_data(uint32_t char_code) const {
+    if (!initialized_) {
+        return nullptr;
+    }
+    
+    if (should_use_ascii_font(char_code)) {
+        return ascii_source_->get_char_data(char_code);
+    } else {
+        return flash_source_->get_char_data(char_code);
+    }
+}
+
 bool HybridFontSource::is_char_supported(uint32_t char_code) const {
     if (!initialized_) {
         return false;
@@ -0,0 +1,89 @@
+#include "fonts/text_layout.hpp"
+
+namespace hybrid_font {
+
+// 断行规则变化时递增，使旧规则生成的索引失效
+static constexpr uint32_t LAYOUT_RULES_VERSION = 1;
+
+uint32_t TextLayout::fingerprint() const {
+    const uint32_t fields[] = {LAYOUT_RULES_VERSION, width, height, line_height, ascii_width, wide_width};
+    uint32_t hash = 2166136261u;    // FNV-1a
+    for (uint32_t field : fields) {
+        for (int i = 0; i < 4; i++) {
+            hash = (hash ^ ((field >> (i * 8)) & 0xFF)) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+PageBreaker::PageBreaker(const TextLayout& layout)
+    : layout_(layout), lines_per_page_(layout.lines_per_page()) {
+    reset(0);
+}
+
+void PageBreaker::reset(size_t page_start) {
+    offset_ = page_start;
+    char_start_ = page_start;
+    char_code_ = 0;
+    pending_ = 0;
+    x_ = 0;
+    line_ = 0;
+}
+
+void PageBreaker::begin_line(size_t line_start, const PageCallback& on_page) {
+    x_ = 0;
+    if (++line_ >= lines_per_page_) {
+        line_ = 0;
+        on_page(line_start);
+    }
+}
+
+void PageBreaker::put_char(uint32_t char_code, size_t start, const PageCallback& on_page) {
+    if (char_code == '\n') {
+        begin_line(start + 1, on_page);
+        return;
+    }
+    if (char_code == '\r' || char_code == 0) {
+        return;
+    }
+
+    int width = layout_.char_width(char_code);
+    if (x_ > 0 && x_ + width > layout_.width) {
+        begin_line(start, on_page);
+    }
+    x_ += width;
+}
+
+void PageBreaker::feed(const uint8_t* data, size_t length, const PageCallback& on_page) {
+    for (size_t i = 0; i < length; i++, offset_++) {
+        uint8_t byte = data[i];
+
+        if (pending_ > 0) {
+            if ((byte & 0xC0) == 0x80) {
+                char_code_ = (char_code_ << 6) | (byte & 0x3F);
+                if (--pending_ == 0) {
+                    put_char(char_code_, char_start_, on_page);
+                }
+                continue;
+            }
+            pending_ = 0;   // 序列被截断：丢弃，当前字节按首字节重新处理
+        }
+
+        char_start_ = offset_;
+        if (byte < 0x80) {
+            put_char(byte, offset_, on_page);
+        } else if ((byte & 0xE0) == 0xC0) {
+            char_code_ = byte & 0x1F;
+            pending_ = 1;
+        } else if ((byte & 0xF0) == 0xE0) {
+            char_code_ = byte & 0x0F;
+            pending_ = 2;
+        } else if ((byte & 0xF8) == 0xF0) {
+            char_code_ = byte & 0x07;
+            pending_ = 3;
+        }
+        // 其他字节 (孤立续字节等) 无效，不占宽度
+    }
+}
+
+} // namespace hybrid_font
@@ -9,6 +9,7 @@
 #include <cstdio>
 #include "fonts/hybrid_font_renderer.hpp"
 #include "fonts/st73xx_font.hpp"
+#include "hardware/input/input_latency.hpp"
 
 namespace ili9488 {
 
@@ -74,8 +75,62 @@ ILI9488Driver::~ILI9488Driver() {
 }
 
 bool ILI9488Driver::initialize() {
+    InitTask task(*this);
+    event_loop::run_blocking(task);
+    return true;
+}
+
+void ILI9488Driver::InitTask::run() {
+    TASK_BEGIN();
     printf("  [ILI9488] 开始硬件初始化...\n");
+    driver_.setupHardware();
+    
+    // 硬件复位
+    printf("  [ILI9488] 执行硬件复位...\n");
+    gpio_put(driver_.rst_pin_, 1);
+    TASK_DELAY_MS(10);
+    gpio_put(driver_.rst_pin_, 0);
+    TASK_DELAY_MS(10);
+    gpio_put(driver_.rst_pin_, 1);
+    TASK_DELAY_MS(150);
+    printf("  [ILI9488] 硬件复位完成\n");
+    
+    // 初始化ILI9488
+    printf("  [ILI9488] 开始初始化序列...\n");
+    
+    // 软件复位
+    printf("  [ILI9488] 软件复位...\n");
+    driver_.writeCommand(ILI9488_CMD_SWRESET);
+    TASK_DELAY_MS(200);
+    
+    // 退出睡眠模式
+    printf("  [ILI9488] 退出睡眠模式...\n");
+    driver_.writeCommand(ILI9488_CMD_SLPOUT);
+    TASK_DELAY_MS(200);
+    
+    driver_.initRegisters();
+    
+    // 开启显示
+    printf("  [ILI9488] 开启显示...\n");
+    driver_.writeCommand(ILI9488_CMD_DISPON);
+    TASK_DELAY_MS(50);
+    
+    printf("  [ILI9488] 初始化序列完成\n");
     
+    // 设置旋转为180度
+    // printf("  [ILI9488] 设置旋转为180度...\n");
+    // setRotation(Rotation::Portrait_180);
+    
+    // 设置显示模式为黑底白字
+    printf("  [ILI9488] 设置显示模式为黑底白字...\n");
+    driver_.updateDisplayMode();
+    
+    printf("  [ILI9488] 硬件初始化完成\n");
+    driver_.initialized_ = true;
+    TASK_END();
+}
+
+void ILI9488Driver::setupHardware() {
     // 初始化GPIO
     printf("  [ILI9488] 初始化GPIO引脚...\n");
     gpio_init(dc_pin_);
@@ -112,46 +167,9 @@ bool ILI9488Driver::initialize() {
     
     pwm_set_chan_level(slice_num, channel, 255);
     printf("  [ILI9488] 背光PWM配置完成: slice=%d, channel=%d\n", slice_num, channel);
-    
-    // 硬件复位
-    printf("  [ILI9488] 执行硬件复位...\n");
-    gpio_put(rst_pin_, 1);
-    sleep_ms(10);
-    gpio_put(rst_pin_, 0);
-    sleep_ms(10);
-    gpio_put(rst_pin_, 1);
-    sleep_ms(150);
-    printf("  [ILI9488] 硬件复位完成\n");
-    
-    // 初始化ILI9488
-    initILI9488();
-    
-    // 设置旋转为180度
-    // printf("  [ILI9488] 设置旋转为180度...\n");
-    // setRotation(Rotation::Portrait_180);
-    
-    // 设置显示模式为黑底白字
-    printf("  [ILI9488] 设置显示模式为黑底白字...\n");
-    updateDisplayMode();
-    
-    printf("  [ILI9488] 硬件初始化完成\n");
-    initialized_ = true;
-    return true;
 }
 
-void ILI9488Driver::initILI9488() {
-    printf("  [ILI9488] 开始初始化序列...\n");
-    
-    // 软件复位
-    printf("  [ILI9488] 软件复位...\n");
-    writeCommand(ILI9488_CMD_SWRESET);
-    sleep_ms(200);
-    
-    // 退出睡眠模式
-    printf("  [ILI9488] 退出睡眠模式...\n");
-    writeCommand(ILI9488_CMD_SLPOUT);
-    sleep_ms(200);
-    
+void ILI9488Driver::initRegisters() {
     // 内存访问控制
     printf("  [ILI9488] 设置内存访问控制...\n");
     writeCommand(ILI9488_CMD_MADCTL);
@@ -199,13 +217,6 @@ void ILI9488Driver::initILI9488() {
     // 显示反转
     printf("  [ILI9488] 设置显示反转...\n");
     writeCommand(ILI9488_CMD_INVON);
-    
-    // 开启显示
-    printf("  [ILI9488] 开启显示...\n");
-    writeCommand(ILI9488_CMD_DISPON);
-    sleep_ms(50);
-    
-    printf("  [ILI9488] 初始化序列完成\n");
 }
 
 void ILI9488Driver::setRotation(Rotation r) {
@@ -245,7 +256,8 @@ void ILI9488Driver::clear() {
 
 void ILI9488Driver::display() {
     // 直接写入模式，不需要缓冲区刷新
-    // 所有绘制操作都是直接写入到屏幕的
+    // 所有绘制操作都是直接写入到屏幕的，阻塞写入返回时最后一个字节已发出
+    hardware::input::InputLatency::frame_presented();
 }
 
 void ILI9488Driver::drawPixelRGB666(uint16_t x, uint16_t y, uint32_t color666) {
@@ -670,4 +682,113 @@ bool ILI9488Driver::getScreenPowerState() const {
     return screen_power_on_;
 }
 
-} // namespace ili9488 
\ No newline at end of file
+// ==================== 显示表面接口 ====================
+
+static_assert(hardware::display::is_display_surface_v<ILI9488Driver>,
+              "ILI9488Driver 必须实现显示表面接口");
+
+void ILI9488Driver::setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint8_t caset[4] = {static_cast<uint8_t>(x0 >> 8), static_cast<uint8_t>(x0 & 0xFF),
+                        static_cast<uint8_t>(x1 >> 8), static_cast<uint8_t>(x1 & 0xFF)};
+    uint8_t raset[4] = {static_cast<uint8_t>(y0 >> 8), static_cast<uint8_t>(y0 & 0xFF),
+                        static_cast<uint8_t>(y1 >> 8), static_cast<uint8_t>(y1 & 0xFF)};
+    writeCommand(ILI9488_CMD_CASET);
+    writeData(caset, sizeof(caset));
+    writeCommand(ILI9488_CMD_RASET);
+    writeData(raset, sizeof(raset));
+    writeCommand(ILI9488_CMD_RAMWR);
+}
+
+void ILI9488Driver::fillSpan(uint16_t x, uint16_t y, uint16_t len, Color color) {
+    fillRect(x, y, len, 1, color);
+}
+
+void ILI9488Driver::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color color) {
+    if (!hardware::display::clip_rect(x, y, w, h, LCD_WIDTH, LCD_HEIGHT)) return;
+    fillAreaRGB666(x, y, x + w - 1, y + h - 1, color);
+}
+
+void ILI9488Driver::blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                             const uint8_t* bits, uint16_t stride, Color fg, Color bg) {
+    if (!hardware::display::clip_rect(x, y, w, h, LCD_WIDTH, LCD_HEIGHT)) return;
+    
+    const uint8_t fg_rgb[3] = {static_cast<uint8_t>((fg >> 16) & 0xFC),
+                               static_cast<uint8_t>((fg >> 8) & 0xFC),
+                               static_cast<uint8_t>(fg & 0xFC)};
+    const uint8_t bg_rgb[3] = {static_cast<uint8_t>((bg >> 16) & 0xFC),
+                               static_cast<uint8_t>((bg >> 8) & 0xFC),
+                               static_cast<uint8_t>(bg & 0xFC)};
+    
+    // 一个窗口写完整个位图，每行展开为RGB666后一次写入
+    setWindow(x, y, x + w - 1, y + h - 1);
+    uint8_t line[LCD_WIDTH * 3];
+    for (uint16_t row = 0; row < h; row++) {
+        const uint8_t* src = bits + row * stride;
+        uint8_t* dst = line;
+        for (uint16_t col = 0; col < w; col++) {
+            const uint8_t* rgb = (src[col >> 3] & (0x80 >> (col & 7))) ? fg_rgb : bg_rgb;
+            *dst++ = rgb[0];
+            *dst++ = rgb[1];
+            *dst++ = rgb[2];
+        }
+        writeData(line, w * 3);
+    }
+}
+
+void ILI9488Driver::blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                             const uint8_t* bits, uint16_t stride, Color fg) {
+    if (!hardware::display::clip_rect(x, y, w, h, LCD_WIDTH, LCD_HEIGHT)) return;
+    
+    // 透明背景无法整窗写入，每行按连续的1位游程各写一个单行窗口
+    uint8_t line[LCD_WIDTH * 3];
+    for (uint16_t i = 0; i < w; i++) {
+        line[i * 3] = (fg >> 16) & 0xFC;
+        line[i * 3 + 1] = (fg >> 8) & 0xFC;
+        line[i * 3 + 2] = fg & 0xFC;
+    }
+    for (uint16_t row = 0; row < h; row++) {
+        const uint8_t* src = bits + row * stride;
+        uint16_t col = 0;
+        while (col < w) {
+            if (!(src[col >> 3] & (0x80 >> (col & 7)))) {
+                col++;
+                continue;
+            }
+            uint16_t start = col;
+            while (col < w && (src[col >> 3] & (0x80 >> (col & 7)))) {
+                col++;
+            }
+            setWindow(x + start, y + row, x + col - 1, y + row);
+            writeData(line, (col - start) * 3);
+        }
+    }
+}
+
+void ILI9488Driver::writeWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Color* pixels) {
+    uint16_t full_w = w;
+    if (!hardware::display::clip_rect(x, y, w, h, LCD_WIDTH, LCD_HEIGHT)) return;
+    
+    setWindow(x, y, x + w - 1, y + h - 1);
+    uint8_t line[LCD_WIDTH * 3];
+    for (uint16_t row = 0; row < h; row++) {
+        const Color* src = pixels + row * full_w;
+        uint8_t* dst = line;
+        for (uint16_t col = 0; col < w; col++) {
+            *dst++ = (src[col] >> 16) & 0xFC;
+            *dst++ = (src[col] >> 8) & 0xFC;
+            *dst++ = src[col] & 0xFC;
+        }
+        writeData(line, w * 3);
+    }
+}
+
+void ILI9488Driver::flushRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    // 直写模式：绘制时已写入GRAM，只记录一帧
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+    hardware::input::InputLatency::frame_presented();
+}
+
+} // namespace ili9488
@@ -1,4 +1,5 @@
-#include "st7306_driver.hpp"
+#include "hardware/display/st7306_driver.hpp"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 #include "hardware/spi.h"
@@ -6,6 +7,7 @@
 #include "pico/stdlib.h"
 #include "fonts/st73xx_font.hpp"
 #include "fonts/gfx_colors.hpp"
+#include "hardware/input/input_latency.hpp"
 
 namespace st7306 {
 
@@ -43,38 +45,57 @@ ST7306Driver::~ST7306Driver() {
 }
 
 void ST7306Driver::initialize() {
+    InitTask task(*this);
+    event_loop::run_blocking(task);
+}
+
+void ST7306Driver::InitTask::run() {
+    TASK_BEGIN();
     // 初始化引脚
-    gpio_set_dir(dc_pin_, GPIO_OUT);
-    gpio_set_dir(res_pin_, GPIO_OUT);
-    gpio_set_dir(cs_pin_, GPIO_OUT);
-    gpio_set_dir(sclk_pin_, GPIO_OUT);
-    gpio_set_dir(sdin_pin_, GPIO_OUT);
+    gpio_set_dir(driver_.dc_pin_, GPIO_OUT);
+    gpio_set_dir(driver_.res_pin_, GPIO_OUT);
+    gpio_set_dir(driver_.cs_pin_, GPIO_OUT);
+    gpio_set_dir(driver_.sclk_pin_, GPIO_OUT);
+    gpio_set_dir(driver_.sdin_pin_, GPIO_OUT);
 
     // 复位时序
-    gpio_put(res_pin_, 1);
-    sleep_ms(10);
-    gpio_put(res_pin_, 0);
-    sleep_ms(10);
-    gpio_put(res_pin_, 1);
-    sleep_ms(10);
+    gpio_put(driver_.res_pin_, 1);
+    TASK_DELAY_MS(10);
+    gpio_put(driver_.res_pin_, 0);
+    TASK_DELAY_MS(10);
+    gpio_put(driver_.res_pin_, 1);
+    TASK_DELAY_MS(10);
 
     // 初始化SPI
     spi_init(spi0, 40000000); // 40MHz
     spi_set_format(spi0, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
-    gpio_set_function(sclk_pin_, GPIO_FUNC_SPI);
-    gpio_set_function(sdin_pin_, GPIO_FUNC_SPI);
+    gpio_set_function(driver_.sclk_pin_, GPIO_FUNC_SPI);
+    gpio_set_function(driver_.sdin_pin_, GPIO_FUNC_SPI);
+
+    driver_.initPowerSettings();
+    driver_.writeCommand(0x11); // Sleep out
+    TASK_DELAY_MS(120);
+
+    driver_.initPanelSettings();
+    driver_.writeCommand(0xBB); // Enable Clear RAM
+    driver_.writeData(0x4F);    // CLR=0 ; Enable Clear RAM,clear RAM to 0
+    // 等待清除完成
+    TASK_DELAY_MS(10);
+
+    driver_.resetAddressWindow();
+    driver_.hpm_mode_ = true;
+    driver_.lpm_mode_ = false;
 
-    initST7306();
-    
     // 初始化显示缓冲区为白色
-    fill(0x00);  // 填充为白色
+    driver_.fill(0x00);  // 填充为白色
     // 不在初始化时自动显示，让应用程序控制第一次显示时机
-    
+
     // 设置初始化完成标志
-    initialized_ = true;
+    driver_.initialized_ = true;
+    TASK_END();
 }
 
-void ST7306Driver::initST7306() {
+void ST7306Driver::initPowerSettings() {
     writeCommand(0xD6); // NVM Load Control
     writeData(0x17);
     writeData(0x02);
@@ -156,10 +177,9 @@ void ST7306Driver::initST7306() {
     // Gate Line Setting
     writeCommand(0xB0);
     writeData(0x64); // 400行 = 100*4
+}
 
-    writeCommand(0x11); // Sleep out
-    sleep_ms(120);
-
+void ST7306Driver::initPanelSettings() {
     writeCommand(0xC9); // Source Voltage Select
     writeData(0x00);   // VSHP1; VSLP1 ; VSHN1 ; VSLN1
 
@@ -194,13 +214,9 @@ void ST7306Driver::initST7306() {
     writeCommand(0x29); // Display ON
 
     writeCommand(0x20); // Display Inversion Off
+}
 
-    writeCommand(0xBB); // Enable Clear RAM
-    writeData(0x4F);   // CLR=0 ; Enable Clear RAM,clear RAM to 0
-
-    // 等待清除完成
-    sleep_ms(10);
-    
+void ST7306Driver::resetAddressWindow() {
     // 重新设置地址窗口，确保显示正常
     writeCommand(0x2A); // Column Address Setting
     writeData(0x05);
@@ -209,9 +225,6 @@ void ST7306Driver::initST7306() {
     writeCommand(0x2B); // Row Address Setting  
     writeData(0x00);
     writeData(0xC7);
-
-    hpm_mode_ = true;
-    lpm_mode_ = false;
 }
 
 void ST7306Driver::writeCommand(uint8_t cmd) {
@@ -237,10 +250,12 @@ void ST7306Driver::writeData(const uint8_t* data, size_t len) {
 
 void ST7306Driver::clear() {
     memset(display_buffer_, 0x00, DISPLAY_BUFFER_LENGTH);
+    invalidate();
 }
 
 void ST7306Driver::fill(uint8_t data) {
     memset(display_buffer_, data, DISPLAY_BUFFER_LENGTH);
+    invalidate();
 }
 
 void ST7306Driver::writePoint(uint16_t x, uint16_t y, bool enabled) {
@@ -249,23 +264,60 @@ void ST7306Driver::writePoint(uint16_t x, uint16_t y, bool enabled) {
 }
 
 void ST7306Driver::display() {
-    setAddress();
-    
-    // 按照原厂Arduino代码的写法传输数据
-    writeData(display_buffer_, DISPLAY_BUFFER_LENGTH);
-    
-    // printf("Display buffer transmitted: %d bytes\n", DISPLAY_BUFFER_LENGTH); // 已注释，避免频繁输出
+    if (dirty_col0_ <= dirty_col1_) {
+        pushWindow(dirty_col0_, dirty_col1_, dirty_row0_, dirty_row1_);
+        dirty_col0_ = LCD_DATA_WIDTH;
+        dirty_col1_ = 0;
+        dirty_row0_ = LCD_DATA_HEIGHT;
+        dirty_row1_ = 0;
+    }
 }
 
-void ST7306Driver::setAddress() {
-    // 完全按照原厂驱动代码中的address函数
+void ST7306Driver::pushWindow(uint8_t col0, uint8_t col1, uint8_t row0, uint8_t row1) {
+    // 列方向对齐到列地址（3字节），行方向即缓冲区行
+    col0 /= BYTES_PER_COLUMN_ADDRESS;
+    col1 /= BYTES_PER_COLUMN_ADDRESS;
+    setAddress(col0, col1, row0, row1);
+
+    // 窗口内逐行发送，整个写入期间保持片选
+    const uint8_t* src = display_buffer_ + row0 * LCD_DATA_WIDTH + col0 * BYTES_PER_COLUMN_ADDRESS;
+    size_t row_bytes = (col1 - col0 + 1) * BYTES_PER_COLUMN_ADDRESS;
+    gpio_put(dc_pin_, 1);
+    gpio_put(cs_pin_, 0);
+    if (row_bytes == LCD_DATA_WIDTH) {
+        spi_write_blocking(spi0, src, (row1 - row0 + 1) * row_bytes);
+    } else {
+        for (uint16_t row = row0; row <= row1; row++) {
+            spi_write_blocking(spi0, src, row_bytes);
+            src += LCD_DATA_WIDTH;
+        }
+    }
+    gpio_put(cs_pin_, 1);
+
+    // spi_write_blocking 等待移位完成后返回，此时最后一个字节已发出；没有发送的帧不计入延迟
+    hardware::input::InputLatency::frame_presented();
+}
+
+void ST7306Driver::invalidate() {
+    markDirty(0, LCD_DATA_WIDTH - 1, 0, LCD_DATA_HEIGHT - 1);
+}
+
+void ST7306Driver::markDirty(uint8_t col0, uint8_t col1, uint8_t row0, uint8_t row1) {
+    if (col0 < dirty_col0_) dirty_col0_ = col0;
+    if (col1 > dirty_col1_) dirty_col1_ = col1;
+    if (row0 < dirty_row0_) dirty_row0_ = row0;
+    if (row1 > dirty_row1_) dirty_row1_ = row1;
+}
+
+void ST7306Driver::setAddress(uint8_t col0, uint8_t col1, uint8_t row0, uint8_t row1) {
+    // 原厂驱动中的address函数，窗口改为待推送的矩形
     writeCommand(0x2A); // Column Address Setting S61~S182
-    writeData(0x05);    // Start column address
-    writeData(0x36);    // End column address 0x36 = 54
+    writeData(COLUMN_ADDRESS_START + col0);    // Start column address（整屏 0x05）
+    writeData(COLUMN_ADDRESS_START + col1);    // End column address（整屏 0x36 = 54）
 
     writeCommand(0x2B); // Row Address Setting G1~G250  
-    writeData(0x00);    // Start row address
-    writeData(0xC7);    // End row address 0xC7 = 199
+    writeData(row0);    // Start row address（整屏 0x00）
+    writeData(row1);    // End row address（整屏 0xC7 = 199）
 
     writeCommand(0x2C); // write image data
 }
@@ -436,6 +488,7 @@ void ST7306Driver::writePointGray(uint16_t x, uint16_t y, uint8_t color) {
     uint real_x = x/2; // 0->0, 1->0, 2->1, 3->1
     uint real_y = y/2; // 0->0, 1->0, 2->1, 3->1
     uint write_byte_index = real_y*LCD_DATA_WIDTH+real_x;
+    markDirty(real_x, real_x, real_y, real_y);
     uint one_two = (y % 2 == 0)?0:1; // 0表示上行，1表示下行
     uint line_bit_1 = (x % 2)*4;     // 0或4
     uint line_bit_0 = (x % 2)*4 + 2; // 2或6
@@ -534,6 +587,201 @@ bool ST7306Driver::is_initialized() const {
     return initialized_;
 }
 
+// ==================== 显示表面接口 ====================
+
+static_assert(hardware::display::is_display_surface_v<ST7306Driver>,
+              "ST7306Driver 必须实现显示表面接口");
+
+// 灰度值在一个缓冲区字节中的位：上行两列像素的 bit1 在第7/3位、bit0 在第5/1位 (下行各右移一位)
+static inline uint8_t grayPairBits(uint8_t color) {
+    return static_cast<uint8_t>(((color & 0x02) ? 0x88 : 0) | ((color & 0x01) ? 0x22 : 0));
+}
 
+uint16_t ST7306Driver::surfaceWidth() const {
+    return (rotation_ & 1) ? LCD_HEIGHT : LCD_WIDTH;
+}
+
+uint16_t ST7306Driver::surfaceHeight() const {
+    return (rotation_ & 1) ? LCD_WIDTH : LCD_HEIGHT;
+}
+
+void ST7306Driver::surfacePoint(uint16_t x, uint16_t y, uint8_t color) {
+    if (rotation_ == 0) {
+        writePointGray(x, y, color);
+    } else {
+        drawPixelGray(x, y, color);
+    }
+}
+
+void ST7306Driver::fillSpanRaw(uint16_t x, uint16_t y, uint16_t len, uint8_t color) {
+    // 一个字节包含相邻两列、相邻两行共4个像素，本行的两个像素占 0xAA（下行 0x55）
+    uint8_t shift = y & 1;
+    uint8_t row_mask = 0xAA >> shift;
+    uint8_t pair = grayPairBits(color) >> shift;
+    uint16_t end = x + len;
+    
+    if (x & 1) {
+        writePointGray(x, y, color);
+        x++;
+    }
+    if (x + 1 < end) {
+        markDirty(x / 2, (end - 1) / 2, y / 2, y / 2);
+    }
+    uint8_t* p = display_buffer_ + (y / 2) * LCD_DATA_WIDTH + x / 2;
+    for (; x + 1 < end; x += 2) {
+        *p = (*p & ~row_mask) | pair;
+        p++;
+    }
+    if (x < end) {
+        writePointGray(x, y, color);
+    }
+}
+
+void ST7306Driver::fillSpan(uint16_t x, uint16_t y, uint16_t len, Color color) {
+    fillRect(x, y, len, 1, color);
+}
+
+void ST7306Driver::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color color) {
+    if (!hardware::display::clip_rect(x, y, w, h, surfaceWidth(), surfaceHeight())) return;
+    
+    for (uint16_t row = 0; row < h; row++) {
+        if (rotation_ == 0) {
+            fillSpanRaw(x, y + row, w, color);
+        } else {
+            for (uint16_t col = 0; col < w; col++) {
+                drawPixelGray(x + col, y + row, color);
+            }
+        }
+    }
+}
+
+void ST7306Driver::blitMonoRowRaw(uint16_t x, uint16_t y, uint16_t w, const uint8_t* src,
+                                  uint8_t fg, uint8_t bg, bool opaque) {
+    // 按缓冲区字节合成：每字节含本行相邻两列，偶数列在高半字节 (0xA0)，奇数列在低半字节 (0x0A)
+    uint8_t shift = y & 1;
+    uint8_t fg_pair = grayPairBits(fg) >> shift;
+    uint8_t bg_pair = grayPairBits(bg) >> shift;
+    uint8_t* line = display_buffer_ + (y / 2) * LCD_DATA_WIDTH;
+    uint8_t first = LCD_DATA_WIDTH, last = 0;
+    uint16_t col = 0;
+    for (uint8_t byte = x / 2; col < w; byte++) {
+        uint8_t mask = 0;
+        uint8_t value = 0;
+        do {
+            uint8_t m = (((x + col) & 1) ? 0x0A : 0xA0) >> shift;
+            if (src[col >> 3] & (0x80 >> (col & 7))) {
+                mask |= m;
+                value |= fg_pair & m;
+            } else if (opaque) {
+                mask |= m;
+                value |= bg_pair & m;
+            }
+            col++;
+        } while (col < w && ((x + col) & 1));
+        if (mask) {
+            line[byte] = (line[byte] & ~mask) | value;
+            if (first == LCD_DATA_WIDTH) first = byte;
+            last = byte;
+        }
+    }
+    if (first <= last) {
+        markDirty(first, last, y / 2, y / 2);
+    }
+}
+
+void ST7306Driver::blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                            const uint8_t* bits, uint16_t stride, Color fg, Color bg) {
+    if (!hardware::display::clip_rect(x, y, w, h, surfaceWidth(), surfaceHeight())) return;
+    
+    for (uint16_t row = 0; row < h; row++) {
+        const uint8_t* src = bits + row * stride;
+        if (rotation_ == 0) {
+            blitMonoRowRaw(x, y + row, w, src, fg, bg, true);
+            continue;
+        }
+        for (uint16_t col = 0; col < w; col++) {
+            drawPixelGray(x + col, y + row, (src[col >> 3] & (0x80 >> (col & 7))) ? fg : bg);
+        }
+    }
+}
+
+void ST7306Driver::blitMono(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                            const uint8_t* bits, uint16_t stride, Color fg) {
+    if (!hardware::display::clip_rect(x, y, w, h, surfaceWidth(), surfaceHeight())) return;
+    
+    for (uint16_t row = 0; row < h; row++) {
+        const uint8_t* src = bits + row * stride;
+        if (rotation_ == 0) {
+            blitMonoRowRaw(x, y + row, w, src, fg, fg, false);
+            continue;
+        }
+        for (uint16_t col = 0; col < w; col++) {
+            if (src[col >> 3] & (0x80 >> (col & 7))) {
+                drawPixelGray(x + col, y + row, fg);
+            }
+        }
+    }
+}
+
+void ST7306Driver::writeWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Color* pixels) {
+    uint16_t full_w = w;
+    if (!hardware::display::clip_rect(x, y, w, h, surfaceWidth(), surfaceHeight())) return;
+    
+    for (uint16_t row = 0; row < h; row++) {
+        const Color* src = pixels + row * full_w;
+        for (uint16_t col = 0; col < w; col++) {
+            surfacePoint(x + col, y + row, src[col]);
+        }
+    }
+}
+
+void ST7306Driver::flushRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (dirty_col0_ > dirty_col1_) return;
+    if (!hardware::display::clip_rect(x, y, w, h, surfaceWidth(), surfaceHeight())) return;
+
+    // 逻辑矩形换算为面板像素矩形（与 drawPixelGray 的旋转一致，含端点）
+    uint16_t x0 = x, x1 = x + w - 1, y0 = y, y1 = y + h - 1;
+    switch (rotation_) {
+        case 1:
+            x0 = LCD_WIDTH - 1 - (y + h - 1);
+            x1 = LCD_WIDTH - 1 - y;
+            y0 = x;
+            y1 = x + w - 1;
+            break;
+        case 2:
+            x0 = LCD_WIDTH - 1 - (x + w - 1);
+            x1 = LCD_WIDTH - 1 - x;
+            y0 = LCD_HEIGHT - 1 - (y + h - 1);
+            y1 = LCD_HEIGHT - 1 - y;
+            break;
+        case 3:
+            x0 = y;
+            x1 = y + h - 1;
+            y0 = LCD_HEIGHT - 1 - (x + w - 1);
+            y1 = LCD_HEIGHT - 1 - x;
+            break;
+        default:
+            break;
+    }
+
+    // 只推送区域与改动矩形的交集（缓冲区单位）
+    uint8_t col0 = std::max<uint8_t>(x0 / 2, dirty_col0_);
+    uint8_t col1 = std::min<uint8_t>(x1 / 2, dirty_col1_);
+    uint8_t row0 = std::max<uint8_t>(y0 / 2, dirty_row0_);
+    uint8_t row1 = std::min<uint8_t>(y1 / 2, dirty_row1_);
+    if (col0 > col1 || row0 > row1) return;
+    pushWindow(col0, col1, row0, row1);
+
+    // 推送的窗口按列地址对齐；改动矩形全部落在其中时才清除，否则留待下一次推送
+    uint8_t pushed_col0 = col0 / BYTES_PER_COLUMN_ADDRESS * BYTES_PER_COLUMN_ADDRESS;
+    uint8_t pushed_col1 = col1 / BYTES_PER_COLUMN_ADDRESS * BYTES_PER_COLUMN_ADDRESS + BYTES_PER_COLUMN_ADDRESS - 1;
+    if (pushed_col0 <= dirty_col0_ && pushed_col1 >= dirty_col1_ &&
+        row0 <= dirty_row0_ && row1 >= dirty_row1_) {
+        dirty_col0_ = LCD_DATA_WIDTH;
+        dirty_col1_ = 0;
+        dirty_row0_ = LCD_DATA_HEIGHT;
+        dirty_row1_ = 0;
+    }
+}
 
-} // namespace st7306 
\ No newline at end of file
+} // namespace st7306
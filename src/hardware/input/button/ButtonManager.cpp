@@ -26,7 +26,11 @@ ButtonManager::ButtonManager()
       page_down_press_start_time_(0),
       page_up_long_press_handled_(false),
       page_down_long_press_handled_(false),
-      pending_event_(ButtonManagerEvent::NONE) {
+      pending_event_(ButtonManagerEvent::NONE),
+      edge_irq_(false),
+      screen_power_edges_(BUTTON_DEBOUNCE_TIME, NEW_BUTTON_LONG_PRESS_MS),
+      page_up_edges_(BUTTON_DEBOUNCE_TIME, NEW_BUTTON_LONG_PRESS_MS),
+      page_down_edges_(BUTTON_DEBOUNCE_TIME, NEW_BUTTON_LONG_PRESS_MS) {
 }
 
 bool ButtonManager::initialize() {
@@ -51,11 +55,21 @@ bool ButtonManager::initialize() {
     last_page_up_state_ = readButtonState(page_up_pin_);
     last_page_down_state_ = readButtonState(page_down_pin_);
     
+#if BUTTON_USE_EDGE_IRQ
+    edge_irq_ = ButtonEdgeCapture::attach((1u << screen_power_pin_) | (1u << page_up_pin_) |
+                                          (1u << page_down_pin_));
+    uint32_t now_us = time_us_32();
+    screen_power_edges_.reset(last_screen_power_state_, now_us);
+    page_up_edges_.reset(last_page_up_state_, now_us);
+    page_down_edges_.reset(last_page_down_state_, now_us);
+#endif
+    
     printf("[ButtonManager] 按键配置:\n");
     printf("  屏幕开关按键: GPIO%d\n", screen_power_pin_);
     printf("  翻页上按键:   GPIO%d\n", page_up_pin_);
     printf("  翻页下按键:   GPIO%d\n", page_down_pin_);
     printf("  防抖时间:     %lu ms\n", debounce_time_ms_);
+    printf("  输入方式:     %s\n", edge_irq_ ? "边沿中断" : "轮询");
     
     printf("[ButtonManager] 初始状态:\n");
     printf("  屏幕开关: %s\n", last_screen_power_state_ ? "按下" : "释放");
@@ -67,6 +81,11 @@ bool ButtonManager::initialize() {
 }
 
 void ButtonManager::update() {
+    if (edge_irq_) {
+        updateFromEdges();
+        return;
+    }
+    
     uint32_t current_time = to_ms_since_boot(get_absolute_time());
     
     // 如果已有待处理事件，不处理新事件（避免事件丢失）
@@ -154,6 +173,84 @@ void ButtonManager::update() {
     last_page_down_state_ = current_page_down;
 }
 
+void ButtonManager::updateFromEdges() {
+    // 一次只产生一个事件；尚未处理的边沿留在FIFO中，不会丢失
+    if (pending_event_ != ButtonManagerEvent::NONE || takeGesture()) {
+        return;
+    }
+    
+    ButtonEdge edge;
+    uint32_t now_us;
+    while (true) {
+        // 先取时间再查FIFO：此后到达的边沿时间戳都不早于now_us
+        now_us = time_us_32();
+        if (!ButtonEdgeCapture::pop(edge)) {
+            break;
+        }
+        bool pressed = edge.pressed();
+        if (edge.pin == screen_power_pin_) {
+            screen_power_edges_.push(pressed, edge.time_us);
+        } else if (edge.pin == page_up_pin_) {
+            page_up_edges_.push(pressed, edge.time_us);
+        } else if (edge.pin == page_down_pin_) {
+            page_down_edges_.push(pressed, edge.time_us);
+        }
+        if (takeGesture()) {
+            return;
+        }
+    }
+    
+    screen_power_edges_.poll(now_us);
+    page_up_edges_.poll(now_us);
+    page_down_edges_.poll(now_us);
+    takeGesture();
+    
+    last_screen_power_state_ = screen_power_edges_.is_pressed();
+    last_page_up_state_ = page_up_edges_.is_pressed();
+    last_page_down_state_ = page_down_edges_.is_pressed();
+}
+
+bool ButtonManager::takeGesture() {
+    ButtonGesture gesture;
+    
+    // 屏幕开关按键（只支持短按，按下即触发）
+    while (screen_power_edges_.pop(gesture)) {
+        if (gesture.type == ButtonGesture::PRESS) {
+            printf("[ButtonManager] 屏幕开关按键按下\n");
+            pending_event_ = ButtonManagerEvent::SCREEN_POWER_TOGGLE;
+            return true;
+        }
+    }
+    
+    while (page_up_edges_.pop(gesture)) {
+        if (gesture.type == ButtonGesture::CLICK) {
+            printf("[ButtonManager] 翻页上按键短按触发 (持续时间: %lu ms)\n", gesture.duration_us / 1000);
+            pending_event_ = ButtonManagerEvent::PAGE_UP;
+            return true;
+        }
+        if (gesture.type == ButtonGesture::LONG_PRESS) {
+            printf("[ButtonManager] 翻页上按键长按触发 (持续时间: %lu ms)\n", gesture.duration_us / 1000);
+            pending_event_ = ButtonManagerEvent::PAGE_UP_LONG;
+            return true;
+        }
+    }
+    
+    while (page_down_edges_.pop(gesture)) {
+        if (gesture.type == ButtonGesture::CLICK) {
+            printf("[ButtonManager] 翻页下按键短按触发 (持续时间: %lu ms)\n", gesture.duration_us / 1000);
+            pending_event_ = ButtonManagerEvent::PAGE_DOWN;
+            return true;
+        }
+        if (gesture.type == ButtonGesture::LONG_PRESS) {
+            printf("[ButtonManager] 翻页下按键长按触发 (持续时间: %lu ms)\n", gesture.duration_us / 1000);
+            pending_event_ = ButtonManagerEvent::PAGE_DOWN_LONG;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
 ButtonManagerEvent ButtonManager::getNextEvent() {
     ButtonManagerEvent event = pending_event_;
     pending_event_ = ButtonManagerEvent::NONE; // 清除事件
@@ -16,8 +16,13 @@ ButtonSystemAdapter::ButtonSystemAdapter(JoystickController* joystick_controller
       current_app_mode_(AppMode::MAIN_MENU),
       last_joystick_direction_(JoystickDirection::NONE),
       last_joystick_button_(ButtonState::RELEASED),
+      last_joystick_event_(UnifiedInputEvent::NONE),
       last_event_time_(0),
       repeat_delay_ms_(200) { // 默认200ms防连发
+    events_.set_coalescing(UnifiedInputEvent::PAGE_PREVIOUS, true);
+    events_.set_coalescing(UnifiedInputEvent::PAGE_NEXT, true);
+    events_.set_coalescing(UnifiedInputEvent::NAVIGATE_UP, true);
+    events_.set_coalescing(UnifiedInputEvent::NAVIGATE_DOWN, true);
 }
 
 bool ButtonSystemAdapter::initialize() {
@@ -29,17 +34,13 @@ bool ButtonSystemAdapter::initialize() {
         return false;
     }
     
-    // 设置按键事件回调
-    button_manager_->set_event_callback([this](EnhancedButtonEvent event) {
-        handle_button_event(event);
-    });
-    
     // 设置初始应用模式
     button_manager_->set_app_mode(current_app_mode_);
     
     printf("[ButtonSystemAdapter] 初始化完成\n");
     printf("  摇杆控制器: %s\n", joystick_controller_ ? "已连接" : "未连接");
-    printf("  防连发延迟: %lu ms\n", repeat_delay_ms_);
+    printf("  防连发延迟: %lu ms (摇杆)\n", repeat_delay_ms_);
+    printf("  事件队列:   %u\n", static_cast<unsigned>(EventQueue::capacity()));
     
     return true;
 }
@@ -55,7 +56,11 @@ void ButtonSystemAdapter::set_app_mode(AppMode mode) {
         // 重置状态，避免模式切换时的误操作
         last_joystick_direction_ = JoystickDirection::NONE;
         last_joystick_button_ = ButtonState::RELEASED;
+        last_joystick_event_ = UnifiedInputEvent::NONE;
         last_event_time_ = 0;
+        
+        // 旧模式下排队的事件在新模式中含义不同
+        events_.clear();
     }
 }
 
@@ -64,49 +69,70 @@ void ButtonSystemAdapter::set_event_callback(std::function<void(UnifiedInputEven
 }
 
 void ButtonSystemAdapter::update() {
-    // 更新增强按键管理器
+    // 更新增强按键管理器，转发其排队的事件（保留来源和时间戳）
     button_manager_->update();
     
+    EnhancedButtonManager::EventEntry button_entry;
+    while (button_manager_->pop_event(button_entry)) {
+        handle_button_event(button_entry);
+    }
+    
     // 更新摇杆状态（如果可用）
     if (joystick_controller_) {
         joystick_controller_->update();
         
-        JoystickDirection current_direction = joystick_controller_->getCurrentDirection();
-        ButtonState current_button = joystick_controller_->getButtonState();
+        ::JoystickEvent joystick_event;
+        while (joystick_controller_->pollEvent(joystick_event)) {
+            handle_joystick_event(joystick_event);
+        }
+        last_joystick_direction_ = joystick_controller_->getCurrentDirection();
         
-        // 检查摇杆状态变化
-        if (current_direction != last_joystick_direction_ || 
-            current_button != last_joystick_button_) {
-            
-            handle_joystick_event(current_direction, current_button);
-            
-            last_joystick_direction_ = current_direction;
+        ButtonState current_button = joystick_controller_->getButtonState();
+        if (current_button != last_joystick_button_) {
+            handle_joystick_button(current_button, to_ms_since_boot(get_absolute_time()));
             last_joystick_button_ = current_button;
         }
     }
+    
+    // 设置了回调时逐个分发（兼容旧接口），否则留给 drain_events
+    if (event_callback_) {
+        EventEntry entry;
+        while (events_.pop(entry, false)) {
+            InputLatency::input_dispatched(entry.time_ms);
+            event_callback_(entry.type);
+        }
+    }
 }
 
-void ButtonSystemAdapter::handle_button_event(EnhancedButtonEvent button_event) {
-    if (button_event == EnhancedButtonEvent::NONE) {
+void ButtonSystemAdapter::handle_button_event(const EnhancedButtonManager::EventEntry& entry) {
+    if (entry.type == EnhancedButtonEvent::NONE) {
         return;
     }
     
-    UnifiedInputEvent unified_event = button_event_to_unified(button_event);
-    trigger_unified_event(unified_event);
+    UnifiedInputEvent unified_event = button_event_to_unified(entry.type);
+    trigger_unified_event(unified_event, entry.source, entry.time_ms);
 }
 
-void ButtonSystemAdapter::handle_joystick_event(JoystickDirection direction, ButtonState button_state) {
-    // 处理摇杆方向
-    if (direction != JoystickDirection::NONE && direction != last_joystick_direction_) {
-        UnifiedInputEvent unified_event = joystick_event_to_unified(direction, ButtonState::RELEASED);
-        trigger_unified_event(unified_event);
+void ButtonSystemAdapter::handle_joystick_event(const ::JoystickEvent& event) {
+    if (event.type == ::JoystickEvent::RELEASE) {
+        return;
     }
     
-    // 处理摇杆按钮
+    // 两个方向枚举取值一致
+    JoystickDirection direction = static_cast<JoystickDirection>(event.direction);
+    UnifiedInputEvent unified_event = joystick_event_to_unified(direction, ButtonState::RELEASED);
+    
+    // 连发由引擎按加速节奏产生，不经过防连发限制
+    if (event.type == ::JoystickEvent::REPEAT || can_trigger_joystick_event(unified_event, event.time_ms)) {
+        trigger_unified_event(unified_event, InputSource::JOYSTICK, event.time_ms);
+    }
+}
+
+void ButtonSystemAdapter::handle_joystick_button(ButtonState button_state, uint32_t time_ms) {
     if (button_state == ButtonState::PRESSED && last_joystick_button_ == ButtonState::RELEASED) {
         // 摇杆按钮刚按下
         UnifiedInputEvent unified_event = joystick_event_to_unified(JoystickDirection::NONE, button_state);
-        trigger_unified_event(unified_event);
+        trigger_unified_event(unified_event, InputSource::JOYSTICK_BUTTON, time_ms);
     }
 }
 
@@ -170,33 +196,30 @@ UnifiedInputEvent ButtonSystemAdapter::joystick_event_to_unified(JoystickDirecti
     return UnifiedInputEvent::NONE;
 }
 
-void ButtonSystemAdapter::trigger_unified_event(UnifiedInputEvent event) {
+void ButtonSystemAdapter::trigger_unified_event(UnifiedInputEvent event, InputSource source, uint32_t time_ms) {
     if (event == UnifiedInputEvent::NONE) {
         return;
     }
     
-    // 防连发检查
-    if (!can_trigger_event()) {
-        return;
-    }
-    
-    // 更新最后事件时间
-    last_event_time_ = to_ms_since_boot(get_absolute_time());
-    
     #if BUTTON_DEBUG_ENABLED
     printf("[ButtonSystemAdapter] 触发统一事件: %s (模式: %s)\n", 
            get_unified_event_name(event), get_app_mode_name(current_app_mode_));
     #endif
     
-    // 调用回调函数
-    if (event_callback_) {
-        event_callback_(event);
+    if (!events_.push(event, source, time_ms)) {
+        printf("[ButtonSystemAdapter] 事件队列已满，丢弃 %s (累计 %lu)\n",
+               get_unified_event_name(event), (unsigned long)events_.overflow_count());
     }
 }
 
-bool ButtonSystemAdapter::can_trigger_event() {
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
-    return (current_time - last_event_time_) >= repeat_delay_ms_;
+bool ButtonSystemAdapter::can_trigger_joystick_event(UnifiedInputEvent event, uint32_t time_ms) {
+    // 按键已在管理器中防抖；这里只抑制摇杆在回中抖动时重复产生的同一事件
+    if (event == last_joystick_event_ && (time_ms - last_event_time_) < repeat_delay_ms_) {
+        return false;
+    }
+    last_joystick_event_ = event;
+    last_event_time_ = time_ms;
+    return true;
 }
 
 // === 便利函数实现 ===
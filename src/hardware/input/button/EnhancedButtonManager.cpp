@@ -18,15 +18,24 @@ EnhancedButtonManager::EnhancedButtonManager()
       debounce_time_ms_(BUTTON_DEBOUNCE_TIME),
       long_press_ms_(NEW_BUTTON_LONG_PRESS_MS), // 使用300ms
       current_mode_(AppMode::MAIN_MENU),
-      pending_event_(EnhancedButtonEvent::NONE) {
+      edge_irq_(false),
+      up_edges_(BUTTON_DEBOUNCE_TIME, NEW_BUTTON_LONG_PRESS_MS),
+      down_edges_(BUTTON_DEBOUNCE_TIME, NEW_BUTTON_LONG_PRESS_MS),
+      screen_edges_(BUTTON_DEBOUNCE_TIME, NEW_BUTTON_LONG_PRESS_MS) {
     
     // 初始化按键状态
-    memset(&up_button_, 0, sizeof(ButtonState));
-    memset(&down_button_, 0, sizeof(ButtonState));
-    memset(&screen_button_, 0, sizeof(ButtonState));
+    memset(&up_button_, 0, sizeof(ButtonTrackState));
+    memset(&down_button_, 0, sizeof(ButtonTrackState));
+    memset(&screen_button_, 0, sizeof(ButtonTrackState));
     
     // 设置默认映射
     current_mapping_ = get_button_mapping(current_mode_);
+    
+    // 翻页/导航可合并：渲染跟不上时一次处理N步
+    events_.set_coalescing(EnhancedButtonEvent::PAGE_UP, true);
+    events_.set_coalescing(EnhancedButtonEvent::PAGE_DOWN, true);
+    events_.set_coalescing(EnhancedButtonEvent::NAV_UP, true);
+    events_.set_coalescing(EnhancedButtonEvent::NAV_DOWN, true);
 }
 
 bool EnhancedButtonManager::initialize() {
@@ -52,12 +61,21 @@ bool EnhancedButtonManager::initialize() {
     down_button_.last_pressed = read_button_gpio(down_pin_);
     screen_button_.last_pressed = read_button_gpio(screen_pin_);
     
+#if BUTTON_USE_EDGE_IRQ
+    edge_irq_ = ButtonEdgeCapture::attach((1u << up_pin_) | (1u << down_pin_) | (1u << screen_pin_));
+    uint32_t now_us = time_us_32();
+    up_edges_.reset(up_button_.last_pressed, now_us);
+    down_edges_.reset(down_button_.last_pressed, now_us);
+    screen_edges_.reset(screen_button_.last_pressed, now_us);
+#endif
+    
     printf("[EnhancedButtonManager] 引脚配置:\n");
     printf("  上键 (GPIO%d): %s\n", up_pin_, up_button_.last_pressed ? "按下" : "释放");
     printf("  下键 (GPIO%d): %s\n", down_pin_, down_button_.last_pressed ? "按下" : "释放");
     printf("  屏幕键 (GPIO%d): %s\n", screen_pin_, screen_button_.last_pressed ? "按下" : "释放");
     printf("  长按阈值: %lu ms\n", long_press_ms_);
     printf("  防抖时间: %lu ms\n", debounce_time_ms_);
+    printf("  输入方式: %s\n", edge_irq_ ? "边沿中断" : "轮询");
     printf("[EnhancedButtonManager] 初始化完成\n");
     
     return true;
@@ -86,6 +104,11 @@ void EnhancedButtonManager::set_event_callback(std::function<void(EnhancedButton
 }
 
 void EnhancedButtonManager::update() {
+    if (edge_irq_) {
+        update_from_edges();
+        return;
+    }
+    
     uint32_t current_time = to_ms_since_boot(get_absolute_time());
     
     // 更新各按键状态
@@ -97,22 +120,24 @@ void EnhancedButtonManager::update() {
     process_button_event(up_button_, 
                         current_mapping_.single_press_up,
                         current_mapping_.long_press_up,
+                        InputSource::BUTTON_UP,
                         current_time);
     
     // 处理下键事件
     process_button_event(down_button_, 
                         current_mapping_.single_press_down,
                         current_mapping_.long_press_down,
+                        InputSource::BUTTON_DOWN,
                         current_time);
     
     // 处理屏幕键事件（只支持短按）
     if (screen_button_.pressed && !screen_button_.last_pressed) {
         // 屏幕键按下
-        trigger_event(function_to_event(current_mapping_.screen_press));
+        trigger_event(function_to_event(current_mapping_.screen_press), InputSource::BUTTON_SCREEN, current_time);
     }
 }
 
-void EnhancedButtonManager::update_button_state(ButtonState& button, uint8_t pin, uint32_t current_time) {
+void EnhancedButtonManager::update_button_state(ButtonTrackState& button, uint8_t pin, uint32_t current_time) {
     bool current_pressed = read_button_gpio(pin);
     
     // 检测按键状态变化
@@ -148,9 +173,10 @@ void EnhancedButtonManager::update_button_state(ButtonState& button, uint8_t pin
     button.last_pressed = current_pressed;
 }
 
-void EnhancedButtonManager::process_button_event(const ButtonState& button, 
+void EnhancedButtonManager::process_button_event(const ButtonTrackState& button, 
                                                 ButtonFunction single_function,
                                                 ButtonFunction long_function,
+                                                InputSource source,
                                                 uint32_t current_time) {
     
     if (button.pressed) {
@@ -159,9 +185,9 @@ void EnhancedButtonManager::process_button_event(const ButtonState& button,
         
         if (!button.long_press_handled && press_duration >= long_press_ms_) {
             // 触发长按事件
-            trigger_event(function_to_event(long_function));
+            trigger_event(function_to_event(long_function), source, current_time);
             // 标记长按已处理，避免重复触发
-            const_cast<ButtonState&>(button).long_press_handled = true;
+            const_cast<ButtonTrackState&>(button).long_press_handled = true;
             
             #if BUTTON_DEBUG_ENABLED
             printf("[EnhancedButtonManager] 长按触发 - 持续时间: %lu ms\n", press_duration);
@@ -174,7 +200,7 @@ void EnhancedButtonManager::process_button_event(const ButtonState& button,
         
         if (!button.long_press_handled && press_duration < long_press_ms_) {
             // 触发短按事件
-            trigger_event(function_to_event(single_function));
+            trigger_event(function_to_event(single_function), source, current_time);
             
             #if BUTTON_DEBUG_ENABLED
             printf("[EnhancedButtonManager] 短按触发 - 持续时间: %lu ms\n", press_duration);
@@ -183,6 +209,79 @@ void EnhancedButtonManager::process_button_event(const ButtonState& button,
     }
 }
 
+void EnhancedButtonManager::update_from_edges() {
+    ButtonEdge edge;
+    uint32_t now_us;
+    while (true) {
+        // 先取时间再查FIFO：此后到达的边沿时间戳都不早于now_us
+        now_us = time_us_32();
+        if (!ButtonEdgeCapture::pop(edge)) {
+            break;
+        }
+        // 先把三个按键都推进到该边沿的时间，主循环停顿时不同按键的事件也按发生顺序入队
+        settle_edges(edge.time_us);
+        bool pressed = edge.pressed();
+        if (edge.pin == up_pin_) {
+            up_edges_.push(pressed, edge.time_us);
+        } else if (edge.pin == down_pin_) {
+            down_edges_.push(pressed, edge.time_us);
+        } else if (edge.pin == screen_pin_) {
+            screen_edges_.push(pressed, edge.time_us);
+        }
+    }
+    settle_edges(now_us);
+    
+    up_button_.pressed = up_edges_.is_pressed();
+    down_button_.pressed = down_edges_.is_pressed();
+    screen_button_.pressed = screen_edges_.is_pressed();
+}
+
+void EnhancedButtonManager::settle_edges(uint32_t time_us) {
+    up_edges_.poll(time_us);
+    down_edges_.poll(time_us);
+    screen_edges_.poll(time_us);
+    dispatch_gestures(up_edges_, current_mapping_.single_press_up, current_mapping_.long_press_up,
+                      InputSource::BUTTON_UP, false);
+    dispatch_gestures(down_edges_, current_mapping_.single_press_down, current_mapping_.long_press_down,
+                      InputSource::BUTTON_DOWN, false);
+    dispatch_gestures(screen_edges_, current_mapping_.screen_press, ButtonFunction::NONE,
+                      InputSource::BUTTON_SCREEN, true);
+}
+
+void EnhancedButtonManager::dispatch_gestures(EdgeDebouncer& edges,
+                                              ButtonFunction single_function,
+                                              ButtonFunction long_function,
+                                              InputSource source,
+                                              bool press_only) {
+    ButtonGesture gesture;
+    while (edges.pop(gesture)) {
+        // 事件时间取手势的边沿时间戳，而不是主循环取到它的时间
+        uint32_t time_ms = edge_time_to_ms(gesture.time_us);
+        switch (gesture.type) {
+            case ButtonGesture::PRESS:
+                if (press_only) {
+                    trigger_event(function_to_event(single_function), source, time_ms);
+                }
+                break;
+            case ButtonGesture::CLICK:
+                if (!press_only) {
+                    trigger_event(function_to_event(single_function), source, time_ms);
+                }
+                break;
+            case ButtonGesture::LONG_PRESS:
+                trigger_event(function_to_event(long_function), source, time_ms);
+                break;
+            case ButtonGesture::RELEASE:
+                break;
+        }
+        
+        #if BUTTON_DEBUG_ENABLED
+        printf("[EnhancedButtonManager] 手势 %d - 时间: %lu ms, 持续: %lu ms\n",
+               static_cast<int>(gesture.type), gesture.time_us / 1000, gesture.duration_us / 1000);
+        #endif
+    }
+}
+
 EnhancedButtonEvent EnhancedButtonManager::function_to_event(ButtonFunction function) {
     switch (function) {
         case ButtonFunction::NAV_UP:
@@ -210,13 +309,13 @@ EnhancedButtonEvent EnhancedButtonManager::function_to_event(ButtonFunction func
     }
 }
 
-void EnhancedButtonManager::trigger_event(EnhancedButtonEvent event) {
+void EnhancedButtonManager::trigger_event(EnhancedButtonEvent event, InputSource source, uint32_t time_ms) {
     if (event != EnhancedButtonEvent::NONE) {
-        pending_event_ = event;
-        
-        // 如果设置了回调函数，立即调用
+        // 设置了回调函数时立即调用，否则排队等待 get_next_event/drain_events
         if (event_callback_) {
             event_callback_(event);
+        } else if (!events_.push(event, source, time_ms)) {
+            printf("[EnhancedButtonManager] 事件队列已满，丢弃事件 %d\n", static_cast<int>(event));
         }
         
         #if BUTTON_DEBUG_ENABLED
@@ -227,17 +326,19 @@ void EnhancedButtonManager::trigger_event(EnhancedButtonEvent event) {
 }
 
 EnhancedButtonEvent EnhancedButtonManager::get_next_event() {
-    EnhancedButtonEvent event = pending_event_;
-    pending_event_ = EnhancedButtonEvent::NONE;
-    return event;
+    EventEntry entry;
+    if (!events_.pop(entry, false)) {
+        return EnhancedButtonEvent::NONE;
+    }
+    return entry.type;
 }
 
 bool EnhancedButtonManager::has_event() const {
-    return pending_event_ != EnhancedButtonEvent::NONE;
+    return !events_.empty();
 }
 
 void EnhancedButtonManager::clear_events() {
-    pending_event_ = EnhancedButtonEvent::NONE;
+    events_.clear();
 }
 
 bool EnhancedButtonManager::read_button_gpio(uint8_t pin) {
@@ -248,12 +349,13 @@ bool EnhancedButtonManager::read_button_gpio(uint8_t pin) {
 const char* EnhancedButtonManager::get_debug_info() const {
     static char debug_buffer[256];
     snprintf(debug_buffer, sizeof(debug_buffer),
-             "Mode: %d, Up: %s, Down: %s, Screen: %s, Event: %d",
+             "Mode: %d, Up: %s, Down: %s, Screen: %s, Queued: %u, Overflows: %lu",
              static_cast<int>(current_mode_),
              up_button_.pressed ? "按下" : "释放",
              down_button_.pressed ? "按下" : "释放", 
              screen_button_.pressed ? "按下" : "释放",
-             static_cast<int>(pending_event_));
+             static_cast<unsigned>(events_.size()),
+             (unsigned long)events_.overflow_count());
     return debug_buffer;
 }
 
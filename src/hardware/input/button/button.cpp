@@ -21,7 +21,10 @@ ButtonController::ButtonController(uint8_t key1_pin, uint8_t key2_pin,
     , debounce_time_ms_(debounce_ms)
     , key1_last_change_(0)
     , key2_last_change_(0)
-    , led_enabled_(led_pin != 255) {
+    , led_enabled_(led_pin != 255)
+    , edge_irq_(false)
+    , key1_edges_(debounce_ms)
+    , key2_edges_(debounce_ms) {
 }
 
 bool ButtonController::initialize() {
@@ -61,15 +64,28 @@ bool ButtonController::initialize() {
     key1_last_state_ = key1_state_;
     key2_last_state_ = key2_state_;
     
+#if BUTTON_USE_EDGE_IRQ
+    edge_irq_ = hardware::input::ButtonEdgeCapture::attach((1u << key1_pin_) | (1u << key2_pin_));
+    uint32_t now_us = time_us_32();
+    key1_edges_.reset(key1_state_ == ButtonState::PRESSED, now_us);
+    key2_edges_.reset(key2_state_ == ButtonState::PRESSED, now_us);
+#endif
+    
     printf("[Button] 初始状态: KEY1=%s, KEY2=%s\n", 
            state_to_string(key1_state_), state_to_string(key2_state_));
     printf("[Button] 防抖时间: %lu ms\n", debounce_time_ms_);
+    printf("[Button] 输入方式: %s\n", edge_irq_ ? "边沿中断" : "轮询");
     printf("[Button] 按键控制器初始化完成\n");
     
     return true;
 }
 
 void ButtonController::update() {
+    if (edge_irq_) {
+        update_from_edges();
+        return;
+    }
+    
     // 读取当前GPIO状态
     ButtonState key1_current = read_button_state(key1_pin_);
     ButtonState key2_current = read_button_state(key2_pin_);
@@ -97,6 +113,58 @@ void ButtonController::update() {
     key2_last_state_ = key2_current;
 }
 
+void ButtonController::update_from_edges() {
+    using hardware::input::ButtonEdge;
+    using hardware::input::ButtonEdgeCapture;
+    
+    key1_last_state_ = key1_state_;
+    key2_last_state_ = key2_state_;
+    
+    // 上次留下的手势优先；某个按键状态变化后停止消费，其余边沿留在FIFO中
+    bool changed = apply_gesture(key1_edges_, key1_state_, "KEY1");
+    changed |= apply_gesture(key2_edges_, key2_state_, "KEY2");
+    
+    ButtonEdge edge;
+    while (!changed) {
+        // 先取时间再查FIFO：此后到达的边沿时间戳都不早于now_us
+        uint32_t now_us = time_us_32();
+        if (!ButtonEdgeCapture::pop(edge)) {
+            key1_edges_.poll(now_us);
+            key2_edges_.poll(now_us);
+            apply_gesture(key1_edges_, key1_state_, "KEY1");
+            apply_gesture(key2_edges_, key2_state_, "KEY2");
+            break;
+        }
+        bool pressed = edge.pressed();
+        if (edge.pin == key1_pin_) {
+            key1_edges_.push(pressed, edge.time_us);
+            changed = apply_gesture(key1_edges_, key1_state_, "KEY1");
+        } else if (edge.pin == key2_pin_) {
+            key2_edges_.push(pressed, edge.time_us);
+            changed = apply_gesture(key2_edges_, key2_state_, "KEY2");
+        }
+    }
+}
+
+bool ButtonController::apply_gesture(hardware::input::EdgeDebouncer& edges, ButtonState& state,
+                                     const char* name) {
+    using hardware::input::ButtonGesture;
+    
+    ButtonGesture gesture;
+    while (edges.pop(gesture)) {
+        if (gesture.type == ButtonGesture::PRESS) {
+            printf("[Button] %s 按下\n", name);
+            state = ButtonState::PRESSED;
+            return true;
+        }
+        if (gesture.type == ButtonGesture::CLICK || gesture.type == ButtonGesture::RELEASE) {
+            state = ButtonState::RELEASED;
+            return true;
+        }
+    }
+    return false;
+}
+
 ButtonEvent ButtonController::get_key1_event() const {
     if (key1_state_ == ButtonState::PRESSED && key1_last_state_ == ButtonState::RELEASED) {
         return ButtonEvent::PRESS;
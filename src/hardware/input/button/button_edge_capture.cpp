@@ -0,0 +1,176 @@
+/**
+ * @file button_edge_capture.cpp
+ * @brief 按键边沿中断采样实现
+ * @version 1.0.0
+ */
+
+#include "hardware/input/button/button_edge_capture.hpp"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+namespace hardware {
+namespace input {
+
+static_assert((BUTTON_EDGE_FIFO_SIZE & (BUTTON_EDGE_FIFO_SIZE - 1)) == 0,
+              "BUTTON_EDGE_FIFO_SIZE 必须是2的幂");
+
+static constexpr uint32_t EDGE_EVENTS = GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE;
+
+ButtonEdge ButtonEdgeCapture::fifo_[BUTTON_EDGE_FIFO_SIZE];
+volatile uint32_t ButtonEdgeCapture::head_ = 0;
+volatile uint32_t ButtonEdgeCapture::tail_ = 0;
+volatile uint32_t ButtonEdgeCapture::dropped_ = 0;
+uint32_t ButtonEdgeCapture::pin_mask_ = 0;
+
+bool ButtonEdgeCapture::attach(uint32_t pin_mask) {
+    uint32_t new_pins = pin_mask & ~pin_mask_;
+    if (new_pins == 0) {
+        return true;
+    }
+
+    // 原始中断处理函数按引脚掩码登记（不占用SDK唯一的GPIO回调），追加引脚时重新登记
+    if (pin_mask_) {
+        gpio_remove_raw_irq_handler_masked(pin_mask_, &irq_handler);
+    }
+    pin_mask_ |= new_pins;
+    gpio_add_raw_irq_handler_masked(pin_mask_, &irq_handler);
+
+    for (uint pin = 0; pin < 32; pin++) {
+        if (new_pins & (1u << pin)) {
+            gpio_acknowledge_irq(pin, EDGE_EVENTS);     // 丢弃初始化期间锁存的边沿
+            gpio_set_irq_enabled(pin, EDGE_EVENTS, true);
+        }
+    }
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    printf("[ButtonIRQ] 边沿中断已启用: 引脚掩码 0x%08lx, FIFO %d\n",
+           (unsigned long)pin_mask_, BUTTON_EDGE_FIFO_SIZE);
+    return true;
+}
+
+void ButtonEdgeCapture::irq_handler() {
+    uint32_t now_us = time_us_32();
+    uint32_t pins = pin_mask_;
+    while (pins) {
+        uint pin = __builtin_ctz(pins);
+        pins &= pins - 1;
+
+        uint32_t events = gpio_get_irq_event_mask(pin) & EDGE_EVENTS;
+        if (!events) {
+            continue;
+        }
+        gpio_acknowledge_irq(pin, events);
+
+        // 两个边沿都已锁存（抖动快于中断响应）时以当前电平为准
+        bool level = events == GPIO_IRQ_EDGE_RISE ? true
+                   : events == GPIO_IRQ_EDGE_FALL ? false
+                   : gpio_get(pin);
+
+        uint32_t head = head_;
+        if (head - tail_ >= BUTTON_EDGE_FIFO_SIZE) {
+            dropped_ = dropped_ + 1;
+            continue;
+        }
+        fifo_[head & (BUTTON_EDGE_FIFO_SIZE - 1)] = ButtonEdge{now_us, static_cast<uint8_t>(pin), level};
+        __dmb();
+        head_ = head + 1;
+    }
+}
+
+bool ButtonEdgeCapture::pop(ButtonEdge& edge) {
+    uint32_t tail = tail_;
+    if (tail == head_) {
+        return false;
+    }
+    __dmb();
+    edge = fifo_[tail & (BUTTON_EDGE_FIFO_SIZE - 1)];
+    __dmb();
+    tail_ = tail + 1;
+    return true;
+}
+
+// ==================== EdgeDebouncer ====================
+
+EdgeDebouncer::EdgeDebouncer(uint32_t debounce_ms, uint32_t long_press_ms)
+    : debounce_us_(debounce_ms * 1000),
+      long_press_us_(long_press_ms * 1000) {
+    reset(false, 0);
+}
+
+void EdgeDebouncer::reset(bool pressed, uint32_t now_us) {
+    stable_ = pressed;
+    raw_ = pressed;
+    burst_ = false;
+    burst_start_us_ = now_us;
+    last_edge_us_ = now_us;
+    press_us_ = now_us;
+    long_sent_ = pressed;   // 初始化时已按住的按键不产生长按
+    head_ = 0;
+    count_ = 0;
+}
+
+void EdgeDebouncer::emit(ButtonGesture::Type type, uint32_t time_us, uint32_t duration_us) {
+    if (count_ == QUEUE_SIZE) {
+        head_ = (head_ + 1) % QUEUE_SIZE;   // 队列满时丢弃最早的手势
+        count_--;
+    }
+    queue_[(head_ + count_) % QUEUE_SIZE] = ButtonGesture{type, time_us, duration_us};
+    count_++;
+}
+
+void EdgeDebouncer::settle(uint32_t now_us) {
+    if (burst_ && now_us - last_edge_us_ >= debounce_us_) {
+        burst_ = false;
+        if (raw_ != stable_) {
+            stable_ = raw_;
+            uint32_t t = burst_start_us_;
+            if (stable_) {
+                press_us_ = t;
+                long_sent_ = false;
+                emit(ButtonGesture::PRESS, t, 0);
+            } else {
+                uint32_t held = t - press_us_;
+                if (!long_sent_ && held >= long_press_us_) {
+                    long_sent_ = true;
+                    emit(ButtonGesture::LONG_PRESS, press_us_ + long_press_us_, long_press_us_);
+                }
+                emit(long_sent_ ? ButtonGesture::RELEASE : ButtonGesture::CLICK, t, held);
+            }
+        }
+    }
+
+    // 抖动串未确认前，按键至少按住到该串开始
+    uint32_t held_until = burst_ ? burst_start_us_ : now_us;
+    if (stable_ && !long_sent_ && held_until - press_us_ >= long_press_us_) {
+        long_sent_ = true;
+        emit(ButtonGesture::LONG_PRESS, press_us_ + long_press_us_, long_press_us_);
+    }
+}
+
+void EdgeDebouncer::push(bool pressed, uint32_t time_us) {
+    settle(time_us);
+    if (!burst_) {
+        burst_ = true;
+        burst_start_us_ = time_us;
+    }
+    raw_ = pressed;
+    last_edge_us_ = time_us;
+}
+
+void EdgeDebouncer::poll(uint32_t now_us) {
+    settle(now_us);
+}
+
+bool EdgeDebouncer::pop(ButtonGesture& gesture) {
+    if (count_ == 0) {
+        return false;
+    }
+    gesture = queue_[head_];
+    head_ = (head_ + 1) % QUEUE_SIZE;
+    count_--;
+    return true;
+}
+
+} // namespace input
+} // namespace hardware
@@ -0,0 +1,180 @@
+/**
+ * @file input_latency.cpp
+ * @brief 输入到显示延迟追踪实现
+ * @version 1.0.0
+ */
+
+#include "hardware/input/input_latency.hpp"
+#include <cstdio>
+
+namespace hardware {
+namespace input {
+
+// ==================== LatencyHistogram ====================
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        buckets_[i] = 0;
+    }
+    count_ = 0;
+    min_ = UINT32_MAX;
+    max_ = 0;
+    sum_ = 0;
+}
+
+int LatencyHistogram::bucket_of(uint32_t value_us) {
+    constexpr uint32_t SUB_COUNT = 1u << SUB_BITS;
+    if (value_us < SUB_COUNT) {
+        return static_cast<int>(value_us);
+    }
+    int exponent = 31 - __builtin_clz(value_us);
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    uint32_t mantissa = (value_us >> (exponent - SUB_BITS)) & (SUB_COUNT - 1);
+    return (exponent - SUB_BITS + 1) * SUB_COUNT + mantissa;
+}
+
+uint32_t LatencyHistogram::bucket_lower(int bucket) {
+    constexpr int SUB_COUNT = 1 << SUB_BITS;
+    if (bucket < SUB_COUNT) {
+        return static_cast<uint32_t>(bucket);
+    }
+    int exponent = bucket / SUB_COUNT + SUB_BITS - 1;
+    uint32_t mantissa = bucket % SUB_COUNT;
+    return (SUB_COUNT + mantissa) << (exponent - SUB_BITS);
+}
+
+void LatencyHistogram::record(uint32_t value_us) {
+    buckets_[bucket_of(value_us)]++;
+    count_++;
+    sum_ += value_us;
+    if (value_us < min_) {
+        min_ = value_us;
+    }
+    if (value_us > max_) {
+        max_ = value_us;
+    }
+}
+
+uint32_t LatencyHistogram::percentile(uint32_t percent) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    // 第 ceil(count * percent / 100) 个样本所在的桶
+    uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(count_) * percent + 99) / 100);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // 桶上界，不超过实际最大值
+            uint32_t upper = i + 1 < BUCKET_COUNT ? bucket_lower(i + 1) - 1 : max_;
+            return upper < max_ ? upper : max_;
+        }
+    }
+    return max_;
+}
+
+// ==================== InputLatency ====================
+
+LatencyHistogram InputLatency::histogram_;
+bool InputLatency::enabled_ = false;
+bool InputLatency::pending_ = false;
+uint32_t InputLatency::pending_us_ = 0;
+uint32_t InputLatency::expired_ = 0;
+uint32_t InputLatency::merged_ = 0;
+
+void InputLatency::set_enabled(bool enabled) {
+    enabled_ = enabled;
+    pending_ = false;
+    printf("[Latency] 延迟追踪%s\n", enabled ? "已开启" : "已关闭");
+}
+
+void InputLatency::reset() {
+    histogram_.reset();
+    pending_ = false;
+    expired_ = 0;
+    merged_ = 0;
+}
+
+void InputLatency::mark_input(uint32_t capture_ms) {
+    // 毫秒时间戳换算为 time_us_32 刻度（两者同在 2^32 us 处回绕）
+    uint32_t capture_us = capture_ms * 1000;
+    uint32_t now_us = time_us_32();
+
+    if (pending_ && now_us - pending_us_ > INPUT_LATENCY_TIMEOUT_MS * 1000u) {
+        expired_++;
+        pending_ = false;
+    }
+    if (pending_) {
+        merged_++;
+        return;
+    }
+    pending_ = true;
+    pending_us_ = capture_us;
+}
+
+void InputLatency::mark_frame(uint32_t now_us) {
+    if (!pending_) {
+        return;
+    }
+    pending_ = false;
+
+    uint32_t latency_us = now_us - pending_us_;
+    if (latency_us > INPUT_LATENCY_TIMEOUT_MS * 1000u) {
+        expired_++;
+        return;
+    }
+    histogram_.record(latency_us);
+}
+
+void InputLatency::print_report() {
+    const LatencyHistogram& h = histogram_;
+    printf("[Latency] 输入到显示: %lu 次 (合并 %lu, 超时 %lu)\n",
+           (unsigned long)h.count(), (unsigned long)merged_, (unsigned long)expired_);
+    if (h.count() == 0) {
+        return;
+    }
+    printf("[Latency] p50 %lu.%03lu ms  p95 %lu.%03lu ms  p99 %lu.%03lu ms\n",
+           (unsigned long)(h.percentile(50) / 1000), (unsigned long)(h.percentile(50) % 1000),
+           (unsigned long)(h.percentile(95) / 1000), (unsigned long)(h.percentile(95) % 1000),
+           (unsigned long)(h.percentile(99) / 1000), (unsigned long)(h.percentile(99) % 1000));
+    printf("[Latency] min %lu us  mean %lu us  max %lu us\n",
+           (unsigned long)h.min(), (unsigned long)h.mean(), (unsigned long)h.max());
+}
+
+bool InputLatency::poll_serial() {
+    bool handled = false;
+    for (;;) {
+        int c = getchar_timeout_us(0);
+        if (c == PICO_ERROR_TIMEOUT) {
+            return handled;
+        }
+        switch (c) {
+            case 'L':
+            case 'l':
+                print_report();
+                handled = true;
+                break;
+            case 'R':
+            case 'r':
+                reset();
+                printf("[Latency] 统计已清空\n");
+                handled = true;
+                break;
+            case 'T':
+            case 't':
+                set_enabled(!enabled_);
+                handled = true;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+} // namespace input
+} // namespace hardware
@@ -179,6 +179,24 @@ int16_t Joystick::get_joy_adc_12bits_offset_value_y(void)
     return value;
 }
 
+bool Joystick::read_sample(JoystickSample *sample)
+{
+    // X and Y offsets are adjacent little-endian int16 at 0x50/0x52
+    uint8_t data[4];
+    if (reg_read(_i2c_port, _addr, JOYSTICK_OFFSET_ADC_VALUE_12BITS_REG, data, 4) != 4) {
+        return false;
+    }
+    uint8_t button = 1;
+    if (reg_read(_i2c_port, _addr, JOYSTICK_BUTTON_REG, &button, 1) != 1) {
+        return false;
+    }
+
+    memcpy(&sample->offset_x, &data[0], 2);
+    memcpy(&sample->offset_y, &data[2], 2);
+    sample->button = button;
+    return true;
+}
+
 int8_t Joystick::get_joy_adc_8bits_offset_value_x(void)
 {
     int8_t value = 0;
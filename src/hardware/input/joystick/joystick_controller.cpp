@@ -1,28 +1,20 @@
 #include "hardware/input/joystick/joystick_controller.hpp"
-#include "config/UserConfigManager_ILI9488.hpp"
-#include <cmath>
 
 namespace hardware {
 namespace input {
 
 JoystickController::JoystickController(Joystick& joystick)
     : joystick_(joystick)
-    , threshold_(1800)
-    , stable_count_required_(3)
-    , previous_direction_(0)
-    , stable_count_(0)
-    , last_reported_direction_(0)
     , last_button_pressed_(false)
     , direction_callback_(nullptr)
     , button_callback_(nullptr)
-    , led_enabled_(true) {
+    , led_enabled_(true)
+    , led_color_(LED_COLOR_UNKNOWN) {
 }
 
 bool JoystickController::initialize() {
     // 初始化状态变量
-    previous_direction_ = 0;
-    stable_count_ = 0;
-    last_reported_direction_ = 0;
+    engine_.reset(to_ms_since_boot(get_absolute_time()));
     last_button_pressed_ = false;
     
     // 注意：LED设置将在软件初始化阶段从用户配置管理器获取
@@ -35,40 +27,34 @@ bool JoystickController::initialize() {
 }
 
 void JoystickController::update() {
-    // 获取ADC偏移值
-    int16_t offset_x = joystick_.get_joy_adc_12bits_offset_value_x();
-    int16_t offset_y = joystick_.get_joy_adc_12bits_offset_value_y();
-    
-    // 判断当前方向
-    JoystickDirection current_direction = determineDirection(offset_x, offset_y);
-    
-    // 稳定性检查
-    if (static_cast<int>(current_direction) == previous_direction_) {
-        stable_count_++;
-    } else {
-        stable_count_ = 0;
-        previous_direction_ = static_cast<int>(current_direction);
+    // 一次批量读取X/Y偏移值和按钮（两次I2C传输）；读取失败时保持上次状态
+    JoystickSample sample;
+    if (!joystick_.read_sample(&sample)) {
+        return;
     }
     
-    // 处理方向变化
-    if (stable_count_ >= stable_count_required_ && 
-        current_direction != JoystickDirection::NONE && 
-        static_cast<int>(current_direction) != last_reported_direction_) {
-        
+    // 方向引擎：滞回判定 + 稳定窗口 + 自动连发
+    JoystickDirection previous_direction = getCurrentDirection();
+    engine_.update(sample.offset_x, sample.offset_y, to_ms_since_boot(get_absolute_time()));
+    JoystickDirection current_direction = getCurrentDirection();
+    
+    if (current_direction != previous_direction && current_direction != JoystickDirection::NONE) {
         handleDirectionChange(current_direction);
-        last_reported_direction_ = static_cast<int>(current_direction);
-    } else if (current_direction == JoystickDirection::NONE && 
-               last_reported_direction_ != 0) {
-        // 回到中心位置时静默处理
-        updateLEDColor(0x000000); // 关闭LED
-        last_reported_direction_ = 0;
     } else if (current_direction == JoystickDirection::NONE) {
+        // 回到中心位置时静默处理
         updateLEDColor(0x000000); // 关闭LED
     }
     
+    // 设置了回调时直接分发事件，否则留给 pollEvent
+    if (direction_callback_) {
+        ::JoystickEvent event;
+        while (engine_.pop(event)) {
+            dispatchEvent(event);
+        }
+    }
+    
     // 处理按钮事件
-    uint8_t button_value = joystick_.get_button_value();
-    handleButtonEvent(button_value);
+    handleButtonEvent(sample.button);
 }
 
 void JoystickController::setDirectionCallback(DirectionCallback callback) {
@@ -79,8 +65,13 @@ void JoystickController::setButtonCallback(ButtonCallback callback) {
     button_callback_ = callback;
 }
 
+bool JoystickController::pollEvent(::JoystickEvent& event) {
+    return engine_.pop(event);
+}
+
 JoystickDirection JoystickController::getCurrentDirection() const {
-    return static_cast<JoystickDirection>(last_reported_direction_);
+    // 两个方向枚举取值一致
+    return static_cast<JoystickDirection>(engine_.direction());
 }
 
 ButtonState JoystickController::getButtonState() const {
@@ -90,7 +81,7 @@ ButtonState JoystickController::getButtonState() const {
 void JoystickController::setLEDColor(uint32_t color) {
     // 注意：此方法会绕过LED开关控制，直接设置LED颜色
     // 建议使用updateLEDColor方法来确保遵守LED开关设置
-    joystick_.set_rgb_color(color);
+    writeLEDColor(color);
 }
 
 void JoystickController::setLEDEnabled(bool enabled) {
@@ -98,7 +89,7 @@ void JoystickController::setLEDEnabled(bool enabled) {
     
     if (!enabled) {
         // 如果禁用LED，立即关闭
-        joystick_.set_rgb_color(0x000000);
+        writeLEDColor(0x000000);
     }
     
     printf("[JOYSTICK_CONTROLLER] LED %s (led_enabled_ = %s)\n", enabled ? "启用" : "禁用", enabled ? "true" : "false");
@@ -109,61 +100,49 @@ bool JoystickController::isLEDEnabled() const {
 }
 
 void JoystickController::updateLEDColor(uint32_t color) {
-    static uint32_t last_color = 0xFFFFFFFF; // 初始化为一个不可能的颜色值
+    if (!led_enabled_) {
+        // 如果LED被禁用，确保LED关闭
+        color = 0x000000;
+    }
     
-    if (led_enabled_) {
-        // 只有当颜色发生变化时才打印日志
-        if (color != last_color) {
+    // 只有当颜色发生变化时才写寄存器和打印日志（空闲轮询不再产生I2C写入）
+    if (color != led_color_) {
+        if (led_enabled_) {
             printf("[JOYSTICK_CONTROLLER] LED启用，设置颜色: 0x%06X\n", color);
-            last_color = color;
-        }
-        joystick_.set_rgb_color(color);
-    } else {
-        // 如果LED被禁用，确保LED关闭
-        if (last_color != 0x000000) {
+        } else {
             printf("[JOYSTICK_CONTROLLER] LED禁用，强制关闭LED\n");
-            last_color = 0x000000;
         }
-        joystick_.set_rgb_color(0x000000);
+        writeLEDColor(color);
     }
 }
 
+void JoystickController::writeLEDColor(uint32_t color) {
+    if (color == led_color_) {
+        return;
+    }
+    joystick_.set_rgb_color(color);
+    led_color_ = color;
+}
+
 void JoystickController::setThreshold(uint16_t threshold) {
-    threshold_ = threshold;
+    JoystickEngineConfig config = engine_.config();
+    config.press_threshold = threshold;
+    config.release_threshold = threshold - threshold / 5;
+    engine_.set_config(config);
 }
 
 void JoystickController::setStableCount(uint8_t count) {
-    stable_count_required_ = count;
+    JoystickEngineConfig config = engine_.config();
+    config.stable_ms = count * STABLE_COUNT_POLL_MS;
+    engine_.set_config(config);
 }
 
-Joystick& JoystickController::getJoystick() {
-    return joystick_;
+void JoystickController::setEngineConfig(const JoystickEngineConfig& config) {
+    engine_.set_config(config);
 }
 
-JoystickDirection JoystickController::determineDirection(int16_t offset_x, int16_t offset_y) {
-    int16_t abs_x = abs(offset_x);
-    int16_t abs_y = abs(offset_y);
-    
-    // 检查是否超过阈值
-    if (abs_x < threshold_ && abs_y < threshold_) {
-        return JoystickDirection::NONE;
-    }
-    
-    // 检查死区（阈值的80%）
-    if (abs_x < threshold_ * 0.8f && abs_y < threshold_ * 0.8f) {
-        return JoystickDirection::NONE;
-    }
-    
-    // 判断主要方向
-    if (abs_y > abs_x * 1.5f) {
-        return (offset_y < 0) ? JoystickDirection::UP : JoystickDirection::DOWN;
-    }
-    
-    if (abs_x > abs_y * 1.5f) {
-        return (offset_x < 0) ? JoystickDirection::LEFT : JoystickDirection::RIGHT;
-    }
-    
-    return JoystickDirection::NONE;
+Joystick& JoystickController::getJoystick() {
+    return joystick_;
 }
 
 void JoystickController::handleDirectionChange(JoystickDirection new_direction) {
@@ -187,11 +166,13 @@ void JoystickController::handleDirectionChange(JoystickDirection new_direction)
         default:
             break;
     }
-    
-    // 调用回调函数
-    if (direction_callback_) {
-        direction_callback_(new_direction);
+}
+
+void JoystickController::dispatchEvent(const ::JoystickEvent& event) {
+    if (event.type == ::JoystickEvent::RELEASE) {
+        return;
     }
+    direction_callback_(static_cast<JoystickDirection>(event.direction));
 }
 
 void JoystickController::handleButtonEvent(uint8_t button_value) {
@@ -1,6 +1,5 @@
 #include "hardware/input/joystick/joystick_debouncer.hpp"
 #include <stdio.h>
-#include <cstdlib>
 
 JoystickDebouncer::JoystickDebouncer() {
     // 默认配置
@@ -9,12 +8,10 @@ JoystickDebouncer::JoystickDebouncer() {
     _config.stable_count_required = 3;
     _config.button_debounce_ms = 200;
     _config.direction_ratio = 1.5f;
+    _engine.set_config(to_engine_config(_config));
     
-    _current_direction = JoystickDirection::NONE;
-    _last_direction = JoystickDirection::NONE;
     _current_button_state = ButtonState::RELEASED;
     _last_button_state = ButtonState::RELEASED;
-    _direction_stable_count = 0;
     _last_button_time = 0;
     _button_event_occurred = false;
     _direction_changed = false;
@@ -44,22 +41,14 @@ void JoystickDebouncer::update(Joystick* joystick) {
     uint16_t x_adc, y_adc;
     joystick->get_joy_adc_16bits_value_xy(&x_adc, &y_adc);
     
-    JoystickDirection new_direction = determine_direction(x_adc, y_adc);
+    // 计算偏移量（12位ADC，中心在2048）
+    JoystickDirection previous_direction = _engine.direction();
+    _engine.update((int16_t)x_adc - 2048, (int16_t)y_adc - 2048, current_time);
+    _direction_changed = _engine.direction() != previous_direction;
     
-    if (new_direction != _current_direction) {
-        if (new_direction == _last_direction) {
-            _direction_stable_count++;
-            if (_direction_stable_count >= _config.stable_count_required) {
-                _current_direction = new_direction;
-                _direction_changed = true;
-            }
-        } else {
-            _direction_stable_count = 1;
-            _last_direction = new_direction;
-        }
-    } else {
-        _direction_stable_count = 0;
-        _direction_changed = false;
+    // 只关心方向变化，事件不使用
+    JoystickEvent event;
+    while (_engine.pop(event)) {
     }
 }
 
@@ -76,39 +65,20 @@ bool JoystickDebouncer::has_direction_changed() const {
 }
 
 JoystickDirection JoystickDebouncer::get_stable_direction() const {
-    return _current_direction;
+    return _engine.direction();
 }
 
 void JoystickDebouncer::set_debounce_config(const JoystickDebounceConfig& config) {
     _config = config;
+    _engine.set_config(to_engine_config(config));
 }
 
-JoystickDirection JoystickDebouncer::determine_direction(uint16_t x_adc, uint16_t y_adc) {
-    // 计算中心点（假设12位ADC，中心在2048）
-    const uint16_t center = 2048;
-    const uint16_t threshold = _config.threshold;
-    const uint16_t deadzone = _config.deadzone;
-    
-    // 计算偏移量
-    int16_t x_offset = (int16_t)x_adc - center;
-    int16_t y_offset = (int16_t)y_adc - center;
-    
-    // 检查是否在死区内
-    if (abs(x_offset) < deadzone && abs(y_offset) < deadzone) {
-        return JoystickDirection::NONE;
-    }
-    
-    // 检查是否超过阈值
-    if (abs(x_offset) < threshold && abs(y_offset) < threshold) {
-        return JoystickDirection::NONE;
-    }
-    
-    // 确定主要方向
-    if (abs(x_offset) > abs(y_offset) * _config.direction_ratio) {
-        // 水平方向为主
-        return (x_offset > 0) ? JoystickDirection::RIGHT : JoystickDirection::LEFT;
-    } else {
-        // 垂直方向为主
-        return (y_offset > 0) ? JoystickDirection::DOWN : JoystickDirection::UP;
-    }
-} 
\ No newline at end of file
+JoystickEngineConfig JoystickDebouncer::to_engine_config(const JoystickDebounceConfig& config) {
+    JoystickEngineConfig engine_config;
+    engine_config.press_threshold = config.threshold;
+    engine_config.release_threshold = config.deadzone < config.threshold ? config.deadzone : config.threshold;
+    engine_config.axis_ratio_q4 = static_cast<uint8_t>(config.direction_ratio * 16.0f + 0.5f);  // 只在配置时换算一次
+    engine_config.stable_ms = config.stable_count_required * 10;
+    engine_config.repeat_delay_ms = 0;
+    return engine_config;
+}
@@ -0,0 +1,140 @@
+#include "hardware/input/joystick/joystick_direction_engine.hpp"
+
+// 偏移在指定方向上的分量（朝该方向为正）
+static inline int32_t along_direction(JoystickDirection direction, int16_t offset_x, int16_t offset_y) {
+    switch (direction) {
+        case JoystickDirection::UP:    return -static_cast<int32_t>(offset_y);
+        case JoystickDirection::DOWN:  return offset_y;
+        case JoystickDirection::LEFT:  return -static_cast<int32_t>(offset_x);
+        case JoystickDirection::RIGHT: return offset_x;
+        default:                       return 0;
+    }
+}
+
+static inline int32_t abs32(int32_t value) {
+    return value < 0 ? -value : value;
+}
+
+JoystickDirectionEngine::JoystickDirectionEngine(const JoystickEngineConfig& config)
+    : _config(config) {
+    reset(0);
+}
+
+void JoystickDirectionEngine::reset(uint32_t now_ms) {
+    _stable = JoystickDirection::NONE;
+    _candidate = JoystickDirection::NONE;
+    _candidate_since = now_ms;
+    _candidate_peak = 0;
+    _rises = 0;
+    _next_repeat = now_ms;
+    _repeat_interval = 0;
+    _repeat_count = 0;
+    _head = 0;
+    _count = 0;
+}
+
+JoystickDirection JoystickDirectionEngine::classify(int16_t offset_x, int16_t offset_y) const {
+    int32_t abs_x = abs32(offset_x);
+    int32_t abs_y = abs32(offset_y);
+
+    // 滞回：当前方向的分量不低于释放阈值且仍是主轴时保持
+    if (_stable != JoystickDirection::NONE) {
+        bool horizontal = _stable == JoystickDirection::LEFT || _stable == JoystickDirection::RIGHT;
+        int32_t along = along_direction(_stable, offset_x, offset_y);
+        int32_t other = horizontal ? abs_y : abs_x;
+        if (along >= _config.release_threshold && along >= other) {
+            return _stable;
+        }
+    }
+
+    int32_t major = abs_x >= abs_y ? abs_x : abs_y;
+    int32_t minor = abs_x >= abs_y ? abs_y : abs_x;
+    if (major < _config.press_threshold || major * 16 <= minor * _config.axis_ratio_q4) {
+        return JoystickDirection::NONE;
+    }
+    if (abs_x >= abs_y) {
+        return offset_x < 0 ? JoystickDirection::LEFT : JoystickDirection::RIGHT;
+    }
+    return offset_y < 0 ? JoystickDirection::UP : JoystickDirection::DOWN;
+}
+
+void JoystickDirectionEngine::update(int16_t offset_x, int16_t offset_y, uint32_t now_ms) {
+    JoystickDirection raw = classify(offset_x, offset_y);
+    int32_t along = along_direction(raw, offset_x, offset_y);
+
+    if (raw != _candidate) {
+        _candidate = raw;
+        _candidate_since = now_ms;
+        _candidate_peak = along;
+        _rises = 0;
+    } else if (along > _candidate_peak) {
+        _candidate_peak = along;
+        if (_rises < 2) {
+            _rises++;
+        }
+    } else {
+        _rises = 0;
+    }
+
+    if (_candidate != _stable) {
+        bool settled = now_ms - _candidate_since >= _config.stable_ms;
+        // 真实推动时偏移单调向外，阈值附近的抖动不会连续两次增大
+        bool predicted = _config.predictive && _candidate != JoystickDirection::NONE && _rises >= 2;
+        if (settled || predicted) {
+            commit(_candidate, _candidate_since);
+        }
+    }
+
+    if (_stable == JoystickDirection::NONE || _config.repeat_delay_ms == 0) {
+        return;
+    }
+
+    // 主循环停顿时最多补发一个队列的连发，其余跳过
+    int emitted = 0;
+    while (static_cast<int32_t>(now_ms - _next_repeat) >= 0) {
+        if (emitted == QUEUE_SIZE) {
+            _next_repeat = now_ms + _repeat_interval;
+            break;
+        }
+        emit(JoystickEvent::REPEAT, _stable, _next_repeat, ++_repeat_count);
+        emitted++;
+
+        _next_repeat += _repeat_interval;
+        uint32_t interval = _repeat_interval * _config.repeat_accel_percent / 100;
+        _repeat_interval = interval > _config.repeat_min_interval_ms ? interval : _config.repeat_min_interval_ms;
+    }
+}
+
+void JoystickDirectionEngine::commit(JoystickDirection direction, uint32_t time_ms) {
+    if (_stable != JoystickDirection::NONE) {
+        emit(JoystickEvent::RELEASE, _stable, time_ms, _repeat_count);
+    }
+    _stable = direction;
+    if (direction != JoystickDirection::NONE) {
+        emit(JoystickEvent::PRESS, direction, time_ms, 0);
+        _repeat_count = 0;
+        // 第一、二次连发相隔初始间隔，之后逐次加速
+        _repeat_interval = _config.repeat_interval_ms;
+        _next_repeat = time_ms + _config.repeat_delay_ms;
+    }
+}
+
+void JoystickDirectionEngine::emit(JoystickEvent::Type type, JoystickDirection direction,
+                                   uint32_t time_ms, uint16_t repeat) {
+    if (_count == QUEUE_SIZE) {
+        _head = (_head + 1) % QUEUE_SIZE;   // 队列满时丢弃最早的事件
+        _count--;
+    }
+    _queue[(_head + _count) % QUEUE_SIZE] = JoystickEvent{type, direction, time_ms, repeat};
+    _count++;
+}
+
+bool JoystickDirectionEngine::pop(JoystickEvent& event) {
+    if (_count == 0) {
+        return false;
+    }
+    event = _queue[_head];
+    _head = (_head + 1) % QUEUE_SIZE;
+    _count--;
+    return true;
+}
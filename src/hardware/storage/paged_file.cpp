@@ -0,0 +1,205 @@
+/**
+ * @file paged_file.cpp
+ * @brief 分页文件视图实现
+ * @version 1.0.0
+ */
+
+#include "hardware/storage/microsd/paged_file.hpp"
+#include <stdio.h>
+#include <string.h>
+
+namespace MicroSD {
+
+PagedFileView::PagedFileView(RWSD& sd)
+    : sd_(&sd), size_(0), tick_(0), current_page_(0), direction_(1) {
+    for (auto& page : pages_) {
+        page = Page{0, 0, 0, false, false};
+    }
+}
+
+PagedFileView::~PagedFileView() {
+    close();
+}
+
+Result<void> PagedFileView::open(const std::string& path) {
+    close();
+
+    auto opened = sd_->open_file(path, "r");
+    if (!opened.is_ok()) {
+        return Result<void>(opened.error_code(), opened.error_message());
+    }
+    file_ = opened.take();
+
+    // 快速定位使向前翻页时的随机定位不再沿FAT链查找；表不够大时保持普通模式
+    file_.enable_fast_seek(Span<DWORD>(clmt_));
+
+    auto size = file_.size();
+    if (!size.is_ok()) {
+        file_.close();
+        return Result<void>(size.error_code(), size.error_message());
+    }
+    size_ = *size;
+    current_page_ = 0;
+    direction_ = 1;
+
+    printf("[PagedFile] 打开 %s: %lu 字节, %lu 页%s\n", path.c_str(), (unsigned long)size_,
+           (unsigned long)page_count(), file_.is_fast_seek() ? ", 快速定位" : "");
+    return Result<void>();
+}
+
+void PagedFileView::close() {
+    file_.close();
+    size_ = 0;
+    for (auto& page : pages_) {
+        page.valid = false;
+        page.prefetched = false;
+    }
+}
+
+int PagedFileView::find_page(uint32_t index) const {
+    for (int i = 0; i < PAGED_FILE_PAGE_COUNT; i++) {
+        if (pages_[i].valid && pages_[i].index == index) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int PagedFileView::choose_slot() const {
+    int victim = -1;
+    for (int i = 0; i < PAGED_FILE_PAGE_COUNT; i++) {
+        if (!pages_[i].valid) {
+            return i;
+        }
+        if (pages_[i].index == current_page_) {
+            continue;   // 调用者可能仍持有当前页的窗口
+        }
+        if (victim < 0 || pages_[i].last_used < pages_[victim].last_used) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+Result<int> PagedFileView::load_page(uint32_t index) {
+    int slot = choose_slot();
+    Page& page = pages_[slot];
+    if (page.valid) {
+        stats_.evictions++;
+        page.valid = false;
+    }
+
+    size_t offset = static_cast<size_t>(index) * PAGED_FILE_PAGE_SIZE;
+    size_t length = size_ - offset < PAGED_FILE_PAGE_SIZE ? size_ - offset : PAGED_FILE_PAGE_SIZE;
+
+    auto result = file_.seek(offset);
+    if (!result.is_ok()) {
+        return Result<int>(result.error_code(), result.error_message());
+    }
+    auto read = file_.read_into(Span<uint8_t>(data_[slot], length));
+    if (!read.is_ok()) {
+        return Result<int>(read.error_code(), read.error_message());
+    }
+    if (*read != length) {
+        return Result<int>(ErrorCode::IO_ERROR, "文件在打开期间被截断");
+    }
+
+    page.index = index;
+    page.length = static_cast<uint32_t>(length);
+    page.last_used = ++tick_;
+    page.valid = true;
+    page.prefetched = false;
+    return Result<int>(slot);
+}
+
+Result<int> PagedFileView::access_page(uint32_t index) {
+    if (index != current_page_) {
+        direction_ = index > current_page_ ? 1 : -1;
+        current_page_ = index;
+    }
+
+    int slot = find_page(index);
+    if (slot >= 0) {
+        Page& page = pages_[slot];
+        stats_.hits++;
+        if (page.prefetched) {
+            stats_.readahead_hits++;
+            page.prefetched = false;
+        }
+        page.last_used = ++tick_;
+        return Result<int>(slot);
+    }
+
+    stats_.faults++;
+    return load_page(index);
+}
+
+Result<PagedFileView::Window> PagedFileView::window(size_t offset, size_t max_length) {
+    if (!file_.is_open()) {
+        return Result<Window>(ErrorCode::INVALID_PARAMETER);
+    }
+
+    Window view;
+    view.offset = offset;
+    if (offset >= size_ || max_length == 0) {
+        return Result<Window>(view);
+    }
+
+    auto slot = access_page(static_cast<uint32_t>(offset / PAGED_FILE_PAGE_SIZE));
+    if (!slot.is_ok()) {
+        return Result<Window>(slot.error_code(), slot.error_message());
+    }
+
+    const Page& page = pages_[*slot];
+    size_t in_page = offset % PAGED_FILE_PAGE_SIZE;
+    size_t available = page.length - in_page;
+    view.data = reinterpret_cast<const char*>(data_[*slot]) + in_page;
+    view.length = available < max_length ? available : max_length;
+    return Result<Window>(view);
+}
+
+Result<size_t> PagedFileView::read(size_t offset, Span<uint8_t> buffer) {
+    size_t copied = 0;
+    while (copied < buffer.size()) {
+        auto view = window(offset + copied, buffer.size() - copied);
+        if (!view.is_ok()) {
+            return Result<size_t>(view.error_code(), view.error_message());
+        }
+        if (view->length == 0) {
+            break;
+        }
+        memcpy(buffer.data() + copied, view->data, view->length);
+        copied += view->length;
+    }
+    return Result<size_t>(copied);
+}
+
+bool PagedFileView::poll() {
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    // 沿翻页方向由近及远，每次只读一页以免阻塞主循环
+    uint32_t pages = page_count();
+    for (int ahead = 1; ahead <= PAGED_FILE_READAHEAD; ahead++) {
+        int64_t index = static_cast<int64_t>(current_page_) + direction_ * ahead;
+        if (index < 0 || index >= pages) {
+            return false;
+        }
+        if (find_page(static_cast<uint32_t>(index)) >= 0) {
+            continue;
+        }
+
+        auto slot = load_page(static_cast<uint32_t>(index));
+        if (!slot.is_ok()) {
+            return false;
+        }
+        // 预读页的LRU时间戳最新，淘汰时先挤出翻页方向后方的旧页
+        pages_[*slot].prefetched = true;
+        stats_.readahead_loads++;
+        return ahead < PAGED_FILE_READAHEAD;
+    }
+    return false;
+}
+
+} // namespace MicroSD
@@ -0,0 +1,205 @@
+/**
+ * @file ring_log.cpp
+ * @brief 掉电安全的环形日志文件实现
+ * @version 1.0.0
+ */
+
+#include "hardware/storage/microsd/ring_log.hpp"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace MicroSD {
+namespace ring_log {
+
+RingLog::RingLog(RWSD& sd)
+    : sd_(&sd), pending_count_(0), next_seq_(0), flushes_(0) {}
+
+RingLog::~RingLog() {
+    close();
+}
+
+Result<void> RingLog::open(const std::string& path, uint32_t slot_count, uint16_t record_size) {
+    close();
+
+    info_ = RingInfo();
+    info_.slot_count = slot_count;
+    info_.record_size = record_size;
+    if (!info_.is_valid()) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER, "槽位数至少为2，记录大小为1..492字节");
+    }
+
+    pending_count_ = 0;
+    flushes_ = 0;
+
+    // 已有文件：校验文件头，参数一致则恢复
+    auto opened = sd_->open_file(path, "r+");
+    if (opened.is_ok()) {
+        file_ = opened.take();
+        RingInfo existing;
+        auto size = file_.size();
+        bool usable = file_.seek(0).is_ok() &&
+                      file_.read_into(Span<uint8_t>(block_)).is_ok() &&
+                      decode_header(block_, existing) &&
+                      existing.slot_count == slot_count &&
+                      existing.record_size == record_size &&
+                      size.is_ok() && *size == (static_cast<size_t>(slot_count) + 1) * SLOT_SIZE;
+        if (usable) {
+            info_ = existing;
+            return recover();
+        }
+        printf("[RingLog] %s 参数不符，重新创建\n", path.c_str());
+        file_.close();
+    }
+
+    return create(path);
+}
+
+Result<void> RingLog::create(const std::string& path) {
+    auto opened = sd_->open_file(path, "w");
+    if (!opened.is_ok()) {
+        return Result<void>(opened.error_code(), opened.error_message());
+    }
+    file_ = opened.take();
+
+    // 一次性分配全部空间；连续空间不足时用扩展定位分配普通簇链
+    size_t total = (static_cast<size_t>(info_.slot_count) + 1) * SLOT_SIZE;
+    if (!file_.preallocate(total).is_ok()) {
+        file_.seek(total);
+        auto size = file_.size();
+        if (!size.is_ok() || *size < total) {
+            file_.close();
+            return Result<void>(ErrorCode::DISK_FULL);
+        }
+    }
+
+    // 新文件ID使预分配空间里的旧数据全部无效
+    info_.file_id = time_us_32() | 1;
+    encode_header(info_, block_);
+    auto result = file_.seek(0);
+    if (result.is_ok()) {
+        auto written = file_.write(Span<const uint8_t>(block_, SLOT_SIZE));
+        if (!written.is_ok() || *written != SLOT_SIZE) {
+            result = Result<void>(ErrorCode::DISK_FULL);
+        }
+    }
+    if (result.is_ok()) {
+        result = file_.flush();     // 唯一一次FAT/目录更新
+    }
+    if (!result.is_ok()) {
+        file_.close();
+        return result;
+    }
+
+    recovery_ = RingHead();
+    next_seq_ = 0;
+    printf("[RingLog] 创建 %s: %lu 槽位 x %u 条记录\n",
+           path.c_str(), (unsigned long)info_.slot_count, (unsigned)info_.records_per_slot());
+    return Result<void>();
+}
+
+bool RingLog::read_slot(uint32_t slot, SlotView& view) {
+    if (!file_.seek((static_cast<size_t>(slot) + 1) * SLOT_SIZE).is_ok()) {
+        return false;
+    }
+    auto result = file_.read_into(Span<uint8_t>(block_));
+    return result.is_ok() && *result == SLOT_SIZE && decode_slot(info_, slot, block_, view);
+}
+
+Result<void> RingLog::recover() {
+    uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+
+    recovery_ = locate_head(info_.slot_count, [this](uint32_t slot, uint32_t& seq) {
+        SlotView view;
+        if (!read_slot(slot, view)) {
+            return false;
+        }
+        seq = view.seq;
+        return true;
+    });
+    next_seq_ = recovery_.empty ? 0 : recovery_.head_seq + 1;
+
+    uint32_t elapsed_ms = to_ms_since_boot(get_absolute_time()) - start_ms;
+    printf("[RingLog] 恢复: 下一序号 %lu, 有效槽位 %lu/%lu, 读取 %lu 个扇区, 用时 %lu ms\n",
+           (unsigned long)next_seq_, (unsigned long)recovery_.valid_slots,
+           (unsigned long)info_.slot_count, (unsigned long)recovery_.probes,
+           (unsigned long)elapsed_ms);
+    return Result<void>();
+}
+
+Result<void> RingLog::append(const void* record) {
+    if (!file_.is_open()) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+
+    memcpy(pending_ + static_cast<size_t>(pending_count_) * info_.record_size, record, info_.record_size);
+    pending_count_++;
+    if (pending_count_ >= info_.records_per_slot()) {
+        return flush();
+    }
+    return Result<void>();
+}
+
+Result<void> RingLog::flush() {
+    if (!file_.is_open()) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+    if (pending_count_ == 0) {
+        return Result<void>();
+    }
+
+    // 每次提交写入一个新槽位，已提交的槽位永不改写
+    uint32_t slot = next_seq_ % info_.slot_count;
+    encode_slot(info_, next_seq_, pending_, pending_count_, block_);
+
+    auto result = file_.seek((static_cast<size_t>(slot) + 1) * SLOT_SIZE);
+    if (!result.is_ok()) {
+        return result;
+    }
+    auto written = file_.write(Span<const uint8_t>(block_, SLOT_SIZE));
+    if (!written.is_ok()) {
+        return Result<void>(written.error_code(), written.error_message());
+    }
+    result = file_.sync_data();
+    if (!result.is_ok()) {
+        return result;
+    }
+
+    next_seq_++;
+    pending_count_ = 0;
+    flushes_++;
+    return Result<void>();
+}
+
+void RingLog::close() {
+    if (file_.is_open()) {
+        flush();
+        file_.close();
+    }
+}
+
+Result<size_t> RingLog::read_all(const std::function<bool(const uint8_t* record, uint32_t seq)>& visitor) {
+    if (!file_.is_open()) {
+        return Result<size_t>(ErrorCode::INVALID_PARAMETER);
+    }
+
+    size_t visited = 0;
+    uint32_t first_seq = next_seq_ > info_.slot_count ? next_seq_ - info_.slot_count : 0;
+    for (uint32_t seq = first_seq; seq < next_seq_; seq++) {
+        SlotView view;
+        if (!read_slot(seq % info_.slot_count, view) || view.seq != seq) {
+            continue;   // 掉电时写坏的槽位
+        }
+        for (uint16_t i = 0; i < view.count; i++) {
+            visited++;
+            if (!visitor(view.records + static_cast<size_t>(i) * info_.record_size, seq)) {
+                return Result<size_t>(visited);
+            }
+        }
+    }
+    return Result<size_t>(visited);
+}
+
+} // namespace ring_log
+} // namespace MicroSD
@@ -0,0 +1,161 @@
+/**
+ * @file ring_log_format.cpp
+ * @brief 环形日志槽位编解码与头部定位实现
+ * @version 1.0.0
+ */
+
+#include "hardware/storage/microsd/ring_log_format.hpp"
+#include "hardware/storage/microsd/sensor_log_format.hpp"
+#include <cstring>
+
+namespace MicroSD {
+namespace ring_log {
+
+namespace {
+
+// 文件头布局
+constexpr size_t HDR_VERSION = 4;
+constexpr size_t HDR_RECORD_SIZE = 6;
+constexpr size_t HDR_SLOT_COUNT = 8;
+constexpr size_t HDR_FILE_ID = 12;
+
+// 槽位布局
+constexpr size_t SLOT_FILE_ID = 4;
+constexpr size_t SLOT_SEQ = 8;
+constexpr size_t SLOT_COUNT = 12;
+constexpr size_t SLOT_RECORD_SIZE = 14;
+
+inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, static_cast<uint16_t>(v));
+    put_u16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+inline uint16_t get_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | (static_cast<uint32_t>(get_u16(p + 2)) << 16);
+}
+
+inline uint32_t block_crc(const uint8_t* block) {
+    return sensor_log::crc32(block, SLOT_CRC_OFFSET);
+}
+
+} // namespace
+
+void encode_header(const RingInfo& info, uint8_t* block) {
+    memset(block, 0, SLOT_SIZE);
+    put_u32(block, HEADER_MAGIC);
+    put_u16(block + HDR_VERSION, FORMAT_VERSION);
+    put_u16(block + HDR_RECORD_SIZE, info.record_size);
+    put_u32(block + HDR_SLOT_COUNT, info.slot_count);
+    put_u32(block + HDR_FILE_ID, info.file_id);
+    put_u32(block + SLOT_CRC_OFFSET, block_crc(block));
+}
+
+bool decode_header(const uint8_t* block, RingInfo& info) {
+    if (get_u32(block) != HEADER_MAGIC || get_u16(block + HDR_VERSION) != FORMAT_VERSION ||
+        get_u32(block + SLOT_CRC_OFFSET) != block_crc(block)) {
+        return false;
+    }
+
+    RingInfo decoded;
+    decoded.record_size = get_u16(block + HDR_RECORD_SIZE);
+    decoded.slot_count = get_u32(block + HDR_SLOT_COUNT);
+    decoded.file_id = get_u32(block + HDR_FILE_ID);
+    if (!decoded.is_valid()) {
+        return false;
+    }
+    info = decoded;
+    return true;
+}
+
+void encode_slot(const RingInfo& info, uint32_t seq, const uint8_t* records, uint16_t count,
+                 uint8_t* block) {
+    size_t bytes = static_cast<size_t>(count) * info.record_size;
+    memset(block, 0, SLOT_SIZE);
+    put_u32(block, SLOT_MAGIC);
+    put_u32(block + SLOT_FILE_ID, info.file_id);
+    put_u32(block + SLOT_SEQ, seq);
+    put_u16(block + SLOT_COUNT, count);
+    put_u16(block + SLOT_RECORD_SIZE, info.record_size);
+    memcpy(block + SLOT_HEADER_SIZE, records, bytes);
+    put_u32(block + SLOT_CRC_OFFSET, block_crc(block));
+}
+
+bool decode_slot(const RingInfo& info, uint32_t slot, const uint8_t* block, SlotView& view) {
+    if (get_u32(block) != SLOT_MAGIC ||
+        get_u32(block + SLOT_FILE_ID) != info.file_id ||
+        get_u16(block + SLOT_RECORD_SIZE) != info.record_size ||
+        get_u32(block + SLOT_CRC_OFFSET) != block_crc(block)) {
+        return false;
+    }
+
+    uint32_t seq = get_u32(block + SLOT_SEQ);
+    uint16_t count = get_u16(block + SLOT_COUNT);
+    if (seq % info.slot_count != slot || count > info.records_per_slot()) {
+        return false;
+    }
+
+    view.seq = seq;
+    view.count = count;
+    view.records = block + SLOT_HEADER_SIZE;
+    return true;
+}
+
+RingHead locate_head(uint32_t slot_count, const SlotSeqReader& read_seq) {
+    RingHead head;
+    uint32_t seq = 0;
+
+    // 基准槽位：槽位0，若其在回绕写入时损坏则用槽位1
+    uint32_t ref = 0;
+    head.probes++;
+    if (!read_seq(0, seq)) {
+        ref = 1;
+        head.probes++;
+        if (!read_seq(1, seq)) {
+            return head;
+        }
+    }
+    const uint32_t base = seq - ref;
+
+    // 二分查找满足 seq - slot == base 的最后一个槽位
+    uint32_t lo = ref;
+    uint32_t hi = slot_count - 1;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        head.probes++;
+        if (read_seq(mid, seq) && seq - mid == base) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    head.empty = false;
+    head.head_slot = lo;
+    head.head_seq = base + lo;
+    head.oldest_slot = ref;
+    head.valid_slots = lo - ref + 1;
+
+    // 头部之后若是上一圈的数据则已回绕；紧随头部的槽位可能是掉电时写坏的那个
+    for (uint32_t slot = lo + 1; slot < slot_count && slot <= lo + 2; slot++) {
+        head.probes++;
+        if (read_seq(slot, seq) && seq + slot_count - slot == base) {
+            head.oldest_slot = slot;
+            head.valid_slots += slot_count - slot;
+            break;
+        }
+    }
+
+    return head;
+}
+
+} // namespace ring_log
+} // namespace MicroSD
@@ -14,6 +14,7 @@
 #include "ff.h"
 #include "diskio.h"
 #include "tf_card.h"
+#include "sector_cache.h"
 #include "pio_spi.h"
 #include <stdio.h>
 #include <string.h>
@@ -25,30 +26,53 @@
 
 namespace MicroSD {
 
+uint32_t RWSD::fat_generation_ = 0;
+RWSD::WriterBucket RWSD::writer_buckets_[RWSD_WRITER_BUCKETS] = {};
+
 // === 构造函数和析构函数 ===
 
 RWSD::RWSD(MicroSD::SPIConfig config) 
-    : config_(config), fs_type_(0), is_initialized_(false) {
+    : config_(config), is_initialized_(false), free_scan_{}, profile_clock_(0), clock_negotiated_(false),
+      handle_cache_tick_(0),
+      handle_cache_limit_(RWSD_HANDLE_CACHE_DEFAULT_LIMIT) {
     memset(&fs_, 0, sizeof(FATFS));
+    memset(card_cid_, 0, sizeof(card_cid_));
+    for (auto& slot : handle_cache_) {
+        slot.is_open = false;
+        slot.last_used = 0;
+        slot.generation = 0;
+    }
 }
 
 RWSD::~RWSD() {
     if (is_initialized_) {
+        invalidate_all_cached_handles();
         unmount_filesystem();
         deinitialize_spi();
     }
 }
 
 RWSD::RWSD(RWSD&& other) noexcept 
-    : config_(other.config_), fs_(other.fs_), fs_type_(other.fs_type_), 
-      is_initialized_(other.is_initialized_), current_dir_(std::move(other.current_dir_)),
-      current_path_(std::move(other.current_path_)) {
+    : config_(other.config_), fs_(other.fs_), 
+      is_initialized_(other.is_initialized_), free_scan_(other.free_scan_), timing_(other.timing_),
+      profile_clock_(other.profile_clock_), clock_negotiated_(other.clock_negotiated_),
+      current_path_(std::move(other.current_path_)),
+      handle_cache_tick_(0), handle_cache_limit_(other.handle_cache_limit_) {
+    memcpy(card_cid_, other.card_cid_, sizeof(card_cid_));
+    // 缓存的FIL引用的是对方的FATFS对象，不能随之迁移
+    other.invalidate_all_cached_handles();
+    for (auto& slot : handle_cache_) {
+        slot.is_open = false;
+        slot.last_used = 0;
+    }
     other.is_initialized_ = false;
     memset(&other.fs_, 0, sizeof(FATFS));
 }
 
 RWSD& RWSD::operator=(RWSD&& other) noexcept {
     if (this != &other) {
+        invalidate_all_cached_handles();
+        other.invalidate_all_cached_handles();
         if (is_initialized_) {
             unmount_filesystem();
             deinitialize_spi();
@@ -56,10 +80,14 @@ RWSD& RWSD::operator=(RWSD&& other) noexcept {
         
         config_ = other.config_;
         fs_ = other.fs_;
-        fs_type_ = other.fs_type_;
         is_initialized_ = other.is_initialized_;
-        current_dir_ = std::move(other.current_dir_);
+        free_scan_ = other.free_scan_;
+        timing_ = other.timing_;
+        memcpy(card_cid_, other.card_cid_, sizeof(card_cid_));
+        profile_clock_ = other.profile_clock_;
+        clock_negotiated_ = other.clock_negotiated_;
         current_path_ = std::move(other.current_path_);
+        handle_cache_limit_ = other.handle_cache_limit_;
         
         other.is_initialized_ = false;
         memset(&other.fs_, 0, sizeof(FATFS));
@@ -112,44 +140,84 @@ void RWSD::deinitialize_spi() {
 }
 
 Result<void> RWSD::mount_filesystem() {
-    printf("[RWSD] 尝试挂载文件系统...\n");
+    // 不在这里调用 f_getfree：FSINFO不可信时它会扫描整个FAT，32GB卡上需要数秒。
+    // 文件系统类型直接取 fs_.fs_type，空闲空间由 poll_background() 分步统计。
+#if RWSD_LAZY_MOUNT
+    FRESULT fr = f_mount(&fs_, "", 0);
+#else
+    uint32_t start_us = time_us_32();
     FRESULT fr = f_mount(&fs_, "", 1);
+    timing_.mount_us = time_us_32() - start_us;
+#endif
     if (fr != FR_OK) {
         printf("[RWSD] 文件系统挂载失败，错误码: %d\n", fr);
         return Result<void>(fresult_to_error_code(fr));
     }
-    printf("[RWSD] 文件系统挂载成功\n");
     
-    // 获取文件系统类型
-    printf("[RWSD] 检测文件系统类型...\n");
-    DWORD fre_clust, fre_sect, tot_sect;
-    FATFS* fs_ptr = const_cast<FATFS*>(&fs_);
-    fr = f_getfree("", &fre_clust, &fs_ptr);
-    if (fr == FR_OK) {
-        tot_sect = (fs_.n_fatent - 2) * fs_.csize;
-        fre_sect = fre_clust * fs_.csize;
-        
-        if (tot_sect < 4085) {
-            fs_type_ = 1; // FAT12
-            printf("[RWSD] 检测到FAT12文件系统\n");
-        } else if (fre_sect < 65525) {
-            fs_type_ = 2; // FAT16
-            printf("[RWSD] 检测到FAT16文件系统\n");
-        } else {
-            fs_type_ = 3; // FAT32
-            printf("[RWSD] 检测到FAT32文件系统\n");
-        }
-        
-        printf("[RWSD] 文件系统信息 - 总簇数: %lu, 空闲簇数: %lu, 每簇扇区数: %u\n", 
-               fs_.n_fatent, fre_clust, fs_.csize);
-    } else {
-        printf("[RWSD] 无法获取文件系统信息，错误码: %d\n", fr);
+    free_scan_ = FreeSpaceScan{};
+#if !RWSD_LAZY_MOUNT
+    printf("[RWSD] 检测到%s文件系统 - 总簇数: %lu, 每簇扇区数: %u\n",
+           get_filesystem_type().c_str(), (unsigned long)fs_.n_fatent, fs_.csize);
+#endif
+    return Result<void>();
+}
+
+Result<void> RWSD::ensure_mounted() const {
+    if (fs_.fs_type != 0) {
+        return Result<void>();
     }
     
+    // 尚无任何文件访问触发挂载，此时不存在打开的文件，重新注册并立即挂载是安全的
+    uint32_t start_us = time_us_32();
+    FRESULT fr = f_mount(const_cast<FATFS*>(&fs_), "", 1);
+    timing_.mount_us = time_us_32() - start_us;
+    if (fr != FR_OK) {
+        printf("[RWSD] 文件系统挂载失败，错误码: %d\n", fr);
+        return Result<void>(fresult_to_error_code(fr));
+    }
+    
+    printf("[RWSD] 挂载%s文件系统 - 总簇数: %lu, 每簇扇区数: %u, 用时 %lu us\n",
+           get_filesystem_type().c_str(), (unsigned long)fs_.n_fatent, fs_.csize,
+           (unsigned long)timing_.mount_us);
     return Result<void>();
 }
 
+namespace {
+
+// FatFs调用失败的说明 (只在错误路径上构造)，随Result返回给调用者
+std::string fatfs_error_text(const char* op, FRESULT fr) {
+    char text[48];
+    snprintf(text, sizeof(text), "%s 失败，错误码: %d", op, (int)fr);
+    return text;
+}
+
+// 用于比较的路径：规范化后把ASCII字母折叠为小写 (FAT文件名不区分大小写)；
+// GBK双字节字符的尾字节可能落在字母范围内，原样保留
+std::string fat_path_key(const std::string& path) {
+    std::string key = StorageDevice::normalize_path(path);
+    for (size_t i = 0; i < key.size(); i++) {
+        uint8_t c = static_cast<uint8_t>(key[i]);
+        if (c >= 0x81 && c <= 0xFE && i + 1 < key.size()) {
+            i++;
+        } else if (c >= 'A' && c <= 'Z') {
+            key[i] = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return key;
+}
+
+// 写回扇区缓存并等待卡片内部编程完成 (f_sync/f_close 发出的 CTRL_SYNC 不写回缓存)
+bool write_back_sector_cache() {
+    return pico_fatfs_cache_flush() == RES_OK && disk_ioctl(0, CTRL_SYNC, nullptr) == RES_OK;
+}
+
+} // namespace
+
 void RWSD::unmount_filesystem() {
+    // f_close/f_sync 不写回扇区缓存，卸载前必须落盘
+    if (!write_back_sector_cache()) {
+        printf("[RWSD] 卸载时扇区缓存写回失败\n");
+    }
     f_unmount("");
 }
 
@@ -160,15 +228,20 @@ Result<void> RWSD::initialize() {
     }
     
     printf("[RWSD] 开始初始化SD卡硬件...\n");
+    timing_ = StartupTiming{};
+    uint32_t start_us = time_us_32();
     
     // 初始化SPI
     printf("[RWSD] 初始化SPI接口...\n");
     initialize_spi();
+    uint32_t spi_done_us = time_us_32();
+    timing_.spi_init_us = spi_done_us - start_us;
     printf("[RWSD] SPI接口初始化完成\n");
     
     // 初始化SD卡硬件
     printf("[RWSD] 初始化SD卡硬件...\n");
     DSTATUS status = disk_initialize(0);
+    timing_.card_init_us = time_us_32() - spi_done_us;
     if (status != 0) {
         printf("[RWSD] SD卡硬件初始化失败，状态码: %d\n", status);
         deinitialize_spi();
@@ -186,11 +259,111 @@ Result<void> RWSD::initialize() {
     }
     printf("[RWSD] 文件系统挂载成功\n");
     
+#if RWSD_ADAPTIVE_CLOCK
+    // 时钟配置文件要读文件系统，协商放到挂载之后的 poll_background()；此前用兼容时钟
+    pico_fatfs_set_clk_fast_freq(MICROSD_SPI_FREQ_FAST_COMPAT);
+    clock_negotiated_ = false;
+#endif
+    
     is_initialized_ = true;
-    printf("[RWSD] SD卡初始化完成\n");
+    timing_.total_us = time_us_32() - start_us;
+    printf("[RWSD] SD卡初始化完成: SPI %lu us, 卡初始化 %lu us, 挂载 %lu us, 总计 %lu us\n",
+           (unsigned long)timing_.spi_init_us, (unsigned long)timing_.card_init_us,
+           (unsigned long)timing_.mount_us, (unsigned long)timing_.total_us);
     return Result<void>();
 }
 
+// === 自适应时钟 ===
+
+namespace {
+
+constexpr uint32_t CLOCK_PROFILE_MAGIC = 0x4B4C4353;    // "SCLK"
+
+// 时钟配置文件内容 (小端，24字节)
+struct ClockProfileRecord {
+    uint32_t magic;
+    uint8_t cid[16];
+    uint32_t clock_hz;
+};
+
+} // namespace
+
+void RWSD::negotiate_clock() {
+    uint32_t start_us = time_us_32();
+    clock_negotiated_ = true;
+    
+    if (disk_ioctl(0, MMC_GET_CID, card_cid_) != RES_OK) {
+        memset(card_cid_, 0, sizeof(card_cid_));
+    }
+    
+    // 文件系统已挂载，仍在兼容时钟下读取配置文件，不在未验证的时钟下访问文件系统
+    profile_clock_ = load_clock_profile();
+    
+    // 已知的卡从上次验证通过的时钟开始，新卡从高速预设开始逐级降频
+    uint32_t start_clock = profile_clock_ ? profile_clock_ : MICROSD_SPI_FREQ_FAST_HIGH;
+    uint32_t clock = pico_fatfs_negotiate_clk_fast(start_clock, MICROSD_SPI_FREQ_FAST_MIN);
+    timing_.clock_us = time_us_32() - start_us;
+    
+    if (clock == 0) {
+        printf("[RWSD] 时钟协商失败，使用最低时钟 %lu kHz\n",
+               (unsigned long)(pico_fatfs_get_clk_fast_freq() / 1000));
+        return;
+    }
+    printf("[RWSD] SPI时钟 %lu kHz (起始 %lu kHz%s, 用时 %lu us)\n",
+           (unsigned long)(clock / 1000), (unsigned long)(start_clock / 1000),
+           profile_clock_ ? ", 来自配置文件" : "", (unsigned long)timing_.clock_us);
+    if (clock != profile_clock_) {
+        save_clock_profile(clock);
+    }
+}
+
+uint32_t RWSD::load_clock_profile() {
+    FIL file;
+    if (f_open(&file, RWSD_CLOCK_PROFILE_PATH, FA_READ) != FR_OK) {
+        return 0;
+    }
+    
+    ClockProfileRecord record;
+    UINT br = 0;
+    FRESULT fr = f_read(&file, &record, sizeof(record), &br);
+    f_close(&file);
+    
+    // 换卡后CID不同，配置文件作废
+    if (fr != FR_OK || br != sizeof(record) || record.magic != CLOCK_PROFILE_MAGIC ||
+        memcmp(record.cid, card_cid_, sizeof(card_cid_)) != 0 ||
+        record.clock_hz < MICROSD_SPI_FREQ_FAST_MIN || record.clock_hz > MICROSD_SPI_FREQ_FAST_HIGH) {
+        return 0;
+    }
+    return record.clock_hz;
+}
+
+void RWSD::save_clock_profile(uint32_t clock_hz) {
+    ClockProfileRecord record = {CLOCK_PROFILE_MAGIC, {}, clock_hz};
+    memcpy(record.cid, card_cid_, sizeof(card_cid_));
+    
+    FIL file;
+    FRESULT fr = f_open(&file, RWSD_CLOCK_PROFILE_PATH, FA_WRITE | FA_CREATE_ALWAYS);
+    if (fr == FR_OK) {
+        UINT bw = 0;
+        fr = f_write(&file, &record, sizeof(record), &bw);
+        FRESULT close_fr = f_close(&file);
+        if (fr == FR_OK) {
+            fr = (bw == sizeof(record)) ? close_fr : FR_DENIED;
+        }
+        note_fat_change();
+    }
+    if (fr != FR_OK) {
+        printf("[RWSD] 保存时钟配置失败，错误码: %d\n", fr);
+    }
+    
+    // 写保护等原因保存失败时也不再重试，避免每次后台轮询都写卡
+    profile_clock_ = clock_hz;
+}
+
+uint32_t RWSD::get_spi_clock() const {
+    return pico_fatfs_get_clk_fast_freq();
+}
+
 // === 错误码转换 ===
 
 ErrorCode RWSD::fresult_to_error_code(FRESULT fr) const {
@@ -222,10 +395,12 @@ ErrorCode RWSD::fresult_to_error_code(FRESULT fr) const {
 // === 文件系统信息 ===
 
 std::string RWSD::get_filesystem_type() const {
-    switch (fs_type_) {
-        case 1: return "FAT12";
-        case 2: return "FAT16";
-        case 3: return "FAT32";
+    // 由f_mount解析的BPB直接给出，无需任何额外磁盘访问
+    switch (fs_.fs_type) {
+        case FS_FAT12: return "FAT12";
+        case FS_FAT16: return "FAT16";
+        case FS_FAT32: return "FAT32";
+        case FS_EXFAT: return "exFAT";
         default: return "Unknown";
     }
 }
@@ -235,15 +410,25 @@ Result<std::pair<size_t, size_t>> RWSD::get_capacity() const {
         return Result<std::pair<size_t, size_t>>(ErrorCode::INIT_FAILED);
     }
     
-    DWORD fre_clust, fre_sect, tot_sect;
+    auto mounted = ensure_mounted();
+    if (!mounted.is_ok()) {
+        return Result<std::pair<size_t, size_t>>(mounted.error_code());
+    }
+    
+    // 空闲簇数已知时FatFs直接返回缓存值；否则同步完成统计 (并缓存到 fs_.free_clst)
+    DWORD fre_clust;
     FATFS* fs_ptr = const_cast<FATFS*>(&fs_);
+    if (!is_free_space_known()) {
+        printf("[RWSD] 空闲空间尚未统计，同步扫描FAT...\n");
+        free_scan_.active = false;
+    }
     FRESULT fr = f_getfree("", &fre_clust, &fs_ptr);
     if (fr != FR_OK) {
         return Result<std::pair<size_t, size_t>>(fresult_to_error_code(fr));
     }
     
-    tot_sect = (fs_.n_fatent - 2) * fs_.csize;
-    fre_sect = fre_clust * fs_.csize;
+    uint64_t tot_sect = (uint64_t)(fs_.n_fatent - 2) * fs_.csize;
+    uint64_t fre_sect = (uint64_t)fre_clust * fs_.csize;
     
     size_t total_bytes = tot_sect * 512;
     size_t free_bytes = fre_sect * 512;
@@ -251,6 +436,125 @@ Result<std::pair<size_t, size_t>> RWSD::get_capacity() const {
     return Result<std::pair<size_t, size_t>>({total_bytes, free_bytes});
 }
 
+bool RWSD::is_free_space_known() const {
+    return fs_.fs_type != 0 && fs_.free_clst <= fs_.n_fatent - 2;
+}
+
+bool RWSD::poll_background() {
+    if (!is_initialized_) {
+        return false;
+    }
+    
+    // 第一步：完成延迟挂载
+    if (fs_.fs_type == 0) {
+        ensure_mounted();
+        return fs_.fs_type != 0;
+    }
+    
+    // 写回超过 PICO_FATFS_CACHE_FLUSH_MS 的脏扇区 (缓存脏扇区不算未完成的后台工作)
+    if (pico_fatfs_cache_poll() != RES_OK) {
+        printf("[RWSD] 扇区缓存定时写回失败，稍后重试\n");
+    }
+    
+#if RWSD_ADAPTIVE_CLOCK
+    // 第二步：挂载完成后读取时钟配置并协商快速时钟
+    if (!clock_negotiated_) {
+        negotiate_clock();
+        return true;
+    }
+    
+    // 运行中因传输错误降频后更新配置文件，下次启动直接从较低的时钟开始验证
+    uint32_t clock = pico_fatfs_get_clk_fast_freq();
+    if (profile_clock_ != 0 && clock < profile_clock_) {
+        printf("[RWSD] SPI时钟已降至 %lu kHz，更新时钟配置\n", (unsigned long)(clock / 1000));
+        save_clock_profile(clock);
+        return true;
+    }
+#endif
+    
+    if (is_free_space_known()) {
+        return false;
+    }
+    
+    uint32_t start_us = time_us_32();
+    bool more = free_space_scan_step();
+    timing_.free_scan_us += time_us_32() - start_us;
+    timing_.free_scan_steps++;
+    
+    if (!more && is_free_space_known()) {
+        printf("[RWSD] 空闲空间统计完成: %lu 簇空闲, %lu 步, 用时 %lu us\n",
+               (unsigned long)fs_.free_clst, (unsigned long)timing_.free_scan_steps,
+               (unsigned long)timing_.free_scan_us);
+    }
+    return more;
+}
+
+bool RWSD::free_space_scan_step() const {
+    FATFS* fs = const_cast<FATFS*>(&fs_);
+    
+    // FAT12表项跨扇区、exFAT使用分配位图，表都很小或已有位图，交给 f_getfree 一次完成
+    if (fs->fs_type != FS_FAT16 && fs->fs_type != FS_FAT32) {
+        DWORD fre_clust;
+        f_getfree("", &fre_clust, &fs);
+        return false;
+    }
+    
+    // 统计期间FAT被修改 (已扫描过的区域可能已变化)：重新开始，多次失败后一次性扫描
+    if (!free_scan_.active || free_scan_.generation != fat_generation_) {
+        uint8_t restarts = free_scan_.active ? free_scan_.restarts + 1 : free_scan_.restarts;
+        if (restarts > RWSD_FREE_SCAN_MAX_RESTARTS) {
+            DWORD fre_clust;
+            f_getfree("", &fre_clust, &fs);
+            free_scan_.active = false;
+            return false;
+        }
+        free_scan_ = FreeSpaceScan{2, 0, fat_generation_, restarts, true};
+    }
+    
+    const bool fat32 = fs->fs_type == FS_FAT32;
+    const DWORD per_sector = fat32 ? 512 / 4 : 512 / 2;
+    BYTE buffer[FF_MAX_SS];
+    
+    for (int i = 0; i < RWSD_FREE_SCAN_SECTORS && free_scan_.next_cluster < fs->n_fatent; i++) {
+        DWORD sector_index = free_scan_.next_cluster / per_sector;
+        LBA_t sector = fs->fatbase + sector_index;
+        
+        // FatFs窗口中的扇区可能比卡上的新 (尚未写回)
+        const BYTE* data = fs->win;
+        if (fs->winsect != sector) {
+            if (disk_read(fs->pdrv, buffer, sector, 1) != RES_OK) {
+                free_scan_.active = false;
+                return false;
+            }
+            data = buffer;
+        }
+        
+        DWORD end = (sector_index + 1) * per_sector;
+        if (end > fs->n_fatent) {
+            end = fs->n_fatent;
+        }
+        for (DWORD clst = free_scan_.next_cluster; clst < end; clst++) {
+            const BYTE* p = data + (clst % per_sector) * (fat32 ? 4 : 2);
+            DWORD value = fat32 ? ((DWORD)p[0] | ((DWORD)p[1] << 8) | ((DWORD)p[2] << 16) | ((DWORD)(p[3] & 0x0F) << 24))
+                                : ((DWORD)p[0] | ((DWORD)p[1] << 8));
+            if (value == 0) {
+                free_scan_.free_count++;
+            }
+        }
+        free_scan_.next_cluster = end;
+    }
+    
+    if (free_scan_.next_cluster < fs->n_fatent) {
+        return true;
+    }
+    
+    // 写入FatFs：此后分配/释放簇时由FatFs增量维护，FAT32下次同步时写回FSINFO
+    fs->free_clst = free_scan_.free_count;
+    fs->fsi_flag |= 1;
+    free_scan_.active = false;
+    return false;
+}
+
 // === 目录操作 ===
 
 Result<std::vector<FileInfo>> RWSD::list_directory(const std::string& path) {
@@ -297,34 +601,29 @@ Result<std::vector<FileInfo>> RWSD::list_directory(const std::string& path) {
         info.size = fno.fsize;
         info.is_directory = (fno.fattrib & AM_DIR) != 0;
         info.attributes = fno.fattrib;
+        info.modified = ((uint32_t)fno.fdate << 16) | fno.ftime;
         
-        files.push_back(info);
+        files.push_back(std::move(info));
     }
     
     f_closedir(&dir);
-    return Result<std::vector<FileInfo>>(files);
+    return Result<std::vector<FileInfo>>(std::move(files));
 }
 
-Result<std::string> RWSD::list_directory_tree(const std::string& path, int max_depth) const {
+Result<DirListing> RWSD::list_directory_into(const std::string& path, ListingArena& arena) const {
     if (!is_initialized_) {
-        return Result<std::string>(ErrorCode::INIT_FAILED);
-    }
-    
-    if (max_depth <= 0) {
-        return Result<std::string>("[达到最大深度限制]\n");
+        return Result<DirListing>(ErrorCode::INIT_FAILED);
     }
     
-    std::string result;
-    std::vector<FileInfo> files;
     DIR dir;
     FILINFO fno;
+    DirListing listing;
     
     FRESULT fr = f_opendir(&dir, path.c_str());
     if (fr != FR_OK) {
-        return Result<std::string>(fresult_to_error_code(fr));
+        return Result<DirListing>(fresult_to_error_code(fr));
     }
     
-    // 收集所有文件和目录
     while (true) {
         fr = f_readdir(&dir, &fno);
         if (fr != FR_OK || fno.fname[0] == 0) {
@@ -336,82 +635,283 @@ Result<std::string> RWSD::list_directory_tree(const std::string& path, int max_d
             continue;
         }
         
-        // 当FF_USE_LFN启用时，fname字段包含长文件名（GBK编码）
-        std::string name = fno.fname;
+        // 同一类型顺序分配，目录项在arena中连续存放
+        DirEntry* entry = static_cast<DirEntry*>(arena.allocate(sizeof(DirEntry), alignof(DirEntry)));
+        if (!entry) {
+            listing.truncated = true;
+            break;
+        }
+        if (!listing.entries) {
+            listing.entries = entry;
+        }
+        entry->assign(fno);
+        listing.count++;
+    }
+    
+    f_closedir(&dir);
+    
+    if (fr != FR_OK) {
+        return Result<DirListing>(fresult_to_error_code(fr));
+    }
+    
+    return Result<DirListing>(listing);
+}
+
+// 目录树遍历的共享状态，路径缓冲区和FILINFO都放在arena中以减少递归栈占用
+struct RWSD::TreeWalkContext {
+    ListingArena& arena;
+    const TreeVisitor& visitor;
+    int max_depth;
+    char* path;
+    FILINFO* fno;
+    bool stopped;
+    bool truncated;     // 有子目录因arena空间不足被跳过
+};
+
+static bool dir_entry_less(const DirEntry& a, const DirEntry& b) {
+    // 目录优先，然后按名称排序
+    if (a.is_directory() != b.is_directory()) {
+        return a.is_directory();
+    }
+    return strcmp(a.name, b.name) < 0;
+}
+
+static bool is_dot_entry(const FILINFO& fno) {
+    return strcmp(fno.fname, ".") == 0 || strcmp(fno.fname, "..") == 0;
+}
+
+Result<void> RWSD::walk_level(TreeWalkContext& ctx, size_t path_len, int depth) const {
+    size_t level_mark = ctx.arena.mark();
+    
+    DIR* dir = ctx.arena.create<DIR>();
+    if (!dir) {
+        ctx.truncated = true;
+        return Result<void>(ErrorCode::INVALID_PARAMETER, "arena空间不足");
+    }
+    
+    FRESULT fr = f_opendir(dir, ctx.path);
+    if (fr != FR_OK) {
+        ctx.arena.rewind(level_mark);
+        return Result<void>(fresult_to_error_code(fr));
+    }
+    
+    // 访问一项并在需要时递归进入子目录
+    auto visit = [&](const DirEntry& entry, bool is_last) -> bool {
+        if (!ctx.visitor(entry, depth, is_last)) {
+            ctx.stopped = true;
+            return false;
+        }
+        if (!entry.is_directory() || depth + 1 >= ctx.max_depth) {
+            return true;
+        }
         
-        FileInfo info;
-        info.name = name;
-        info.full_path = path + "/" + name;
-        info.size = fno.fsize;
-        info.is_directory = (fno.fattrib & AM_DIR) != 0;
+        size_t name_len = strlen(entry.name);
+        size_t sub_len = path_len + 1 + name_len;
+        if (sub_len + 1 > RWSD_TREE_PATH_MAX) {
+            printf("[RWSD] 路径过长，跳过子目录: %s\n", entry.name);
+            return true;
+        }
+        
+        ctx.path[path_len] = '/';
+        memcpy(ctx.path + path_len + 1, entry.name, name_len + 1);
+        walk_level(ctx, sub_len, depth + 1);  // 子目录错误与原实现一致：跳过
+        ctx.path[path_len] = '\0';
+        return !ctx.stopped;
+    };
+    
+    // 先尝试把本层全部收集到arena中排序
+    size_t entries_mark = ctx.arena.mark();
+    DirEntry* entries = nullptr;
+    size_t count = 0;
+    bool overflow = false;
+    
+    while (true) {
+        fr = f_readdir(dir, ctx.fno);
+        if (fr != FR_OK || ctx.fno->fname[0] == 0) {
+            break;
+        }
+        if (is_dot_entry(*ctx.fno)) {
+            continue;
+        }
         
-        files.push_back(info);
+        DirEntry* entry = static_cast<DirEntry*>(ctx.arena.allocate(sizeof(DirEntry), alignof(DirEntry)));
+        if (!entry) {
+            overflow = true;
+            break;
+        }
+        if (!entries) {
+            entries = entry;
+        }
+        entry->assign(*ctx.fno);
+        count++;
     }
     
-    f_closedir(&dir);
+    Result<void> result;
     
-    // 按名称排序
-    std::sort(files.begin(), files.end(), [](const FileInfo& a, const FileInfo& b) {
-        // 目录优先，然后按名称排序
-        if (a.is_directory != b.is_directory) {
-            return a.is_directory > b.is_directory;
+    if (fr != FR_OK) {
+        result = Result<void>(fresult_to_error_code(fr));
+    } else if (!overflow) {
+        f_closedir(dir);
+        std::sort(entries, entries + count, dir_entry_less);
+        for (size_t i = 0; i < count; ++i) {
+            if (!visit(entries[i], i == count - 1)) {
+                break;
+            }
+        }
+        ctx.arena.rewind(level_mark);
+        return result;
+    } else {
+        // 本层放不下：退化为目录原始顺序流式输出，只保留当前项和一个预读项
+        ctx.arena.rewind(entries_mark);
+        DirEntry* current = static_cast<DirEntry*>(ctx.arena.allocate(sizeof(DirEntry), alignof(DirEntry)));
+        DirEntry* next = static_cast<DirEntry*>(ctx.arena.allocate(sizeof(DirEntry), alignof(DirEntry)));
+        if (!current || !next) {
+            ctx.truncated = true;
+            result = Result<void>(ErrorCode::INVALID_PARAMETER, "arena空间不足");
+        } else {
+            // 读取下一个有效目录项，目录结束返回false
+            auto read_next = [&](DirEntry* out) -> bool {
+                while (true) {
+                    fr = f_readdir(dir, ctx.fno);
+                    if (fr != FR_OK || ctx.fno->fname[0] == 0) {
+                        return false;
+                    }
+                    if (!is_dot_entry(*ctx.fno)) {
+                        out->assign(*ctx.fno);
+                        return true;
+                    }
+                }
+            };
+            
+            f_readdir(dir, nullptr);  // 回到目录开头
+            bool has_current = read_next(current);
+            while (has_current) {
+                bool has_next = read_next(next);
+                if (!visit(*current, !has_next)) {
+                    break;
+                }
+                std::swap(current, next);
+                has_current = has_next;
+            }
+            if (fr != FR_OK) {
+                result = Result<void>(fresult_to_error_code(fr));
+            }
         }
-        return a.name < b.name;
-    });
+    }
+    
+    f_closedir(dir);
+    ctx.arena.rewind(level_mark);
+    return result;
+}
+
+Result<bool> RWSD::walk_directory_tree(const std::string& path, ListingArena& arena,
+                                       const TreeVisitor& visitor, int max_depth) const {
+    if (!is_initialized_) {
+        return Result<bool>(ErrorCode::INIT_FAILED);
+    }
+    
+    if (max_depth <= 0 || !visitor) {
+        return Result<bool>(ErrorCode::INVALID_PARAMETER);
+    }
+    
+    // 去掉结尾的'/'，子路径统一用 "/" 拼接
+    size_t path_len = path.size();
+    while (path_len > 0 && path[path_len - 1] == '/') {
+        path_len--;
+    }
+    if (path_len + 1 > RWSD_TREE_PATH_MAX) {
+        return Result<bool>(ErrorCode::INVALID_PARAMETER);
+    }
+    
+    size_t walk_mark = arena.mark();
+    char* path_buf = static_cast<char*>(arena.allocate(RWSD_TREE_PATH_MAX, 1));
+    FILINFO* fno = arena.create<FILINFO>();
+    if (!path_buf || !fno) {
+        arena.rewind(walk_mark);
+        return Result<bool>(ErrorCode::INVALID_PARAMETER, "arena空间不足");
+    }
+    
+    memcpy(path_buf, path.data(), path_len);
+    path_buf[path_len] = '\0';
     
-    // 构建树形输出
-    for (size_t i = 0; i < files.size(); ++i) {
-        const auto& file = files[i];
-        bool is_last = (i == files.size() - 1);
+    TreeWalkContext ctx{arena, visitor, max_depth, path_buf, fno, false, false};
+    Result<void> result = walk_level(ctx, path_len, 0);
+    
+    arena.rewind(walk_mark);
+    if (!result.is_ok()) {
+        return Result<bool>(result.error_code(), result.error_message());
+    }
+    return Result<bool>(!ctx.truncated);
+}
+
+Result<std::string> RWSD::list_directory_tree(const std::string& path, int max_depth) const {
+    // 所有调用共用一块静态arena，遍历结束后回退，不再每次分配
+    static StaticListingArena<RWSD_TREE_ARENA_SIZE> arena;
+    return list_directory_tree(path, arena, max_depth);
+}
+
+Result<std::string> RWSD::list_directory_tree(const std::string& path, ListingArena& arena, int max_depth) const {
+    if (!is_initialized_) {
+        return Result<std::string>(ErrorCode::INIT_FAILED);
+    }
+    
+    if (max_depth <= 0) {
+        return Result<std::string>("[达到最大深度限制]\n");
+    }
+    
+    // 遍历期间不再有其他堆分配 (输出字符串除外)
+    std::string result;
+    result.reserve(1024);
+    uint32_t last_mask = 0;  // 第i位: 深度i的祖先是否为同级最后一项
+    
+    auto visitor = [&](const DirEntry& entry, int depth, bool is_last) -> bool {
+        if (depth < 32) {
+            if (is_last) {
+                last_mask |= (1u << depth);
+            } else {
+                last_mask &= ~(1u << depth);
+            }
+        }
         
         // 添加前缀
-        std::string prefix = (max_depth == 10) ? "" : std::string((10 - max_depth) * 2, ' ');
-        if (!prefix.empty()) {
-            prefix += (is_last ? "└── " : "├── ");
+        if (depth > 0) {
+            result += "  ";
+            for (int i = 1; i < depth; ++i) {
+                bool ancestor_last = i < 32 && (last_mask & (1u << i));
+                result += ancestor_last ? "    " : "│   ";
+            }
+            result += is_last ? "└── " : "├── ";
         }
         
         // 添加文件/目录图标和名称
-        std::string icon = file.is_directory ? "📁" : "📄";
-        result += prefix + icon + " " + file.name;
+        result += entry.is_directory() ? "📁 " : "📄 ";
+        result += entry.name;
         
         // 添加文件大小信息
-        if (!file.is_directory && file.size > 0) {
-            if (file.size < 1024) {
-                result += " (" + std::to_string(file.size) + " B)";
-            } else if (file.size < 1024 * 1024) {
-                result += " (" + std::to_string(file.size / 1024) + " KB)";
+        if (!entry.is_directory() && entry.size > 0) {
+            char size_buf[24];
+            if (entry.size < 1024) {
+                snprintf(size_buf, sizeof(size_buf), " (%lu B)", (unsigned long)entry.size);
+            } else if (entry.size < 1024 * 1024) {
+                snprintf(size_buf, sizeof(size_buf), " (%lu KB)", (unsigned long)(entry.size / 1024));
             } else {
-                result += " (" + std::to_string(file.size / (1024 * 1024)) + " MB)";
+                snprintf(size_buf, sizeof(size_buf), " (%lu MB)", (unsigned long)(entry.size / (1024 * 1024)));
             }
+            result += size_buf;
         }
         result += "\n";
-        
-        // 递归处理子目录
-        if (file.is_directory) {
-            auto sub_result = list_directory_tree(file.full_path, max_depth - 1);
-            if (sub_result.is_ok()) {
-                std::string sub_prefix = (max_depth == 10) ? "" : std::string((10 - max_depth) * 2, ' ');
-                if (!sub_prefix.empty()) {
-                    sub_prefix += (is_last ? "    " : "│   ");
-                }
-                
-                // 为子目录的每一行添加前缀
-                std::string sub_content = *sub_result;
-                size_t pos = 0;
-                while ((pos = sub_content.find('\n', pos)) != std::string::npos) {
-                    if (pos > 0) {
-                        sub_content.insert(pos, sub_prefix);
-                        pos += sub_prefix.length() + 1;
-                    } else {
-                        pos++;
-                    }
-                }
-                result += sub_content;
-            }
-        }
+        return true;
+    };
+    
+    auto walk_result = walk_directory_tree(path, arena, visitor, max_depth);
+    if (!walk_result.is_ok()) {
+        return Result<std::string>(walk_result.error_code(), walk_result.error_message());
+    }
+    if (!*walk_result) {
+        result += "[arena空间不足，目录树不完整]\n";
     }
     
-    return Result<std::string>(result);
+    return Result<std::string>(std::move(result));
 }
 
 Result<void> RWSD::create_directory(const std::string& path) {
@@ -419,6 +919,7 @@ Result<void> RWSD::create_directory(const std::string& path) {
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    note_fat_change();
     FRESULT fr = f_mkdir(path.c_str());
     return Result<void>(fresult_to_error_code(fr));
 }
@@ -428,6 +929,7 @@ Result<void> RWSD::remove_directory(const std::string& path) {
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    note_fat_change();
     FRESULT fr = f_rmdir(path.c_str());
     return Result<void>(fresult_to_error_code(fr));
 }
@@ -461,8 +963,10 @@ Result<FileInfo> RWSD::get_file_info(const std::string& path) const {
     info.full_path = path;
     info.size = fno.fsize;
     info.is_directory = (fno.fattrib & AM_DIR) != 0;
+    info.attributes = fno.fattrib;
+    info.modified = ((uint32_t)fno.fdate << 16) | fno.ftime;
     
-    return Result<FileInfo>(info);
+    return Result<FileInfo>(std::move(info));
 }
 
 // === 一次性读写操作 ===
@@ -489,49 +993,222 @@ Result<std::vector<uint8_t>> RWSD::read_file(const std::string& path) const {
     }
     
     data.resize(bytes_read);
-    return Result<std::vector<uint8_t>>(data);
+    return Result<std::vector<uint8_t>>(std::move(data));
 }
 
 Result<std::vector<uint8_t>> RWSD::read_file_chunk(const std::string& path, 
                                                    size_t offset, size_t size) const {
+    std::vector<uint8_t> data(size);
+    auto result = read_file_chunk_into(path, offset, Span<uint8_t>(data));
+    if (!result.is_ok()) {
+        return Result<std::vector<uint8_t>>(result.error_code(), result.error_message());
+    }
+    
+    data.resize(*result);
+    return Result<std::vector<uint8_t>>(std::move(data));
+}
+
+Result<size_t> RWSD::read_file_chunk_into(const std::string& path, size_t offset,
+                                          Span<uint8_t> buffer) const {
     if (!is_initialized_) {
-        return Result<std::vector<uint8_t>>(ErrorCode::INIT_FAILED);
+        return Result<size_t>(ErrorCode::INIT_FAILED);
     }
     
+    // 优先复用缓存中已打开的句柄：顺序分块读取时 f_lseek 从当前簇继续，
+    // 不必每次重新解析路径并从簇链起点走到偏移处
+    FRESULT fr = FR_OK;
+    FIL* cached = acquire_cached_handle(path, fr);
     FIL file;
-    FRESULT fr = f_open(&file, path.c_str(), FA_READ);
-    if (fr != FR_OK) {
-        return Result<std::vector<uint8_t>>(fresult_to_error_code(fr));
+    FIL* fp = cached;
+    if (!fp) {
+        if (fr != FR_OK) {
+            return Result<size_t>(fresult_to_error_code(fr), fatfs_error_text("f_open", fr));
+        }
+        fr = f_open(&file, path.c_str(), FA_READ);
+        if (fr != FR_OK) {
+            return Result<size_t>(fresult_to_error_code(fr), fatfs_error_text("f_open", fr));
+        }
+        fp = &file;
     }
     
-    fr = f_lseek(&file, offset);
-    if (fr != FR_OK) {
+    const char* op = "f_lseek";
+    if (f_tell(fp) != offset) {
+        fr = f_lseek(fp, offset);
+    }
+    
+    UINT bytes_read = 0;
+    if (fr == FR_OK) {
+        op = "f_read";
+        fr = f_read(fp, buffer.data(), buffer.size(), &bytes_read);
+    }
+    
+    if (!cached) {
         f_close(&file);
-        return Result<std::vector<uint8_t>>(fresult_to_error_code(fr));
+    } else if (fr != FR_OK) {
+        invalidate_cached_handle(path);
     }
     
-    UINT bytes_read;
-    std::vector<uint8_t> data(size);
+    if (fr != FR_OK) {
+        return Result<size_t>(fresult_to_error_code(fr), fatfs_error_text(op, fr));
+    }
     
-    fr = f_read(&file, data.data(), size, &bytes_read);
-    f_close(&file);
+    return Result<size_t>(static_cast<size_t>(bytes_read));
+}
+
+// === 只读句柄缓存 ===
+
+FIL* RWSD::acquire_cached_handle(const std::string& path, FRESULT& fr) const {
+    fr = FR_OK;
+    if (handle_cache_limit_ == 0) {
+        return nullptr;
+    }
+    
+    std::string key = fat_path_key(path);
+    const WriterBucket& bucket = writer_buckets_[writer_bucket(key)];
+    
+    // 写句柄打开期间其写入不会反映到缓存FIL的缓冲区和文件大小：不缓存，由调用者临时打开
+    if (bucket.writers > 0) {
+        invalidate_cached_handle(path);
+        handle_cache_stats_.bypasses++;
+        return nullptr;
+    }
+    
+    handle_cache_tick_++;
+    
+    size_t open_count = 0;
+    CachedHandle* free_slot = nullptr;
+    CachedHandle* lru_slot = nullptr;
+    for (auto& slot : handle_cache_) {
+        if (slot.is_open && slot.path == key) {
+            if (slot.generation == bucket.generation) {
+                slot.last_used = handle_cache_tick_;
+                handle_cache_stats_.hits++;
+                return &slot.file;
+            }
+            // 缓存后有写句柄打开过该路径 (或同桶路径)，重新打开
+            release_cached_handle(slot);
+            handle_cache_stats_.invalidations++;
+        }
+        if (!slot.is_open) {
+            if (!free_slot) free_slot = &slot;
+            continue;
+        }
+        open_count++;
+        if (!lru_slot || slot.last_used < lru_slot->last_used) {
+            lru_slot = &slot;
+        }
+    }
+    
+    handle_cache_stats_.misses++;
+    
+    // 达到上限或没有空槽时淘汰最久未用的句柄
+    CachedHandle* target = free_slot;
+    if (open_count >= handle_cache_limit_ || !target) {
+        if (!lru_slot) {
+            return nullptr;
+        }
+        release_cached_handle(*lru_slot);
+        handle_cache_stats_.evictions++;
+        target = lru_slot;
+    }
     
+    fr = f_open(&target->file, path.c_str(), FA_READ);
     if (fr != FR_OK) {
-        return Result<std::vector<uint8_t>>(fresult_to_error_code(fr));
+        return nullptr;
     }
     
-    data.resize(bytes_read);
-    return Result<std::vector<uint8_t>>(data);
+    target->path = std::move(key);
+    target->last_used = handle_cache_tick_;
+    target->generation = bucket.generation;
+    target->is_open = true;
+    return &target->file;
+}
+
+void RWSD::release_cached_handle(CachedHandle& slot) const {
+    if (slot.is_open) {
+        f_close(&slot.file);
+        slot.is_open = false;
+        slot.path.clear();
+    }
+}
+
+void RWSD::invalidate_cached_handle(const std::string& path) const {
+    std::string key = fat_path_key(path);
+    for (auto& slot : handle_cache_) {
+        if (slot.is_open && slot.path == key) {
+            release_cached_handle(slot);
+            handle_cache_stats_.invalidations++;
+        }
+    }
+}
+
+size_t RWSD::writer_bucket(const std::string& key) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash % RWSD_WRITER_BUCKETS;
+}
+
+void RWSD::invalidate_all_cached_handles() {
+    for (auto& slot : handle_cache_) {
+        if (slot.is_open) {
+            release_cached_handle(slot);
+            handle_cache_stats_.invalidations++;
+        }
+    }
+}
+
+void RWSD::set_handle_cache_limit(size_t limit) {
+    if (limit > RWSD_HANDLE_CACHE_SLOTS) {
+        limit = RWSD_HANDLE_CACHE_SLOTS;
+    }
+    handle_cache_limit_ = limit;
+    
+    // 关闭超出新上限的句柄 (按LRU顺序)
+    while (true) {
+        size_t open_count = 0;
+        CachedHandle* lru_slot = nullptr;
+        for (auto& slot : handle_cache_) {
+            if (!slot.is_open) continue;
+            open_count++;
+            if (!lru_slot || slot.last_used < lru_slot->last_used) {
+                lru_slot = &slot;
+            }
+        }
+        if (open_count <= handle_cache_limit_ || !lru_slot) {
+            break;
+        }
+        release_cached_handle(*lru_slot);
+        handle_cache_stats_.evictions++;
+    }
 }
 
 Result<std::string> RWSD::read_text_file(const std::string& path) const {
-    auto result = read_file(path);
-    if (!result.is_ok()) {
-        return Result<std::string>(result.error_code());
+    if (!is_initialized_) {
+        return Result<std::string>(ErrorCode::INIT_FAILED);
+    }
+    
+    FIL file;
+    FRESULT fr = f_open(&file, path.c_str(), FA_READ);
+    if (fr != FR_OK) {
+        return Result<std::string>(fresult_to_error_code(fr));
     }
     
-    std::string text(reinterpret_cast<const char*>(result->data()), result->size());
-    return Result<std::string>(text);
+    // 直接读入字符串缓冲区，避免先读入vector再拷贝
+    UINT bytes_read = 0;
+    std::string text(f_size(&file), '\0');
+    
+    fr = f_read(&file, &text[0], text.size(), &bytes_read);
+    f_close(&file);
+    
+    if (fr != FR_OK) {
+        return Result<std::string>(fresult_to_error_code(fr));
+    }
+    
+    text.resize(bytes_read);
+    return Result<std::string>(std::move(text));
 }
 
 Result<void> RWSD::write_file(const std::string& path, const std::vector<uint8_t>& data) {
@@ -539,7 +1216,10 @@ Result<void> RWSD::write_file(const std::string& path, const std::vector<uint8_t
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    invalidate_cached_handle(path);
+    
     FIL file;
+    note_fat_change();
     FRESULT fr = f_open(&file, path.c_str(), FA_WRITE | FA_CREATE_ALWAYS);
     if (fr != FR_OK) {
         return Result<void>(fresult_to_error_code(fr));
@@ -566,7 +1246,10 @@ Result<void> RWSD::append_file(const std::string& path, const std::vector<uint8_
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    invalidate_cached_handle(path);
+    
     FIL file;
+    note_fat_change();
     FRESULT fr = f_open(&file, path.c_str(), FA_WRITE | FA_OPEN_APPEND);
     if (fr != FR_OK) {
         return Result<void>(fresult_to_error_code(fr));
@@ -593,6 +1276,9 @@ Result<void> RWSD::delete_file(const std::string& path) {
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    invalidate_cached_handle(path);
+    
+    note_fat_change();
     FRESULT fr = f_unlink(path.c_str());
     return Result<void>(fresult_to_error_code(fr));
 }
@@ -602,17 +1288,109 @@ Result<void> RWSD::rename(const std::string& old_path, const std::string& new_pa
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    // 重命名目录时其下所有路径都会变化，直接全部关闭
+    invalidate_all_cached_handles();
+    
+    note_fat_change();
     FRESULT fr = f_rename(old_path.c_str(), new_path.c_str());
     return Result<void>(fresult_to_error_code(fr));
 }
 
-Result<void> RWSD::copy_file(const std::string& src_path, const std::string& dst_path) {
-    auto read_result = read_file(src_path);
-    if (!read_result.is_ok()) {
-        return Result<void>(read_result.error_code());
+Result<void> RWSD::copy_file(const std::string& src_path, const std::string& dst_path,
+                             bool preallocate) {
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[RWSD_COPY_BUFFER_SIZE]);
+    return copy_file(src_path, dst_path, Span<uint8_t>(buffer.get(), RWSD_COPY_BUFFER_SIZE),
+                     preallocate);
+}
+
+Result<void> RWSD::copy_file(const std::string& src_path, const std::string& dst_path,
+                             Span<uint8_t> buffer, bool preallocate) {
+    if (!is_initialized_) {
+        return Result<void>(ErrorCode::INIT_FAILED);
+    }
+    
+    // FF_FS_LOCK=0 时FatFs不阻止以 FA_CREATE_ALWAYS 打开正在读取的文件：
+    // 源和目标是同一个文件时，打开目标会先把源截断，必须在打开任何文件之前拒绝
+    if (fat_path_key(src_path) == fat_path_key(dst_path)) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER, "源文件与目标文件相同");
+    }
+    
+    invalidate_cached_handle(dst_path);
+    
+    // 按扇区对齐：文件指针始终落在扇区边界上，f_read/f_write 会绕过FIL缓冲区
+    // 直接以多块方式 (CMD18/CMD25) 读写中转缓冲区
+    size_t chunk = buffer.size() - (buffer.size() % FF_MAX_SS);
+    if (chunk == 0) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+    
+    FIL src;
+    FRESULT fr = f_open(&src, src_path.c_str(), FA_READ);
+    if (fr != FR_OK) {
+        return Result<void>(fresult_to_error_code(fr));
+    }
+    
+    FIL dst;
+    note_fat_change();
+    fr = f_open(&dst, dst_path.c_str(), FA_WRITE | FA_CREATE_ALWAYS);
+    if (fr != FR_OK) {
+        f_close(&src);
+        return Result<void>(fresult_to_error_code(fr));
+    }
+    
+    FSIZE_t total = f_size(&src);
+    if (preallocate && total > 0) {
+        // 连续空间不足时返回FR_DENIED，此时退回到写入时按需分配
+        FRESULT efr = f_expand(&dst, total, 1);
+        if (efr != FR_OK) {
+            printf("[RWSD] 目标文件预分配失败(%d)，使用普通分配\n", efr);
+        }
+    }
+    
+    uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+    FSIZE_t copied = 0;
+    
+    while (copied < total) {
+        UINT bytes_read = 0;
+        fr = f_read(&src, buffer.data(), chunk, &bytes_read);
+        if (fr != FR_OK || bytes_read == 0) {
+            break;
+        }
+        
+        UINT bytes_written = 0;
+        fr = f_write(&dst, buffer.data(), bytes_read, &bytes_written);
+        if (fr == FR_OK && bytes_written != bytes_read) {
+            fr = FR_DENIED;  // 磁盘已满
+        }
+        if (fr != FR_OK) {
+            break;
+        }
+        copied += bytes_written;
+    }
+    
+    f_close(&src);
+    FRESULT close_fr = f_close(&dst);
+    if (fr == FR_OK) {
+        fr = close_fr;
+    }
+    
+    if (fr != FR_OK || copied != total) {
+        // 不留下不完整的目标文件
+        f_unlink(dst_path.c_str());
+        if (fr == FR_DENIED) {
+            return Result<void>(ErrorCode::DISK_FULL);
+        }
+        return Result<void>(fr != FR_OK ? fresult_to_error_code(fr) : ErrorCode::IO_ERROR);
     }
     
-    return write_file(dst_path, *read_result);
+    uint32_t elapsed_ms = to_ms_since_boot(get_absolute_time()) - start_ms;
+    if (elapsed_ms > 0) {
+        printf("[RWSD] 复制完成: %lu 字节, %lu ms, %.2f MB/s\n",
+               (unsigned long)copied, (unsigned long)elapsed_ms,
+               (double)copied / 1000.0 / elapsed_ms);
+    }
+    
+    return Result<void>();
 }
 
 Result<void> RWSD::sync() {
@@ -620,17 +1398,39 @@ Result<void> RWSD::sync() {
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
-    // 同步所有打开的文件
-    f_sync(nullptr);
+    // 写回扇区缓存中的脏扇区，并等待卡片内部编程完成
+    // (已打开文件的FatFs缓冲区由 f_sync / FileHandle::flush 负责)
+    if (!write_back_sector_cache()) {
+        return Result<void>(ErrorCode::IO_ERROR, "扇区缓存写回失败");
+    }
     return Result<void>();
 }
 
 // === 文件句柄类实现 ===
 
 RWSD::FileHandle::FileHandle(FileHandle&& other) noexcept 
-    : file_(other.file_), is_open_(other.is_open_), 
+    : file_(other.file_), is_open_(other.is_open_), fast_seek_(other.fast_seek_),
+      writer_bucket_(other.writer_bucket_),
       path_(std::move(other.path_)), mode_(std::move(other.mode_)) {
     other.is_open_ = false;
+    other.fast_seek_ = false;
+    other.writer_bucket_ = -1;
+}
+
+RWSD::FileHandle& RWSD::FileHandle::operator=(FileHandle&& other) noexcept {
+    if (this != &other) {
+        close();
+        file_ = other.file_;
+        is_open_ = other.is_open_;
+        fast_seek_ = other.fast_seek_;
+        writer_bucket_ = other.writer_bucket_;
+        path_ = std::move(other.path_);
+        mode_ = std::move(other.mode_);
+        other.is_open_ = false;
+        other.fast_seek_ = false;
+        other.writer_bucket_ = -1;
+    }
+    return *this;
 }
 
 Result<void> RWSD::FileHandle::open(const std::string& path, const std::string& mode) {
@@ -652,6 +1452,10 @@ Result<void> RWSD::FileHandle::open(const std::string& path, const std::string&
         flags |= FA_OPEN_EXISTING;
     }
     
+    // 只有创建或截断文件会改动FAT/目录簇；打开已有文件原位改写 ("r+") 不打断后台空闲簇统计
+    if (flags & (FA_CREATE_ALWAYS | FA_OPEN_ALWAYS)) {
+        note_fat_change();
+    }
     FRESULT fr = f_open(&file_, path.c_str(), flags);
     if (fr != FR_OK) {
         return Result<void>(static_cast<ErrorCode>(fr));
@@ -661,13 +1465,81 @@ Result<void> RWSD::FileHandle::open(const std::string& path, const std::string&
     path_ = path;
     mode_ = mode;
     
+    // 登记写句柄：关闭前同路径的分块读取不经过句柄缓存，已缓存的句柄在下次命中时失效
+    if (flags & FA_WRITE) {
+        writer_bucket_ = static_cast<int>(writer_bucket(fat_path_key(path)));
+        writer_buckets_[writer_bucket_].writers++;
+        writer_buckets_[writer_bucket_].generation++;
+    }
+    
+    return Result<void>();
+}
+
+Result<void> RWSD::FileHandle::open(const std::string& path, const std::string& mode,
+                                    Span<DWORD> clmt) {
+    auto result = open(path, mode);
+    if (!result.is_ok()) {
+        return result;
+    }
+    
+    auto fast_result = enable_fast_seek(clmt);
+    if (!fast_result.is_ok()) {
+        printf("[RWSD] 快速定位未启用 (%s)，使用普通定位\n", fast_result.error_message().c_str());
+    }
     return Result<void>();
 }
 
+Result<size_t> RWSD::FileHandle::enable_fast_seek(Span<DWORD> clmt) {
+    if (!is_open_) {
+        return Result<size_t>(ErrorCode::INVALID_PARAMETER);
+    }
+    if (file_.flag & FA_WRITE) {
+        return Result<size_t>(ErrorCode::PERMISSION_DENIED, "快速定位仅支持只读文件");
+    }
+    if (clmt.size() < 4) {
+        return Result<size_t>(ErrorCode::INVALID_PARAMETER, "CLMT至少需要4个DWORD");
+    }
+    
+    // 保存当前位置：建表期间 cltbl 生效，之后的 f_lseek 都走查表路径
+    FSIZE_t position = f_tell(&file_);
+    clmt[0] = static_cast<DWORD>(clmt.size());
+    file_.cltbl = clmt.data();
+    
+    FRESULT fr = f_lseek(&file_, CREATE_LINKMAP);
+    if (fr != FR_OK) {
+        // FR_NOT_ENOUGH_CORE 时 clmt[0] 为所需大小
+        size_t required = clmt[0];
+        file_.cltbl = nullptr;
+        fast_seek_ = false;
+        if (fr == FR_NOT_ENOUGH_CORE) {
+            return Result<size_t>(ErrorCode::INVALID_PARAMETER,
+                                  "CLMT过小，需要 " + std::to_string(required) + " 个DWORD");
+        }
+        return Result<size_t>(static_cast<ErrorCode>(fr));
+    }
+    
+    fast_seek_ = true;
+    f_lseek(&file_, position);
+    return Result<size_t>(static_cast<size_t>(clmt[0]));
+}
+
+void RWSD::FileHandle::disable_fast_seek() {
+    if (is_open_) {
+        file_.cltbl = nullptr;
+    }
+    fast_seek_ = false;
+}
+
 void RWSD::FileHandle::close() {
     if (is_open_) {
         f_close(&file_);
+        if (writer_bucket_ >= 0) {
+            writer_buckets_[writer_bucket_].writers--;
+            writer_buckets_[writer_bucket_].generation++;
+            writer_bucket_ = -1;
+        }
         is_open_ = false;
+        fast_seek_ = false;
         path_.clear();
         mode_.clear();
     }
@@ -679,34 +1551,56 @@ Result<std::vector<uint8_t>> RWSD::FileHandle::read(size_t size) {
     }
     
     std::vector<uint8_t> data(size);
-    UINT bytes_read;
+    auto result = read_into(Span<uint8_t>(data));
+    if (!result.is_ok()) {
+        return Result<std::vector<uint8_t>>(result.error_code(), result.error_message());
+    }
     
-    FRESULT fr = f_read(&file_, data.data(), size, &bytes_read);
+    data.resize(*result);
+    return Result<std::vector<uint8_t>>(std::move(data));
+}
+
+Result<size_t> RWSD::FileHandle::read_into(Span<uint8_t> buffer) {
+    if (!is_open_) {
+        return Result<size_t>(ErrorCode::INVALID_PARAMETER);
+    }
+    
+    UINT bytes_read = 0;
+    FRESULT fr = f_read(&file_, buffer.data(), buffer.size(), &bytes_read);
     if (fr != FR_OK) {
-        return Result<std::vector<uint8_t>>(static_cast<ErrorCode>(fr));
+        return Result<size_t>(static_cast<ErrorCode>(fr), fatfs_error_text("f_read", fr));
     }
     
-    data.resize(bytes_read);
-    return Result<std::vector<uint8_t>>(data);
+    return Result<size_t>(static_cast<size_t>(bytes_read));
 }
 
 Result<size_t> RWSD::FileHandle::read_text(std::string& text, size_t max_size) {
-    auto result = read(max_size);
+    // 复用调用者字符串的容量，直接读入
+    text.resize(max_size);
+    auto result = read_into(Span<uint8_t>(reinterpret_cast<uint8_t*>(&text[0]), max_size));
     if (!result.is_ok()) {
-        return Result<size_t>(result.error_code());
+        text.clear();
+        return result;
     }
     
-    text.assign(reinterpret_cast<const char*>(result->data()), result->size());
-    return Result<size_t>(result->size());
+    text.resize(*result);
+    return result;
 }
 
-Result<size_t> RWSD::FileHandle::write(const std::vector<uint8_t>& data) {
+Result<size_t> RWSD::FileHandle::write(Span<const uint8_t> data) {
     if (!is_open_) {
         return Result<size_t>(ErrorCode::INVALID_PARAMETER);
     }
     
+    // 预分配文件内的原位覆盖写不分配簇：只有文件变大 (可能链接新簇) 或首簇变化时才算FAT修改，
+    // 否则环形/传感器日志的每次写入都会让后台空闲簇统计重新开始
+    const FSIZE_t size_before = f_size(&file_);
+    const DWORD sclust_before = file_.obj.sclust;
     UINT bytes_written;
     FRESULT fr = f_write(&file_, data.data(), data.size(), &bytes_written);
+    if (fr != FR_OK || f_size(&file_) != size_before || file_.obj.sclust != sclust_before) {
+        note_fat_change();
+    }
     if (fr != FR_OK) {
         return Result<size_t>(static_cast<ErrorCode>(fr));
     }
@@ -714,9 +1608,12 @@ Result<size_t> RWSD::FileHandle::write(const std::vector<uint8_t>& data) {
     return Result<size_t>(bytes_written);
 }
 
+Result<size_t> RWSD::FileHandle::write(const std::vector<uint8_t>& data) {
+    return write(Span<const uint8_t>(data.data(), data.size()));
+}
+
 Result<size_t> RWSD::FileHandle::write(const std::string& text) {
-    std::vector<uint8_t> data(text.begin(), text.end());
-    return write(data);
+    return write(Span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
 }
 
 Result<size_t> RWSD::FileHandle::write_line(const std::string& line) {
@@ -729,6 +1626,10 @@ Result<void> RWSD::FileHandle::seek(size_t position) {
         return Result<void>(ErrorCode::INVALID_PARAMETER);
     }
     
+    // 写模式下定位到文件末尾之后会扩展文件
+    if ((file_.flag & FA_WRITE) && position > f_size(&file_)) {
+        note_fat_change();
+    }
     FRESULT fr = f_lseek(&file_, position);
     return Result<void>(static_cast<ErrorCode>(fr));
 }
@@ -755,7 +1656,30 @@ Result<void> RWSD::FileHandle::flush() {
     }
     
     FRESULT fr = f_sync(&file_);
-    return Result<void>(static_cast<ErrorCode>(fr));
+    if (fr != FR_OK) {
+        return Result<void>(static_cast<ErrorCode>(fr));
+    }
+    // 显式刷新是持久化点：扇区缓存一并写回 (f_close 不写回，由定时写回处理)
+    if (!write_back_sector_cache()) {
+        return Result<void>(ErrorCode::IO_ERROR, "扇区缓存写回失败");
+    }
+    return Result<void>();
+}
+
+Result<void> RWSD::FileHandle::sync_data() {
+    if (!is_open_) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+    
+    // 写回FIL数据缓冲区，不更新目录项；目录项已与大小/簇链一致时关闭也不会再写目录扇区
+    FRESULT fr = f_sync_data(&file_);
+    if (fr != FR_OK) {
+        return Result<void>(static_cast<ErrorCode>(fr));
+    }
+    if (!write_back_sector_cache()) {
+        return Result<void>(ErrorCode::IO_ERROR);
+    }
+    return Result<void>();
 }
 
 Result<void> RWSD::FileHandle::truncate(size_t size) {
@@ -763,15 +1687,40 @@ Result<void> RWSD::FileHandle::truncate(size_t size) {
         return Result<void>(ErrorCode::INVALID_PARAMETER);
     }
     
+    // 截断点就在文件末尾时不释放簇
+    if (f_tell(&file_) < f_size(&file_)) {
+        note_fat_change();
+    }
     FRESULT fr = f_truncate(&file_);
     return Result<void>(static_cast<ErrorCode>(fr));
 }
 
+Result<void> RWSD::FileHandle::preallocate(size_t size) {
+    if (!is_open_ || !(file_.flag & FA_WRITE)) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+    if (f_size(&file_) != 0) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER, "只能为空文件预分配");
+    }
+    
+    note_fat_change();
+    FRESULT fr = f_expand(&file_, size, 1);
+    if (fr == FR_DENIED) {
+        return Result<void>(ErrorCode::DISK_FULL, "连续空间不足");
+    }
+    return Result<void>(static_cast<ErrorCode>(fr));
+}
+
 Result<RWSD::FileHandle> RWSD::open_file(const std::string& path, const std::string& mode) {
     if (!is_initialized_) {
         return Result<FileHandle>(ErrorCode::INIT_FAILED);
     }
     
+    // 以写方式打开时，缓存的只读句柄会看到过期数据
+    if (mode.find_first_of("wa+") != std::string::npos) {
+        invalidate_cached_handle(path);
+    }
+    
     FileHandle handle;
     auto result = handle.open(path, mode);
     if (!result.is_ok()) {
@@ -788,6 +1737,8 @@ Result<void> RWSD::format(const std::string& volume_label) {
         return Result<void>(ErrorCode::INIT_FAILED);
     }
     
+    invalidate_all_cached_handles();
+    
     BYTE work[FF_MAX_SS];
     MKFS_PARM opt = {0};
     opt.fmt = FM_FAT32;
@@ -796,6 +1747,7 @@ Result<void> RWSD::format(const std::string& volume_label) {
     opt.n_root = 0;
     opt.au_size = 0;
     
+    note_fat_change();
     FRESULT fr = f_mkfs("", &opt, work, sizeof(work));
     if (fr != FR_OK) {
         return Result<void>(fresult_to_error_code(fr));
@@ -803,10 +1755,14 @@ Result<void> RWSD::format(const std::string& volume_label) {
     
     // 设置卷标
     if (!volume_label.empty()) {
+#if FF_USE_LABEL
         fr = f_setlabel(volume_label.c_str());
         if (fr != FR_OK) {
             return Result<void>(fresult_to_error_code(fr));
         }
+#else
+        printf("[RWSD] 未启用卷标支持 (FF_USE_LABEL=0)，忽略卷标\n");
+#endif
     }
     
     return Result<void>();
@@ -868,14 +1824,53 @@ std::string RWSD::get_status_info() const {
     if (is_initialized_) {
         oss << "文件系统类型: " << get_filesystem_type() << "\n";
         
-        auto capacity_result = get_capacity();
-        if (capacity_result.is_ok()) {
-            auto [total, free] = *capacity_result;
-            double usage_percent = total > 0 ? (double)(total - free) / total * 100.0 : 0.0;
-            oss << "总容量: " << (total / 1024 / 1024) << " MB\n";
-            oss << "可用容量: " << (free / 1024 / 1024) << " MB\n";
-            oss << "使用率: " << std::fixed << std::setprecision(1) << usage_percent << "%\n";
+        // 状态显示不触发同步FAT扫描
+        if (is_free_space_known()) {
+            auto capacity_result = get_capacity();
+            if (capacity_result.is_ok()) {
+                auto [total, free] = *capacity_result;
+                double usage_percent = total > 0 ? (double)(total - free) / total * 100.0 : 0.0;
+                oss << "总容量: " << (total / 1024 / 1024) << " MB\n";
+                oss << "可用容量: " << (free / 1024 / 1024) << " MB\n";
+                oss << "使用率: " << std::fixed << std::setprecision(1) << usage_percent << "%\n";
+            }
+        } else {
+            oss << "可用容量: 统计中\n";
         }
+        
+        oss << "启动耗时: SPI " << timing_.spi_init_us
+            << " us, 卡初始化 " << timing_.card_init_us
+            << " us, 挂载 " << timing_.mount_us
+            << " us, 总计 " << timing_.total_us << " us\n";
+        oss << "空闲簇统计: " << timing_.free_scan_steps << " 步, "
+            << timing_.free_scan_us << " us\n";
+        
+        pico_fatfs_link_stats_t link;
+        pico_fatfs_get_link_stats(&link);
+        oss << "SPI时钟: " << (get_spi_clock() / 1000) << " kHz"
+            << " (协商 " << timing_.clock_us << " us, CRC校验"
+            << (pico_fatfs_is_crc_active() ? "开启" : "关闭") << ")\n";
+        oss << "链路错误: 命令 " << link.cmd_errors
+            << ", 数据令牌 " << link.token_errors
+            << ", 写入 " << link.write_errors
+            << ", CRC " << link.crc_errors
+            << ", 重试 " << link.retries
+            << ", 失败 " << link.failed
+            << ", 降频 " << link.clk_steps << " 次\n";
+        
+        oss << "句柄缓存: 命中 " << handle_cache_stats_.hits
+            << ", 未命中 " << handle_cache_stats_.misses
+            << ", 淘汰 " << handle_cache_stats_.evictions
+            << ", 失效 " << handle_cache_stats_.invalidations
+            << ", 绕过 " << handle_cache_stats_.bypasses << "\n";
+
+        pico_fatfs_cache_stats_t cache;
+        pico_fatfs_cache_get_stats(&cache);
+        oss << "扇区缓存: 读命中 " << cache.read_hits
+            << ", 写命中 " << cache.write_hits
+            << ", 写回 " << cache.flushes << " 次"
+            << ", 卡写命令 " << cache.card_writes
+            << " (合并 " << cache.coalesced_writes << ")\n";
     }
     
     return oss.str();
@@ -0,0 +1,324 @@
+/**
+ * @file sensor_log.cpp
+ * @brief 追加式二进制传感器日志读写实现
+ * @version 1.0.0
+ */
+
+#include "hardware/storage/microsd/sensor_log.hpp"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+namespace MicroSD {
+namespace sensor_log {
+
+// === SensorLogWriter ===
+
+SensorLogWriter::SensorLogWriter(RWSD& sd)
+    : sd_(&sd), block_(0), last_time_ms_(0), samples_(0), blocks_written_(0), has_samples_(false) {}
+
+SensorLogWriter::~SensorLogWriter() {
+    if (file_.is_open()) {
+        close();
+    }
+}
+
+Result<void> SensorLogWriter::open(const std::string& path, const Schema& schema, size_t preallocate) {
+    if (!schema.is_valid()) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER, "schema无效");
+    }
+    if (file_.is_open()) {
+        close();
+    }
+
+    auto opened = sd_->open_file(path, "w");
+    if (!opened.is_ok()) {
+        return Result<void>(opened.error_code(), opened.error_message());
+    }
+    file_ = opened.take();
+
+    schema_ = schema;
+    if (schema_.created_ms == 0) {
+        schema_.created_ms = to_ms_since_boot(get_absolute_time());
+    }
+    if (schema_.file_id == 0) {
+        schema_.file_id = time_us_32() | 1;
+    }
+
+    if (preallocate > 0) {
+        // 预分配连续空间：之后每次写块只覆盖数据扇区，不再更新FAT
+        size_t size = (preallocate + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        auto result = file_.preallocate(size);
+        if (!result.is_ok()) {
+            printf("[SensorLog] 预分配失败(%s)，使用普通分配\n", result.error_message().c_str());
+        }
+    }
+
+    encode_header(schema_, scratch_);
+    auto result = write_block(0, scratch_);
+    if (!result.is_ok()) {
+        file_.close();
+        return result;
+    }
+
+    block_ = 1;
+    encoder_.begin(schema_, block_);
+    index_.reset();
+    samples_ = 0;
+    blocks_written_ = 0;
+    has_samples_ = false;
+
+    printf("[SensorLog] 创建日志 %s: %u 通道, 每块 %u 个样本\n",
+           path.c_str(), schema_.channel_count, (unsigned)schema_.samples_per_block());
+    return Result<void>();
+}
+
+Result<void> SensorLogWriter::write_block(uint32_t block_number, const uint8_t* data) {
+    auto seek_result = file_.seek(static_cast<size_t>(block_number) * BLOCK_SIZE);
+    if (!seek_result.is_ok()) {
+        return seek_result;
+    }
+
+    auto result = file_.write(Span<const uint8_t>(data, BLOCK_SIZE));
+    if (!result.is_ok()) {
+        return Result<void>(result.error_code(), result.error_message());
+    }
+    if (*result != BLOCK_SIZE) {
+        return Result<void>(ErrorCode::DISK_FULL);
+    }
+
+    blocks_written_++;
+    return Result<void>();
+}
+
+Result<void> SensorLogWriter::seal_current_block() {
+    auto result = write_block(block_, encoder_.seal());
+    if (!result.is_ok()) {
+        return result;
+    }
+    index_.add(block_, encoder_.first_time());
+    block_++;
+
+    if (is_index_block(block_, schema_.index_interval)) {
+        index_.encode(schema_, block_, scratch_);
+        result = write_block(block_, scratch_);
+        if (!result.is_ok()) {
+            return result;
+        }
+        index_.reset();
+        block_++;
+    }
+
+    encoder_.begin(schema_, block_);
+    return Result<void>();
+}
+
+Result<void> SensorLogWriter::append(const Sample& sample) {
+    if (!file_.is_open()) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+    if (has_samples_ && sample.time_ms < last_time_ms_) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER, "时间戳倒退");
+    }
+
+    if (!encoder_.append(sample)) {
+        // 块已满或增量超出范围：封块后放入新块 (新块首样本为绝对值，必定成功)
+        auto result = seal_current_block();
+        if (!result.is_ok()) {
+            return result;
+        }
+        encoder_.append(sample);
+    }
+
+    last_time_ms_ = sample.time_ms;
+    has_samples_ = true;
+    samples_++;
+    return Result<void>();
+}
+
+Result<void> SensorLogWriter::flush() {
+    if (!file_.is_open()) {
+        return Result<void>(ErrorCode::INVALID_PARAMETER);
+    }
+
+    if (!encoder_.empty()) {
+        auto result = write_block(block_, encoder_.seal());
+        if (!result.is_ok()) {
+            return result;
+        }
+    }
+    return file_.flush();
+}
+
+Result<void> SensorLogWriter::close() {
+    if (!file_.is_open()) {
+        return Result<void>();
+    }
+
+    auto result = flush();
+
+    // 截掉未使用的预分配空间
+    size_t end = static_cast<size_t>(block_ + (encoder_.empty() ? 0 : 1)) * BLOCK_SIZE;
+    auto size = file_.size();
+    if (result.is_ok() && size.is_ok() && *size > end) {
+        file_.seek(end);
+        file_.truncate(end);
+    }
+
+    file_.close();
+    printf("[SensorLog] 关闭日志: %lu 个样本, %lu 次块写入\n",
+           (unsigned long)samples_, (unsigned long)blocks_written_);
+    return result;
+}
+
+// === SensorLogReader ===
+
+SensorLogReader::SensorLogReader(RWSD& sd)
+    : sd_(&sd), end_block_(0), blocks_read_(0) {}
+
+Result<void> SensorLogReader::open(const std::string& path) {
+    close();
+
+    auto opened = sd_->open_file(path, "r");
+    if (!opened.is_ok()) {
+        return Result<void>(opened.error_code(), opened.error_message());
+    }
+    file_ = opened.take();
+
+    if (!read_block(0) || !decode_header(block_buf_, schema_)) {
+        file_.close();
+        return Result<void>(ErrorCode::FATFS_ERROR, "不是有效的传感器日志");
+    }
+
+    auto size = file_.size();
+    uint32_t file_blocks = size.is_ok() ? static_cast<uint32_t>(*size / BLOCK_SIZE) : 0;
+    end_block_ = find_end_block(file_blocks);
+
+    printf("[SensorLog] 打开日志 %s: %lu 个有效块 (检查 %lu 块)\n",
+           path.c_str(), (unsigned long)end_block_, (unsigned long)blocks_read_);
+    return Result<void>();
+}
+
+void SensorLogReader::close() {
+    file_.close();
+    end_block_ = 0;
+    blocks_read_ = 0;
+}
+
+bool SensorLogReader::read_block(uint32_t block_number) {
+    if (!file_.seek(static_cast<size_t>(block_number) * BLOCK_SIZE).is_ok()) {
+        return false;
+    }
+    auto result = file_.read_into(Span<uint8_t>(block_buf_));
+    blocks_read_++;
+    return result.is_ok() && *result == BLOCK_SIZE;
+}
+
+bool SensorLogReader::is_valid_block(uint32_t block_number) {
+    uint32_t magic = is_index_block(block_number, schema_.index_interval) ? INDEX_MAGIC : DATA_MAGIC;
+    return read_block(block_number) && verify_block(block_buf_, magic, schema_.file_id, block_number);
+}
+
+uint32_t SensorLogReader::find_end_block(uint32_t file_blocks) {
+    // 块按顺序写入，有效块构成前缀；预分配区域里的旧数据文件ID或块号不匹配
+    uint32_t lo = 1;
+    uint32_t hi = file_blocks;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (is_valid_block(mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+uint32_t SensorLogReader::find_start_block(uint64_t from_ms) {
+    const uint8_t interval = schema_.index_interval;
+    uint32_t groups = end_block_ >= interval + 2u ? (end_block_ - 2u - interval) / (interval + 1u) + 1 : 0;
+
+    // 在索引块上二分：lo = 首时间 <= from_ms 的索引组数
+    uint32_t lo = 0;
+    uint32_t hi = groups;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        size_t n = read_block(index_block_number(mid, interval))
+                 ? decode_index(block_buf_, schema_, index_block_number(mid, interval), entries_) : 0;
+        if (n > 0 && entries_[0].first_time_ms <= from_ms) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    uint32_t start = 1;
+    uint32_t scan_from = 1;
+    if (lo > 0) {
+        uint32_t group = lo - 1;
+        uint32_t index_block = index_block_number(group, interval);
+        size_t n = read_block(index_block) ? decode_index(block_buf_, schema_, index_block, entries_) : 0;
+        for (size_t i = 0; i < n && entries_[i].first_time_ms <= from_ms; i++) {
+            start = entries_[i].block;
+        }
+        if (lo < groups) {
+            return start;
+        }
+        scan_from = index_block + 1;
+    } else if (groups > 0) {
+        return start;
+    }
+
+    // 末尾尚未写索引块的数据块：逐块检查块头
+    for (uint32_t block = scan_from; block < end_block_; block++) {
+        DataBlockDecoder decoder;
+        if (!read_block(block) || !decoder.open(block_buf_, schema_, block) || decoder.first_time() > from_ms) {
+            break;
+        }
+        start = block;
+    }
+    return start;
+}
+
+Result<size_t> SensorLogReader::query(uint64_t from_ms, uint64_t to_ms,
+                                      const std::function<bool(const Sample&)>& visitor) {
+    if (!file_.is_open() || from_ms > to_ms) {
+        return Result<size_t>(ErrorCode::INVALID_PARAMETER);
+    }
+
+    blocks_read_ = 0;
+    size_t visited = 0;
+
+    for (uint32_t block = find_start_block(from_ms); block < end_block_; block++) {
+        if (is_index_block(block, schema_.index_interval)) {
+            continue;
+        }
+        if (!read_block(block)) {
+            return Result<size_t>(ErrorCode::IO_ERROR);
+        }
+
+        DataBlockDecoder decoder;
+        if (!decoder.open(block_buf_, schema_, block)) {
+            break;
+        }
+
+        Sample sample;
+        while (decoder.next(sample)) {
+            if (sample.time_ms < from_ms) {
+                continue;
+            }
+            if (sample.time_ms > to_ms) {
+                return Result<size_t>(visited);
+            }
+            visited++;
+            if (!visitor(sample)) {
+                return Result<size_t>(visited);
+            }
+        }
+    }
+
+    return Result<size_t>(visited);
+}
+
+} // namespace sensor_log
+} // namespace MicroSD
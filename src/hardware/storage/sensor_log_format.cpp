@@ -0,0 +1,314 @@
+/**
+ * @file sensor_log_format.cpp
+ * @brief 二进制传感器日志编解码实现
+ * @version 1.0.0
+ */
+
+#include "hardware/storage/microsd/sensor_log_format.hpp"
+#include <cstring>
+
+namespace MicroSD {
+namespace sensor_log {
+
+namespace {
+
+// 文件头布局
+constexpr size_t HDR_VERSION = 4;
+constexpr size_t HDR_CHANNEL_COUNT = 6;
+constexpr size_t HDR_INDEX_INTERVAL = 7;
+constexpr size_t HDR_SAMPLE_PERIOD = 8;
+constexpr size_t HDR_FILE_ID = 12;
+constexpr size_t HDR_CREATED = 16;
+constexpr size_t HDR_CHANNELS = 24;
+constexpr size_t HDR_CHANNEL_SIZE = CHANNEL_NAME_LEN + 4;
+
+// 数据块/索引块公共布局
+constexpr size_t BLK_FILE_ID = 4;
+constexpr size_t BLK_NUMBER = 8;
+constexpr size_t DATA_FIRST_TIME = 12;
+constexpr size_t DATA_COUNT = 20;
+constexpr size_t DATA_VALUES = DATA_HEADER_SIZE;
+constexpr size_t INDEX_COUNT = 12;
+
+inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, static_cast<uint16_t>(v));
+    put_u16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+inline void put_u64(uint8_t* p, uint64_t v) {
+    put_u32(p, static_cast<uint32_t>(v));
+    put_u32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+inline uint16_t get_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | (static_cast<uint32_t>(get_u16(p + 2)) << 16);
+}
+
+inline uint64_t get_u64(const uint8_t* p) {
+    return get_u32(p) | (static_cast<uint64_t>(get_u32(p + 4)) << 32);
+}
+
+inline size_t record_size(const Schema& schema) {
+    return 2 + 2 * schema.channel_count;
+}
+
+inline void seal_block(uint8_t* block) {
+    put_u32(block + CRC_OFFSET, crc32(block, CRC_OFFSET));
+}
+
+} // namespace
+
+// === Schema ===
+
+bool Schema::add_channel(const char* name, int32_t scale) {
+    if (channel_count >= MAX_CHANNELS) {
+        return false;
+    }
+    ChannelInfo& ch = channels[channel_count++];
+    strncpy(ch.name, name, CHANNEL_NAME_LEN - 1);
+    ch.name[CHANNEL_NAME_LEN - 1] = '\0';
+    ch.scale = scale > 0 ? scale : 1;
+    return true;
+}
+
+bool Schema::is_valid() const {
+    return channel_count > 0 && channel_count <= MAX_CHANNELS &&
+           index_interval > 0 && index_interval <= MAX_INDEX_INTERVAL;
+}
+
+size_t Schema::samples_per_block() const {
+    if (!is_valid()) {
+        return 0;
+    }
+    size_t header = DATA_HEADER_SIZE + 4 * channel_count;
+    return 1 + (CRC_OFFSET - header) / record_size(*this);
+}
+
+// === CRC32 ===
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    // 半字节查表，表只占64字节
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+// === 文件头 ===
+
+void encode_header(const Schema& schema, uint8_t* block) {
+    memset(block, 0, BLOCK_SIZE);
+    put_u32(block, HEADER_MAGIC);
+    put_u16(block + HDR_VERSION, FORMAT_VERSION);
+    block[HDR_CHANNEL_COUNT] = schema.channel_count;
+    block[HDR_INDEX_INTERVAL] = schema.index_interval;
+    put_u32(block + HDR_SAMPLE_PERIOD, schema.sample_period_ms);
+    put_u32(block + HDR_FILE_ID, schema.file_id);
+    put_u64(block + HDR_CREATED, schema.created_ms);
+    for (size_t i = 0; i < schema.channel_count; i++) {
+        uint8_t* p = block + HDR_CHANNELS + i * HDR_CHANNEL_SIZE;
+        memcpy(p, schema.channels[i].name, CHANNEL_NAME_LEN);
+        put_u32(p + CHANNEL_NAME_LEN, static_cast<uint32_t>(schema.channels[i].scale));
+    }
+    seal_block(block);
+}
+
+bool decode_header(const uint8_t* block, Schema& schema) {
+    if (get_u32(block) != HEADER_MAGIC || get_u16(block + HDR_VERSION) != FORMAT_VERSION) {
+        return false;
+    }
+    if (get_u32(block + CRC_OFFSET) != crc32(block, CRC_OFFSET)) {
+        return false;
+    }
+
+    Schema decoded;
+    decoded.channel_count = block[HDR_CHANNEL_COUNT];
+    decoded.index_interval = block[HDR_INDEX_INTERVAL];
+    decoded.sample_period_ms = get_u32(block + HDR_SAMPLE_PERIOD);
+    decoded.file_id = get_u32(block + HDR_FILE_ID);
+    decoded.created_ms = get_u64(block + HDR_CREATED);
+    if (!decoded.is_valid()) {
+        return false;
+    }
+    for (size_t i = 0; i < decoded.channel_count; i++) {
+        const uint8_t* p = block + HDR_CHANNELS + i * HDR_CHANNEL_SIZE;
+        memcpy(decoded.channels[i].name, p, CHANNEL_NAME_LEN);
+        decoded.channels[i].name[CHANNEL_NAME_LEN - 1] = '\0';
+        decoded.channels[i].scale = static_cast<int32_t>(get_u32(p + CHANNEL_NAME_LEN));
+    }
+    schema = decoded;
+    return true;
+}
+
+bool verify_block(const uint8_t* block, uint32_t magic, uint32_t file_id, uint32_t block_number) {
+    return get_u32(block) == magic &&
+           get_u32(block + BLK_FILE_ID) == file_id &&
+           get_u32(block + BLK_NUMBER) == block_number &&
+           get_u32(block + CRC_OFFSET) == crc32(block, CRC_OFFSET);
+}
+
+// === 数据块编码 ===
+
+void DataBlockEncoder::begin(const Schema& schema, uint32_t block_number) {
+    schema_ = &schema;
+    capacity_ = schema.samples_per_block();
+    count_ = 0;
+    memset(block_, 0, BLOCK_SIZE);
+    put_u32(block_, DATA_MAGIC);
+    put_u32(block_ + BLK_FILE_ID, schema.file_id);
+    put_u32(block_ + BLK_NUMBER, block_number);
+}
+
+bool DataBlockEncoder::append(const Sample& sample) {
+    if (!schema_ || full()) {
+        return false;
+    }
+
+    const size_t channels = schema_->channel_count;
+    if (count_ == 0) {
+        // 首样本以绝对值存放在块头
+        put_u64(block_ + DATA_FIRST_TIME, sample.time_ms);
+        for (size_t i = 0; i < channels; i++) {
+            put_u32(block_ + DATA_VALUES + 4 * i, static_cast<uint32_t>(sample.values[i]));
+        }
+    } else {
+        if (sample.time_ms < last_.time_ms || sample.time_ms - last_.time_ms > UINT16_MAX) {
+            return false;
+        }
+        int16_t deltas[MAX_CHANNELS];
+        for (size_t i = 0; i < channels; i++) {
+            int64_t d = static_cast<int64_t>(sample.values[i]) - last_.values[i];
+            if (d < INT16_MIN || d > INT16_MAX) {
+                return false;
+            }
+            deltas[i] = static_cast<int16_t>(d);
+        }
+
+        uint8_t* p = block_ + DATA_VALUES + 4 * channels + (count_ - 1) * record_size(*schema_);
+        put_u16(p, static_cast<uint16_t>(sample.time_ms - last_.time_ms));
+        for (size_t i = 0; i < channels; i++) {
+            put_u16(p + 2 + 2 * i, static_cast<uint16_t>(deltas[i]));
+        }
+    }
+
+    last_ = sample;
+    count_++;
+    return true;
+}
+
+const uint8_t* DataBlockEncoder::seal() {
+    put_u16(block_ + DATA_COUNT, count_);
+    seal_block(block_);
+    return block_;
+}
+
+uint64_t DataBlockEncoder::first_time() const {
+    return get_u64(block_ + DATA_FIRST_TIME);
+}
+
+// === 数据块解码 ===
+
+bool DataBlockDecoder::open(const uint8_t* block, const Schema& schema, uint32_t block_number) {
+    block_ = nullptr;
+    count_ = 0;
+    index_ = 0;
+    if (!verify_block(block, DATA_MAGIC, schema.file_id, block_number)) {
+        return false;
+    }
+    uint16_t count = get_u16(block + DATA_COUNT);
+    if (count > schema.samples_per_block()) {
+        return false;
+    }
+
+    block_ = block;
+    schema_ = &schema;
+    count_ = count;
+    return true;
+}
+
+bool DataBlockDecoder::next(Sample& sample) {
+    if (!block_ || index_ >= count_) {
+        return false;
+    }
+
+    const size_t channels = schema_->channel_count;
+    if (index_ == 0) {
+        current_.time_ms = get_u64(block_ + DATA_FIRST_TIME);
+        for (size_t i = 0; i < channels; i++) {
+            current_.values[i] = static_cast<int32_t>(get_u32(block_ + DATA_VALUES + 4 * i));
+        }
+    } else {
+        const uint8_t* p = block_ + DATA_VALUES + 4 * channels + (index_ - 1) * record_size(*schema_);
+        current_.time_ms += get_u16(p);
+        for (size_t i = 0; i < channels; i++) {
+            current_.values[i] += static_cast<int16_t>(get_u16(p + 2 + 2 * i));
+        }
+    }
+
+    index_++;
+    sample = current_;
+    return true;
+}
+
+uint64_t DataBlockDecoder::first_time() const {
+    return block_ ? get_u64(block_ + DATA_FIRST_TIME) : 0;
+}
+
+// === 索引块 ===
+
+void IndexBuilder::add(uint32_t block, uint64_t first_time_ms) {
+    if (count_ < MAX_INDEX_INTERVAL) {
+        entries_[count_++] = IndexEntry{block, first_time_ms};
+    }
+}
+
+void IndexBuilder::encode(const Schema& schema, uint32_t block_number, uint8_t* block) const {
+    memset(block, 0, BLOCK_SIZE);
+    put_u32(block, INDEX_MAGIC);
+    put_u32(block + BLK_FILE_ID, schema.file_id);
+    put_u32(block + BLK_NUMBER, block_number);
+    put_u16(block + INDEX_COUNT, static_cast<uint16_t>(count_));
+    for (size_t i = 0; i < count_; i++) {
+        uint8_t* p = block + INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE;
+        put_u32(p, entries_[i].block);
+        put_u64(p + 4, entries_[i].first_time_ms);
+    }
+    seal_block(block);
+}
+
+size_t decode_index(const uint8_t* block, const Schema& schema, uint32_t block_number,
+                    IndexEntry* entries) {
+    if (!verify_block(block, INDEX_MAGIC, schema.file_id, block_number)) {
+        return 0;
+    }
+    size_t count = get_u16(block + INDEX_COUNT);
+    if (count > MAX_INDEX_INTERVAL) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* p = block + INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE;
+        entries[i].block = get_u32(p);
+        entries[i].first_time_ms = get_u64(p + 4);
+    }
+    return count;
+}
+
+} // namespace sensor_log
+} // namespace MicroSD
@@ -0,0 +1,332 @@
+/**
+ * @file text_page_index.cpp
+ * @brief 文本文件分页索引实现
+ * @version 1.0.0
+ */
+
+#include "hardware/storage/microsd/text_page_index.hpp"
+#include "hardware/storage/microsd/sensor_log_format.hpp"
+#include <stdio.h>
+#include <string.h>
+
+namespace MicroSD {
+
+namespace {
+
+// 文件头布局
+constexpr size_t HDR_VERSION = 4;
+constexpr size_t HDR_TEXT_SIZE = 8;
+constexpr size_t HDR_TEXT_MODIFIED = 12;
+constexpr size_t HDR_FINGERPRINT = 16;
+constexpr size_t HDR_PAGES = 20;
+constexpr size_t HDR_FLAGS = 24;
+constexpr size_t HDR_CRC = 28;
+
+constexpr uint32_t FLAG_COMPLETE = 0x01;
+
+inline void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+inline uint32_t get_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+TextPageIndex::TextPageIndex(RWSD& sd)
+    : sd_(&sd), text_size_(0), text_modified_(0), fingerprint_(0),
+      saved_pages_(0), pending_count_(0), complete_(false), failed_(false) {}
+
+TextPageIndex::~TextPageIndex() {
+    close();
+}
+
+Result<void> TextPageIndex::open(const std::string& text_path, const hybrid_font::TextLayout& layout) {
+    close();
+
+    auto info = sd_->get_file_info(text_path);
+    if (!info.is_ok()) {
+        return Result<void>(info.error_code(), info.error_message());
+    }
+    auto opened = sd_->open_file(text_path, "r");
+    if (!opened.is_ok()) {
+        return Result<void>(opened.error_code(), opened.error_message());
+    }
+    text_ = opened.take();
+
+    text_size_ = info->size;
+    text_modified_ = info->modified;
+    fingerprint_ = layout.fingerprint();
+    breaker_ = hybrid_font::PageBreaker(layout);
+
+    index_path_ = text_path + ".pidx";
+    bool reused = load_existing(index_path_);
+    if (!reused) {
+        auto result = create(index_path_);
+        if (!result.is_ok()) {
+            text_.close();
+            return result;
+        }
+    }
+
+    printf("[PageIndex] %s: %s, 已知 %lu 页%s\n", text_path.c_str(),
+           reused ? "使用已有索引" : "新建索引", (unsigned long)page_count(),
+           complete_ ? "" : ", 后台继续扫描");
+    return Result<void>();
+}
+
+bool TextPageIndex::load_existing(const std::string& index_path) {
+    auto opened = sd_->open_file(index_path, "r+");
+    if (!opened.is_ok()) {
+        return false;
+    }
+    index_ = opened.take();
+
+    // 文本被修改 (大小/修改时间) 或排版参数变化时作废
+    uint8_t header[HEADER_SIZE];
+    auto read = index_.read_into(Span<uint8_t>(header));
+    auto size = index_.size();
+    bool valid = read.is_ok() && *read == HEADER_SIZE && size.is_ok() &&
+                 get_u32(header) == MAGIC &&
+                 (header[HDR_VERSION] | (header[HDR_VERSION + 1] << 8)) == VERSION &&
+                 get_u32(header + HDR_CRC) == sensor_log::crc32(header, HDR_CRC) &&
+                 get_u32(header + HDR_TEXT_SIZE) == text_size_ &&
+                 get_u32(header + HDR_TEXT_MODIFIED) == text_modified_ &&
+                 get_u32(header + HDR_FINGERPRINT) == fingerprint_ &&
+                 get_u32(header + HDR_PAGES) > 0 &&
+                 *size >= HEADER_SIZE + static_cast<size_t>(get_u32(header + HDR_PAGES)) * 4;
+    if (!valid) {
+        index_.close();
+        return false;
+    }
+
+    saved_pages_ = get_u32(header + HDR_PAGES);
+    pending_count_ = 0;
+    complete_ = (get_u32(header + HDR_FLAGS) & FLAG_COMPLETE) != 0;
+    if (complete_) {
+        return true;
+    }
+
+    // 从最后保存的页起始处继续扫描 (页起始必为行首，分页状态可以直接复位)
+    auto last = read_entry(saved_pages_ - 1);
+    if (!last.is_ok() || *last > text_size_ || !text_.seek(*last).is_ok()) {
+        index_.close();
+        return false;
+    }
+    breaker_.reset(*last);
+    return true;
+}
+
+Result<void> TextPageIndex::create(const std::string& index_path) {
+    // 扫描期间 page_offset() 要读回已保存的条目
+    auto opened = sd_->open_file(index_path, "w+");
+    if (!opened.is_ok()) {
+        return Result<void>(opened.error_code(), opened.error_message());
+    }
+    index_ = opened.take();
+
+    saved_pages_ = 0;
+    pending_count_ = 0;
+    complete_ = text_size_ == 0;
+    breaker_.reset(0);
+    pending_[pending_count_++] = 0;     // 第0页
+
+    auto result = flush_pending();
+    if (!result.is_ok()) {
+        index_.close();
+    }
+    return result;
+}
+
+Result<void> TextPageIndex::write_header() {
+    uint8_t header[HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    put_u32(header, MAGIC);
+    header[HDR_VERSION] = static_cast<uint8_t>(VERSION);
+    header[HDR_VERSION + 1] = static_cast<uint8_t>(VERSION >> 8);
+    put_u32(header + HDR_TEXT_SIZE, static_cast<uint32_t>(text_size_));
+    put_u32(header + HDR_TEXT_MODIFIED, text_modified_);
+    put_u32(header + HDR_FINGERPRINT, fingerprint_);
+    put_u32(header + HDR_PAGES, saved_pages_);
+    put_u32(header + HDR_FLAGS, complete_ ? FLAG_COMPLETE : 0);
+    put_u32(header + HDR_CRC, sensor_log::crc32(header, HDR_CRC));
+
+    auto result = index_.seek(0);
+    if (!result.is_ok()) {
+        return result;
+    }
+    auto written = index_.write(Span<const uint8_t>(header, HEADER_SIZE));
+    if (!written.is_ok()) {
+        return Result<void>(written.error_code(), written.error_message());
+    }
+    return *written == HEADER_SIZE ? Result<void>() : Result<void>(ErrorCode::DISK_FULL);
+}
+
+Result<void> TextPageIndex::flush_pending() {
+    // 先追加条目再更新头部页数：中途掉电时头部仍指向旧的完整前缀
+    if (pending_count_ > 0) {
+        uint8_t entries[TEXT_INDEX_FLUSH_PAGES * 4];
+        for (uint32_t i = 0; i < pending_count_; i++) {
+            put_u32(entries + i * 4, pending_[i]);
+        }
+        auto result = index_.seek(HEADER_SIZE + static_cast<size_t>(saved_pages_) * 4);
+        if (!result.is_ok()) {
+            return result;
+        }
+        auto written = index_.write(Span<const uint8_t>(entries, pending_count_ * 4));
+        if (!written.is_ok()) {
+            return Result<void>(written.error_code(), written.error_message());
+        }
+        if (*written != pending_count_ * 4) {
+            return Result<void>(ErrorCode::DISK_FULL);
+        }
+        saved_pages_ += pending_count_;
+        pending_count_ = 0;
+    }
+
+    auto result = write_header();
+    if (!result.is_ok()) {
+        return result;
+    }
+    return index_.flush();
+}
+
+Result<uint32_t> TextPageIndex::read_entry(uint32_t page) {
+    if (page >= saved_pages_) {
+        if (page < saved_pages_ + pending_count_) {
+            return Result<uint32_t>(pending_[page - saved_pages_]);
+        }
+        return Result<uint32_t>(ErrorCode::INVALID_PARAMETER, "页号超出已扫描范围");
+    }
+
+    uint8_t entry[4];
+    auto result = index_.seek(HEADER_SIZE + static_cast<size_t>(page) * 4);
+    if (!result.is_ok()) {
+        return Result<uint32_t>(result.error_code(), result.error_message());
+    }
+    auto read = index_.read_into(Span<uint8_t>(entry));
+    if (!read.is_ok() || *read != sizeof(entry)) {
+        return Result<uint32_t>(ErrorCode::IO_ERROR);
+    }
+    return Result<uint32_t>(get_u32(entry));
+}
+
+void TextPageIndex::add_page(size_t page_start) {
+    if (page_start >= text_size_) {
+        return;     // 文本恰好在页末结束，不产生空页
+    }
+    pending_[pending_count_++] = static_cast<uint32_t>(page_start);
+    if (pending_count_ == TEXT_INDEX_FLUSH_PAGES) {
+        auto result = flush_pending();
+        if (!result.is_ok()) {
+            abandon(result);
+        }
+    }
+}
+
+void TextPageIndex::abandon(const Result<void>& error) {
+    // 条目与头部可能只写入了一部分，不再信任索引文件
+    printf("[PageIndex] 索引写入失败: %s，停止扫描\n", error.error_message().c_str());
+    index_.close();
+    text_.close();
+    if (!sd_->delete_file(index_path_).is_ok()) {
+        printf("[PageIndex] 删除索引文件失败: %s\n", index_path_.c_str());
+    }
+    saved_pages_ = 0;
+    pending_count_ = 0;
+    complete_ = false;
+    failed_ = true;
+}
+
+bool TextPageIndex::poll() {
+    if (!is_open() || complete_) {
+        return false;
+    }
+
+    size_t remaining = text_size_ - breaker_.offset();
+    size_t length = remaining < TEXT_INDEX_SCAN_CHUNK ? remaining : TEXT_INDEX_SCAN_CHUNK;
+    auto read = text_.read_into(Span<uint8_t>(chunk_, length));
+    if (!read.is_ok() || *read == 0) {
+        printf("[PageIndex] 读取文本失败，停止扫描\n");
+        return false;
+    }
+
+    breaker_.feed(chunk_, *read, [this](size_t page_start) {
+        if (!failed_) {
+            add_page(page_start);
+        }
+    });
+    if (failed_) {
+        return false;
+    }
+
+    if (breaker_.offset() >= text_size_) {
+        complete_ = true;
+        auto result = flush_pending();
+        if (!result.is_ok()) {
+            abandon(result);
+            return false;
+        }
+        printf("[PageIndex] 扫描完成: %lu 页\n", (unsigned long)page_count());
+        return false;
+    }
+    return true;
+}
+
+Result<size_t> TextPageIndex::page_offset(uint32_t page, bool wait) {
+    if (!is_open()) {
+        return Result<size_t>(ErrorCode::INVALID_PARAMETER);
+    }
+    while (wait && page >= page_count() && poll()) {
+    }
+
+    auto entry = read_entry(page);
+    if (!entry.is_ok()) {
+        return Result<size_t>(entry.error_code(), entry.error_message());
+    }
+    return Result<size_t>(*entry);
+}
+
+Result<uint32_t> TextPageIndex::page_of(size_t offset) {
+    if (!is_open()) {
+        return Result<uint32_t>(ErrorCode::INVALID_PARAMETER);
+    }
+
+    // 最后一个起始偏移 <= offset 的页；第0页起始为0，必定满足
+    uint32_t lo = 0;
+    uint32_t hi = page_count() - 1;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        auto entry = read_entry(mid);
+        if (!entry.is_ok()) {
+            return Result<uint32_t>(entry.error_code(), entry.error_message());
+        }
+        if (*entry <= offset) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return Result<uint32_t>(lo);
+}
+
+void TextPageIndex::close() {
+    if (index_.is_open() && pending_count_ > 0) {
+        auto result = flush_pending();
+        if (!result.is_ok()) {
+            abandon(result);
+        }
+    }
+    index_.close();
+    text_.close();
+    saved_pages_ = 0;
+    pending_count_ = 0;
+    complete_ = false;
+    failed_ = false;
+}
+
+} // namespace MicroSD
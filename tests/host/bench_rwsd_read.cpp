@@ -0,0 +1,150 @@
+/**
+ * @file bench_rwsd_read.cpp
+ * @brief RAM盘上的分块读取基准：返回 vector 的接口与读入调用者缓冲区的接口对比
+ *        (每块的堆分配次数与主机吞吐量；缓冲区接口在顺序读取中不应有任何分配)
+ */
+
+#include "host_test.hpp"
+#include "ram_disk.hpp"
+#include "hardware/storage/microsd/rw_sd.hpp"
+
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+using MicroSD::Span;
+
+namespace {
+
+// 统计测量区间内的全局 operator new 调用
+size_t g_allocations = 0;
+
+constexpr uint32_t DISK_SECTORS = 64u * 1024 * 1024 / 512;
+constexpr size_t FILE_SIZE = 4u * 1024 * 1024;
+constexpr size_t CHUNK = 4096;
+constexpr int PASSES = 4;
+
+struct Measurement {
+    double mb_per_s;
+    double allocations_per_chunk;
+    uint32_t checksum;
+};
+
+uint32_t checksum_add(uint32_t sum, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        sum = sum * 31u + data[i];
+    }
+    return sum;
+}
+
+// 运行 PASSES 遍顺序分块读取；read_chunk 返回读到的字节数，第一遍累加校验和 (其余遍只计时)
+template<typename ReadChunk>
+Measurement measure(ReadChunk read_chunk) {
+    uint32_t sum = 0;
+    size_t chunks = 0;
+    size_t allocations_before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (size_t offset = 0; offset < FILE_SIZE; offset += CHUNK) {
+            if (read_chunk(offset, pass == 0 ? &sum : nullptr) != CHUNK) {
+                return Measurement{0, 0, 0};
+            }
+            chunks++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Measurement m;
+    m.mb_per_s = (double)FILE_SIZE * PASSES / (1024.0 * 1024.0) / seconds;
+    m.allocations_per_chunk = (double)(g_allocations - allocations_before) / chunks;
+    m.checksum = sum;
+    return m;
+}
+
+void report(const char* name, const Measurement& m) {
+    printf("  %-34s %8.1f MB/s  每块分配 %.2f 次\n", name, m.mb_per_s, m.allocations_per_chunk);
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+HOST_TEST(chunked_reads_from_ram_disk) {
+    host::ram_disk_reset(DISK_SECTORS);
+    MicroSD::RWSD sd;
+    REQUIRE(sd.initialize().is_ok());
+    REQUIRE(sd.format().is_ok());
+
+    std::vector<uint8_t> data(FILE_SIZE);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (uint8_t)(i * 7 + (i >> 9));
+    }
+    REQUIRE(sd.write_file("/bench.bin", data).is_ok());
+    uint32_t expected = checksum_add(0, data.data(), data.size());
+    printf("  文件 %zu KB，每块 %zu 字节，%d 遍\n", FILE_SIZE / 1024, CHUNK, PASSES);
+
+    // read_file_chunk：每块一个新 vector
+    Measurement chunk_vec = measure([&](size_t offset, uint32_t* sum) -> size_t {
+        auto r = sd.read_file_chunk("/bench.bin", offset, CHUNK);
+        if (!r.is_ok()) return 0;
+        if (sum) *sum = checksum_add(*sum, r->data(), r->size());
+        return r->size();
+    });
+
+    // read_file_chunk_into：读入同一块缓冲区，复用缓存的句柄
+    static uint8_t buffer[CHUNK];
+    Measurement chunk_into = measure([&](size_t offset, uint32_t* sum) -> size_t {
+        auto r = sd.read_file_chunk_into("/bench.bin", offset, Span<uint8_t>(buffer));
+        if (!r.is_ok()) return 0;
+        if (sum) *sum = checksum_add(*sum, buffer, *r);
+        return *r;
+    });
+
+    // FileHandle::read 与 read_into
+    auto opened = sd.open_file("/bench.bin", "r");
+    REQUIRE(opened.is_ok());
+    auto file = opened.take();
+    Measurement handle_vec = measure([&](size_t offset, uint32_t* sum) -> size_t {
+        if (offset == 0 && !file.seek(0).is_ok()) return 0;
+        auto r = file.read(CHUNK);
+        if (!r.is_ok()) return 0;
+        if (sum) *sum = checksum_add(*sum, r->data(), r->size());
+        return r->size();
+    });
+    Measurement handle_into = measure([&](size_t offset, uint32_t* sum) -> size_t {
+        if (offset == 0 && !file.seek(0).is_ok()) return 0;
+        auto r = file.read_into(Span<uint8_t>(buffer));
+        if (!r.is_ok()) return 0;
+        if (sum) *sum = checksum_add(*sum, buffer, *r);
+        return *r;
+    });
+    file.close();
+
+    report("RWSD::read_file_chunk", chunk_vec);
+    report("RWSD::read_file_chunk_into", chunk_into);
+    report("FileHandle::read", handle_vec);
+    report("FileHandle::read_into", handle_into);
+
+    CHECK_EQ(chunk_vec.checksum, expected);
+    CHECK_EQ(chunk_into.checksum, expected);
+    CHECK_EQ(handle_vec.checksum, expected);
+    CHECK_EQ(handle_into.checksum, expected);
+    // vector 接口每块至少一次分配，缓冲区接口没有
+    CHECK(chunk_vec.allocations_per_chunk >= 1.0);
+    CHECK(handle_vec.allocations_per_chunk >= 1.0);
+    CHECK(chunk_into.allocations_per_chunk == 0.0);
+    CHECK(handle_into.allocations_per_chunk == 0.0);
+
+    // 顺序分块命中缓存的句柄：两种 read_file_chunk 接口共用，整个基准只打开一次
+    CHECK_EQ(sd.get_handle_cache_stats().misses, 1u);
+}
+
+HOST_TEST_MAIN()
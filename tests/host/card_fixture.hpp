@@ -0,0 +1,74 @@
+/**
+ * @file card_fixture.hpp
+ * @brief 模拟SD卡 + 已格式化并挂载的RWSD
+ */
+
+#pragma once
+
+#include "sd_card_model.hpp"
+#include "hardware/storage/microsd/rw_sd.hpp"
+#include "sector_cache.h"
+
+#include <memory>
+
+namespace host {
+
+class CardFixture {
+public:
+    explicit CardFixture(const MicroSD::SPIConfig& config = MicroSD::Config::DEFAULT)
+        : card_(std::make_unique<SdCardModel>(2u * 1024 * 1024, config.pins.pin_cs)),
+          config_(config) {}
+
+    ~CardFixture() { shutdown(); }
+
+    /**
+     * @brief 初始化、格式化 (FAT32) 并挂载
+     */
+    bool format() {
+        if (!start()) return false;
+        if (!sd_->format().is_ok()) return false;
+        // 格式化后重新挂载
+        shutdown();
+        return start();
+    }
+
+    /**
+     * @brief 在现有卡内容上初始化RWSD
+     */
+    bool start() {
+        sd_ = std::make_unique<MicroSD::RWSD>(config_);
+        if (!sd_->initialize().is_ok()) return false;
+        while (sd_->poll_background()) {
+        }
+        return true;
+    }
+
+    /**
+     * @brief 卸载RWSD；缓存中的脏扇区写回本卡后清空，不会漏到下一张模拟卡上
+     */
+    void shutdown() {
+        sd_.reset();
+        pico_fatfs_cache_invalidate();
+    }
+
+    /**
+     * @brief 模拟掉电：丢弃RWSD和缓存中未写回的数据，卡保留已落盘的扇区
+     */
+    void power_loss() {
+        auto image = card_->snapshot();
+        sd_.reset();
+        pico_fatfs_cache_invalidate();  // 写回的数据在掉电后的镜像里不存在
+        card_->restore(image);
+        card_->restore_power();
+    }
+
+    MicroSD::RWSD& sd() { return *sd_; }
+    SdCardModel& card() { return *card_; }
+
+private:
+    std::unique_ptr<SdCardModel> card_;
+    MicroSD::SPIConfig config_;
+    std::unique_ptr<MicroSD::RWSD> sd_;
+};
+
+} // namespace host
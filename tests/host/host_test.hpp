@@ -0,0 +1,81 @@
+/**
+ * @file host_test.hpp
+ * @brief 主机测试的最小断言与用例注册 (每个测试程序一个 main)
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace host {
+
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<TestCase>& test_registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*fn)()) { test_registry().push_back(TestCase{name, fn}); }
+};
+
+inline int run_all_tests() {
+    for (const auto& test : test_registry()) {
+        int before = test_failures();
+        printf("[ RUN  ] %s\n", test.name);
+        test.fn();
+        printf("[ %s ] %s\n", test_failures() == before ? " OK " : "FAIL", test.name);
+    }
+    printf("%zu 个用例, %d 处失败\n", test_registry().size(), test_failures());
+    return test_failures() == 0 ? 0 : 1;
+}
+
+} // namespace host
+
+#define HOST_TEST(name)                                                      \
+    static void name();                                                      \
+    static host::TestRegistrar name##_registrar(#name, &name);               \
+    static void name()
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("  %s:%d: CHECK(%s) 失败\n", __FILE__, __LINE__, #cond);   \
+            host::test_failures()++;                                         \
+        }                                                                    \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                       \
+    do {                                                                     \
+        auto check_a_ = (a);                                                 \
+        auto check_b_ = (b);                                                 \
+        if (!(check_a_ == check_b_)) {                                       \
+            printf("  %s:%d: CHECK_EQ(%s, %s) 失败: %lld != %lld\n", __FILE__, \
+                   __LINE__, #a, #b, (long long)check_a_, (long long)check_b_); \
+            host::test_failures()++;                                         \
+        }                                                                    \
+    } while (0)
+
+// 前置条件不满足时结束当前用例
+#define REQUIRE(cond)                                                        \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("  %s:%d: REQUIRE(%s) 失败\n", __FILE__, __LINE__, #cond); \
+            host::test_failures()++;                                         \
+            return;                                                          \
+        }                                                                    \
+    } while (0)
+
+#define HOST_TEST_MAIN()                                                     \
+    int main() { return host::run_all_tests(); }
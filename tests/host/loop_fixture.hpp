@@ -0,0 +1,58 @@
+/**
+ * @file loop_fixture.hpp
+ * @brief 事件循环的虚拟时钟平台：睡眠即推进虚拟时间，脚本化的中断在到点时提前唤醒
+ */
+
+#pragma once
+
+#include "EventLoop.hpp"
+#include "pico/stdlib.h"
+
+#include <functional>
+#include <map>
+
+namespace host {
+
+class VirtualLoopPlatform : public event_loop::LoopPlatform {
+public:
+    uint64_t now_us() override { return time_us_64(); }
+
+    void sleep_until(uint64_t deadline_us) override {
+        sleeps_++;
+        uint64_t now = time_us_64();
+        // 截止时间之前有中断：推进到中断时刻，在"中断上下文"执行后返回
+        auto irq = irqs_.begin();
+        if (irq != irqs_.end() && irq->first <= deadline_us && irq->first <= limit_us_) {
+            if (irq->first > now) host_advance_us(irq->first - now);
+            auto handler = std::move(irq->second);
+            irqs_.erase(irq);
+            handler();
+            return;
+        }
+        if (deadline_us > limit_us_) deadline_us = limit_us_;
+        if (deadline_us > now) host_advance_us(deadline_us - now);
+    }
+
+    /**
+     * @brief 在绝对时间 time_us 注入一次中断
+     */
+    void at(uint64_t time_us, std::function<void()> irq) { irqs_.emplace(time_us, std::move(irq)); }
+
+    /**
+     * @brief 运行事件循环直到虚拟时间到达 until_us
+     */
+    void run_until(event_loop::EventLoop& loop, uint64_t until_us) {
+        limit_us_ = until_us;
+        while (time_us_64() < until_us) loop.run_once();
+        limit_us_ = UINT64_MAX;
+    }
+
+    uint32_t sleeps() const { return sleeps_; }
+
+private:
+    std::multimap<uint64_t, std::function<void()>> irqs_;
+    uint64_t limit_us_ = UINT64_MAX;
+    uint32_t sleeps_ = 0;
+};
+
+} // namespace host
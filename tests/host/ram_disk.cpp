@@ -0,0 +1,135 @@
+/**
+ * @file ram_disk.cpp
+ * @brief RAM盘 diskio 后端与 pico_fatfs 接口的空实现
+ */
+
+#include "ram_disk.hpp"
+
+#include "ff.h"
+#include "diskio.h"
+#include "tf_card.h"
+#include "sector_cache.h"
+
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t SECTOR_SIZE = 512;
+
+std::vector<uint8_t> g_sectors;
+DSTATUS g_status = STA_NOINIT;
+uint g_clk_fast = CLK_FAST_DEFAULT;
+host::RamDiskStats g_stats;
+
+} // namespace
+
+namespace host {
+
+void ram_disk_reset(uint32_t sector_count) {
+    g_sectors.assign((size_t)sector_count * SECTOR_SIZE, 0);
+    g_status = STA_NOINIT;
+    g_stats = RamDiskStats();
+}
+
+const RamDiskStats& ram_disk_stats() { return g_stats; }
+
+void ram_disk_reset_stats() { g_stats = RamDiskStats(); }
+
+} // namespace host
+
+// === diskio ===
+
+DSTATUS disk_initialize(BYTE drv) {
+    if (drv) return STA_NOINIT;
+    g_status = g_sectors.empty() ? STA_NOINIT : 0;
+    return g_status;
+}
+
+DSTATUS disk_status(BYTE drv) {
+    return drv ? STA_NOINIT : g_status;
+}
+
+DRESULT disk_read(BYTE drv, BYTE* buff, LBA_t sector, UINT count) {
+    if (drv || !count) return RES_PARERR;
+    if (g_status & STA_NOINIT) return RES_NOTRDY;
+    if ((uint64_t)(sector + count) * SECTOR_SIZE > g_sectors.size()) return RES_PARERR;
+    memcpy(buff, g_sectors.data() + (size_t)sector * SECTOR_SIZE, (size_t)count * SECTOR_SIZE);
+    g_stats.sectors_read += count;
+    g_stats.read_calls++;
+    return RES_OK;
+}
+
+DRESULT disk_write(BYTE drv, const BYTE* buff, LBA_t sector, UINT count) {
+    if (drv || !count) return RES_PARERR;
+    if (g_status & STA_NOINIT) return RES_NOTRDY;
+    if ((uint64_t)(sector + count) * SECTOR_SIZE > g_sectors.size()) return RES_PARERR;
+    memcpy(g_sectors.data() + (size_t)sector * SECTOR_SIZE, buff, (size_t)count * SECTOR_SIZE);
+    g_stats.sectors_written += count;
+    g_stats.write_calls++;
+    return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE drv, BYTE cmd, void* buff) {
+    if (drv) return RES_PARERR;
+    if (g_status & STA_NOINIT) return RES_NOTRDY;
+
+    switch (cmd) {
+    case CTRL_SYNC:
+    case CTRL_TRIM:
+        return RES_OK;
+    case GET_SECTOR_COUNT:
+        *(LBA_t*)buff = (LBA_t)(g_sectors.size() / SECTOR_SIZE);
+        return RES_OK;
+    case GET_BLOCK_SIZE:
+        *(DWORD*)buff = 1;
+        return RES_OK;
+    case MMC_GET_CID:
+        memset(buff, 0, 16);
+        memcpy(buff, "RAMDISK", 7);
+        return RES_OK;
+    default:
+        return RES_PARERR;
+    }
+}
+
+DWORD get_fattime(void) {
+    return 0;
+}
+
+// === pico_fatfs 接口：RAM盘没有链路，全部为空操作 ===
+
+bool pico_fatfs_set_config(pico_fatfs_spi_config_t* config) {
+    g_clk_fast = config->clk_fast;
+    return true;
+}
+
+void pico_fatfs_config_spi_pio(PIO pio, uint sm) {}
+
+uint pico_fatfs_get_clk_fast_freq(void) { return g_clk_fast; }
+
+uint pico_fatfs_set_clk_fast_freq(uint freq) {
+    g_clk_fast = freq;
+    return freq;
+}
+
+uint pico_fatfs_negotiate_clk_fast(uint max_freq, uint min_freq) {
+    g_clk_fast = max_freq;
+    return max_freq;
+}
+
+bool pico_fatfs_is_crc_active(void) { return false; }
+
+void pico_fatfs_get_link_stats(pico_fatfs_link_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+DRESULT pico_fatfs_cache_flush(void) { return RES_OK; }
+
+DRESULT pico_fatfs_cache_poll(void) { return RES_OK; }
+
+void pico_fatfs_cache_invalidate(void) {}
+
+void pico_fatfs_cache_get_stats(pico_fatfs_cache_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
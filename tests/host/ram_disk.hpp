@@ -0,0 +1,30 @@
+/**
+ * @file ram_disk.hpp
+ * @brief RAM盘 diskio 后端：代替 tf_card.c 和 sector_cache.c，FatFs 直接读写内存中的扇区
+ *
+ * 用于基准测试：去掉SPI时序与卡模型的开销，只剩 FatFs 和 RWSD 本身的CPU时间与内存分配。
+ * 同时提供 RWSD 用到的 pico_fatfs_* 接口 (时钟、CRC、缓存均为空操作)。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace host {
+
+struct RamDiskStats {
+    uint64_t sectors_read = 0;
+    uint64_t sectors_written = 0;
+    uint32_t read_calls = 0;
+    uint32_t write_calls = 0;
+};
+
+/**
+ * @brief 重新创建一块全零的RAM盘 (下一次 disk_initialize 生效前也可直接访问)
+ */
+void ram_disk_reset(uint32_t sector_count);
+
+const RamDiskStats& ram_disk_stats();
+void ram_disk_reset_stats();
+
+} // namespace host
@@ -0,0 +1,409 @@
+/**
+ * @file sd_card_model.cpp
+ * @brief SPI模式SD卡主机模型实现
+ */
+
+#include "sd_card_model.hpp"
+
+#include <string.h>
+
+namespace host {
+
+namespace {
+
+constexpr uint8_t R1_IDLE = 0x01;
+constexpr uint8_t R1_ILLEGAL = 0x04;
+constexpr uint8_t R1_CRC_ERROR = 0x08;
+constexpr uint8_t R1_PARAM_ERROR = 0x40;
+
+constexpr uint8_t DATA_ACCEPTED = 0x05;
+constexpr uint8_t DATA_CRC_ERROR = 0x0B;
+constexpr uint8_t DATA_WRITE_ERROR = 0x0D;
+
+constexpr int ACMD41_POLLS_UNTIL_READY = 3;
+
+} // namespace
+
+SdCardModel::SdCardModel(uint32_t sector_count, uint cs_pin)
+    : sector_count_(sector_count), cs_pin_(cs_pin) {
+    host_set_spi_device(&SdCardModel::spi_hook, this);
+    host_set_gpio_listener(&SdCardModel::gpio_hook, this);
+}
+
+SdCardModel::~SdCardModel() {
+    host_set_spi_device(nullptr, nullptr);
+    host_set_gpio_listener(nullptr, nullptr);
+}
+
+uint8_t SdCardModel::ref_crc7(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            bool in = ((data[i] >> bit) & 1) ^ ((crc >> 6) & 1);
+            crc = (uint8_t)((crc << 1) & 0x7F);
+            if (in) crc ^= 0x09;
+        }
+    }
+    return crc;
+}
+
+uint16_t SdCardModel::ref_crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+SdCardModel::Sector SdCardModel::read_sector(uint32_t lba) const {
+    auto it = sectors_.find(lba);
+    if (it == sectors_.end()) {
+        Sector zero{};
+        return zero;
+    }
+    return it->second;
+}
+
+void SdCardModel::write_sector(uint32_t lba, const Sector& data) {
+    sectors_[lba] = data;
+}
+
+void SdCardModel::restore_power() {
+    powered_ = true;
+    faults_.power_cut_after_writes = -1;
+    faults_.stuck_busy = false;
+    idle_ = true;
+    app_cmd_ = false;
+    crc_on_ = false;
+    acmd41_polls_ = 0;
+    rx_ = RxState::COMMAND;
+    cmd_len_ = 0;
+    tx_.clear();
+    reading_multi_ = false;
+    writing_multi_ = false;
+    busy_left_ = 0;
+}
+
+uint8_t SdCardModel::spi_hook(void* ctx, uint8_t mosi) {
+    return static_cast<SdCardModel*>(ctx)->exchange(mosi);
+}
+
+void SdCardModel::gpio_hook(void* ctx, uint gpio, bool level) {
+    auto* card = static_cast<SdCardModel*>(ctx);
+    if (gpio != card->cs_pin_) {
+        return;
+    }
+    card->selected_ = !level;
+    if (level) {
+        // 取消片选：DO高阻，未发完的响应丢弃；内部编程 (忙) 继续
+        card->tx_.clear();
+        card->cmd_len_ = 0;
+    }
+}
+
+bool SdCardModel::clock_too_fast() const {
+    return faults_.max_clock_hz != 0 && host_spi_clock_hz() > faults_.max_clock_hz;
+}
+
+uint8_t SdCardModel::exchange(uint8_t mosi) {
+    if (!selected_) {
+        return 0xFF;
+    }
+    stats_.bytes++;
+
+    uint8_t out = 0xFF;
+    if (!tx_.empty()) {
+        out = tx_.front();
+        tx_.pop_front();
+    } else if (faults_.stuck_busy && busy_left_ > 0) {
+        out = 0x00;
+    } else if (busy_left_ > 0) {
+        busy_left_--;
+        out = 0x00;
+    } else if (reading_multi_) {
+        queue_read_block();
+        out = tx_.front();
+        tx_.pop_front();
+    }
+
+    switch (rx_) {
+    case RxState::COMMAND:
+        if (cmd_len_ == 0 && (mosi & 0xC0) != 0x40) {
+            break;
+        }
+        cmd_buf_[cmd_len_++] = mosi;
+        if (cmd_len_ == 6) {
+            cmd_len_ = 0;
+            on_command();
+        }
+        break;
+
+    case RxState::WAIT_TOKEN:
+        if (mosi == 0xFE || (mosi == 0xFC && writing_multi_)) {
+            data_buf_.clear();
+            rx_ = RxState::DATA;
+        } else if (mosi == 0xFD && writing_multi_) {
+            // STOP_TRAN：结束多块写，随后进入忙
+            writing_multi_ = false;
+            rx_ = RxState::COMMAND;
+            busy_left_ = faults_.busy_bytes;
+        } else if ((mosi & 0xC0) == 0x40) {
+            writing_multi_ = false;
+            rx_ = RxState::COMMAND;
+            cmd_buf_[0] = mosi;
+            cmd_len_ = 1;
+        }
+        break;
+
+    case RxState::DATA:
+        data_buf_.push_back(mosi);
+        if (data_buf_.size() == 512 + 2) {
+            finish_write_block();
+        }
+        break;
+    }
+    return out;
+}
+
+void SdCardModel::queue_r1(uint8_t r1) {
+    tx_.push_back(0xFF);    // NCR: 命令后一个字节再响应
+    tx_.push_back(r1);
+}
+
+void SdCardModel::queue_block(const uint8_t* data, size_t len, bool corrupt) {
+    uint16_t crc = ref_crc16(data, len);
+    tx_.push_back(0xFF);
+    tx_.push_back(0xFE);
+    for (size_t i = 0; i < len; i++) {
+        uint8_t b = data[i];
+        if (corrupt && i == len / 2) {
+            b ^= 0x10;
+        }
+        tx_.push_back(b);
+    }
+    tx_.push_back((uint8_t)(crc >> 8));
+    tx_.push_back((uint8_t)crc);
+}
+
+void SdCardModel::queue_read_block() {
+    if (read_lba_ >= sector_count_) {
+        reading_multi_ = false;
+        tx_.push_back(0xFF);
+        return;
+    }
+    Sector data = read_sector(read_lba_++);
+    bool corrupt = clock_too_fast();
+    if (faults_.corrupt_reads > 0) {
+        faults_.corrupt_reads--;
+        corrupt = true;
+    }
+    queue_block(data.data(), data.size(), corrupt);
+    stats_.blocks_read++;
+}
+
+void SdCardModel::finish_write_block() {
+    Sector data;
+    memcpy(data.data(), data_buf_.data(), 512);
+    uint16_t crc = (uint16_t)((data_buf_[512] << 8) | data_buf_[513]);
+    if (clock_too_fast()) {
+        data[100] ^= 0x01;  // 信号完整性不足：线上的数据已经错了
+    }
+
+    uint8_t resp;
+    if (crc_on_ && ref_crc16(data.data(), 512) != crc) {
+        stats_.data_crc_errors++;
+        resp = DATA_CRC_ERROR;
+    } else if (faults_.reject_writes > 0) {
+        faults_.reject_writes--;
+        resp = DATA_WRITE_ERROR;
+    } else {
+        resp = DATA_ACCEPTED;
+        if (faults_.power_cut_after_writes == 0) {
+            powered_ = false;
+        }
+        if (powered_) {
+            sectors_[write_lba_] = data;
+            stats_.blocks_written++;
+            stats_.written_lbas.push_back(write_lba_);
+            if (faults_.power_cut_after_writes > 0) {
+                faults_.power_cut_after_writes--;
+            }
+        }
+        busy_left_ = faults_.stuck_busy ? 1 : faults_.busy_bytes;
+    }
+    tx_.push_back(resp | 0xE0);
+
+    if (writing_multi_ && resp == DATA_ACCEPTED) {
+        write_lba_++;
+        rx_ = RxState::WAIT_TOKEN;
+    } else if (writing_multi_) {
+        rx_ = RxState::WAIT_TOKEN;  // 主机随后发送STOP_TRAN
+    } else {
+        rx_ = RxState::COMMAND;
+    }
+}
+
+void SdCardModel::on_command() {
+    uint8_t cmd = cmd_buf_[0] & 0x3F;
+    uint32_t arg = ((uint32_t)cmd_buf_[1] << 24) | ((uint32_t)cmd_buf_[2] << 16) |
+                   ((uint32_t)cmd_buf_[3] << 8) | cmd_buf_[4];
+    uint8_t crc = cmd_buf_[5] >> 1;
+    bool app = app_cmd_;
+    app_cmd_ = false;
+    stats_.commands++;
+
+    uint8_t idle_bit = idle_ ? R1_IDLE : 0;
+
+    // CMD0/CMD8 总是校验CRC；其余命令只在CRC模式下校验
+    if ((crc_on_ || cmd == 0 || cmd == 8) && ref_crc7(cmd_buf_, 5) != crc) {
+        stats_.cmd_crc_errors++;
+        queue_r1(R1_CRC_ERROR | idle_bit);
+        return;
+    }
+
+    if (cmd == 12) {
+        reading_multi_ = false;
+        tx_.clear();
+        queue_r1(0x00);
+        return;
+    }
+
+    if (idle_ && !(cmd == 0 || cmd == 8 || cmd == 55 || cmd == 58 || cmd == 59 || (app && cmd == 41))) {
+        queue_r1(R1_ILLEGAL | R1_IDLE);
+        return;
+    }
+
+    switch (cmd) {
+    case 0:
+        idle_ = true;
+        crc_on_ = false;
+        acmd41_polls_ = 0;
+        reading_multi_ = false;
+        writing_multi_ = false;
+        queue_r1(R1_IDLE);
+        break;
+
+    case 8:
+        queue_r1(idle_bit);
+        tx_.push_back(0x00);
+        tx_.push_back(0x00);
+        tx_.push_back((uint8_t)((arg >> 8) & 0x0F));
+        tx_.push_back((uint8_t)arg);
+        break;
+
+    case 55:
+        app_cmd_ = true;
+        queue_r1(idle_bit);
+        break;
+
+    case 41:
+        if (!app) {
+            queue_r1(R1_ILLEGAL | idle_bit);
+            break;
+        }
+        if (++acmd41_polls_ >= ACMD41_POLLS_UNTIL_READY) {
+            idle_ = false;
+        }
+        queue_r1(idle_ ? R1_IDLE : 0);
+        break;
+
+    case 58:
+        queue_r1(idle_bit);
+        tx_.push_back(idle_ ? 0x40 : 0xC0);     // 上电完成 + CCS (块寻址)
+        tx_.push_back(0xFF);
+        tx_.push_back(0x80);
+        tx_.push_back(0x00);
+        break;
+
+    case 59:
+        crc_on_ = arg & 1;
+        queue_r1(idle_bit);
+        break;
+
+    case 9: {
+        uint8_t csd[16] = {};
+        uint32_t c_size = sector_count_ / 1024 - 1;
+        csd[0] = 0x40;                          // CSD 2.0
+        csd[5] = 0x59;                          // READ_BL_LEN = 9
+        csd[7] = (uint8_t)((c_size >> 16) & 0x3F);
+        csd[8] = (uint8_t)(c_size >> 8);
+        csd[9] = (uint8_t)c_size;
+        csd[10] = 0x7F;                         // ERASE_BLK_EN, SECTOR_SIZE
+        csd[11] = 0x80;
+        csd[15] = (uint8_t)((ref_crc7(csd, 15) << 1) | 1);
+        queue_r1(0x00);
+        queue_block(csd, sizeof(csd), false);
+        break;
+    }
+
+    case 10: {
+        uint8_t cid[16] = {0x03, 'S', 'D', 'H', 'O', 'S', 'T', '1', 0x10, 0x12, 0x34, 0x56, 0x78, 0x01, 0x6A, 0};
+        cid[15] = (uint8_t)((ref_crc7(cid, 15) << 1) | 1);
+        queue_r1(0x00);
+        queue_block(cid, sizeof(cid), false);
+        break;
+    }
+
+    case 13: {
+        if (!app) {
+            queue_r1(R1_ILLEGAL);
+            break;
+        }
+        uint8_t sds[64] = {};
+        sds[10] = 0x90;     // AU_SIZE = 9 (4MB)
+        queue_r1(0x00);
+        tx_.push_back(0x00);    // R2第二字节
+        queue_block(sds, sizeof(sds), false);
+        break;
+    }
+
+    case 16:
+    case 23:
+    case 32:
+    case 33:
+    case 38:
+        queue_r1(0x00);
+        break;
+
+    case 17:
+    case 18:
+        if (arg >= sector_count_) {
+            queue_r1(R1_PARAM_ERROR);
+            break;
+        }
+        queue_r1(0x00);
+        read_lba_ = arg;
+        if (cmd == 17) {
+            queue_read_block();
+        } else {
+            reading_multi_ = true;
+        }
+        break;
+
+    case 24:
+    case 25:
+        if (arg >= sector_count_) {
+            queue_r1(R1_PARAM_ERROR);
+            break;
+        }
+        queue_r1(0x00);
+        write_lba_ = arg;
+        writing_multi_ = cmd == 25;
+        rx_ = RxState::WAIT_TOKEN;
+        if (cmd == 24) {
+            stats_.single_writes++;
+        } else {
+            stats_.multi_writes++;
+        }
+        break;
+
+    default:
+        queue_r1(R1_ILLEGAL);
+        break;
+    }
+}
+
+} // namespace host
@@ -0,0 +1,120 @@
+/**
+ * @file sd_card_model.hpp
+ * @brief SPI模式SD卡 (SDHC) 的主机模型，挂在 pico_host 的SPI设备接口上
+ *
+ * 按字节实现命令解析、R1/R3/R7响应、数据令牌、数据响应与写后忙等待，
+ * CRC模式 (CMD59) 下校验命令CRC7和写数据CRC16。校验使用独立的按位实现，
+ * 不依赖被测的 sd_crc.c。故障注入用于覆盖重试、降频与掉电路径。
+ */
+
+#pragma once
+
+#include "pico_host.h"
+
+#include <array>
+#include <deque>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace host {
+
+class SdCardModel {
+public:
+    using Sector = std::array<uint8_t, 512>;
+
+    explicit SdCardModel(uint32_t sector_count = 2u * 1024 * 1024, uint cs_pin = 13);
+    ~SdCardModel();
+
+    SdCardModel(const SdCardModel&) = delete;
+    SdCardModel& operator=(const SdCardModel&) = delete;
+
+    // === 介质 ===
+    uint32_t sector_count() const { return sector_count_; }
+    Sector read_sector(uint32_t lba) const;
+    void write_sector(uint32_t lba, const Sector& data);
+    std::unordered_map<uint32_t, Sector> snapshot() const { return sectors_; }
+    void restore(const std::unordered_map<uint32_t, Sector>& image) { sectors_ = image; }
+
+    /**
+     * @brief 掉电后重新上电：清除协议状态，需要重新初始化
+     */
+    void restore_power();
+
+    // === 故障注入 ===
+    struct Faults {
+        uint32_t max_clock_hz = 0;          // 高于此SCK时读数据位翻转、写数据CRC错 (0: 不限)
+        uint32_t corrupt_reads = 0;         // 接下来N个读数据块翻转一位
+        uint32_t reject_writes = 0;         // 接下来N个写数据块返回写错误 (0x0D)
+        uint32_t busy_bytes = 16;           // 每个写入块之后保持忙的字节数
+        bool stuck_busy = false;            // 写入后一直忙
+        int64_t power_cut_after_writes = -1;// 再提交N个块后掉电：之后的写不落盘 (-1: 不掉电)
+    };
+    Faults& faults() { return faults_; }
+
+    // === 统计 ===
+    struct Stats {
+        uint64_t bytes = 0;                 // 片选有效时交换的字节数
+        uint32_t commands = 0;
+        uint32_t cmd_crc_errors = 0;        // 收到的命令CRC7错误
+        uint32_t data_crc_errors = 0;       // 收到的写数据CRC16错误
+        uint32_t blocks_read = 0;
+        uint32_t blocks_written = 0;
+        uint32_t single_writes = 0;         // CMD24
+        uint32_t multi_writes = 0;          // CMD25
+        std::vector<uint32_t> written_lbas; // 按落盘顺序
+    };
+    Stats& stats() { return stats_; }
+    void reset_stats() { stats_ = Stats(); }
+
+    bool crc_mode() const { return crc_on_; }
+    bool powered() const { return powered_; }
+
+    // 独立的参考CRC实现
+    static uint8_t ref_crc7(const uint8_t* data, size_t len);
+    static uint16_t ref_crc16(const uint8_t* data, size_t len);
+
+private:
+    enum class RxState { COMMAND, WAIT_TOKEN, DATA };
+
+    uint32_t sector_count_;
+    uint cs_pin_;
+    std::unordered_map<uint32_t, Sector> sectors_;
+    Faults faults_;
+    Stats stats_;
+
+    bool selected_ = false;
+    bool idle_ = true;
+    bool app_cmd_ = false;
+    bool crc_on_ = false;
+    bool powered_ = true;
+    int acmd41_polls_ = 0;
+
+    RxState rx_ = RxState::COMMAND;
+    uint8_t cmd_buf_[6] = {};
+    int cmd_len_ = 0;
+    std::deque<uint8_t> tx_;
+
+    // 读
+    bool reading_multi_ = false;
+    uint32_t read_lba_ = 0;
+
+    // 写
+    bool writing_multi_ = false;
+    uint32_t write_lba_ = 0;
+    std::vector<uint8_t> data_buf_;
+    uint32_t busy_left_ = 0;
+
+    static uint8_t spi_hook(void* ctx, uint8_t mosi);
+    static void gpio_hook(void* ctx, uint gpio, bool level);
+
+    uint8_t exchange(uint8_t mosi);
+    void on_command();
+    void queue_r1(uint8_t r1);
+    void queue_block(const uint8_t* data, size_t len, bool corrupt);
+    void queue_read_block();
+    void finish_write_block();
+    bool clock_too_fast() const;
+};
+
+} // namespace host
@@ -0,0 +1,103 @@
+/**
+ * @file st7306_model.hpp
+ * @brief ST7306 面板RAM的主机模型，挂在 pico_host 的SPI设备接口上
+ *
+ * 按D/C引脚区分命令和数据，只解释列地址 (0x2A)、行地址 (0x2B) 和写RAM (0x2C)：
+ * 写RAM的数据按窗口逐行填入，每个列地址3字节。记录每次写RAM的窗口和字节数。
+ */
+
+#pragma once
+
+#include "pico_host.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace host {
+
+class St7306Model {
+public:
+    static constexpr int RAM_WIDTH = 150;       // 字节 (50个列地址 x 3)
+    static constexpr int RAM_HEIGHT = 200;      // 行 (每行2行像素)
+    static constexpr uint8_t COLUMN_ADDRESS_START = 0x05;
+
+    // 一次写RAM：列为列地址 (已减去起始偏移)，行为RAM行
+    struct Write {
+        uint8_t col0, col1, row0, row1;
+        size_t bytes;
+    };
+
+    explicit St7306Model(uint dc_pin) : dc_pin_(dc_pin) {
+        memset(ram_, 0, sizeof(ram_));
+        host_set_spi_device(&St7306Model::exchange, this);
+    }
+
+    ~St7306Model() { host_set_spi_device(nullptr, nullptr); }
+
+    St7306Model(const St7306Model&) = delete;
+    St7306Model& operator=(const St7306Model&) = delete;
+
+    uint8_t ram(int row, int byte) const { return ram_[row][byte]; }
+    std::vector<uint8_t> image() const {
+        return std::vector<uint8_t>(&ram_[0][0], &ram_[0][0] + sizeof(ram_));
+    }
+
+    const std::vector<Write>& writes() const { return writes_; }
+    void reset_writes() { writes_.clear(); }
+    size_t data_bytes() const { return data_bytes_; }    // 所有数据字节 (含命令参数)
+
+private:
+    static uint8_t exchange(void* ctx, uint8_t mosi) {
+        static_cast<St7306Model*>(ctx)->on_byte(mosi);
+        return 0xFF;
+    }
+
+    void on_byte(uint8_t b) {
+        if (!gpio_get(dc_pin_)) {
+            command_ = b;
+            param_ = 0;
+            if (command_ == 0x2C) {
+                writes_.push_back(Write{col0_, col1_, row0_, row1_, 0});
+                cursor_col_ = col0_ * 3;
+                cursor_row_ = row0_;
+            }
+            return;
+        }
+        data_bytes_++;
+        switch (command_) {
+            case 0x2A:
+                if (param_ == 0) col0_ = b - COLUMN_ADDRESS_START;
+                if (param_ == 1) col1_ = b - COLUMN_ADDRESS_START;
+                break;
+            case 0x2B:
+                if (param_ == 0) row0_ = b;
+                if (param_ == 1) row1_ = b;
+                break;
+            case 0x2C:
+                writes_.back().bytes++;
+                if (cursor_row_ <= row1_ && cursor_row_ < RAM_HEIGHT && cursor_col_ < RAM_WIDTH) {
+                    ram_[cursor_row_][cursor_col_] = b;
+                }
+                if (++cursor_col_ > col1_ * 3 + 2) {
+                    cursor_col_ = col0_ * 3;
+                    cursor_row_++;
+                }
+                break;
+            default:
+                break;
+        }
+        param_++;
+    }
+
+    uint dc_pin_;
+    uint8_t ram_[RAM_HEIGHT][RAM_WIDTH];
+    uint8_t command_ = 0;
+    int param_ = 0;
+    uint8_t col0_ = 0, col1_ = 49, row0_ = 0, row1_ = RAM_HEIGHT - 1;
+    int cursor_col_ = 0, cursor_row_ = 0;
+    std::vector<Write> writes_;
+    size_t data_bytes_ = 0;
+};
+
+} // namespace host
@@ -0,0 +1,385 @@
+/**
+ * @file pico_host.cpp
+ * @brief 主机测试用的Pico SDK替身实现
+ */
+
+#include "pico_host.h"
+
+extern "C" {
+#include "pio_spi.h"    // 上游头文件没有 extern "C"，tf_card.c 按C链接调用
+}
+
+#include <string>
+#include <vector>
+
+spi_inst_t host_spi_instances[2];
+i2c_inst_t host_i2c_instances[2];
+pio_hw_t host_pio_instances[2];
+
+extern "C" const pio_program_t spi_cpha0_program = {0};
+extern "C" const pio_program_t spi_cpha1_program = {0};
+
+namespace {
+
+constexpr uint32_t HOST_CLK_SYS_HZ = 125 * MHZ;
+constexpr uint32_t HOST_CLK_PERI_HZ = 125 * MHZ;
+
+struct GpioPin {
+    bool level = false;
+    bool out = false;
+    bool pull_up = false;
+    uint32_t irq_enabled = 0;
+    uint32_t irq_latched = 0;
+};
+
+struct RawIrqHandler {
+    uint32_t mask;
+    irq_handler_t handler;
+};
+
+struct HostState {
+    uint64_t time_ns = 0;
+    GpioPin pins[32];
+    std::vector<RawIrqHandler> raw_handlers;
+    gpio_irq_callback_t gpio_callback = nullptr;
+    host_gpio_listener_fn gpio_listener = nullptr;
+    void* gpio_listener_ctx = nullptr;
+    host_spi_device_fn spi_device = nullptr;
+    void* spi_device_ctx = nullptr;
+    host_i2c_device_fn i2c_device = nullptr;
+    void* i2c_device_ctx = nullptr;
+    uint32_t spi_clock_hz = 400 * KHZ;
+    std::string stdin_buffer;
+    void (*chars_available)(void*) = nullptr;
+    void* chars_available_param = nullptr;
+    int dma_next = 0;
+};
+
+HostState state;
+
+// 一个字节8个SCK周期；时间按纳秒累计，避免高时钟下被取整成0
+uint8_t spi_xfer(uint32_t clock_hz, uint8_t mosi) {
+    state.spi_clock_hz = clock_hz;
+    state.time_ns += 8ull * 1000000000ull / (clock_hz ? clock_hz : 1);
+    return state.spi_device ? state.spi_device(state.spi_device_ctx, mosi) : 0xFF;
+}
+
+// PIO SPI：4个PIO周期产生一个SCK周期，clkdiv 为 16.8 定点分频
+uint32_t pio_clock_hz(const pio_spi_inst_t* spi) {
+    uint32_t div = spi->pio->sm[spi->sm].clkdiv;
+    if (div < 0x100) {
+        return HOST_CLK_SYS_HZ / 4;
+    }
+    return (uint32_t)((uint64_t)HOST_CLK_SYS_HZ * 256 / (div >> 8) / 4);
+}
+
+void raise_irq(uint gpio) {
+    for (const auto& entry : state.raw_handlers) {
+        if (entry.mask & (1u << gpio)) {
+            entry.handler();
+        }
+    }
+    if (state.gpio_callback && state.pins[gpio].irq_latched) {
+        uint32_t events = state.pins[gpio].irq_latched;
+        state.pins[gpio].irq_latched = 0;
+        state.gpio_callback(gpio, events);
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+/* ---- 时间 ---- */
+
+absolute_time_t get_absolute_time(void) { return state.time_ns / 1000; }
+uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+absolute_time_t make_timeout_time_ms(uint32_t ms) { return get_absolute_time() + (uint64_t)ms * 1000; }
+absolute_time_t make_timeout_time_us(uint64_t us) { return get_absolute_time() + us; }
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+bool time_reached(absolute_time_t t) { return get_absolute_time() >= t; }
+uint32_t time_us_32(void) { return (uint32_t)get_absolute_time(); }
+uint64_t time_us_64(void) { return get_absolute_time(); }
+void sleep_ms(uint32_t ms) { host_advance_us((uint64_t)ms * 1000); }
+void sleep_us(uint64_t us) { host_advance_us(us); }
+void sleep_until(absolute_time_t t) {
+    if (t > get_absolute_time()) {
+        host_advance_us(t - get_absolute_time());
+    }
+}
+void busy_wait_us(uint64_t us) { host_advance_us(us); }
+void busy_wait_us_32(uint32_t us) { host_advance_us(us); }
+void busy_wait_ms(uint32_t ms) { host_advance_us((uint64_t)ms * 1000); }
+bool best_effort_wfe_or_timeout(absolute_time_t t) {
+    sleep_until(t);
+    return true;
+}
+void tight_loop_contents(void) {}
+
+/* ---- 中断与同步 ---- */
+
+uint32_t save_and_disable_interrupts(void) { return 0; }
+void restore_interrupts(uint32_t status) { (void)status; }
+void __dmb(void) {}
+void __wfe(void) {}
+void __wfi(void) {}
+void __sev(void) {}
+void critical_section_init(critical_section_t* cs) { cs->save = 0; }
+void critical_section_enter_blocking(critical_section_t* cs) { (void)cs; }
+void critical_section_exit(critical_section_t* cs) { (void)cs; }
+void irq_set_enabled(uint num, bool enabled) { (void)num; (void)enabled; }
+
+/* ---- GPIO ---- */
+
+void gpio_init(uint gpio) {
+    state.pins[gpio].out = false;
+    state.pins[gpio].level = state.pins[gpio].pull_up;
+}
+void gpio_init_mask(uint32_t mask) {
+    for (uint pin = 0; pin < 32; pin++) {
+        if (mask & (1u << pin)) gpio_init(pin);
+    }
+}
+void gpio_set_dir(uint gpio, bool out) { state.pins[gpio].out = out; }
+uint gpio_get_dir(uint gpio) { return state.pins[gpio].out ? GPIO_OUT : GPIO_IN; }
+void gpio_put(uint gpio, bool value) {
+    bool changed = state.pins[gpio].level != value;
+    state.pins[gpio].level = value;
+    if (changed && state.gpio_listener) {
+        state.gpio_listener(state.gpio_listener_ctx, gpio, value);
+    }
+}
+bool gpio_get(uint gpio) { return state.pins[gpio].level; }
+uint32_t gpio_get_all(void) {
+    uint32_t value = 0;
+    for (uint pin = 0; pin < 32; pin++) {
+        if (state.pins[pin].level) value |= 1u << pin;
+    }
+    return value;
+}
+void gpio_set_function(uint gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+enum gpio_function gpio_get_function(uint gpio) { (void)gpio; return GPIO_FUNC_SIO; }
+void gpio_pull_up(uint gpio) {
+    state.pins[gpio].pull_up = true;
+    if (!state.pins[gpio].out) state.pins[gpio].level = true;
+}
+void gpio_pull_down(uint gpio) {
+    state.pins[gpio].pull_up = false;
+    if (!state.pins[gpio].out) state.pins[gpio].level = false;
+}
+void gpio_disable_pulls(uint gpio) { state.pins[gpio].pull_up = false; }
+void gpio_set_slew_rate(uint gpio, enum gpio_slew_rate slew) { (void)gpio; (void)slew; }
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive) { (void)gpio; (void)drive; }
+void gpio_set_schmitt(uint gpio, bool enabled) { (void)gpio; (void)enabled; }
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) {
+    if (enabled) {
+        state.pins[gpio].irq_enabled |= events;
+    } else {
+        state.pins[gpio].irq_enabled &= ~events;
+    }
+}
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {
+    state.gpio_callback = callback;
+    gpio_set_irq_enabled(gpio, events, enabled);
+}
+uint32_t gpio_get_irq_event_mask(uint gpio) { return state.pins[gpio].irq_latched; }
+void gpio_acknowledge_irq(uint gpio, uint32_t events) { state.pins[gpio].irq_latched &= ~events; }
+void gpio_add_raw_irq_handler_masked(uint32_t gpio_mask, irq_handler_t handler) {
+    state.raw_handlers.push_back(RawIrqHandler{gpio_mask, handler});
+}
+void gpio_remove_raw_irq_handler_masked(uint32_t gpio_mask, irq_handler_t handler) {
+    for (auto it = state.raw_handlers.begin(); it != state.raw_handlers.end(); ++it) {
+        if (it->mask == gpio_mask && it->handler == handler) {
+            state.raw_handlers.erase(it);
+            return;
+        }
+    }
+}
+
+/* ---- SPI ---- */
+
+uint spi_init(spi_inst_t* spi, uint baudrate) { return spi_set_baudrate(spi, baudrate); }
+void spi_deinit(spi_inst_t* spi) { (void)spi; }
+uint spi_set_baudrate(spi_inst_t* spi, uint baudrate) {
+    // 与SDK相同：偶数预分频 (2..254) × 后分频 (1..256)，取不超过请求值的最高频率
+    uint prescale = 2;
+    while (prescale <= 254 && (uint64_t)HOST_CLK_PERI_HZ >= (uint64_t)(prescale + 2) * 256 * baudrate) {
+        prescale += 2;
+    }
+    uint postdiv = 256;
+    while (postdiv > 1 && HOST_CLK_PERI_HZ / (prescale * (postdiv - 1)) <= baudrate) {
+        postdiv--;
+    }
+    spi->baudrate = HOST_CLK_PERI_HZ / (prescale * postdiv);
+    return spi->baudrate;
+}
+uint spi_get_baudrate(const spi_inst_t* spi) { return spi->baudrate; }
+void spi_set_format(spi_inst_t* spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    (void)spi; (void)data_bits; (void)cpol; (void)cpha; (void)order;
+}
+int spi_write_blocking(spi_inst_t* spi, const uint8_t* src, size_t len) {
+    for (size_t i = 0; i < len; i++) spi_xfer(spi->baudrate, src[i]);
+    return (int)len;
+}
+int spi_read_blocking(spi_inst_t* spi, uint8_t repeated_tx_data, uint8_t* dst, size_t len) {
+    for (size_t i = 0; i < len; i++) dst[i] = spi_xfer(spi->baudrate, repeated_tx_data);
+    return (int)len;
+}
+int spi_write_read_blocking(spi_inst_t* spi, const uint8_t* src, uint8_t* dst, size_t len) {
+    for (size_t i = 0; i < len; i++) dst[i] = spi_xfer(spi->baudrate, src[i]);
+    return (int)len;
+}
+int spi_write16_blocking(spi_inst_t* spi, const uint16_t* src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        spi_xfer(spi->baudrate, (uint8_t)(src[i] >> 8));
+        spi_xfer(spi->baudrate, (uint8_t)src[i]);
+    }
+    return (int)len;
+}
+bool spi_is_busy(const spi_inst_t* spi) { (void)spi; return false; }
+bool spi_is_writable(const spi_inst_t* spi) { (void)spi; return true; }
+spi_hw_t* spi_get_hw(spi_inst_t* spi) { return &spi->hw; }
+uint spi_get_dreq(spi_inst_t* spi, bool is_tx) { return spi_get_index(spi) * 2 + (is_tx ? 16 : 17); }
+uint spi_get_index(const spi_inst_t* spi) { return spi == spi1 ? 1 : 0; }
+
+/* ---- I2C ---- */
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+void i2c_deinit(i2c_inst_t* i2c) { (void)i2c; }
+
+// 地址字节 + 数据字节，每字节9个SCL周期
+static int i2c_transfer(i2c_inst_t* i2c, uint8_t addr, bool read, uint8_t* data, size_t len, bool nostop) {
+    uint32_t baudrate = i2c->baudrate ? i2c->baudrate : 100 * KHZ;
+    state.time_ns += 9ull * (len + 1) * 1000000000ull / baudrate;
+    if (!state.i2c_device) {
+        return PICO_ERROR_GENERIC;
+    }
+    return state.i2c_device(state.i2c_device_ctx, addr, read, data, len, nostop);
+}
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop) {
+    return i2c_transfer(i2c, addr, false, const_cast<uint8_t*>(src), len, nostop);
+}
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop) {
+    return i2c_transfer(i2c, addr, true, dst, len, nostop);
+}
+
+/* ---- PIO ---- */
+
+uint pio_add_program(PIO pio, const pio_program_t* program) { (void)pio; (void)program; return 0; }
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) { (void)pio; return sm + (is_tx ? 0 : 4); }
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm) { (void)pio; (void)sm; return false; }
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm) { (void)pio; (void)sm; return false; }
+
+void pio_spi_init(PIO pio, uint sm, uint prog_offs, uint n_bits, float clkdiv, bool cpha, bool cpol,
+                  uint pin_sck, uint pin_mosi, uint pin_miso) {
+    (void)prog_offs; (void)n_bits; (void)cpha; (void)cpol; (void)pin_sck; (void)pin_mosi; (void)pin_miso;
+    // 与 sm_config_set_clkdiv() 相同的16.8定点格式
+    uint32_t div_int = (uint32_t)clkdiv;
+    uint32_t div_frac = (uint32_t)((clkdiv - (float)div_int) * 256.0f);
+    pio->sm[sm].clkdiv = (div_int << 16) | (div_frac << 8);
+}
+
+void pio_spi_write8_blocking(const pio_spi_inst_t* spi, const uint8_t* src, size_t len) {
+    uint32_t hz = pio_clock_hz(spi);
+    for (size_t i = 0; i < len; i++) spi_xfer(hz, src[i]);
+}
+
+void pio_spi_read8_blocking(const pio_spi_inst_t* spi, uint8_t* dst, size_t len) {
+    uint32_t hz = pio_clock_hz(spi);
+    for (size_t i = 0; i < len; i++) dst[i] = spi_xfer(hz, 0);
+}
+
+void pio_spi_write8_read8_blocking(const pio_spi_inst_t* spi, uint8_t* src, uint8_t* dst, size_t len) {
+    uint32_t hz = pio_clock_hz(spi);
+    for (size_t i = 0; i < len; i++) dst[i] = spi_xfer(hz, src[i]);
+}
+
+/* ---- 时钟 ---- */
+
+uint32_t clock_get_hz(enum clock_index clk) { return clk == clk_peri ? HOST_CLK_PERI_HZ : HOST_CLK_SYS_HZ; }
+uint32_t frequency_count_khz(uint src) { (void)src; return HOST_CLK_SYS_HZ / KHZ; }
+
+/* ---- DMA ---- */
+
+int dma_claim_unused_channel(bool required) { (void)required; return state.dma_next < 12 ? state.dma_next++ : -1; }
+void dma_channel_unclaim(uint channel) { (void)channel; }
+
+/* ---- stdio ---- */
+
+bool stdio_init_all(void) { return true; }
+bool stdio_usb_connected(void) { return true; }
+int getchar_timeout_us(uint32_t timeout_us) {
+    if (state.stdin_buffer.empty()) {
+        host_advance_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+    int c = (unsigned char)state.stdin_buffer[0];
+    state.stdin_buffer.erase(0, 1);
+    return c;
+}
+void stdio_set_chars_available_callback(void (*fn)(void*), void* param) {
+    state.chars_available = fn;
+    state.chars_available_param = param;
+}
+
+/* ==================== 主机测试控制接口 ==================== */
+
+void host_set_spi_device(host_spi_device_fn fn, void* ctx) {
+    state.spi_device = fn;
+    state.spi_device_ctx = ctx;
+}
+
+void host_set_i2c_device(host_i2c_device_fn fn, void* ctx) {
+    state.i2c_device = fn;
+    state.i2c_device_ctx = ctx;
+}
+
+uint32_t host_spi_clock_hz(void) { return state.spi_clock_hz; }
+
+void host_set_gpio_listener(host_gpio_listener_fn fn, void* ctx) {
+    state.gpio_listener = fn;
+    state.gpio_listener_ctx = ctx;
+}
+
+void host_gpio_drive(uint gpio, bool level) {
+    GpioPin& pin = state.pins[gpio];
+    if (pin.level == level) {
+        return;
+    }
+    pin.level = level;
+    uint32_t event = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (pin.irq_enabled & event) {
+        pin.irq_latched |= event;
+        raise_irq(gpio);
+    }
+}
+
+void host_advance_us(uint64_t us) { state.time_ns += us * 1000; }
+
+void host_stdin_push(const char* text) {
+    state.stdin_buffer += text;
+    if (state.chars_available) {
+        state.chars_available(state.chars_available_param);
+    }
+}
+
+void host_reset(void) {
+    uint64_t now = state.time_ns;
+    state = HostState{};
+    state.time_ns = now;
+    for (auto& i2c : host_i2c_instances) {
+        i2c = i2c_inst_t{};
+    }
+    for (auto& pio : host_pio_instances) {
+        pio = pio_hw_t{};
+    }
+}
+
+} // extern "C"
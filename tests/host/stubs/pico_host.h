@@ -0,0 +1,249 @@
+/**
+ * @file pico_host.h
+ * @brief 主机测试用的Pico SDK替身 - 只声明被测代码用到的接口
+ *
+ * 时间是虚拟的：只有 sleep/busy_wait、SPI传输和 host_advance_us() 会推进时间，
+ * 因此超时、节拍相关的逻辑在主机上可以确定性地复现。
+ * SPI (硬件SPI与PIO SPI) 的每个字节都交给 host_set_spi_device() 注册的设备模型。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+typedef volatile uint32_t io_rw_32;
+typedef volatile uint16_t io_rw_16;
+typedef volatile uint8_t io_rw_8;
+typedef const volatile uint32_t io_ro_32;
+
+#define KHZ 1000
+#define MHZ 1000000
+
+#define __not_in_flash_func(x) x
+#define __time_critical_func(x) x
+#define __compiler_memory_barrier() __asm__ volatile("" ::: "memory")
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define PICO_ERROR_NONE 0
+#define PICO_ERROR_TIMEOUT (-1)
+#define PICO_ERROR_GENERIC (-1)
+
+#define PICO_DEFAULT_LED_PIN 25
+#define PICO_DEFAULT_I2C_SDA_PIN 4
+#define PICO_DEFAULT_I2C_SCL_PIN 5
+
+/* ---- 时间 ---- */
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t to_us_since_boot(absolute_time_t t);
+absolute_time_t from_us_since_boot(uint64_t us);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+absolute_time_t make_timeout_time_us(uint64_t us);
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms);
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+bool time_reached(absolute_time_t t);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void sleep_until(absolute_time_t t);
+void busy_wait_us(uint64_t us);
+void busy_wait_us_32(uint32_t us);
+void busy_wait_ms(uint32_t ms);
+bool best_effort_wfe_or_timeout(absolute_time_t t);
+void tight_loop_contents(void);
+
+/* ---- 中断与同步 ---- */
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+void __dmb(void);
+void __wfe(void);
+void __wfi(void);
+void __sev(void);
+
+typedef struct { uint32_t save; } critical_section_t;
+void critical_section_init(critical_section_t* cs);
+void critical_section_enter_blocking(critical_section_t* cs);
+void critical_section_exit(critical_section_t* cs);
+
+typedef void (*irq_handler_t)(void);
+#define IO_IRQ_BANK0 13
+void irq_set_enabled(uint num, bool enabled);
+
+/* ---- GPIO ---- */
+#define GPIO_OUT 1
+#define GPIO_IN 0
+enum gpio_function {
+    GPIO_FUNC_XIP = 0, GPIO_FUNC_SPI = 1, GPIO_FUNC_UART = 2, GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4, GPIO_FUNC_SIO = 5, GPIO_FUNC_PIO0 = 6, GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_NULL = 0x1f
+};
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 1, GPIO_IRQ_LEVEL_HIGH = 2, GPIO_IRQ_EDGE_FALL = 4, GPIO_IRQ_EDGE_RISE = 8
+};
+enum gpio_slew_rate { GPIO_SLEW_RATE_SLOW = 0, GPIO_SLEW_RATE_FAST = 1 };
+enum gpio_drive_strength {
+    GPIO_DRIVE_STRENGTH_2MA = 0, GPIO_DRIVE_STRENGTH_4MA, GPIO_DRIVE_STRENGTH_8MA, GPIO_DRIVE_STRENGTH_12MA
+};
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_init_mask(uint32_t mask);
+void gpio_set_dir(uint gpio, bool out);
+uint gpio_get_dir(uint gpio);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+uint32_t gpio_get_all(void);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+enum gpio_function gpio_get_function(uint gpio);
+void gpio_pull_up(uint gpio);
+void gpio_pull_down(uint gpio);
+void gpio_disable_pulls(uint gpio);
+void gpio_set_slew_rate(uint gpio, enum gpio_slew_rate slew);
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive);
+void gpio_set_schmitt(uint gpio, bool enabled);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+uint32_t gpio_get_irq_event_mask(uint gpio);
+void gpio_acknowledge_irq(uint gpio, uint32_t events);
+void gpio_add_raw_irq_handler_masked(uint32_t gpio_mask, irq_handler_t handler);
+void gpio_remove_raw_irq_handler_masked(uint32_t gpio_mask, irq_handler_t handler);
+
+/* ---- SPI ---- */
+typedef struct { io_rw_32 cr0, cr1, dr, sr, cpsr, imsc, ris, mis, icr, dmacr; } spi_hw_t;
+typedef struct spi_inst {
+    spi_hw_t hw;
+    uint baudrate;
+} spi_inst_t;
+extern spi_inst_t host_spi_instances[2];
+#define spi0 (&host_spi_instances[0])
+#define spi1 (&host_spi_instances[1])
+typedef enum { SPI_CPOL_0 = 0, SPI_CPOL_1 = 1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0 = 0, SPI_CPHA_1 = 1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST = 0, SPI_MSB_FIRST = 1 } spi_order_t;
+#define SPI_SSPSR_BSY_BITS 0x10
+#define SPI_SSPSR_RNE_BITS 0x4
+
+uint spi_init(spi_inst_t* spi, uint baudrate);
+void spi_deinit(spi_inst_t* spi);
+uint spi_set_baudrate(spi_inst_t* spi, uint baudrate);
+uint spi_get_baudrate(const spi_inst_t* spi);
+void spi_set_format(spi_inst_t* spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t* spi, const uint8_t* src, size_t len);
+int spi_read_blocking(spi_inst_t* spi, uint8_t repeated_tx_data, uint8_t* dst, size_t len);
+int spi_write_read_blocking(spi_inst_t* spi, const uint8_t* src, uint8_t* dst, size_t len);
+int spi_write16_blocking(spi_inst_t* spi, const uint16_t* src, size_t len);
+bool spi_is_busy(const spi_inst_t* spi);
+bool spi_is_writable(const spi_inst_t* spi);
+spi_hw_t* spi_get_hw(spi_inst_t* spi);
+uint spi_get_dreq(spi_inst_t* spi, bool is_tx);
+uint spi_get_index(const spi_inst_t* spi);
+
+/* ---- I2C ---- */
+typedef struct i2c_inst {
+    uint baudrate;
+} i2c_inst_t;
+extern i2c_inst_t host_i2c_instances[2];
+#define i2c0 (&host_i2c_instances[0])
+#define i2c1 (&host_i2c_instances[1])
+#define i2c_default i2c0
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t* i2c);
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop);
+
+/* ---- PIO ---- */
+typedef struct {
+    io_rw_32 txf[4];
+    io_rw_32 rxf[4];
+    struct { io_rw_32 clkdiv, execctrl, shiftctrl, addr, instr, pinctrl; } sm[4];
+} pio_hw_t;
+typedef pio_hw_t* PIO;
+extern pio_hw_t host_pio_instances[2];
+#define pio0 (&host_pio_instances[0])
+#define pio1 (&host_pio_instances[1])
+typedef struct { int unused; } pio_program_t;
+uint pio_add_program(PIO pio, const pio_program_t* program);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm);
+
+/* ---- 时钟 ---- */
+enum clock_index { clk_gpout0 = 0, clk_ref = 4, clk_sys = 5, clk_peri = 6, clk_usb = 7, clk_adc = 8 };
+#define CLOCKS_FC0_SRC_VALUE_CLK_SYS 0x09
+uint32_t clock_get_hz(enum clock_index clk);
+uint32_t frequency_count_khz(uint src);
+
+/* ---- DMA (主机上不启用，仅保证编译) ---- */
+typedef struct { uint32_t ctrl; } dma_channel_config;
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+
+/* ---- stdio ---- */
+bool stdio_init_all(void);
+bool stdio_usb_connected(void);
+int getchar_timeout_us(uint32_t timeout_us);
+void stdio_set_chars_available_callback(void (*fn)(void*), void* param);
+
+/* ==================== 主机测试控制接口 ==================== */
+
+/**
+ * @brief SPI设备模型：每个时钟字节调用一次，返回MISO上的字节
+ */
+typedef uint8_t (*host_spi_device_fn)(void* ctx, uint8_t mosi);
+void host_set_spi_device(host_spi_device_fn fn, void* ctx);
+
+/**
+ * @brief I2C设备模型：每次传输调用一次，返回传输的字节数或 PICO_ERROR_GENERIC (无应答)
+ * 未注册设备时所有传输都无应答。
+ */
+typedef int (*host_i2c_device_fn)(void* ctx, uint8_t addr, bool read, uint8_t* data, size_t len, bool nostop);
+void host_set_i2c_device(host_i2c_device_fn fn, void* ctx);
+
+/**
+ * @brief 当前SPI时钟 (Hz)：最近一次传输所用的硬件SPI波特率或PIO分频对应的频率
+ */
+uint32_t host_spi_clock_hz(void);
+
+/**
+ * @brief 输出引脚电平变化的监听器 (片选等)
+ */
+typedef void (*host_gpio_listener_fn)(void* ctx, uint gpio, bool level);
+void host_set_gpio_listener(host_gpio_listener_fn fn, void* ctx);
+
+/**
+ * @brief 外部驱动输入引脚电平；使能了对应边沿中断时同步执行中断处理
+ */
+void host_gpio_drive(uint gpio, bool level);
+
+/**
+ * @brief 推进虚拟时间
+ */
+void host_advance_us(uint64_t us);
+
+/**
+ * @brief 串口输入：追加供 getchar_timeout_us() 读取的字符，并触发 chars_available 回调
+ */
+void host_stdin_push(const char* text);
+
+/**
+ * @brief 复位所有替身状态 (时间不回退)
+ */
+void host_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+#include "pico_host.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const pio_program_t spi_cpha0_program;
+extern const pio_program_t spi_cpha1_program;
+
+/* PIO程序在主机上不执行：只按 clkdiv 记录SCK分频，传输由 pio_spi_* 替身转给SPI设备模型 */
+void pio_spi_init(PIO pio, uint sm, uint prog_offs, uint n_bits, float clkdiv, bool cpha, bool cpol,
+                  uint pin_sck, uint pin_mosi, uint pin_miso);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file test_button_edges.cpp
+ * @brief 按键边沿采样：防抖与长按按边沿时间戳判定、与主循环节拍无关；中断FIFO的时间戳、电平换算与溢出计数
+ */
+
+#include "host_test.hpp"
+#include "hardware/input/button/button_edge_capture.hpp"
+
+#include <vector>
+
+using namespace hardware::input;
+
+namespace {
+
+struct Edge {
+    bool pressed;
+    uint32_t time_us;
+};
+
+struct Gesture {
+    ButtonGesture::Type type;
+    uint32_t time_ms;
+    uint32_t duration_ms;
+
+    bool operator==(const Gesture& other) const {
+        return type == other.type && time_ms == other.time_ms && duration_ms == other.duration_ms;
+    }
+};
+
+// 按 poll_us 节拍运行主循环：每拍先把已到达的边沿全部交给防抖器，再推进时间
+std::vector<Gesture> replay(const std::vector<Edge>& edges, uint32_t end_us, uint32_t poll_us, uint32_t base_us = 0) {
+    EdgeDebouncer debouncer(50, 600);
+    debouncer.reset(false, base_us);
+    std::vector<Gesture> out;
+    ButtonGesture gesture;
+    auto collect = [&]() {
+        while (debouncer.pop(gesture)) {
+            out.push_back(Gesture{gesture.type, (gesture.time_us - base_us) / 1000, gesture.duration_us / 1000});
+        }
+    };
+    size_t next = 0;
+    for (uint32_t now = poll_us; now <= end_us; now += poll_us) {
+        while (next < edges.size() && edges[next].time_us <= now) {
+            debouncer.push(edges[next].pressed, base_us + edges[next].time_us);
+            next++;
+            collect();
+        }
+        debouncer.poll(base_us + now);
+        collect();
+    }
+    return out;
+}
+
+constexpr uint BUTTON_PIN = 20;
+
+} // namespace
+
+HOST_TEST(bouncy_click_is_timed_at_first_edge_of_each_burst) {
+    // 按下和释放各带一串抖动，按住约200ms
+    const std::vector<Edge> click = {
+        {true, 100000}, {false, 101000}, {true, 102500},
+        {false, 300000}, {true, 300800}, {false, 301500},
+    };
+    const std::vector<Gesture> expected = {
+        {ButtonGesture::PRESS, 100, 0},
+        {ButtonGesture::CLICK, 300, 200},
+    };
+    CHECK(replay(click, 3000000, 1000) == expected);
+    // 1秒一拍的慢主循环得到相同的时间和时长
+    CHECK(replay(click, 3000000, 1000000) == expected);
+}
+
+HOST_TEST(long_press_is_judged_from_timestamps) {
+    const std::vector<Edge> hold = {{true, 100000}, {false, 100500}, {true, 101000}, {false, 1500000}};
+    const std::vector<Gesture> expected = {
+        {ButtonGesture::PRESS, 100, 0},
+        {ButtonGesture::LONG_PRESS, 700, 600},
+        {ButtonGesture::RELEASE, 1500, 1400},
+    };
+    CHECK(replay(hold, 4000000, 1000) == expected);
+    // 主循环错过长按时刻：释放前补发LONG_PRESS，时间仍为按下后600ms
+    CHECK(replay(hold, 4000000, 2000000) == expected);
+}
+
+HOST_TEST(glitch_shorter_than_debounce_is_ignored) {
+    CHECK(replay({{true, 100000}, {false, 110000}}, 2000000, 1000).empty());
+    CHECK(replay({{true, 100000}, {false, 110000}}, 2000000, 1000000).empty());
+}
+
+HOST_TEST(two_presses_inside_one_slow_poll_period_are_both_seen) {
+    const std::vector<Edge> two = {{true, 100000}, {false, 200000}, {true, 300000}, {false, 400000}};
+    const std::vector<Gesture> expected = {
+        {ButtonGesture::PRESS, 100, 0},
+        {ButtonGesture::CLICK, 200, 100},
+        {ButtonGesture::PRESS, 300, 0},
+        {ButtonGesture::CLICK, 400, 100},
+    };
+    CHECK(replay(two, 2000000, 1000) == expected);
+    CHECK(replay(two, 2000000, 1000000) == expected);
+}
+
+HOST_TEST(durations_survive_time_us_32_wraparound) {
+    const std::vector<Edge> click = {{true, 1000}, {false, 201000}};
+    const std::vector<Gesture> expected = {
+        {ButtonGesture::PRESS, 1, 0},
+        {ButtonGesture::CLICK, 201, 200},
+    };
+    CHECK(replay(click, 400000, 1000, 0xFFFF0000u) == expected);
+}
+
+HOST_TEST(capture_records_edges_with_irq_timestamps) {
+    gpio_init(BUTTON_PIN);
+    gpio_pull_up(BUTTON_PIN);
+    REQUIRE(ButtonEdgeCapture::attach(1u << BUTTON_PIN));
+    CHECK(ButtonEdgeCapture::is_attached(BUTTON_PIN));
+
+    ButtonEdge edge;
+    while (ButtonEdgeCapture::pop(edge)) {
+    }
+
+    // 按下 (低电平) 与释放 (高电平)，时间戳是中断发生的时刻
+    uint32_t press_us = time_us_32();
+    host_gpio_drive(BUTTON_PIN, !BUTTON_RELEASED_LEVEL);
+    host_advance_us(180000);
+    uint32_t release_us = time_us_32();
+    host_gpio_drive(BUTTON_PIN, BUTTON_RELEASED_LEVEL);
+    host_advance_us(500000);    // 主循环很晚才取
+
+    REQUIRE(ButtonEdgeCapture::pop(edge));
+    CHECK_EQ(edge.pin, BUTTON_PIN);
+    CHECK(edge.pressed());
+    CHECK_EQ(edge.time_us, press_us);
+    REQUIRE(ButtonEdgeCapture::pop(edge));
+    CHECK(!edge.pressed());
+    CHECK_EQ(edge.time_us, release_us);
+    CHECK(!ButtonEdgeCapture::pop(edge));
+}
+
+HOST_TEST(capture_counts_edges_dropped_when_fifo_is_full) {
+    REQUIRE(ButtonEdgeCapture::attach(1u << BUTTON_PIN));
+    ButtonEdge edge;
+    while (ButtonEdgeCapture::pop(edge)) {
+    }
+
+    const uint32_t dropped_before = ButtonEdgeCapture::dropped();
+    const int edges = BUTTON_EDGE_FIFO_SIZE + 6;
+    for (int i = 0; i < edges; i++) {
+        host_advance_us(1000);
+        host_gpio_drive(BUTTON_PIN, (i % 2 == 0) ? !BUTTON_RELEASED_LEVEL : BUTTON_RELEASED_LEVEL);
+    }
+    CHECK_EQ(ButtonEdgeCapture::dropped() - dropped_before, 6u);
+
+    // 保留的是最早的边沿，顺序不变
+    int popped = 0;
+    uint32_t last_us = 0;
+    bool ordered = true;
+    while (ButtonEdgeCapture::pop(edge)) {
+        if (edge.pressed() != (popped % 2 == 0) || (popped > 0 && edge.time_us <= last_us)) ordered = false;
+        last_us = edge.time_us;
+        popped++;
+    }
+    CHECK_EQ(popped, BUTTON_EDGE_FIFO_SIZE);
+    CHECK(ordered);
+    host_gpio_drive(BUTTON_PIN, BUTTON_RELEASED_LEVEL);
+}
+
+HOST_TEST_MAIN()
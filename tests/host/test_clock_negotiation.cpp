@@ -0,0 +1,65 @@
+/**
+ * @file test_clock_negotiation.cpp
+ * @brief 自适应时钟：initialize() 不访问文件系统，挂载后在 poll_background() 中协商并保存配置
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "config/spi_config.hpp"
+
+#include <memory>
+
+using MicroSD::RWSD;
+
+HOST_TEST(initialize_does_not_mount_or_read_profile) {
+    host::SdCardModel card(2u * 1024 * 1024, MicroSD::Config::DEFAULT.pins.pin_cs);
+    RWSD sd(MicroSD::Config::DEFAULT);
+    REQUIRE(sd.initialize().is_ok());
+
+    // 未格式化的卡也能完成初始化：没有读任何数据块，运行在兼容时钟
+    CHECK_EQ(card.stats().blocks_read, 0u);
+    CHECK_EQ(card.stats().blocks_written, 0u);
+    CHECK(sd.get_spi_clock() <= MICROSD_SPI_FREQ_FAST_COMPAT);
+
+    // 没有文件系统：后台挂载失败后停止，不协商也不尝试写配置文件
+    CHECK(!sd.poll_background());
+    CHECK_EQ(card.stats().blocks_written, 0u);
+    CHECK(sd.get_spi_clock() <= MICROSD_SPI_FREQ_FAST_COMPAT);
+}
+
+HOST_TEST(negotiates_after_mount_and_reuses_saved_profile) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    fx.shutdown();
+    fx.card().faults().max_clock_hz = 18 * 1000 * 1000;  // PIO最高约20.8MHz，需要降一级
+
+    auto sd = std::make_unique<RWSD>(MicroSD::Config::DEFAULT);
+    REQUIRE(sd->initialize().is_ok());
+    CHECK(sd->get_spi_clock() <= MICROSD_SPI_FREQ_FAST_COMPAT);
+
+    // 第一步挂载，第二步协商
+    REQUIRE(sd->poll_background());
+    CHECK(sd->get_spi_clock() <= MICROSD_SPI_FREQ_FAST_COMPAT);
+    sd->poll_background();
+    uint32_t negotiated = sd->get_spi_clock();
+    CHECK(negotiated >= MICROSD_SPI_FREQ_FAST_MIN);
+    CHECK(negotiated <= 18u * 1000 * 1000);
+    while (sd->poll_background()) {
+    }
+    REQUIRE(sd->file_exists(RWSD_CLOCK_PROFILE_PATH));
+    sd.reset();
+    pico_fatfs_cache_invalidate();
+
+    // 再次启动：从配置文件的时钟开始，得到同一时钟，不再改写配置
+    fx.card().reset_stats();
+    sd = std::make_unique<RWSD>(MicroSD::Config::DEFAULT);
+    REQUIRE(sd->initialize().is_ok());
+    while (sd->poll_background()) {
+    }
+    CHECK_EQ(sd->get_spi_clock(), negotiated);
+    REQUIRE(sd->sync().is_ok());
+    CHECK_EQ(fx.card().stats().blocks_written, 0u);
+    sd.reset();
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,154 @@
+/**
+ * @file test_copy_file.cpp
+ * @brief RWSD::copy_file：大于中转缓冲区的流式复制、预分配连续簇及空间不连续时的退回、
+ *        拒绝把文件复制到自身 (FF_FS_LOCK=0 时会先截断源文件)
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+
+#include <string.h>
+
+using MicroSD::ErrorCode;
+using MicroSD::Span;
+
+namespace {
+
+std::vector<uint8_t> make_pattern(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    uint32_t x = seed;
+    for (auto& b : data) {
+        x = x * 1103515245u + 12345u;
+        b = (uint8_t)(x >> 16);
+    }
+    return data;
+}
+
+// 文件的不连续片段数：快速定位表每个片段占2个DWORD，另加2个DWORD头尾
+size_t fragments(MicroSD::RWSD& sd, const std::string& path) {
+    auto opened = sd.open_file(path, "r");
+    if (!opened.is_ok()) return 0;
+    DWORD clmt[256];
+    auto used = opened->enable_fast_seek(Span<DWORD>(clmt));
+    return used.is_ok() ? (*used - 2) / 2 : 0;
+}
+
+} // namespace
+
+HOST_TEST(copy_streams_files_larger_than_the_buffer) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    auto data = make_pattern(70000, 1);
+    REQUIRE(fx.sd().write_file("/src.bin", data).is_ok());
+
+    // 缓冲区向下取整到扇区：1500 字节按 1024 字节分块，共69块
+    std::vector<uint8_t> buffer(1500);
+    REQUIRE(fx.sd().copy_file("/src.bin", "/dst.bin", Span<uint8_t>(buffer), false).is_ok());
+    auto copied = fx.sd().read_file("/dst.bin");
+    REQUIRE(copied.is_ok());
+    CHECK(*copied == data);
+
+    // 覆盖已有的目标文件；默认缓冲区并预分配连续簇
+    REQUIRE(fx.sd().write_file("/dst.bin", make_pattern(100, 2)).is_ok());
+    REQUIRE(fx.sd().copy_file("/src.bin", "/dst.bin").is_ok());
+    copied = fx.sd().read_file("/dst.bin");
+    REQUIRE(copied.is_ok());
+    CHECK(*copied == data);
+    CHECK_EQ(fragments(fx.sd(), "/dst.bin"), 1u);
+
+    // 空源文件与不足一个扇区的缓冲区
+    REQUIRE(fx.sd().write_file("/empty.bin", {}).is_ok());
+    REQUIRE(fx.sd().copy_file("/empty.bin", "/empty2.bin").is_ok());
+    auto info = fx.sd().get_file_info("/empty2.bin");
+    REQUIRE(info.is_ok());
+    CHECK_EQ(info->size, 0u);
+    uint8_t tiny[100];
+    CHECK(fx.sd().copy_file("/src.bin", "/x.bin", Span<uint8_t>(tiny)).error_code() ==
+          ErrorCode::INVALID_PARAMETER);
+    CHECK(!fx.sd().file_exists("/x.bin"));
+    CHECK(fx.sd().copy_file("/missing.bin", "/x.bin").error_code() == ErrorCode::FILE_NOT_FOUND);
+}
+
+HOST_TEST(copy_falls_back_when_free_space_is_fragmented) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    MicroSD::RWSD& sd = fx.sd();
+    auto data = make_pattern(250 * 1024, 3);
+    REQUIRE(sd.write_file("/SRC.BIN", data).is_ok());
+
+    // 用预分配 (只写FAT，不写数据) 占满卡：前面一个大文件，尾部20个64KB文件，
+    // 删掉其中一半后只剩10段互不相邻的64KB空闲区
+    constexpr size_t HOLE = 64 * 1024;
+    auto capacity = sd.get_capacity();
+    REQUIRE(capacity.is_ok());
+    size_t free_bytes = capacity->second;
+    {
+        auto filler = sd.open_file("/FILL.BIN", "w");
+        REQUIRE(filler.is_ok());
+        REQUIRE(filler->preallocate(free_bytes - 20 * HOLE).is_ok());
+    }
+    for (int i = 0; i < 20; i++) {
+        auto hole = sd.open_file("/H" + std::to_string(i) + ".BIN", "w");
+        REQUIRE(hole.is_ok());
+        REQUIRE(hole->preallocate(HOLE).is_ok());
+    }
+    for (int i = 0; i < 20; i += 2) {
+        REQUIRE(sd.delete_file("/H" + std::to_string(i) + ".BIN").is_ok());
+    }
+    capacity = sd.get_capacity();
+    REQUIRE(capacity.is_ok());
+    CHECK_EQ(capacity->second, 10 * HOLE);
+
+    // 连续空间不够：同样大小的预分配失败，复制退回按需分配并成功
+    {
+        auto probe = sd.open_file("/PROBE.BIN", "w");
+        REQUIRE(probe.is_ok());
+        CHECK(probe->preallocate(data.size()).error_code() == ErrorCode::DISK_FULL);
+    }
+    REQUIRE(sd.delete_file("/PROBE.BIN").is_ok());
+    REQUIRE(sd.copy_file("/SRC.BIN", "/DST.BIN").is_ok());
+    auto copied = sd.read_file("/DST.BIN");
+    REQUIRE(copied.is_ok());
+    CHECK(*copied == data);
+    CHECK(fragments(sd, "/DST.BIN") >= data.size() / HOLE);
+
+    // 再复制一份后只剩约140KB：第三份空间不足，不留下不完整的目标文件，已分配的簇全部释放
+    REQUIRE(sd.copy_file("/SRC.BIN", "/DST2.BIN").is_ok());
+    capacity = sd.get_capacity();
+    REQUIRE(capacity.is_ok());
+    size_t free_before = capacity->second;
+    CHECK(sd.copy_file("/SRC.BIN", "/DST3.BIN").error_code() == ErrorCode::DISK_FULL);
+    CHECK(!sd.file_exists("/DST3.BIN"));
+    capacity = sd.get_capacity();
+    REQUIRE(capacity.is_ok());
+    CHECK_EQ(capacity->second, free_before);
+}
+
+HOST_TEST(copy_onto_itself_is_rejected_before_opening) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    MicroSD::RWSD& sd = fx.sd();
+    REQUIRE(sd.create_directory("/dir").is_ok());
+    auto data = make_pattern(30000, 4);
+    REQUIRE(sd.write_file("/dir/Book.txt", data).is_ok());
+
+    // 同一文件的不同写法：大小写、反斜杠、重复和结尾的斜杠
+    for (const char* alias : {"/dir/Book.txt", "/DIR/BOOK.TXT", "\\dir\\book.txt", "dir//Book.txt/"}) {
+        auto result = sd.copy_file("/dir/Book.txt", alias);
+        CHECK(result.error_code() == ErrorCode::INVALID_PARAMETER);
+        auto kept = sd.read_file("/dir/Book.txt");
+        REQUIRE(kept.is_ok());
+        CHECK(*kept == data);
+    }
+
+    // GBK双字节字符的尾字节不参与大小写折叠："\xB0\x41" 与 "\xB0\x61" 是两个不同的字
+    std::string upper = "/dir/\xB0\x41.txt";
+    std::string lower = "/dir/\xB0\x61.txt";
+    REQUIRE(sd.write_file(upper, data).is_ok());
+    REQUIRE(sd.copy_file(upper, lower).is_ok());
+    auto copy = sd.read_file(lower);
+    REQUIRE(copy.is_ok());
+    CHECK(*copy == data);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,144 @@
+/**
+ * @file test_dir_listing.cpp
+ * @brief 目录枚举：list_directory_into 的arena截断、目录树的精确输出格式、
+ *        arena不足时的流式退化与未展开子目录的标记
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+
+#include <string>
+#include <vector>
+
+using MicroSD::ListingArena;
+using MicroSD::StaticListingArena;
+
+namespace {
+
+bool make_file(MicroSD::RWSD& sd, const std::string& path, size_t size) {
+    return sd.write_file(path, std::vector<uint8_t>(size, 0x5A)).is_ok();
+}
+
+// 遍历起点的路径缓冲区、FILINFO 和一层的 DIR，再加 entries 个目录项
+size_t walk_bytes(size_t entries) {
+    return RWSD_TREE_PATH_MAX + sizeof(FILINFO) + sizeof(DIR) + entries * sizeof(MicroSD::DirEntry);
+}
+
+} // namespace
+
+HOST_TEST(list_directory_into_reports_truncation) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(fx.sd().create_directory("/list").is_ok());
+    for (int i = 0; i < 6; i++) {
+        REQUIRE(make_file(fx.sd(), "/list/f" + std::to_string(i) + ".txt", 10));
+    }
+
+    StaticListingArena<8 * sizeof(MicroSD::DirEntry)> big;
+    auto all = fx.sd().list_directory_into("/list", big);
+    REQUIRE(all.is_ok());
+    CHECK_EQ(all->count, 6u);
+    CHECK(!all->truncated);
+
+    // 只够放4项：返回前4项并标记截断
+    StaticListingArena<4 * sizeof(MicroSD::DirEntry)> small;
+    auto part = fx.sd().list_directory_into("/list", small);
+    REQUIRE(part.is_ok());
+    CHECK_EQ(part->count, 4u);
+    CHECK(part->truncated);
+    CHECK(std::string(part->entries[0].name) == all->entries[0].name);
+}
+
+HOST_TEST(tree_format_for_nested_directories) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    MicroSD::RWSD& sd = fx.sd();
+    REQUIRE(sd.create_directory("/t").is_ok());   // 卡根目录下还有时钟配置文件
+    REQUIRE(sd.create_directory("/t/c").is_ok());
+    REQUIRE(sd.create_directory("/t/a").is_ok());
+    REQUIRE(sd.create_directory("/t/a/sub").is_ok());
+    REQUIRE(sd.create_directory("/t/a/sub/inner").is_ok());
+    REQUIRE(make_file(sd, "/t/z.bin", 1500));
+    REQUIRE(make_file(sd, "/t/b.txt", 0));
+    REQUIRE(make_file(sd, "/t/a/x.txt", 100));
+    REQUIRE(make_file(sd, "/t/a/sub/deep.bin", 2048));
+    REQUIRE(make_file(sd, "/t/a/sub/inner/leaf.txt", 1));
+
+    // 每层目录优先、按名称排序；祖先不是最后一项时画 "│"
+    const std::string expected =
+        "📁 a\n"
+        "  ├── 📁 sub\n"
+        "  │   ├── 📁 inner\n"
+        "  │   │   └── 📄 leaf.txt (1 B)\n"
+        "  │   └── 📄 deep.bin (2 KB)\n"
+        "  └── 📄 x.txt (100 B)\n"
+        "📁 c\n"
+        "📄 b.txt\n"
+        "📄 z.bin (1 KB)\n";
+    auto tree = sd.list_directory_tree("/t");
+    REQUIRE(tree.is_ok());
+    CHECK(*tree == expected);
+
+    // 调用者提供的arena：返回后回退到调用前的标记
+    StaticListingArena<4096> arena;
+    auto again = sd.list_directory_tree("/t", arena);
+    REQUIRE(again.is_ok());
+    CHECK(*again == expected);
+    CHECK_EQ(arena.used(), 0u);
+    CHECK(arena.peak() > 0);
+
+    // 深度限制：只展开两层
+    auto shallow = sd.list_directory_tree("/t/a", arena, 2);
+    REQUIRE(shallow.is_ok());
+    CHECK(*shallow ==
+          "📁 sub\n"
+          "  ├── 📁 inner\n"
+          "  └── 📄 deep.bin (2 KB)\n"
+          "📄 x.txt (100 B)\n");
+}
+
+HOST_TEST(tree_streams_and_marks_truncation_when_arena_is_full) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    MicroSD::RWSD& sd = fx.sd();
+    REQUIRE(sd.create_directory("/t").is_ok());
+    REQUIRE(make_file(sd, "/t/k.txt", 1));
+    REQUIRE(sd.create_directory("/t/d").is_ok());
+    REQUIRE(make_file(sd, "/t/d/inside.txt", 1));
+    REQUIRE(make_file(sd, "/t/e.txt", 1));
+
+    // 起始目录只放得下当前项和预读项：按目录原始顺序输出，子目录的 DIR 放不下，不展开
+    std::vector<uint8_t> buffer(walk_bytes(2) + 8);
+    ListingArena arena(buffer.data(), buffer.size());
+    std::vector<std::string> visited;
+    auto walked = sd.walk_directory_tree("/t", arena,
+        [&](const MicroSD::DirEntry& entry, int depth, bool is_last) {
+            visited.push_back(std::to_string(depth) + entry.name + (is_last ? "$" : ""));
+            return true;
+        });
+    REQUIRE(walked.is_ok());
+    CHECK(!*walked);
+    CHECK(visited == std::vector<std::string>({"0k.txt", "0d", "0e.txt$"}));
+    CHECK_EQ(arena.used(), 0u);
+
+    auto tree = sd.list_directory_tree("/t", arena);
+    REQUIRE(tree.is_ok());
+    CHECK(*tree ==
+          "📄 k.txt (1 B)\n"
+          "📁 d\n"
+          "📄 e.txt (1 B)\n"
+          "[arena空间不足，目录树不完整]\n");
+
+    // 连起点都放不下时返回错误
+    ListingArena tiny(buffer.data(), RWSD_TREE_PATH_MAX);
+    CHECK(!sd.list_directory_tree("/t", tiny).is_ok());
+
+    // 空间足够时完整遍历
+    StaticListingArena<4096> enough;
+    auto full = sd.walk_directory_tree("/t", enough,
+        [](const MicroSD::DirEntry&, int, bool) { return true; });
+    REQUIRE(full.is_ok());
+    CHECK(*full);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,157 @@
+/**
+ * @file test_event_loop.cpp
+ * @brief 事件循环：定时器按截止时间分发与超时统计、旧定时器ID不会取消复用槽位的新定时器、
+ *        中断信号合并并唤醒睡眠、串口字符到达作为事件源
+ */
+
+#include "host_test.hpp"
+#include "loop_fixture.hpp"
+#include "hardware/input/input_latency.hpp"
+
+#include <string>
+#include <vector>
+
+using event_loop::EventLoop;
+
+namespace {
+
+uint64_t ms_from(uint64_t base_us, uint32_t ms) {
+    return base_us + ms * 1000ull;
+}
+
+} // namespace
+
+HOST_TEST(timers_dispatch_by_deadline_and_count_overruns) {
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    const uint64_t t0 = time_us_64();
+
+    std::string order;
+    loop.add_timer(30, 0, [&]() { order += 'c'; });
+    loop.add_timer(10, 0, [&]() { order += 'a'; });
+    loop.add_timer(20, 0, [&]() { order += 'b'; });
+    int ticks = 0;
+    loop.add_timer(25, 25, [&]() { ticks++; });
+    platform.run_until(loop, ms_from(t0, 110));
+    CHECK(order == "abc");
+    CHECK_EQ(ticks, 4);                         // 25, 50, 75, 100 ms
+    CHECK_EQ(loop.stats().timer_overruns, 0u);
+
+    // 回调耗时超过周期：不补发，计入超时
+    int slow = 0;
+    loop.add_timer(0, 10, [&]() {
+        slow++;
+        host_advance_us(35000);
+    });
+    platform.run_until(loop, ms_from(t0, 300));
+    CHECK(slow >= 4 && slow <= 6);
+    CHECK(loop.stats().timer_overruns > 0);
+}
+
+HOST_TEST(stale_timer_id_does_not_cancel_reused_slot) {
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    const uint64_t t0 = time_us_64();
+
+    int first = 0;
+    int old_id = loop.add_timer(10, 0, [&]() { first++; });
+    platform.run_until(loop, ms_from(t0, 20));
+    CHECK_EQ(first, 1);
+
+    // 新定时器复用同一槽位，但ID不同；用旧ID取消不影响它
+    int second = 0;
+    int new_id = loop.add_timer(10, 0, [&]() { second++; });
+    CHECK_EQ(new_id & 0xFF, old_id & 0xFF);
+    CHECK(new_id != old_id);
+    loop.cancel_timer(old_id);
+    platform.run_until(loop, ms_from(t0, 40));
+    CHECK_EQ(second, 1);
+
+    // 有效ID仍然可以取消，包括在自己的回调中取消周期定时器
+    int cancelled = 0;
+    int id = loop.add_timer(10, 0, [&]() { cancelled++; });
+    loop.cancel_timer(id);
+    int periodic = 0;
+    int periodic_id = EventLoop::INVALID_ID;
+    periodic_id = loop.add_timer(5, 5, [&]() {
+        if (++periodic == 3) loop.cancel_timer(periodic_id);
+    });
+    loop.cancel_timer(EventLoop::INVALID_ID);
+    platform.run_until(loop, ms_from(t0, 100));
+    CHECK_EQ(cancelled, 0);
+    CHECK_EQ(periodic, 3);
+
+    // 槽位多次复用后代数回绕，ID仍然唯一到下一次回绕
+    int last = EventLoop::INVALID_ID;
+    bool distinct = true;
+    for (int i = 0; i < 300; i++) {
+        int reused = loop.add_timer(1000, 0, []() {});
+        distinct = distinct && reused != last && reused >= 0;
+        last = reused;
+        loop.cancel_timer(reused);
+    }
+    CHECK(distinct);
+}
+
+HOST_TEST(signals_coalesce_and_wake_the_sleeping_loop) {
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    const uint64_t t0 = time_us_64();
+
+    std::vector<uint64_t> dispatched;
+    int source = loop.add_source([&]() { dispatched.push_back(time_us_64() - t0); });
+    int timer_fires = 0;
+    loop.add_timer(100, 0, [&]() { timer_fires++; });
+
+    // 睡眠中的两次中断信号在下一轮合并为一次回调
+    platform.at(ms_from(t0, 5), [&]() {
+        loop.signal(source);
+        loop.signal(source);
+    });
+    platform.at(ms_from(t0, 40), [&]() { loop.signal(source); });
+    platform.run_until(loop, ms_from(t0, 150));
+
+    REQUIRE(dispatched.size() == 2);
+    CHECK_EQ(dispatched[0], 5000ull);
+    CHECK_EQ(dispatched[1], 40000ull);
+    CHECK_EQ(timer_fires, 1);
+    event_loop::LoopStats stats = loop.stats();
+    CHECK_EQ(stats.source_dispatches, 2u);
+    CHECK_EQ(stats.timer_dispatches, 1u);
+
+    // 无效ID的信号被忽略
+    loop.signal(EventLoop::INVALID_ID);
+    loop.signal(5);
+    platform.run_until(loop, ms_from(t0, 160));
+    CHECK_EQ(dispatched.size(), 2u);
+}
+
+HOST_TEST(serial_input_is_an_event_source) {
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    const uint64_t t0 = time_us_64();
+    hardware::input::InputLatency::set_enabled(false);
+
+    // 与演示程序相同的接法：stdio 回调只发信号，处理函数在主循环中取完字符
+    static int serial_source;
+    int handled = 0;
+    serial_source = loop.add_source([&]() {
+        if (hardware::input::InputLatency::poll_serial()) handled++;
+    });
+    stdio_set_chars_available_callback([](void* param) {
+        static_cast<EventLoop*>(param)->signal(serial_source);
+    }, &loop);
+
+    platform.at(ms_from(t0, 7), []() { host_stdin_push("T"); });
+    platform.at(ms_from(t0, 30), []() { host_stdin_push("xT"); });
+    platform.run_until(loop, ms_from(t0, 50));
+
+    CHECK_EQ(handled, 2);
+    CHECK(!hardware::input::InputLatency::is_enabled());
+    // 没有定时器：两次唤醒之外一直睡眠，不轮询串口
+    CHECK_EQ(loop.stats().source_dispatches, 2u);
+    CHECK(platform.sleeps() <= 4);
+    stdio_set_chars_available_callback(nullptr, nullptr);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,138 @@
+/**
+ * @file test_fast_seek.cpp
+ * @brief FileHandle 快速定位 (CLMT)：碎片文件上的随机定位与表大小处理
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "ff.h"
+
+#include <string.h>
+
+using MicroSD::ErrorCode;
+using MicroSD::Span;
+
+namespace {
+
+constexpr size_t FILE_SIZE = 1024 * 1024;   // 交替写入后簇链跨多个FAT扇区
+constexpr size_t PIECE = 4096;
+
+uint8_t pattern_byte(size_t offset) {
+    return (uint8_t)((offset * 131u) ^ (offset >> 9));
+}
+
+// 两个文件交替追加，使目标文件的簇链不连续
+bool write_fragmented(MicroSD::RWSD& sd) {
+    auto a = sd.open_file("/frag.bin", "w");
+    auto b = sd.open_file("/other.bin", "w");
+    if (!a.is_ok() || !b.is_ok()) return false;
+    std::vector<uint8_t> piece(PIECE);
+    for (size_t offset = 0; offset < FILE_SIZE; offset += PIECE) {
+        for (size_t i = 0; i < PIECE; i++) piece[i] = pattern_byte(offset + i);
+        if (!a->write(piece).is_ok()) return false;
+        if (!a->flush().is_ok()) return false;
+        if (!b->write(piece).is_ok()) return false;
+        if (!b->flush().is_ok()) return false;
+    }
+    return true;
+}
+
+// 固定序列的随机位置 (含向后跳转)，返回读取期间FatFs请求的扇区数；data_sectors 为所读数据覆盖的扇区数
+uint32_t random_reads(MicroSD::RWSD::FileHandle& file, bool& data_ok, uint32_t& data_sectors) {
+    pico_fatfs_cache_reset_stats();
+    uint32_t x = 7;
+    uint8_t buffer[64];
+    data_ok = true;
+    data_sectors = 0;
+    for (int i = 0; i < 200; i++) {
+        x = x * 1664525u + 1013904223u;
+        size_t position = (x >> 8) % (FILE_SIZE - sizeof(buffer));
+        data_sectors += (position + sizeof(buffer) - 1) / 512 - position / 512 + 1;
+        if (!file.seek(position).is_ok()) {
+            data_ok = false;
+            break;
+        }
+        auto n = file.read_into(Span<uint8_t>(buffer));
+        if (!n.is_ok() || *n != sizeof(buffer)) {
+            data_ok = false;
+            break;
+        }
+        for (size_t j = 0; j < sizeof(buffer); j++) {
+            if (buffer[j] != pattern_byte(position + j)) data_ok = false;
+        }
+    }
+    pico_fatfs_cache_stats_t stats;
+    pico_fatfs_cache_get_stats(&stats);
+    return stats.read_hits + stats.read_misses;
+}
+
+} // namespace
+
+HOST_TEST(fast_seek_reads_same_data_with_fewer_sector_reads) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(write_fragmented(fx.sd()));
+    auto plain = fx.sd().open_file("/frag.bin", "r");
+    REQUIRE(plain.is_ok());
+    bool plain_ok = false;
+    uint32_t data_sectors = 0;
+    uint32_t plain_reads = random_reads(*plain, plain_ok, data_sectors);
+    plain->close();
+
+    DWORD clmt[1024];
+    MicroSD::RWSD::FileHandle fast;
+    REQUIRE(fast.open("/frag.bin", "r", Span<DWORD>(clmt)).is_ok());
+    REQUIRE(fast.is_fast_seek());
+    bool fast_ok = false;
+    uint32_t fast_reads = random_reads(fast, fast_ok, data_sectors);
+
+    CHECK(plain_ok);
+    CHECK(fast_ok);
+    // 普通定位沿FAT链查找会读FAT扇区，查表定位只读数据扇区
+    printf("  随机读200次 (数据 %u 扇区): 普通定位 %u 扇区, 快速定位 %u 扇区\n",
+           data_sectors, plain_reads, fast_reads);
+    CHECK(fast_reads <= data_sectors);
+    CHECK(plain_reads > data_sectors + 100);
+}
+
+HOST_TEST(small_table_reports_required_size_and_stays_usable) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(write_fragmented(fx.sd()));
+
+    auto file = fx.sd().open_file("/frag.bin", "r");
+    REQUIRE(file.is_ok());
+    DWORD small[4];
+    auto result = file->enable_fast_seek(Span<DWORD>(small));
+    CHECK(result.error_code() == ErrorCode::INVALID_PARAMETER);
+    CHECK(result.error_message().find("需要") != std::string::npos);
+    CHECK(!file->is_fast_seek());
+
+    // 退回普通模式后仍能正常定位读取
+    uint8_t b = 0;
+    REQUIRE(file->seek(FILE_SIZE - 1).is_ok());
+    auto n = file->read_into(Span<uint8_t>(&b, 1));
+    REQUIRE(n.is_ok());
+    CHECK_EQ(*n, 1u);
+    CHECK_EQ(b, pattern_byte(FILE_SIZE - 1));
+
+    // 用报告的大小重试
+    size_t required = strtoul(result.error_message().c_str() + result.error_message().find("需要") + strlen("需要 "), nullptr, 10);
+    std::vector<DWORD> table(required);
+    auto retry = file->enable_fast_seek(Span<DWORD>(table));
+    CHECK(retry.is_ok());
+    CHECK(file->is_fast_seek());
+}
+
+HOST_TEST(fast_seek_rejected_for_writable_files) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    auto file = fx.sd().open_file("/w.bin", "w");
+    REQUIRE(file.is_ok());
+    DWORD clmt[64];
+    auto result = file->enable_fast_seek(Span<DWORD>(clmt));
+    CHECK(result.error_code() == ErrorCode::PERMISSION_DENIED);
+    CHECK(!file->is_fast_seek());
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,131 @@
+/**
+ * @file test_free_scan.cpp
+ * @brief 延迟挂载后的分步空闲簇统计：预分配文件内的原位覆盖写不打断统计，
+ *        扩展文件的写入让统计重新开始，结果与未受干扰的统计一致
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+
+#include <string.h>
+#include <vector>
+
+using MicroSD::RWSD;
+
+namespace {
+
+constexpr size_t RING_SIZE = 256 * 1024;
+
+// 把FSINFO中的空闲簇数改为未知，挂载后只能由后台统计得出
+bool forget_free_count(host::SdCardModel& card) {
+    for (const auto& entry : card.snapshot()) {
+        const uint8_t* p = entry.second.data();
+        uint32_t lead, struc;
+        memcpy(&lead, p, 4);
+        memcpy(&struc, p + 484, 4);
+        if (lead == 0x41615252 && struc == 0x61417272) {
+            host::SdCardModel::Sector sector = entry.second;
+            memset(sector.data() + 488, 0xFF, 4);
+            card.write_sector(entry.first, sector);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 挂载并完成时钟协商，停在空闲簇统计开始之前
+std::unique_ptr<RWSD> start_lazily(host::CardFixture& fx) {
+    fx.shutdown();
+    if (!forget_free_count(fx.card())) return nullptr;
+    auto sd = std::make_unique<RWSD>(MicroSD::Config::DEFAULT);
+    if (!sd->initialize().is_ok()) return nullptr;
+    while (sd->get_startup_timing().free_scan_steps == 0 && sd->poll_background()) {
+    }
+    return sd;
+}
+
+size_t free_bytes(RWSD& sd) {
+    auto capacity = sd.get_capacity();
+    return capacity.is_ok() ? capacity->second : 0;
+}
+
+} // namespace
+
+HOST_TEST(in_place_writes_do_not_restart_the_scan) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    {
+        auto ring = fx.sd().open_file("/ring.bin", "w");
+        REQUIRE(ring.is_ok());
+        REQUIRE(ring->preallocate(RING_SIZE).is_ok());
+    }
+
+    // 未受干扰的统计
+    auto sd = start_lazily(fx);
+    REQUIRE(sd);
+    CHECK(!sd->is_free_space_known());
+    while (sd->poll_background()) {
+    }
+    REQUIRE(sd->is_free_space_known());
+    const uint32_t baseline_steps = sd->get_startup_timing().free_scan_steps;
+    const size_t baseline_free = free_bytes(*sd);
+    CHECK(baseline_steps > 10u);
+    sd.reset();
+
+    // 统计进行中以 "r+" 打开日志并反复原位覆盖写，每次写后推进一步
+    sd = start_lazily(fx);
+    REQUIRE(sd);
+    auto opened = sd->open_file("/ring.bin", "r+");
+    REQUIRE(opened.is_ok());
+    auto ring = opened.take();
+    std::vector<uint8_t> record(512);
+    size_t offset = 0;
+    bool more = true;
+    while (more) {
+        record[0] = (uint8_t)offset;
+        REQUIRE(ring.seek(offset).is_ok());
+        REQUIRE(ring.write(record).is_ok());
+        REQUIRE(ring.sync_data().is_ok());
+        offset = (offset + record.size()) % RING_SIZE;
+        more = sd->poll_background();
+    }
+    ring.close();
+
+    // 步数与未受干扰时相同：没有重新开始，也没有退回阻塞的 f_getfree
+    REQUIRE(sd->is_free_space_known());
+    CHECK_EQ(sd->get_startup_timing().free_scan_steps, baseline_steps);
+    CHECK_EQ(free_bytes(*sd), baseline_free);
+}
+
+HOST_TEST(growing_writes_restart_the_scan) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(fx.sd().write_file("/log.txt", std::vector<uint8_t>(100, 'x')).is_ok());
+
+    auto sd = start_lazily(fx);
+    REQUIRE(sd);
+    while (sd->poll_background()) {
+    }
+    const uint32_t baseline_steps = sd->get_startup_timing().free_scan_steps;
+    const size_t baseline_free = free_bytes(*sd);
+    sd.reset();
+
+    // 统计到一半时追加 64KB：链接了新簇，已扫描的区域作废，从头再来
+    sd = start_lazily(fx);
+    REQUIRE(sd);
+    for (uint32_t i = 0; i < baseline_steps / 2; i++) {
+        REQUIRE(sd->poll_background());
+    }
+    {
+        auto opened = sd->open_file("/log.txt", "a");
+        REQUIRE(opened.is_ok());
+        REQUIRE(opened->write(std::vector<uint8_t>(64 * 1024, 'y')).is_ok());
+    }
+    while (sd->poll_background()) {
+    }
+    REQUIRE(sd->is_free_space_known());
+    CHECK(sd->get_startup_timing().free_scan_steps > baseline_steps);
+    CHECK_EQ(free_bytes(*sd), baseline_free - 64 * 1024);
+}
+
+HOST_TEST_MAIN()
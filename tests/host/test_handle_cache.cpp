@@ -0,0 +1,203 @@
+/**
+ * @file test_handle_cache.cpp
+ * @brief read_file_chunk 只读句柄缓存：命中/未命中/淘汰计数、大小写折叠的键、
+ *        写入/追加/删除/重命名/写句柄造成的失效，以及写句柄打开期间绕过缓存
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+
+#include <string>
+#include <vector>
+
+using MicroSD::RWSD;
+using MicroSD::Span;
+
+namespace {
+
+std::vector<uint8_t> filled(size_t size, uint8_t value) {
+    return std::vector<uint8_t>(size, value);
+}
+
+// 读取 offset 处的一个字节，失败返回 -1
+int byte_at(RWSD& sd, const std::string& path, size_t offset) {
+    uint8_t b = 0;
+    auto r = sd.read_file_chunk_into(path, offset, Span<uint8_t>(&b, 1));
+    return r.is_ok() && *r == 1 ? b : -1;
+}
+
+} // namespace
+
+HOST_TEST(hits_misses_and_lru_eviction) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    RWSD& sd = fx.sd();
+    REQUIRE(sd.write_file("/a.bin", filled(4096, 0xA1)).is_ok());
+    REQUIRE(sd.write_file("/b.bin", filled(4096, 0xB2)).is_ok());
+    REQUIRE(sd.write_file("/c.bin", filled(4096, 0xC3)).is_ok());
+    sd.set_handle_cache_limit(2);
+    sd.reset_handle_cache_stats();
+
+    CHECK_EQ(byte_at(sd, "/a.bin", 0), 0xA1);
+    CHECK_EQ(byte_at(sd, "/a.bin", 1000), 0xA1);
+    CHECK_EQ(byte_at(sd, "/b.bin", 0), 0xB2);
+    CHECK_EQ(byte_at(sd, "/a.bin", 2000), 0xA1);
+    auto stats = sd.get_handle_cache_stats();
+    CHECK_EQ(stats.misses, 2u);
+    CHECK_EQ(stats.hits, 2u);
+    CHECK_EQ(stats.evictions, 0u);
+
+    // 第三个文件淘汰最久未用的 b，a 仍然命中
+    CHECK_EQ(byte_at(sd, "/c.bin", 0), 0xC3);
+    CHECK_EQ(byte_at(sd, "/a.bin", 3000), 0xA1);
+    CHECK_EQ(byte_at(sd, "/b.bin", 0), 0xB2);
+    stats = sd.get_handle_cache_stats();
+    CHECK_EQ(stats.misses, 4u);
+    CHECK_EQ(stats.hits, 3u);
+    CHECK_EQ(stats.evictions, 2u);
+
+    // 上限为0时不缓存
+    sd.set_handle_cache_limit(0);
+    sd.reset_handle_cache_stats();
+    CHECK_EQ(byte_at(sd, "/a.bin", 0), 0xA1);
+    stats = sd.get_handle_cache_stats();
+    CHECK_EQ(stats.hits + stats.misses, 0u);
+}
+
+HOST_TEST(keys_fold_case_and_separators) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    RWSD& sd = fx.sd();
+    REQUIRE(sd.create_directory("/logs").is_ok());
+    REQUIRE(sd.write_file("/logs/LOG.TXT", filled(100, 0x11)).is_ok());
+    sd.reset_handle_cache_stats();
+
+    CHECK_EQ(byte_at(sd, "/logs/LOG.TXT", 0), 0x11);
+    CHECK_EQ(byte_at(sd, "/logs/log.txt", 1), 0x11);
+    CHECK_EQ(byte_at(sd, "\\LOGS\\Log.Txt", 2), 0x11);
+    CHECK_EQ(sd.get_handle_cache_stats().misses, 1u);
+    CHECK_EQ(sd.get_handle_cache_stats().hits, 2u);
+
+    // 以另一种写法写入也使缓存失效
+    REQUIRE(sd.write_file("/LOGS/log.txt", filled(100, 0x22)).is_ok());
+    CHECK_EQ(sd.get_handle_cache_stats().invalidations, 1u);
+    CHECK_EQ(byte_at(sd, "/logs/LOG.TXT", 0), 0x22);
+}
+
+HOST_TEST(whole_file_operations_invalidate) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    RWSD& sd = fx.sd();
+    REQUIRE(sd.write_file("/f.bin", filled(100, 0x01)).is_ok());
+    sd.reset_handle_cache_stats();
+
+    // write_file
+    CHECK_EQ(byte_at(sd, "/f.bin", 50), 0x01);
+    REQUIRE(sd.write_file("/f.bin", filled(100, 0x02)).is_ok());
+    CHECK_EQ(sd.get_handle_cache_stats().invalidations, 1u);
+    CHECK_EQ(byte_at(sd, "/f.bin", 50), 0x02);
+
+    // append_file：缓存的FIL不知道新的文件大小
+    REQUIRE(sd.append_file("/f.bin", filled(100, 0x03)).is_ok());
+    CHECK_EQ(sd.get_handle_cache_stats().invalidations, 2u);
+    CHECK_EQ(byte_at(sd, "/f.bin", 150), 0x03);
+
+    // rename：旧路径的句柄关闭，新路径重新打开
+    REQUIRE(sd.rename("/f.bin", "/g.bin").is_ok());
+    CHECK_EQ(sd.get_handle_cache_stats().invalidations, 3u);
+    CHECK_EQ(byte_at(sd, "/f.bin", 0), -1);
+    CHECK_EQ(byte_at(sd, "/g.bin", 0), 0x02);
+
+    // delete_file
+    REQUIRE(sd.delete_file("/g.bin").is_ok());
+    CHECK_EQ(sd.get_handle_cache_stats().invalidations, 4u);
+    CHECK_EQ(byte_at(sd, "/g.bin", 0), -1);
+    CHECK_EQ(sd.get_handle_cache_stats().hits, 0u);
+}
+
+HOST_TEST(open_writer_bypasses_cache_until_closed) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    RWSD& sd = fx.sd();
+    REQUIRE(sd.write_file("/ring.bin", filled(8192, 0x00)).is_ok());
+    sd.reset_handle_cache_stats();
+    CHECK_EQ(byte_at(sd, "/ring.bin", 100), 0x00);
+
+    {
+        // 日志类的写法：长期打开的写句柄，原位覆盖后 flush
+        auto opened = sd.open_file("/RING.BIN", "r+");
+        REQUIRE(opened.is_ok());
+        auto writer = opened.take();
+        CHECK_EQ(sd.get_handle_cache_stats().invalidations, 1u);
+
+        for (uint8_t round = 1; round <= 3; round++) {
+            REQUIRE(writer.seek(100).is_ok());
+            REQUIRE(writer.write(filled(1, round)).is_ok());
+            REQUIRE(writer.flush().is_ok());
+            CHECK_EQ(byte_at(sd, "/ring.bin", 100), round);
+        }
+        // 扩展文件：临时打开的FIL看到新的大小
+        REQUIRE(writer.seek(8192).is_ok());
+        REQUIRE(writer.write(filled(10, 0x7E)).is_ok());
+        REQUIRE(writer.flush().is_ok());
+        CHECK_EQ(byte_at(sd, "/ring.bin", 8195), 0x7E);
+
+        auto stats = sd.get_handle_cache_stats();
+        CHECK_EQ(stats.bypasses, 4u);
+        CHECK_EQ(stats.hits, 0u);
+        CHECK_EQ(stats.misses, 1u);
+    }
+
+    // 写句柄关闭后恢复缓存
+    CHECK_EQ(byte_at(sd, "/ring.bin", 100), 3);
+    CHECK_EQ(byte_at(sd, "/ring.bin", 101), 0x00);
+    auto stats = sd.get_handle_cache_stats();
+    CHECK_EQ(stats.misses, 2u);
+    CHECK_EQ(stats.hits, 1u);
+    CHECK_EQ(stats.bypasses, 4u);
+}
+
+HOST_TEST(writer_opened_without_rwsd_invalidates_on_next_hit) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    RWSD& sd = fx.sd();
+    REQUIRE(sd.write_file("/s.bin", filled(4096, 0x10)).is_ok());
+    sd.reset_handle_cache_stats();
+    CHECK_EQ(byte_at(sd, "/s.bin", 10), 0x10);
+    CHECK_EQ(byte_at(sd, "/s.bin", 20), 0x10);
+    CHECK_EQ(sd.get_handle_cache_stats().hits, 1u);
+
+    // 直接 FileHandle::open 不经过 RWSD::open_file，缓存中的句柄仍在
+    {
+        RWSD::FileHandle writer;
+        REQUIRE(writer.open("/S.BIN", "a").is_ok());
+        REQUIRE(writer.write(filled(100, 0x20)).is_ok());
+        REQUIRE(writer.flush().is_ok());
+        CHECK_EQ(byte_at(sd, "/s.bin", 4100), 0x20);
+        CHECK_EQ(sd.get_handle_cache_stats().bypasses, 1u);
+        CHECK_EQ(sd.get_handle_cache_stats().invalidations, 1u);
+
+        // 移动后仍登记为写句柄
+        RWSD::FileHandle moved(std::move(writer));
+        CHECK_EQ(byte_at(sd, "/s.bin", 0), 0x10);
+        CHECK_EQ(sd.get_handle_cache_stats().bypasses, 2u);
+        REQUIRE(moved.write(filled(1, 0x30)).is_ok());
+    }
+
+    // 关闭时最后一次写入落盘，代数变化使关闭前的缓存不可再命中
+    CHECK_EQ(byte_at(sd, "/s.bin", 4196), 0x30);
+    CHECK_EQ(byte_at(sd, "/s.bin", 4197), -1);
+    auto stats = sd.get_handle_cache_stats();
+    CHECK_EQ(stats.hits, 2u);
+    CHECK_EQ(stats.misses, 2u);
+
+    // 只读句柄不登记
+    {
+        RWSD::FileHandle reader;
+        REQUIRE(reader.open("/s.bin", "r").is_ok());
+        CHECK_EQ(byte_at(sd, "/s.bin", 0), 0x10);
+    }
+    CHECK_EQ(sd.get_handle_cache_stats().hits, 3u);
+}
+
+HOST_TEST_MAIN()
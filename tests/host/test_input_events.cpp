@@ -0,0 +1,112 @@
+/**
+ * @file test_input_events.cpp
+ * @brief 输入事件队列：合并、溢出与索引回绕；按键事件的时间戳是边沿中断时间而不是入队时间
+ */
+
+#include "host_test.hpp"
+#include "hardware/input/button/EnhancedButtonManager.hpp"
+#include "hardware/input/button/input_event_queue.hpp"
+
+#include <vector>
+
+using namespace hardware::input;
+
+namespace {
+
+enum class Ev { NONE, A, B };
+
+// 带抖动地按下并在 hold_us 后释放
+void press_key(uint pin, uint32_t hold_us) {
+    host_gpio_drive(pin, !BUTTON_RELEASED_LEVEL);
+    host_advance_us(800);
+    host_gpio_drive(pin, BUTTON_RELEASED_LEVEL);
+    host_advance_us(700);
+    host_gpio_drive(pin, !BUTTON_RELEASED_LEVEL);
+    host_advance_us(hold_us - 1500);
+    host_gpio_drive(pin, BUTTON_RELEASED_LEVEL);
+}
+
+uint32_t now_ms() {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+} // namespace
+
+HOST_TEST(queue_coalesces_overflows_and_wraps) {
+    InputEventQueue<Ev, 4> queue;
+    queue.set_coalescing(Ev::A, true);
+    for (uint32_t i = 0; i < 3; i++) CHECK(queue.push(Ev::A, InputSource::BUTTON_DOWN, 10 + i));
+    CHECK(queue.push(Ev::B, InputSource::JOYSTICK, 20));
+    CHECK(!queue.push(Ev::A, InputSource::BUTTON_DOWN, 30));
+    CHECK_EQ(queue.overflow_count(), 1u);
+    CHECK_EQ(queue.high_water(), 4u);
+
+    std::vector<decltype(queue)::Entry> drained;
+    queue.drain([&](const decltype(queue)::Entry& entry) { drained.push_back(entry); });
+    REQUIRE(drained.size() == 2);
+    CHECK(drained[0].type == Ev::A);
+    CHECK_EQ(drained[0].count, 3);
+    CHECK_EQ(drained[0].time_ms, 10u);      // 合并条目保留第一个事件的时间
+    CHECK(drained[1].type == Ev::B);
+    CHECK_EQ(drained[1].count, 1);
+    CHECK_EQ(queue.coalesced_count(), 2u);
+
+    // 不合并的类型逐个取出，索引多次回绕后仍然正确
+    decltype(queue)::Entry entry;
+    bool ok = true;
+    for (uint32_t round = 0; round < 10; round++) {
+        queue.push(Ev::B, InputSource::JOYSTICK, round);
+        queue.push(Ev::B, InputSource::JOYSTICK, round + 100);
+        ok = ok && queue.pop(entry) && entry.time_ms == round && entry.count == 1;
+        ok = ok && queue.pop(entry) && entry.time_ms == round + 100;
+    }
+    CHECK(ok);
+    CHECK(queue.empty());
+}
+
+HOST_TEST(button_events_carry_the_edge_timestamp) {
+    EnhancedButtonManager buttons;
+    REQUIRE(buttons.initialize());
+    buttons.set_app_mode(AppMode::CONTENT_READING);
+
+    // 短按和长按都在主循环停顿期间发生，很久之后才 update
+    host_advance_us(10000);
+    press_key(BUTTON_KEY2_PIN, 120000);
+    const uint32_t click_ms = now_ms();
+    host_advance_us(200000);
+    const uint32_t long_start_ms = now_ms();
+    press_key(BUTTON_KEY1_PIN, 900000);
+    host_advance_us(700000);
+    buttons.update();
+
+    EnhancedButtonManager::EventEntry entry;
+    REQUIRE(buttons.pop_event(entry));
+    CHECK(entry.type == EnhancedButtonEvent::PAGE_DOWN);
+    CHECK(entry.source == InputSource::BUTTON_DOWN);
+    CHECK_EQ(entry.time_ms, click_ms);
+    REQUIRE(buttons.pop_event(entry));
+    CHECK(entry.type == EnhancedButtonEvent::MENU_ENTER);
+    CHECK_EQ(entry.time_ms, long_start_ms + NEW_BUTTON_LONG_PRESS_MS);
+    CHECK(!buttons.pop_event(entry));
+}
+
+HOST_TEST(edge_timestamps_survive_time_us_32_wraparound) {
+    EnhancedButtonManager buttons;
+    REQUIRE(buttons.initialize());
+    buttons.set_app_mode(AppMode::CONTENT_READING);
+
+    // 运行约72分钟后 time_us_32 已回绕，事件时间仍与 to_ms_since_boot 一致
+    host_advance_us((1ull << 32) - time_us_32() - 50000);
+    press_key(BUTTON_KEY2_PIN, 120000);
+    const uint32_t click_ms = now_ms();
+    CHECK(time_us_32() < 100000);
+    host_advance_us(300000);
+    buttons.update();
+
+    EnhancedButtonManager::EventEntry entry;
+    REQUIRE(buttons.pop_event(entry));
+    CHECK(entry.type == EnhancedButtonEvent::PAGE_DOWN);
+    CHECK_EQ(entry.time_ms, click_ms);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,212 @@
+/**
+ * @file test_input_latency.cpp
+ * @brief 输入到显示延迟：脚本化的按键序列驱动 ButtonSystemAdapter，应用在回调中绘制，
+ *        主循环按固定节拍推送到 ST7306 (SPI替身按字节计时)，直方图与逐次计算的期望值一致
+ */
+
+#include "host_test.hpp"
+#include "hardware/display/st7306_driver.hpp"
+#include "hardware/input/button/ButtonSystemAdapter.hpp"
+#include "hardware/input/input_latency.hpp"
+
+#include <vector>
+
+using namespace hardware::input;
+
+namespace {
+
+constexpr uint32_t LOOP_PERIOD_US = 20000;
+
+// 面板模型：只统计收到的SPI字节
+uint8_t count_spi_byte(void* ctx, uint8_t) {
+    (*static_cast<uint32_t*>(ctx))++;
+    return 0xFF;
+}
+
+// 带抖动地按下并在 hold_us 后释放，返回释放边沿的时间
+uint32_t click(uint pin, uint32_t hold_us) {
+    host_gpio_drive(pin, !BUTTON_RELEASED_LEVEL);
+    host_advance_us(800);
+    host_gpio_drive(pin, BUTTON_RELEASED_LEVEL);
+    host_advance_us(700);
+    host_gpio_drive(pin, !BUTTON_RELEASED_LEVEL);
+    host_advance_us(hold_us - 1500);
+    host_gpio_drive(pin, BUTTON_RELEASED_LEVEL);
+    return time_us_32();
+}
+
+/**
+ * @brief 脚本化的应用：翻页只重绘一行文字区域，菜单键重绘整屏
+ */
+class ScriptedApp {
+public:
+    ScriptedApp() : lcd_(20, 15, 17, 18, 19) {}
+
+    bool start() {
+        host_set_spi_device(count_spi_byte, &spi_bytes_);
+        lcd_.initialize();
+        lcd_.display();
+        if (!input_.initialize()) {
+            return false;
+        }
+        input_.set_app_mode(AppMode::CONTENT_READING);
+        input_.set_event_callback([this](UnifiedInputEvent event) {
+            if (event == UnifiedInputEvent::PAGE_NEXT) {
+                lcd_.fillRect(0, 100, st7306::ST7306Driver::LCD_WIDTH, 16, st7306::ST7306Driver::COLOR_BLACK);
+            } else {
+                lcd_.invalidate();
+            }
+            dirty_ = true;
+        });
+        return true;
+    }
+
+    // 等到下一个循环节拍：处理输入，有改动时推送到屏幕
+    void tick() {
+        host_advance_us(LOOP_PERIOD_US - time_us_32() % LOOP_PERIOD_US);
+        input_.update();
+        if (dirty_) {
+            dirty_ = false;
+            uint32_t before = spi_bytes_;
+            lcd_.display();
+            last_frame_bytes_ = spi_bytes_ - before;
+            last_frame_us_ = time_us_32();
+        }
+    }
+
+    // 运行到 since_us 之后的第一帧，返回该帧完成时间
+    uint32_t run_until_frame(uint32_t since_us) {
+        for (int t = 0; t < 10; t++) {
+            tick();
+            if (last_frame_us_ - since_us < 1000000) {
+                return last_frame_us_;
+            }
+        }
+        return 0;
+    }
+
+    uint32_t last_frame_us() const { return last_frame_us_; }
+    uint32_t last_frame_bytes() const { return last_frame_bytes_; }
+
+private:
+    st7306::ST7306Driver lcd_;
+    ButtonSystemAdapter input_;
+    bool dirty_ = false;
+    uint32_t spi_bytes_ = 0;
+    uint32_t last_frame_bytes_ = 0;
+    uint32_t last_frame_us_ = 0;
+};
+
+} // namespace
+
+HOST_TEST(latency_is_measured_from_edge_to_last_spi_byte) {
+    ScriptedApp app;
+    REQUIRE(app.start());
+    InputLatency::reset();
+    InputLatency::set_enabled(true);
+
+    // 按下时刻与循环节拍的相位各不相同；期望值 = 释放边沿 → 该帧最后一个字节
+    uint32_t expected_min = UINT32_MAX;
+    uint32_t expected_max = 0;
+    uint32_t partial_bytes = 0;
+    for (int i = 0; i < 8; i++) {
+        host_advance_us(200000 + i * 3100);
+        uint32_t release_us = click(BUTTON_KEY2_PIN, 90000);
+        uint32_t frame_us = app.run_until_frame(release_us);
+        REQUIRE(frame_us != 0);
+        uint32_t expected = frame_us - release_us;
+        if (expected < expected_min) expected_min = expected;
+        if (expected > expected_max) expected_max = expected;
+        partial_bytes = app.last_frame_bytes();
+    }
+
+    const LatencyHistogram& h = InputLatency::histogram();
+    CHECK_EQ(h.count(), 8u);
+    CHECK_EQ(InputLatency::merged(), 0u);
+    CHECK_EQ(InputLatency::expired(), 0u);
+    // 事件时间戳按毫秒截断，测得值最多比期望大1ms
+    CHECK(h.min() >= expected_min && h.min() <= expected_min + 1000);
+    CHECK(h.max() >= expected_max && h.max() <= expected_max + 1000);
+    CHECK(h.percentile(50) >= h.min() && h.percentile(50) <= h.max());
+    printf("  翻页: p50 %lu us (期望 %lu..%lu us)，每帧 %lu 字节\n", (unsigned long)h.percentile(50),
+           (unsigned long)expected_min, (unsigned long)expected_max, (unsigned long)partial_bytes);
+
+    // 整屏重绘的SPI时间计入延迟
+    InputLatency::reset();
+    host_advance_us(200000);
+    uint32_t release_us = click(BUTTON_KEY1_PIN, 90000);
+    REQUIRE(app.run_until_frame(release_us) != 0);
+    uint32_t full_bytes = app.last_frame_bytes();
+    CHECK(full_bytes > partial_bytes * 10);
+    REQUIRE(h.count() == 1u);
+    CHECK(h.min() >= app.last_frame_us() - release_us);
+    CHECK(h.min() > full_bytes * 8 / 40);      // 40MHz下的移位时间 (us)
+
+    InputLatency::set_enabled(false);
+}
+
+HOST_TEST(inputs_before_one_frame_merge_and_stale_inputs_expire) {
+    ScriptedApp app;
+    REQUIRE(app.start());
+    InputLatency::reset();
+    InputLatency::set_enabled(true);
+
+    // 主循环停顿期间的下一页和上一页在同一次 update 中分别分发，但并入同一帧，从第一次开始计时
+    host_advance_us(100000);
+    uint32_t first_us = click(BUTTON_KEY2_PIN, 90000);
+    host_advance_us(150000);
+    uint32_t second_us = click(BUTTON_KEY1_PIN, 90000);
+    host_advance_us(100000);
+    uint32_t frame_us = app.run_until_frame(second_us);
+    REQUIRE(frame_us != 0);
+    CHECK_EQ(InputLatency::histogram().count(), 1u);
+    CHECK_EQ(InputLatency::merged(), 1u);
+    CHECK(InputLatency::histogram().min() >= frame_us - first_us);
+
+    // 回调方式逐个分发同类翻页，同一帧之前的第二次同样计为合并
+    host_advance_us(100000);
+    click(BUTTON_KEY2_PIN, 90000);
+    host_advance_us(150000);
+    second_us = click(BUTTON_KEY2_PIN, 90000);
+    host_advance_us(100000);
+    REQUIRE(app.run_until_frame(second_us) != 0);
+    CHECK_EQ(InputLatency::histogram().count(), 2u);
+    CHECK_EQ(InputLatency::merged(), 2u);
+
+    // 分发后超时仍没有刷新：下一次输入时丢弃并计数
+    InputLatency::input_dispatched(to_ms_since_boot(get_absolute_time()));
+    host_advance_us((INPUT_LATENCY_TIMEOUT_MS + 100) * 1000ull);
+    uint32_t release_us = click(BUTTON_KEY2_PIN, 90000);
+    REQUIRE(app.run_until_frame(release_us) != 0);
+    CHECK_EQ(InputLatency::expired(), 1u);
+    CHECK_EQ(InputLatency::histogram().count(), 3u);
+
+    InputLatency::set_enabled(false);
+}
+
+HOST_TEST(serial_commands_toggle_report_and_reset) {
+    InputLatency::set_enabled(false);
+    InputLatency::reset();
+    CHECK(!InputLatency::poll_serial());
+
+    host_stdin_push("T");
+    CHECK(InputLatency::poll_serial());
+    CHECK(InputLatency::is_enabled());
+
+    InputLatency::input_dispatched(to_ms_since_boot(get_absolute_time()));
+    host_advance_us(5000);
+    InputLatency::frame_presented();
+    CHECK_EQ(InputLatency::histogram().count(), 1u);
+
+    // 一次取完所有字符，未知字符被忽略
+    host_stdin_push("Lxr");
+    CHECK(InputLatency::poll_serial());
+    CHECK_EQ(InputLatency::histogram().count(), 0u);
+    CHECK(!InputLatency::poll_serial());
+    host_stdin_push("x\n");
+    CHECK(!InputLatency::poll_serial());
+
+    InputLatency::set_enabled(false);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,239 @@
+/**
+ * @file test_io_queue.cpp
+ * @brief tf_card 异步块请求队列：FIFO顺序、分散块表、每次轮询的有界工作量、重试与超时
+ */
+
+#include "host_test.hpp"
+#include "sd_card_model.hpp"
+
+#include "tf_card.h"
+#include "tf_card_async.h"
+
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr uint CS_PIN = 9;
+
+// 硬件SPI连接的模拟卡，已初始化
+struct QueueFixture {
+    host::SdCardModel card{2u * 1024 * 1024, CS_PIN};
+    bool ok = false;
+
+    QueueFixture() {
+        pico_fatfs_spi_config_t config = {spi1, 400 * KHZ, 25 * MHZ, 8, CS_PIN, 10, 11, true};
+        pico_fatfs_set_config(&config);
+        ok = (disk_initialize(0) & STA_NOINIT) == 0;
+        pico_fatfs_reset_link_stats();
+        card.reset_stats();
+    }
+};
+
+std::vector<BYTE> make_blocks(UINT count, uint8_t seed) {
+    std::vector<BYTE> data(512 * count);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (BYTE)(seed + i * 7 + (i >> 9));
+    return data;
+}
+
+pico_fatfs_io_req_t make_req(pico_fatfs_io_op_t op, BYTE* buff, LBA_t sector, UINT count) {
+    pico_fatfs_io_req_t req = {};
+    req.op = op;
+    req.buff = buff;
+    req.sector = sector;
+    req.count = count;
+    return req;
+}
+
+std::vector<int> completion_order;
+
+void record_completion(pico_fatfs_io_req_t* req, DRESULT result) {
+    completion_order.push_back((int)(intptr_t)req->user);
+}
+
+} // namespace
+
+HOST_TEST(requests_complete_in_fifo_order) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    auto data = make_blocks(3, 0x11);
+    std::vector<BYTE> back(512 * 3);
+
+    auto write = make_req(PICO_FATFS_IO_WRITE, data.data(), 100, 3);
+    auto sync = make_req(PICO_FATFS_IO_SYNC, nullptr, 0, 0);
+    auto read = make_req(PICO_FATFS_IO_READ, back.data(), 100, 3);
+    write.callback = sync.callback = read.callback = record_completion;
+    write.user = (void*)1;
+    sync.user = (void*)2;
+    read.user = (void*)3;
+
+    completion_order.clear();
+    REQUIRE(pico_fatfs_io_submit(&write));
+    REQUIRE(pico_fatfs_io_submit(&sync));
+    REQUIRE(pico_fatfs_io_submit(&read));
+    CHECK(pico_fatfs_io_busy());
+    while (pico_fatfs_io_poll()) {
+    }
+
+    CHECK_EQ(write.result, RES_OK);
+    CHECK_EQ(sync.result, RES_OK);
+    CHECK_EQ(read.result, RES_OK);
+    REQUIRE(completion_order.size() == 3);
+    CHECK_EQ(completion_order[0], 1);
+    CHECK_EQ(completion_order[1], 2);
+    CHECK_EQ(completion_order[2], 3);
+    CHECK(back == data);
+    CHECK_EQ(fx.card.stats().multi_writes, 1u);
+}
+
+HOST_TEST(scatter_list_writes_and_reads_separate_buffers) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    auto a = make_blocks(1, 0x21);
+    auto b = make_blocks(1, 0x42);
+    auto c = make_blocks(1, 0x63);
+    BYTE* blocks[3] = {a.data(), b.data(), c.data()};
+
+    auto write = make_req(PICO_FATFS_IO_WRITE, nullptr, 2000, 3);
+    write.blocks = blocks;
+    REQUIRE(pico_fatfs_io_submit(&write));
+    CHECK_EQ(pico_fatfs_io_wait(&write), RES_OK);
+
+    // 卡上连续落盘
+    CHECK(memcmp(fx.card.read_sector(2000).data(), a.data(), 512) == 0);
+    CHECK(memcmp(fx.card.read_sector(2001).data(), b.data(), 512) == 0);
+    CHECK(memcmp(fx.card.read_sector(2002).data(), c.data(), 512) == 0);
+
+    // 反向读到三个独立缓冲区
+    std::vector<BYTE> ra(512), rb(512), rc(512);
+    BYTE* targets[3] = {rc.data(), rb.data(), ra.data()};
+    auto read = make_req(PICO_FATFS_IO_READ, nullptr, 2000, 3);
+    read.blocks = targets;
+    REQUIRE(pico_fatfs_io_submit(&read));
+    CHECK_EQ(pico_fatfs_io_wait(&read), RES_OK);
+    CHECK(rc == a);
+    CHECK(rb == b);
+    CHECK(ra == c);
+}
+
+HOST_TEST(poll_clocks_bounded_bytes_while_card_is_busy) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    fx.card.faults().busy_bytes = 4000;
+    auto data = make_blocks(4, 0x33);
+
+    auto write = make_req(PICO_FATFS_IO_WRITE, data.data(), 300, 4);
+    REQUIRE(pico_fatfs_io_submit(&write));
+    uint64_t max_step = 0;
+    uint32_t probe_polls = 0;
+    for (;;) {
+        uint64_t before = fx.card.stats().bytes;
+        bool pending = pico_fatfs_io_poll();
+        uint64_t step = fx.card.stats().bytes - before;
+        if (step > max_step) max_step = step;
+        if (step > 0 && step <= PICO_FATFS_IO_PROBE_BYTES) probe_polls++;
+        if (!pending) break;
+    }
+    CHECK_EQ(write.result, RES_OK);
+    // 一次轮询最多发送命令序列 (ACMD23 + CMD25) 加一个数据块
+    CHECK(max_step <= 600);
+    // 忙等待分摊到大量只探测几个字节的轮询里
+    CHECK(probe_polls > 3 * 4000 / PICO_FATFS_IO_PROBE_BYTES);
+}
+
+HOST_TEST(transfer_errors_are_retried) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    CHECK(fx.card.crc_mode());
+    auto data = make_blocks(2, 0x55);
+    std::vector<BYTE> back(1024);
+
+    fx.card.faults().reject_writes = 1;
+    auto write = make_req(PICO_FATFS_IO_WRITE, data.data(), 500, 2);
+    REQUIRE(pico_fatfs_io_submit(&write));
+    CHECK_EQ(pico_fatfs_io_wait(&write), RES_OK);
+
+    fx.card.faults().corrupt_reads = 1;
+    auto read = make_req(PICO_FATFS_IO_READ, back.data(), 500, 2);
+    REQUIRE(pico_fatfs_io_submit(&read));
+    CHECK_EQ(pico_fatfs_io_wait(&read), RES_OK);
+    CHECK(back == data);
+
+    pico_fatfs_link_stats_t stats;
+    pico_fatfs_get_link_stats(&stats);
+    CHECK_EQ(stats.write_errors, 1u);
+    CHECK_EQ(stats.crc_errors, 1u);
+    CHECK_EQ(stats.retries, 2u);
+    CHECK_EQ(stats.failed, 0u);
+}
+
+HOST_TEST(persistent_errors_fail_after_retries) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    auto data = make_blocks(1, 0x66);
+
+    fx.card.faults().reject_writes = 100;
+    auto write = make_req(PICO_FATFS_IO_WRITE, data.data(), 700, 1);
+    REQUIRE(pico_fatfs_io_submit(&write));
+    CHECK_EQ(pico_fatfs_io_wait(&write), RES_ERROR);
+
+    pico_fatfs_link_stats_t stats;
+    pico_fatfs_get_link_stats(&stats);
+    CHECK_EQ(stats.retries, (uint32_t)PICO_FATFS_IO_RETRIES);
+    CHECK_EQ(stats.failed, 1u);
+    CHECK(!pico_fatfs_io_busy());
+}
+
+HOST_TEST(ready_timeout_reports_disk_error) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    auto data = make_blocks(1, 0x77);
+    std::vector<BYTE> back(512);
+
+    // 第一个块被接受后卡一直忙
+    fx.card.faults().stuck_busy = true;
+    auto first = make_req(PICO_FATFS_IO_WRITE, data.data(), 800, 1);
+    REQUIRE(pico_fatfs_io_submit(&first));
+    CHECK_EQ(pico_fatfs_io_wait(&first), RES_OK);
+
+    // 之后的读、写和SYNC都在500ms等待就绪超时后报磁盘错误，而不是"未就绪"
+    uint64_t t0 = time_us_64();
+    auto sync = make_req(PICO_FATFS_IO_SYNC, nullptr, 0, 0);
+    REQUIRE(pico_fatfs_io_submit(&sync));
+    CHECK_EQ(pico_fatfs_io_wait(&sync), RES_ERROR);
+    CHECK(time_us_64() - t0 >= 499 * 1000);   // _millis() 以毫秒取整
+
+    auto write = make_req(PICO_FATFS_IO_WRITE, data.data(), 801, 1);
+    REQUIRE(pico_fatfs_io_submit(&write));
+    CHECK_EQ(pico_fatfs_io_wait(&write), RES_ERROR);
+
+    auto read = make_req(PICO_FATFS_IO_READ, back.data(), 800, 1);
+    REQUIRE(pico_fatfs_io_submit(&read));
+    CHECK_EQ(pico_fatfs_io_wait(&read), RES_ERROR);
+
+    // 同步包装经缓存未命中也得到同样的结果
+    CHECK_EQ(disk_read(0, back.data(), 900, 1), RES_ERROR);
+    CHECK(!pico_fatfs_io_busy());
+}
+
+HOST_TEST(invalid_requests_are_rejected_without_callback) {
+    QueueFixture fx;
+    REQUIRE(fx.ok);
+    BYTE buffer[512];
+
+    completion_order.clear();
+    auto empty = make_req(PICO_FATFS_IO_READ, buffer, 0, 0);
+    empty.callback = record_completion;
+    CHECK(!pico_fatfs_io_submit(&empty));
+    CHECK_EQ(empty.result, RES_PARERR);
+
+    auto no_buffer = make_req(PICO_FATFS_IO_WRITE, nullptr, 0, 1);
+    no_buffer.callback = record_completion;
+    CHECK(!pico_fatfs_io_submit(&no_buffer));
+    CHECK_EQ(no_buffer.result, RES_PARERR);
+
+    CHECK(completion_order.empty());
+    CHECK(!pico_fatfs_io_busy());
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,291 @@
+/**
+ * @file test_joystick_engine.cpp
+ * @brief 摇杆方向引擎：回放ADC偏移轨迹，检查滞回、预测确认、稳定窗口、自动连发；经I2C寄存器模型的完整轮询路径
+ *        及批量读取前后每次轮询的总线占用
+ */
+
+#include "host_test.hpp"
+#include "hardware/input/joystick/joystick_controller.hpp"
+
+#include <functional>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t POLL_MS = 10;
+
+struct Sample {
+    int16_t x;
+    int16_t y;
+};
+
+struct Event {
+    JoystickEvent::Type type;
+    JoystickDirection direction;
+    uint32_t time_ms;
+
+    bool operator==(const Event& other) const {
+        return type == other.type && direction == other.direction && time_ms == other.time_ms;
+    }
+};
+
+// 每 POLL_MS 一个采样，第i个采样的时间为 i*POLL_MS；轨迹结束后保持最后一个采样直到 end_ms
+std::vector<Event> replay(const std::vector<Sample>& trace, uint32_t end_ms = 0,
+                          const JoystickEngineConfig& config = JoystickEngineConfig()) {
+    JoystickDirectionEngine engine(config);
+    std::vector<Event> events;
+    JoystickEvent event;
+    uint32_t samples = trace.size();
+    if (end_ms / POLL_MS + 1 > samples) samples = end_ms / POLL_MS + 1;
+    for (uint32_t i = 0; i < samples; i++) {
+        const Sample& s = trace[i < trace.size() ? i : trace.size() - 1];
+        engine.update(s.x, s.y, i * POLL_MS);
+        while (engine.pop(event)) events.push_back(Event{event.type, event.direction, event.time_ms});
+    }
+    return events;
+}
+
+std::vector<Event> presses_only(const std::vector<Event>& events) {
+    std::vector<Event> out;
+    for (const auto& e : events) {
+        if (e.type != JoystickEvent::REPEAT) out.push_back(e);
+    }
+    return out;
+}
+
+JoystickEngineConfig no_repeat() {
+    JoystickEngineConfig config;
+    config.repeat_delay_ms = 0;
+    return config;
+}
+
+} // namespace
+
+HOST_TEST(noise_around_the_threshold_produces_no_events) {
+    // 中心附近的抖动，以及在进入阈值上下跳动 (每次只增大一次就回落)
+    std::vector<Sample> trace;
+    for (int i = 0; i < 20; i++) trace.push_back({(int16_t)((i % 3) * 40 - 40), (int16_t)((i % 2) * 30)});
+    for (int i = 0; i < 40; i++) trace.push_back({(int16_t)(i % 2 ? 1810 : 1790), 0});
+    CHECK(replay(trace, 0, no_repeat()).empty());
+}
+
+HOST_TEST(single_increase_waits_for_the_stable_window) {
+    // 超过阈值后只增大一次就停在平台上：不能提前确认，稳定窗口 (30ms) 到了才确认
+    std::vector<Sample> trace = {{0, 0}, {0, 1900}, {0, 2000}, {0, 2000}, {0, 1990}, {0, 2000}, {0, 2000}};
+    const std::vector<Event> expected = {{JoystickEvent::PRESS, JoystickDirection::DOWN, 10}};
+    auto events = replay(trace, 0, no_repeat());
+    CHECK(events == expected);
+
+    // 确认时刻是第一个超过阈值的采样之后30ms (第4个采样)
+    JoystickDirectionEngine engine(no_repeat());
+    for (uint32_t i = 0; i < trace.size(); i++) {
+        engine.update(trace[i].x, trace[i].y, i * POLL_MS);
+        bool expect_down = i * POLL_MS >= 40;
+        if ((engine.direction() == JoystickDirection::DOWN) != expect_down) {
+            printf("  采样 %u: 方向 %d\n", i, (int)engine.direction());
+            CHECK(false);
+        }
+    }
+}
+
+HOST_TEST(ramp_commits_after_two_consecutive_increases) {
+    // 持续向外推动：第二次连续增大时 (第3个超过阈值的采样) 提前确认，事件时间仍是第一个采样
+    std::vector<Sample> trace = {{0, 0}, {-1850, 0}, {-2100, 0}, {-2400, 0}, {-2500, 0}};
+    JoystickDirectionEngine engine(no_repeat());
+    std::vector<uint32_t> direction_at;
+    for (uint32_t i = 0; i < trace.size(); i++) {
+        engine.update(trace[i].x, trace[i].y, i * POLL_MS);
+        direction_at.push_back((uint32_t)engine.direction());
+    }
+    CHECK(direction_at[1] == (uint32_t)JoystickDirection::NONE);
+    CHECK(direction_at[2] == (uint32_t)JoystickDirection::NONE);
+    CHECK(direction_at[3] == (uint32_t)JoystickDirection::LEFT);
+    JoystickEvent event;
+    REQUIRE(engine.pop(event));
+    CHECK(event.type == JoystickEvent::PRESS);
+    CHECK_EQ(event.time_ms, 10u);
+
+    // 增大、回落、再增大不算连续 (稳定窗口加长到60ms，只看预测确认)
+    std::vector<Sample> zigzag = {{0, 0}, {0, -1850}, {0, -1950}, {0, -1900}, {0, -1960}};
+    JoystickEngineConfig slow = no_repeat();
+    slow.stable_ms = 60;
+    JoystickDirectionEngine zig(slow);
+    for (uint32_t i = 0; i < zigzag.size(); i++) zig.update(zigzag[i].x, zigzag[i].y, i * POLL_MS);
+    CHECK(zig.direction() == JoystickDirection::NONE);
+}
+
+HOST_TEST(hysteresis_holds_direction_down_to_release_threshold) {
+    // 进入后回落到释放阈值 (1440) 以上仍保持，低于释放阈值才释放
+    std::vector<Sample> trace = {{2000, 0}, {2000, 0}, {2000, 0}, {2000, 0},
+                                 {1500, 0}, {1450, 0}, {1700, 0}, {1460, 0},
+                                 {1400, 0}, {1400, 0}, {1400, 0}, {1400, 0}};
+    const std::vector<Event> expected = {
+        {JoystickEvent::PRESS, JoystickDirection::RIGHT, 0},
+        {JoystickEvent::RELEASE, JoystickDirection::RIGHT, 80},
+    };
+    CHECK(replay(trace, 0, no_repeat()) == expected);
+}
+
+HOST_TEST(held_direction_repeats_with_acceleration) {
+    // 按住1秒：400ms后首次连发，间隔 150 -> 120 -> 96 -> 76 ... 最小40ms
+    std::vector<Sample> trace = {{0, 2000}};
+    auto events = replay(trace, 1000);
+    std::vector<uint32_t> repeats;
+    for (const auto& e : events) {
+        if (e.type == JoystickEvent::REPEAT) repeats.push_back(e.time_ms);
+    }
+    REQUIRE(events.size() > 4);
+    CHECK(events[0] == (Event{JoystickEvent::PRESS, JoystickDirection::DOWN, 0}));
+    REQUIRE(repeats.size() >= 4);
+    CHECK_EQ(repeats[0], 400u);
+    CHECK_EQ(repeats[1], 550u);
+    CHECK_EQ(repeats[2], 670u);
+    CHECK_EQ(repeats[3], 766u);
+    bool min_interval_ok = true;
+    for (size_t i = 1; i < repeats.size(); i++) {
+        if (repeats[i] - repeats[i - 1] < 40) min_interval_ok = false;
+    }
+    CHECK(min_interval_ok);
+}
+
+HOST_TEST(direction_change_releases_before_press_and_diagonals_are_ignored) {
+    std::vector<Sample> trace = {{0, -2000}, {0, -2000}, {0, -2000}, {0, -2000},
+                                 {2000, 0}, {2000, 0}, {2000, 0}, {2000, 0}};
+    const std::vector<Event> expected = {
+        {JoystickEvent::PRESS, JoystickDirection::UP, 0},
+        {JoystickEvent::RELEASE, JoystickDirection::UP, 40},
+        {JoystickEvent::PRESS, JoystickDirection::RIGHT, 40},
+    };
+    CHECK(presses_only(replay(trace, 0, no_repeat())) == expected);
+
+    // 两轴接近 (主轴不到副轴的1.5倍) 时不确定方向
+    CHECK(replay({{2000, 1800}, {2200, 2000}, {2400, 2100}}, 200, no_repeat()).empty());
+}
+
+// ==================== 经I2C的完整轮询路径 ====================
+
+namespace {
+
+// 摇杆模块寄存器模型：写寄存器地址后读取；X/Y偏移在0x50/0x52，按钮在0x20 (0为按下)
+struct JoystickModule {
+    uint8_t regs[256] = {};
+    uint8_t reg = 0;
+    int transfers = 0;
+
+    void set(int16_t x, int16_t y) {
+        memcpy(&regs[JOYSTICK_OFFSET_ADC_VALUE_12BITS_REG], &x, 2);
+        memcpy(&regs[JOYSTICK_OFFSET_ADC_VALUE_12BITS_REG + 2], &y, 2);
+    }
+
+    static int transfer(void* ctx, uint8_t addr, bool read, uint8_t* data, size_t len, bool nostop) {
+        auto* self = static_cast<JoystickModule*>(ctx);
+        if (addr != JOYSTICK_ADDR) return PICO_ERROR_GENERIC;
+        self->transfers++;
+        if (read) {
+            memcpy(data, &self->regs[self->reg], len);
+        } else if (len > 0) {
+            self->reg = data[0];
+            if (len > 1) memcpy(&self->regs[self->reg], data + 1, len - 1);
+        }
+        return (int)len;
+    }
+};
+
+} // namespace
+
+HOST_TEST(controller_replays_adc_trace_over_i2c) {
+    JoystickModule module;
+    module.regs[JOYSTICK_BUTTON_REG] = 1;
+    host_set_i2c_device(&JoystickModule::transfer, &module);
+
+    Joystick joystick;
+    REQUIRE(joystick.begin(i2c1, JOYSTICK_ADDR, JOYSTICK_PIN_SDA, JOYSTICK_PIN_SCL, JOYSTICK_I2C_SPEED));
+    hardware::input::JoystickController controller(joystick);
+    REQUIRE(controller.initialize());
+    const uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+
+    // 向下推到底、按住、回中；10ms一次轮询
+    const std::vector<Sample> trace = {
+        {0, 0}, {20, 600}, {10, 1300}, {0, 1900}, {-10, 2300}, {0, 2450},
+    };
+    std::vector<JoystickEvent> events;
+    JoystickEvent event;
+    auto poll = [&](const Sample& s) {
+        module.set(s.x, s.y);
+        uint32_t poll_start = to_ms_since_boot(get_absolute_time());
+        controller.update();
+        while (controller.pollEvent(event)) events.push_back(event);
+        // I2C传输本身也消耗虚拟时间，按固定节拍补齐
+        host_advance_us((uint64_t)(POLL_MS - (to_ms_since_boot(get_absolute_time()) - poll_start)) * 1000);
+    };
+    for (const auto& s : trace) poll(s);
+    CHECK(controller.getCurrentDirection() == hardware::input::JoystickDirection::DOWN);
+    for (int i = 0; i < 50; i++) poll({0, 2450});
+    for (int i = 0; i < 5; i++) poll({0, 0});
+    CHECK(controller.getCurrentDirection() == hardware::input::JoystickDirection::NONE);
+
+    REQUIRE(events.size() >= 3);
+    CHECK(events.front().type == JoystickEvent::PRESS);
+    CHECK(events.front().direction == JoystickDirection::DOWN);
+    // PRESS 的时间是第一个超过阈值的采样 (第4次轮询)
+    CHECK(events.front().time_ms - start_ms >= 3 * POLL_MS && events.front().time_ms - start_ms <= 4 * POLL_MS);
+    CHECK(events[1].type == JoystickEvent::REPEAT);
+    CHECK(events.back().type == JoystickEvent::RELEASE);
+
+    // 空闲时每次轮询两次读传输 (写地址+读数据各算一次)，不写LED
+    module.transfers = 0;
+    for (int i = 0; i < 10; i++) poll({0, 0});
+    CHECK_EQ(module.transfers, 10 * 4);
+    host_set_i2c_device(nullptr, nullptr);
+}
+
+HOST_TEST(batched_poll_bus_time_on_100khz_bus) {
+    JoystickModule module;
+    module.regs[JOYSTICK_BUTTON_REG] = 1;
+    host_set_i2c_device(&JoystickModule::transfer, &module);
+
+    Joystick joystick;
+    REQUIRE(joystick.begin(i2c1, JOYSTICK_ADDR, JOYSTICK_PIN_SDA, JOYSTICK_PIN_SCL, 100 * KHZ));
+    hardware::input::JoystickController controller(joystick);
+    REQUIRE(controller.initialize());
+
+    // 摇杆静止时轮询 POLLS 次，返回总线占用的虚拟时间 (每字节9个SCL周期，含地址字节)
+    constexpr int POLLS = 1000;
+    auto measure = [&](const std::function<void()>& poll_once) {
+        module.transfers = 0;
+        uint64_t start_us = time_us_64();
+        for (int i = 0; i < POLLS; i++) poll_once();
+        return time_us_64() - start_us;
+    };
+
+    // 批量读取之前的轮询：X、Y、按钮各一次 "写寄存器地址+读"，每次都写4字节LED颜色
+    uint64_t before_us = measure([&] {
+        joystick.get_joy_adc_12bits_offset_value_x();
+        joystick.get_joy_adc_12bits_offset_value_y();
+        joystick.get_button_value();
+        joystick.set_rgb_color(0x10000000);
+    });
+    const int before_transfers = module.transfers;
+
+    // 现在的轮询：X/Y一次4字节突发读 + 按钮，LED颜色不变时不写
+    // (上面改写过LED，先轮询一次让控制器写回它的颜色)
+    controller.update();
+    uint64_t after_us = measure([&] { controller.update(); });
+    const int after_transfers = module.transfers;
+
+    printf("  100kHz总线，静止摇杆 %d 次轮询:\n", POLLS);
+    printf("    批量前: 每次 %d 次传输, %.2f ms, 约 %.0f 次/秒\n", before_transfers / POLLS,
+           before_us / 1000.0 / POLLS, POLLS * 1e6 / before_us);
+    printf("    批量后: 每次 %d 次传输, %.2f ms, 约 %.0f 次/秒\n", after_transfers / POLLS,
+           after_us / 1000.0 / POLLS, POLLS * 1e6 / after_us);
+
+    // 批量前 (2+3)+(2+3)+(2+2)+6 = 20 字节 = 180 位时间；批量后 (2+5)+(2+2) = 11 字节 = 99 位时间
+    CHECK_EQ(before_transfers, POLLS * 7);
+    CHECK_EQ(after_transfers, POLLS * 4);
+    CHECK_EQ(before_us, (uint64_t)POLLS * 1800);
+    CHECK_EQ(after_us, (uint64_t)POLLS * 990);
+    host_set_i2c_device(nullptr, nullptr);
+}
+
+HOST_TEST_MAIN()
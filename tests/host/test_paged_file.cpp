@@ -0,0 +1,163 @@
+/**
+ * @file test_paged_file.cpp
+ * @brief PagedFileView：顺序翻页时的预读命中、反向翻页、随机访问下的LRU淘汰，
+ *        以及命中/缺页/淘汰计数与返回内容
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "hardware/storage/microsd/paged_file.hpp"
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <random>
+#include <string.h>
+#include <vector>
+
+using MicroSD::PagedFileView;
+using MicroSD::Span;
+
+namespace {
+
+constexpr size_t PAGE = PAGED_FILE_PAGE_SIZE;
+constexpr uint32_t FULL_PAGES = 20;
+constexpr size_t FILE_SIZE = FULL_PAGES * PAGE + 1000;     // 末页不满
+
+std::vector<uint8_t> make_content() {
+    std::vector<uint8_t> data(FILE_SIZE);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (uint8_t)((i / PAGE) * 37 + i * 13 + (i >> 11));
+    }
+    return data;
+}
+
+// 只看页号的LRU参考模型 (不调用 poll() 时 PagedFileView 应与之一致)
+struct LruModel {
+    std::list<uint32_t> pages;      // 前端为最近使用
+    uint32_t hits = 0, faults = 0, evictions = 0;
+
+    void access(uint32_t index) {
+        for (auto it = pages.begin(); it != pages.end(); ++it) {
+            if (*it == index) {
+                pages.erase(it);
+                pages.push_front(index);
+                hits++;
+                return;
+            }
+        }
+        faults++;
+        if (pages.size() == PAGED_FILE_PAGE_COUNT) {
+            pages.pop_back();
+            evictions++;
+        }
+        pages.push_front(index);
+    }
+};
+
+} // namespace
+
+HOST_TEST(sequential_paging_hits_readahead) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    const auto content = make_content();
+    REQUIRE(fx.sd().write_file("/book.txt", content).is_ok());
+
+    auto view = std::make_unique<PagedFileView>(fx.sd());
+    REQUIRE(view->open("/book.txt").is_ok());
+    CHECK_EQ(view->size(), FILE_SIZE);
+
+    // 第一页缺页，之后每页都在上一次 poll() 中预读好
+    std::vector<uint8_t> buffer(PAGE);
+    for (uint32_t page = 0; page <= FULL_PAGES; page++) {
+        auto copied = view->read(page * PAGE, Span<uint8_t>(buffer));
+        REQUIRE(copied.is_ok());
+        size_t expected = page < FULL_PAGES ? PAGE : FILE_SIZE - FULL_PAGES * PAGE;
+        REQUIRE(*copied == expected);
+        CHECK(memcmp(buffer.data(), content.data() + page * PAGE, expected) == 0);
+        while (view->poll()) {
+        }
+    }
+    auto stats = view->stats();
+    CHECK_EQ(stats.faults, 1u);
+    CHECK_EQ(stats.hits, FULL_PAGES);
+    CHECK_EQ(stats.readahead_hits, FULL_PAGES);
+    CHECK_EQ(stats.readahead_loads, FULL_PAGES);
+    CHECK_EQ(stats.evictions, FULL_PAGES + 1 - PAGED_FILE_PAGE_COUNT);
+
+    // 预读的页再次访问时只读缓存，不访问卡
+    fx.card().reset_stats();
+    auto window = view->window(FULL_PAGES * PAGE + 10, 100);
+    REQUIRE(window.is_ok());
+    CHECK_EQ(window->length, 100u);
+    CHECK(memcmp(window->data, content.data() + FULL_PAGES * PAGE + 10, 100) == 0);
+    CHECK_EQ(fx.card().stats().blocks_read, 0u);
+
+    // 文件末尾之后返回空窗口
+    window = view->window(FILE_SIZE);
+    REQUIRE(window.is_ok());
+    CHECK_EQ(window->length, 0u);
+
+    // 跳回前面的页：缺页后改为向前预读
+    view->reset_stats();
+    REQUIRE(view->window(10 * PAGE).is_ok());
+    CHECK_EQ(view->stats().faults, 1u);
+    while (view->poll()) {
+    }
+    CHECK_EQ(view->stats().readahead_loads, (uint32_t)PAGED_FILE_READAHEAD);
+    for (uint32_t page = 9; page > 10 - PAGED_FILE_READAHEAD - 1; page--) {
+        auto back = view->window(page * PAGE + 1, 1);
+        REQUIRE(back.is_ok());
+        CHECK_EQ((uint8_t)back->data[0], content[page * PAGE + 1]);
+    }
+    CHECK_EQ(view->stats().faults, 1u);
+    CHECK_EQ(view->stats().readahead_hits, (uint32_t)PAGED_FILE_READAHEAD);
+}
+
+HOST_TEST(random_access_follows_lru) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    const auto content = make_content();
+    REQUIRE(fx.sd().write_file("/book.txt", content).is_ok());
+
+    auto view = std::make_unique<PagedFileView>(fx.sd());
+    REQUIRE(view->open("/book.txt").is_ok());
+
+    // 随机偏移和长度，可跨页；不调用 poll()，计数与纯LRU模型一致
+    std::mt19937 rng(1234);
+    LruModel model;
+    std::vector<uint8_t> buffer(3 * PAGE);
+    int mismatches = 0;
+    for (int i = 0; i < 500; i++) {
+        // 偏向前面几页，使命中和淘汰都足够多
+        size_t offset = (i % 3 == 0) ? rng() % FILE_SIZE : rng() % (10 * PAGE);
+        size_t length = 1 + rng() % buffer.size();
+        auto copied = view->read(offset, Span<uint8_t>(buffer.data(), length));
+        REQUIRE(copied.is_ok());
+        size_t expected = std::min(length, FILE_SIZE - offset);
+        REQUIRE(*copied == expected);
+        if (memcmp(buffer.data(), content.data() + offset, expected) != 0) {
+            mismatches++;
+        }
+        for (size_t page = offset / PAGE; page <= (offset + expected - 1) / PAGE; page++) {
+            model.access((uint32_t)page);
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+    auto stats = view->stats();
+    CHECK_EQ(stats.hits, model.hits);
+    CHECK_EQ(stats.faults, model.faults);
+    CHECK_EQ(stats.evictions, model.evictions);
+    CHECK(stats.hits > 100u);
+    CHECK(stats.evictions > 50u);
+    CHECK_EQ(stats.readahead_loads, 0u);
+
+    // 关闭后重新打开清空页缓存
+    view->reset_stats();
+    REQUIRE(view->open("/book.txt").is_ok());
+    REQUIRE(view->window(0).is_ok());
+    CHECK_EQ(view->stats().faults, 1u);
+    CHECK_EQ(view->stats().hits, 0u);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,153 @@
+/**
+ * @file test_ring_log.cpp
+ * @brief 环形日志掉电安全：槽位在任意字节处撕裂后的头部定位，以及卡上任意块写入后掉电的恢复
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "hardware/storage/microsd/ring_log.hpp"
+
+#include <string.h>
+#include <vector>
+
+using namespace MicroSD::ring_log;
+
+namespace {
+
+constexpr uint32_t FILE_ID = 77;
+
+RingInfo make_info(uint32_t slots) {
+    RingInfo info;
+    info.slot_count = slots;
+    info.record_size = 8;
+    info.file_id = FILE_ID;
+    return info;
+}
+
+void encode_seq(const RingInfo& info, uint32_t seq, uint8_t* block) {
+    uint8_t record[8];
+    for (int i = 0; i < 8; i++) record[i] = (uint8_t)(seq * 8 + i);
+    encode_slot(info, seq, record, 1, block);
+}
+
+RingHead locate(const RingInfo& info, const std::vector<std::vector<uint8_t>>& disk) {
+    return locate_head(info.slot_count, [&](uint32_t slot, uint32_t& seq) {
+        SlotView view;
+        if (!decode_slot(info, slot, disk[slot].data(), view)) return false;
+        seq = view.seq;
+        return true;
+    });
+}
+
+} // namespace
+
+HOST_TEST(locate_head_after_tear_at_every_offset) {
+    int failures = 0;
+    uint32_t max_probes = 0;
+    for (uint32_t slots : {2u, 3u, 7u, 33u}) {
+        RingInfo info = make_info(slots);
+        for (uint32_t writes = 0; writes <= 3 * slots + 1; writes++) {
+            // 未写过的槽位是上一个文件留下的内容
+            std::vector<std::vector<uint8_t>> disk(slots, std::vector<uint8_t>(SLOT_SIZE));
+            RingInfo old_file = make_info(slots);
+            old_file.file_id = FILE_ID + 1;
+            for (uint32_t s = 0; s < slots; s++) encode_seq(old_file, s, disk[s].data());
+            for (uint32_t seq = 0; seq < writes; seq++) encode_seq(info, seq, disk[seq % slots].data());
+
+            // 第 writes 次写入在第 cut 字节处掉电：前 cut 字节是新内容，之后仍是旧内容
+            uint8_t fresh[SLOT_SIZE];
+            encode_seq(info, writes, fresh);
+            const uint32_t slot = writes % slots;
+            const std::vector<uint8_t> before = disk[slot];
+            for (size_t cut = 0; cut <= SLOT_SIZE; cut++) {
+                memcpy(disk[slot].data(), fresh, cut);
+                memcpy(disk[slot].data() + cut, before.data() + cut, SLOT_SIZE - cut);
+
+                SlotView view;
+                bool valid = decode_slot(info, slot, disk[slot].data(), view);
+                bool committed = valid && view.seq == writes;
+                bool old_kept = valid && !committed;
+                uint32_t total = committed ? writes + 1 : writes;
+                uint32_t expected_valid = total < slots ? total
+                                        : (committed || old_kept ? slots : slots - 1);
+
+                RingHead head = locate(info, disk);
+                bool ok = total == 0 ? head.empty
+                        : (!head.empty && head.head_seq == total - 1 && head.head_slot == (total - 1) % slots &&
+                           head.valid_slots == expected_valid);
+                if (!ok && failures++ < 5) {
+                    printf("  N=%u 写入%u次 撕裂于%zu: head_seq=%u valid=%u (期望 %u / %u)\n",
+                           slots, writes, cut, head.head_seq, head.valid_slots, total - 1, expected_valid);
+                }
+                if (head.probes > max_probes) max_probes = head.probes;
+            }
+        }
+    }
+    CHECK_EQ(failures, 0);
+    // 二分查找：33个槽位也只读少量槽位
+    CHECK(max_probes <= 16);
+}
+
+HOST_TEST(recovers_committed_records_after_power_cut_at_every_write) {
+    constexpr uint32_t SLOTS = 4;
+    constexpr int FLUSHES = 10;     // 超过一圈，覆盖回绕
+    constexpr int PER_FLUSH = 3;
+
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    {
+        RingLog log(fx.sd());
+        REQUIRE(log.open("/ring.bin", SLOTS, 16).is_ok());
+    }
+    fx.shutdown();
+    const auto image = fx.card().snapshot();
+
+    for (int cut = 0; cut <= FLUSHES; cut++) {
+        fx.card().restore(image);
+        fx.card().restore_power();
+        REQUIRE(fx.start());
+        REQUIRE(fx.sd().sync().is_ok());    // 启动时的元数据写入 (时钟配置等) 先落盘
+        fx.card().reset_stats();
+        fx.card().faults().power_cut_after_writes = cut;
+        {
+            RingLog log(fx.sd());
+            REQUIRE(log.open("/ring.bin", SLOTS, 16).is_ok());
+            for (int i = 0; i < FLUSHES * PER_FLUSH; i++) {
+                uint8_t record[16] = {};
+                memcpy(record, &i, sizeof(i));
+                REQUIRE(log.append(record).is_ok());
+                if ((i + 1) % PER_FLUSH == 0) REQUIRE(log.flush().is_ok());
+            }
+        }
+        // 每次 flush 恰好一次扇区写入，不写FAT和目录
+        CHECK_EQ(fx.card().stats().blocks_written, (uint32_t)cut);
+        fx.power_loss();
+
+        REQUIRE(fx.start());
+        RingLog log(fx.sd());
+        REQUIRE(log.open("/ring.bin", SLOTS, 16).is_ok());
+        std::vector<int> seen;
+        auto visited = log.read_all([&](const uint8_t* record, uint32_t seq) {
+            int value;
+            memcpy(&value, record, sizeof(value));
+            seen.push_back(value);
+            return true;
+        });
+        REQUIRE(visited.is_ok());
+
+        // 最后 min(cut, SLOTS) 次提交的记录完整保留
+        int kept = (cut < (int)SLOTS ? cut : (int)SLOTS) * PER_FLUSH;
+        int first = cut * PER_FLUSH - kept;
+        CHECK_EQ(seen.size(), (size_t)kept);
+        bool in_order = true;
+        for (size_t i = 0; i < seen.size(); i++) {
+            if (seen[i] != first + (int)i) in_order = false;
+        }
+        CHECK(in_order);
+        CHECK_EQ(log.next_seq(), (uint32_t)cut);
+        log.close();
+        fx.shutdown();
+    }
+}
+
+HOST_TEST_MAIN()
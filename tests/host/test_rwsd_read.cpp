@@ -0,0 +1,121 @@
+/**
+ * @file test_rwsd_read.cpp
+ * @brief RWSD 缓冲区读取接口：read_into / read_file_chunk_into / Result<T> 移动语义
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+
+#include <string.h>
+
+using MicroSD::ErrorCode;
+using MicroSD::Span;
+
+namespace {
+
+std::vector<uint8_t> make_pattern(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    uint32_t x = seed;
+    for (auto& b : data) {
+        x = x * 1103515245u + 12345u;
+        b = (uint8_t)(x >> 16);
+    }
+    return data;
+}
+
+} // namespace
+
+HOST_TEST(read_into_matches_written_data) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    auto data = make_pattern(20000, 1);
+    REQUIRE(fx.sd().write_file("/data.bin", data).is_ok());
+
+    // 不同大小的缓冲区 (含非扇区整数倍) 顺序读完整个文件
+    for (size_t chunk : {1u, 100u, 512u, 4096u, 7000u}) {
+        auto opened = fx.sd().open_file("/data.bin", "r");
+        REQUIRE(opened.is_ok());
+        auto file = opened.take();
+        std::vector<uint8_t> buffer(chunk);
+        std::vector<uint8_t> read_back;
+        while (true) {
+            auto n = file.read_into(Span<uint8_t>(buffer));
+            REQUIRE(n.is_ok());
+            if (*n == 0) break;
+            read_back.insert(read_back.end(), buffer.begin(), buffer.begin() + *n);
+        }
+        CHECK(read_back == data);
+    }
+}
+
+HOST_TEST(read_file_chunk_into_offsets_and_eof) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    auto data = make_pattern(5000, 2);
+    REQUIRE(fx.sd().write_file("/chunk.bin", data).is_ok());
+
+    uint8_t buffer[1024];
+    for (size_t offset : {0u, 1u, 511u, 512u, 4000u}) {
+        memset(buffer, 0xAA, sizeof(buffer));
+        auto n = fx.sd().read_file_chunk_into("/chunk.bin", offset, Span<uint8_t>(buffer));
+        REQUIRE(n.is_ok());
+        size_t expected = std::min(sizeof(buffer), data.size() - offset);
+        CHECK_EQ(*n, expected);
+        CHECK(memcmp(buffer, data.data() + offset, expected) == 0);
+    }
+
+    // 从文件尾开始：读到0字节而不是错误
+    auto at_end = fx.sd().read_file_chunk_into("/chunk.bin", data.size(), Span<uint8_t>(buffer));
+    REQUIRE(at_end.is_ok());
+    CHECK_EQ(*at_end, 0u);
+
+    auto missing = fx.sd().read_file_chunk_into("/missing.bin", 0, Span<uint8_t>(buffer));
+    CHECK(missing.error_code() == ErrorCode::FILE_NOT_FOUND);
+    CHECK(!missing.error_message().empty());
+
+    // vector 包装返回同样的错误码和FatFs错误说明
+    auto missing_chunk = fx.sd().read_file_chunk("/missing.bin", 0, 16);
+    CHECK(missing_chunk.error_code() == ErrorCode::FILE_NOT_FOUND);
+    CHECK(missing_chunk.error_message() == missing.error_message());
+}
+
+HOST_TEST(vector_wrappers_agree_with_buffer_api) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    auto data = make_pattern(3000, 3);
+    REQUIRE(fx.sd().write_file("/wrap.bin", data).is_ok());
+
+    auto chunk = fx.sd().read_file_chunk("/wrap.bin", 1000, 1500);
+    REQUIRE(chunk.is_ok());
+    std::vector<uint8_t> moved = chunk.take();
+    CHECK(moved.size() == 1500);
+    CHECK(std::equal(moved.begin(), moved.end(), data.begin() + 1000));
+
+    auto whole = fx.sd().read_file("/wrap.bin");
+    REQUIRE(whole.is_ok());
+    CHECK(*whole == data);
+}
+
+HOST_TEST(read_text_file_round_trip) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    std::string text;
+    for (int i = 0; i < 200; i++) {
+        text += "第" + std::to_string(i) + "行 line\n";
+    }
+    REQUIRE(fx.sd().write_text_file("/text.txt", text).is_ok());
+
+    auto read = fx.sd().read_text_file("/text.txt");
+    REQUIRE(read.is_ok());
+    CHECK(*read == text);
+
+    auto opened = fx.sd().open_file("/text.txt", "r");
+    REQUIRE(opened.is_ok());
+    std::string partial;
+    auto n = opened->read_text(partial, 100);
+    REQUIRE(n.is_ok());
+    CHECK_EQ(*n, 100u);
+    CHECK(partial == text.substr(0, 100));
+}
+
+HOST_TEST_MAIN()
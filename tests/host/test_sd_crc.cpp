@@ -0,0 +1,144 @@
+/**
+ * @file test_sd_crc.cpp
+ * @brief SD CRC7/CRC16 查表实现与按位参考实现一致；CRC模式下链路错误被检出并重试/降频
+ */
+
+#include "host_test.hpp"
+#include "sd_card_model.hpp"
+
+#include "sd_crc.h"
+#include "sector_cache.h"
+#include "tf_card.h"
+#include "tf_card_async.h"
+
+#include <random>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr uint CS_PIN = 9;
+
+bool init_card(uint clk_fast) {
+    pico_fatfs_spi_config_t config = {spi1, 400 * KHZ, clk_fast, 8, CS_PIN, 10, 11, true};
+    pico_fatfs_set_config(&config);
+    bool ok = (disk_initialize(0) & STA_NOINIT) == 0;
+    pico_fatfs_reset_link_stats();
+    return ok;
+}
+
+} // namespace
+
+HOST_TEST(crc7_matches_spec_commands_and_reference) {
+    // 规范中的固定命令: CMD0 -> 0x95, CMD8(0x1AA) -> 0x87, CMD17(0) -> 0x55
+    const uint8_t cmd0[5] = {0x40, 0, 0, 0, 0};
+    const uint8_t cmd8[5] = {0x48, 0, 0, 0x01, 0xAA};
+    const uint8_t cmd17[5] = {0x51, 0, 0, 0, 0};
+    CHECK_EQ((sd_crc7(cmd0, 5) << 1) | 1, 0x95);
+    CHECK_EQ((sd_crc7(cmd8, 5) << 1) | 1, 0x87);
+    CHECK_EQ((sd_crc7(cmd17, 5) << 1) | 1, 0x55);
+
+    std::mt19937 rng(7);
+    int mismatches = 0;
+    for (int i = 0; i < 2000; i++) {
+        uint8_t packet[5];
+        for (auto& b : packet) b = (uint8_t)rng();
+        if (sd_crc7(packet, 5) != host::SdCardModel::ref_crc7(packet, 5)) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+HOST_TEST(crc16_matches_spec_block_and_reference) {
+    // 规范示例: 512字节0xFF的CRC16为0x7FA1
+    std::vector<uint8_t> ones(512, 0xFF);
+    CHECK_EQ(sd_crc16(ones.data(), ones.size()), 0x7FA1);
+
+    std::mt19937 rng(11);
+    int mismatches = 0;
+    std::vector<uint8_t> block(512);
+    for (int i = 0; i < 200; i++) {
+        for (auto& b : block) b = (uint8_t)rng();
+        uint16_t expected = host::SdCardModel::ref_crc16(block.data(), block.size());
+        if (sd_crc16(block.data(), block.size()) != expected) mismatches++;
+
+        // 分段计算 (DMA分块接收) 与整块结果相同
+        size_t split = rng() % 513;
+        uint16_t crc = sd_crc16_update(0, block.data(), split);
+        crc = sd_crc16_update(crc, block.data() + split, block.size() - split);
+        if (crc != expected) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+HOST_TEST(crc_mode_is_negotiated_and_can_be_disabled) {
+    {
+        host::SdCardModel card(2u * 1024 * 1024, CS_PIN);
+        REQUIRE(init_card(25 * MHZ));
+        CHECK(pico_fatfs_is_crc_active());
+        CHECK(card.crc_mode());
+
+        // 达到缓存旁路大小，直接写卡
+        std::vector<BYTE> data(512 * PICO_FATFS_CACHE_BYPASS_SECTORS, 0x3C);
+        std::vector<BYTE> back(data.size());
+        CHECK(disk_write(0, data.data(), 40, PICO_FATFS_CACHE_BYPASS_SECTORS) == RES_OK);
+        CHECK(disk_read(0, back.data(), 40, PICO_FATFS_CACHE_BYPASS_SECTORS) == RES_OK);
+        CHECK_EQ(card.stats().blocks_written, (uint32_t)PICO_FATFS_CACHE_BYPASS_SECTORS);
+        CHECK(back == data);
+        // 主机发出的命令和数据CRC全部被卡接受
+        CHECK_EQ(card.stats().cmd_crc_errors, 0u);
+        CHECK_EQ(card.stats().data_crc_errors, 0u);
+    }
+
+    pico_fatfs_set_crc_enabled(false);
+    {
+        host::SdCardModel card(2u * 1024 * 1024, CS_PIN);
+        REQUIRE(init_card(25 * MHZ));
+        CHECK(!pico_fatfs_is_crc_active());
+        CHECK(!card.crc_mode());
+    }
+    pico_fatfs_set_crc_enabled(true);
+}
+
+HOST_TEST(link_errors_at_high_clock_are_detected_and_stepped_down) {
+    host::SdCardModel card(2u * 1024 * 1024, CS_PIN);
+    REQUIRE(init_card(25 * MHZ));
+    card.faults().max_clock_hz = 15 * 1000 * 1000;    // 25MHz下读写数据都会出错
+
+    std::vector<BYTE> data(512 * 2);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (BYTE)(i * 13);
+    std::vector<BYTE> back(512 * 2);
+
+    // 每个请求至多重试 PICO_FATFS_IO_RETRIES 次；降频后必然成功
+    DRESULT write = RES_ERROR;
+    for (int attempt = 0; attempt < 5 && write != RES_OK; attempt++) {
+        pico_fatfs_io_req_t req = {};
+        req.op = PICO_FATFS_IO_WRITE;
+        req.buff = data.data();
+        req.sector = 60;
+        req.count = 2;
+        REQUIRE(pico_fatfs_io_submit(&req));
+        write = pico_fatfs_io_wait(&req);
+    }
+    CHECK(write == RES_OK);
+
+    pico_fatfs_io_req_t read = {};
+    read.op = PICO_FATFS_IO_READ;
+    read.buff = back.data();
+    read.sector = 60;
+    read.count = 2;
+    REQUIRE(pico_fatfs_io_submit(&read));
+    CHECK(pico_fatfs_io_wait(&read) == RES_OK);
+    CHECK(back == data);
+
+    // CRC错误的块被卡拒收后重发，落盘的是正确数据
+    CHECK(memcmp(card.read_sector(60).data(), data.data(), 512) == 0);
+    CHECK(card.stats().data_crc_errors > 0);
+
+    pico_fatfs_link_stats_t stats;
+    pico_fatfs_get_link_stats(&stats);
+    CHECK(stats.crc_errors > 0);
+    CHECK(stats.clk_steps > 0);
+    CHECK(pico_fatfs_get_clk_fast_freq() <= 15u * 1000 * 1000);
+}
+
+HOST_TEST_MAIN()
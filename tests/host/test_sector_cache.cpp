@@ -0,0 +1,139 @@
+/**
+ * @file test_sector_cache.cpp
+ * @brief 写回扇区缓存：关闭文件不强制写回、后台定时写回、显式同步、合并写入与错误分离
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "tf_card.h"
+
+#include <string.h>
+#include <string>
+
+namespace {
+
+std::vector<uint8_t> line(int i) {
+    std::string text = "record " + std::to_string(i) + "\n";
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+pico_fatfs_cache_stats_t cache_stats() {
+    pico_fatfs_cache_stats_t stats;
+    pico_fatfs_cache_get_stats(&stats);
+    return stats;
+}
+
+} // namespace
+
+HOST_TEST(append_and_close_does_not_write_back_each_time) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(fx.sd().write_text_file("/log.txt", "").is_ok());
+    REQUIRE(fx.sd().sync().is_ok());
+
+    pico_fatfs_cache_reset_stats();
+    fx.card().reset_stats();
+    for (int i = 0; i < 20; i++) {
+        REQUIRE(fx.sd().append_file("/log.txt", line(i)).is_ok());
+    }
+    // 每行 f_open/f_write/f_close 只更新缓存中的扇区
+    CHECK_EQ(cache_stats().flushes, 0u);
+    CHECK_EQ(fx.card().stats().blocks_written, 0u);
+
+    // 到期前后台轮询不写回，到期后写回一次
+    fx.sd().poll_background();
+    CHECK_EQ(cache_stats().flushes, 0u);
+    host_advance_us((PICO_FATFS_CACHE_FLUSH_MS + 10) * 1000);
+    fx.sd().poll_background();
+    CHECK_EQ(cache_stats().flushes, 1u);
+    CHECK(fx.card().stats().blocks_written > 0);
+
+    // 定时写回后掉电，内容完整
+    fx.power_loss();
+    REQUIRE(fx.start());
+    auto text = fx.sd().read_text_file("/log.txt");
+    REQUIRE(text.is_ok());
+    std::string expected;
+    for (int i = 0; i < 20; i++) expected += "record " + std::to_string(i) + "\n";
+    CHECK(*text == expected);
+}
+
+HOST_TEST(explicit_sync_and_flush_write_back_immediately) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+
+    pico_fatfs_cache_reset_stats();
+    REQUIRE(fx.sd().append_file("/a.txt", line(1)).is_ok());
+    CHECK_EQ(cache_stats().flushes, 0u);
+    REQUIRE(fx.sd().sync().is_ok());
+    CHECK_EQ(cache_stats().flushes, 1u);
+
+    auto file = fx.sd().open_file("/a.txt", "a");
+    REQUIRE(file.is_ok());
+    REQUIRE(file->write(line(2)).is_ok());
+    REQUIRE(file->flush().is_ok());
+    CHECK_EQ(cache_stats().flushes, 2u);
+    file->close();
+
+    fx.power_loss();
+    REQUIRE(fx.start());
+    auto text = fx.sd().read_text_file("/a.txt");
+    REQUIRE(text.is_ok());
+    CHECK(*text == "record 1\nrecord 2\n");
+}
+
+HOST_TEST(adjacent_dirty_sectors_merge_into_one_card_write) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(fx.sd().sync().is_ok());
+
+    // 数据区末尾的空闲扇区，直接经 disk_write 写入缓存
+    const LBA_t base = fx.card().sector_count() - 64;
+    BYTE sector[512];
+    pico_fatfs_cache_reset_stats();
+    fx.card().reset_stats();
+    for (LBA_t lba : {base + 2, base, base + 1, base + 10}) {
+        memset(sector, (int)(lba & 0xFF), sizeof(sector));
+        REQUIRE(disk_write(0, sector, lba, 1) == RES_OK);
+    }
+    CHECK_EQ(fx.card().stats().blocks_written, 0u);
+    REQUIRE(pico_fatfs_cache_flush() == RES_OK);
+
+    auto stats = cache_stats();
+    CHECK_EQ(stats.card_writes, 2u);       // [base..base+2] 和 [base+10]
+    CHECK_EQ(stats.coalesced_writes, 1u);
+    CHECK_EQ(fx.card().stats().multi_writes, 1u);
+    const auto& order = fx.card().stats().written_lbas;
+    REQUIRE(order.size() == 4);
+    CHECK_EQ(order[0], base);
+    CHECK_EQ(order[1], base + 1);
+    CHECK_EQ(order[2], base + 2);
+    CHECK_EQ(order[3], base + 10);
+    CHECK_EQ(fx.card().read_sector(base + 1)[0], (uint8_t)((base + 1) & 0xFF));
+}
+
+HOST_TEST(write_back_errors_are_not_read_errors) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    REQUIRE(fx.sd().sync().is_ok());
+
+    const LBA_t base = fx.card().sector_count() - 64;
+    BYTE sector[512];
+    memset(sector, 0x5A, sizeof(sector));
+    REQUIRE(disk_write(0, sector, base, 1) == RES_OK);
+
+    // 到期的写回失败：读取仍然成功，错误由 poll 报告，脏扇区保留待重试
+    fx.card().faults().reject_writes = 1000;
+    host_advance_us((PICO_FATFS_CACHE_FLUSH_MS + 10) * 1000);
+    BYTE back[512];
+    CHECK(disk_read(0, back, base + 20, 1) == RES_OK);
+    CHECK(disk_read(0, back, base, 1) == RES_OK);
+    CHECK_EQ(back[0], 0x5A);
+    CHECK(pico_fatfs_cache_poll() == RES_ERROR);
+
+    fx.card().faults().reject_writes = 0;
+    CHECK(pico_fatfs_cache_poll() == RES_OK);
+    CHECK_EQ(fx.card().read_sector(base)[0], 0x5A);
+}
+
+HOST_TEST_MAIN()
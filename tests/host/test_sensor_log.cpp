@@ -0,0 +1,222 @@
+/**
+ * @file test_sensor_log.cpp
+ * @brief 传感器日志：块编解码、按时间范围查询的代价、flush后掉电恢复与预分配区旧数据
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "hardware/storage/microsd/sensor_log.hpp"
+
+#include <string.h>
+#include <vector>
+
+using namespace MicroSD::sensor_log;
+
+namespace {
+
+Schema make_schema(uint32_t file_id, uint8_t index_interval) {
+    Schema schema;
+    schema.add_channel("temp", 100);
+    schema.add_channel("hum", 100);
+    schema.add_channel("press", 10);
+    schema.file_id = file_id;
+    schema.created_ms = 1;
+    schema.index_interval = index_interval;
+    return schema;
+}
+
+// 周期500ms，中间有一次时间跳变和一次超出int16的值跳变 (强制提前封块)
+Sample make_sample(int i) {
+    Sample sample;
+    sample.time_ms = 1000 + i * 500ull + (i >= 700 ? 100000 : 0);
+    sample.values[0] = 2000 + (i % 50) - (i == 300 ? 40000 : 0);
+    sample.values[1] = i;
+    sample.values[2] = 10000 - i;
+    return sample;
+}
+
+bool same_sample(const Sample& a, const Sample& b, size_t channels) {
+    if (a.time_ms != b.time_ms) return false;
+    for (size_t c = 0; c < channels; c++) {
+        if (a.values[c] != b.values[c]) return false;
+    }
+    return true;
+}
+
+bool write_log(MicroSD::RWSD& sd, const char* path, const Schema& schema, int samples) {
+    SensorLogWriter writer(sd);
+    if (!writer.open(path, schema, 256 * 1024).is_ok()) return false;
+    for (int i = 0; i < samples; i++) {
+        if (!writer.append(make_sample(i)).is_ok()) return false;
+    }
+    return writer.close().is_ok();
+}
+
+// 在取快照的时刻掉电：之后写入的数据 (含扇区缓存中的脏扇区) 都丢失
+void power_loss_at(host::CardFixture& fx, const std::unordered_map<uint32_t, host::SdCardModel::Sector>& image) {
+    fx.shutdown();
+    fx.card().restore(image);
+    fx.card().restore_power();
+}
+
+} // namespace
+
+HOST_TEST(blocks_round_trip_and_detect_corruption) {
+    const char* text = "123456789";
+    CHECK_EQ(crc32((const uint8_t*)text, 9), 0xCBF43926u);
+
+    Schema schema = make_schema(1234, 4);
+    uint8_t header[BLOCK_SIZE];
+    encode_header(schema, header);
+    Schema decoded;
+    REQUIRE(decode_header(header, decoded));
+    CHECK_EQ(decoded.channel_count, 3);
+    CHECK(strcmp(decoded.channels[2].name, "press") == 0);
+    CHECK_EQ(decoded.samples_per_block(), schema.samples_per_block());
+
+    std::vector<std::vector<uint8_t>> blocks(1, std::vector<uint8_t>(header, header + BLOCK_SIZE));
+    DataBlockEncoder encoder;
+    IndexBuilder index;
+    uint32_t block = 1;
+    encoder.begin(schema, block);
+    for (int i = 0; i < 2000; i++) {
+        if (encoder.append(make_sample(i))) continue;
+        const uint8_t* sealed = encoder.seal();
+        blocks.emplace_back(sealed, sealed + BLOCK_SIZE);
+        index.add(block, encoder.first_time());
+        block++;
+        if (is_index_block(block, schema.index_interval)) {
+            uint8_t index_block[BLOCK_SIZE];
+            index.encode(schema, block, index_block);
+            blocks.emplace_back(index_block, index_block + BLOCK_SIZE);
+            index.reset();
+            block++;
+        }
+        encoder.begin(schema, block);
+        REQUIRE(encoder.append(make_sample(i)));
+    }
+    const uint8_t* last = encoder.seal();
+    blocks.emplace_back(last, last + BLOCK_SIZE);
+
+    int next = 0;
+    int index_blocks = 0;
+    for (uint32_t b = 1; b < blocks.size(); b++) {
+        if (is_index_block(b, schema.index_interval)) {
+            IndexEntry entries[MAX_INDEX_INTERVAL];
+            CHECK_EQ(decode_index(blocks[b].data(), decoded, b, entries), (size_t)schema.index_interval);
+            index_blocks++;
+            continue;
+        }
+        DataBlockDecoder decoder;
+        REQUIRE(decoder.open(blocks[b].data(), decoded, b));
+        Sample sample;
+        while (decoder.next(sample)) {
+            REQUIRE(next < 2000);
+            CHECK(same_sample(sample, make_sample(next), 3));
+            next++;
+        }
+    }
+    CHECK_EQ(next, 2000);
+    CHECK(index_blocks > 0);
+
+    // 位翻转、错误块号、错误文件ID都被拒绝
+    DataBlockDecoder decoder;
+    blocks[3][100] ^= 1;
+    CHECK(!decoder.open(blocks[3].data(), decoded, 3));
+    CHECK(!decoder.open(blocks[2].data(), decoded, 3));
+    Schema other = decoded;
+    other.file_id = 99;
+    CHECK(!decoder.open(blocks[2].data(), other, 2));
+}
+
+HOST_TEST(time_range_query_reads_few_blocks) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    Schema schema = make_schema(0x51, 8);
+    REQUIRE(write_log(fx.sd(), "/s.log", schema, 5000));
+
+    SensorLogReader reader(fx.sd());
+    REQUIRE(reader.open("/s.log").is_ok());
+    uint32_t total_blocks = reader.end_block();
+
+    // 取末段中间的2分钟
+    uint64_t from = make_sample(4000).time_ms;
+    uint64_t to = make_sample(4240).time_ms;
+    int expected = 4000;
+    size_t visited_ok = 0;
+    auto visited = reader.query(from, to, [&](const Sample& sample) {
+        if (same_sample(sample, make_sample(expected), 3)) visited_ok++;
+        expected++;
+        return true;
+    });
+    REQUIRE(visited.is_ok());
+    CHECK_EQ(*visited, 241u);
+    CHECK_EQ(visited_ok, 241u);
+    printf("  查询 %zu 个样本读取 %u 块 (文件共 %u 块)\n", *visited, reader.blocks_read(), total_blocks);
+    CHECK(reader.blocks_read() < total_blocks / 4);
+
+    // visitor 返回false提前结束
+    size_t count = 0;
+    auto early = reader.query(0, UINT64_MAX, [&](const Sample&) { return ++count < 10; });
+    REQUIRE(early.is_ok());
+    CHECK_EQ(*early, 10u);
+}
+
+HOST_TEST(flushed_samples_survive_power_loss) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    Schema schema = make_schema(0x77, 4);
+    std::unordered_map<uint32_t, host::SdCardModel::Sector> image;
+    {
+        SensorLogWriter writer(fx.sd());
+        REQUIRE(writer.open("/p.log", schema, 256 * 1024).is_ok());
+        for (int i = 0; i < 1234; i++) REQUIRE(writer.append(make_sample(i)).is_ok());
+        REQUIRE(writer.flush().is_ok());
+        // flush 之后的样本只在RAM里
+        for (int i = 1234; i < 1300; i++) REQUIRE(writer.append(make_sample(i)).is_ok());
+        image = fx.card().snapshot();
+    }
+    power_loss_at(fx, image);
+
+    REQUIRE(fx.start());
+    SensorLogReader reader(fx.sd());
+    REQUIRE(reader.open("/p.log").is_ok());
+    int expected = 0;
+    bool ok = true;
+    auto visited = reader.query(0, UINT64_MAX, [&](const Sample& sample) {
+        if (!same_sample(sample, make_sample(expected), 3)) ok = false;
+        expected++;
+        return true;
+    });
+    REQUIRE(visited.is_ok());
+    CHECK_EQ(*visited, 1234u);
+    CHECK(ok);
+}
+
+HOST_TEST(stale_blocks_in_preallocated_space_are_ignored) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    // 旧日志写满大部分预分配空间后删除，新日志复用同样的簇
+    REQUIRE(write_log(fx.sd(), "/old.log", make_schema(0x1111, 4), 6000));
+    REQUIRE(fx.sd().delete_file("/old.log").is_ok());
+
+    Schema schema = make_schema(0x2222, 4);
+    std::unordered_map<uint32_t, host::SdCardModel::Sector> image;
+    {
+        SensorLogWriter writer(fx.sd());
+        REQUIRE(writer.open("/new.log", schema, 256 * 1024).is_ok());
+        for (int i = 0; i < 500; i++) REQUIRE(writer.append(make_sample(i)).is_ok());
+        REQUIRE(writer.flush().is_ok());
+        image = fx.card().snapshot();   // 未截断，文件大小仍是预分配大小
+    }
+    power_loss_at(fx, image);
+
+    REQUIRE(fx.start());
+    SensorLogReader reader(fx.sd());
+    REQUIRE(reader.open("/new.log").is_ok());
+    auto visited = reader.query(0, UINT64_MAX, [](const Sample&) { return true; });
+    REQUIRE(visited.is_ok());
+    CHECK_EQ(*visited, 500u);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,166 @@
+/**
+ * @file test_st7306_flush.cpp
+ * @brief ST7306 局部推送：单个字形和一行数值的更新只发送对齐到列地址的改动窗口，
+ *        flushRegion 只推送区域内的改动 (含旋转)，没有改动时不发送也不记一帧
+ */
+
+#include "host_test.hpp"
+#include "st7306_model.hpp"
+#include "hardware/display/st7306_driver.hpp"
+#include "hardware/input/input_latency.hpp"
+
+#include <vector>
+
+using st7306::ST7306Driver;
+using hardware::input::InputLatency;
+
+namespace {
+
+constexpr uint DC_PIN = 20, RES_PIN = 15, CS_PIN = 17, SCLK_PIN = 18, SDIN_PIN = 19;
+constexpr size_t SETUP_BYTES = 4;       // 列地址和行地址各两个参数
+
+const uint8_t GLYPH[16] = {0x00, 0x18, 0x3C, 0x66, 0x66, 0x66, 0x7E, 0x66,
+                           0x66, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+// 整屏推送一次并清空记录，之后的写入都是局部更新
+void settle(ST7306Driver& lcd, host::St7306Model& panel, int rotation = 0) {
+    lcd.setRotation(rotation);
+    lcd.fill(0x00);
+    lcd.display();
+    panel.reset_writes();
+}
+
+// 同样的绘制整屏推送到另一块面板，作为面板RAM的期望值
+template<typename Draw>
+std::vector<uint8_t> full_render(int rotation, Draw draw) {
+    host::St7306Model panel(DC_PIN);
+    ST7306Driver lcd(DC_PIN, RES_PIN, CS_PIN, SCLK_PIN, SDIN_PIN);
+    lcd.setRotation(rotation);
+    lcd.fill(0x00);
+    draw(lcd);
+    lcd.invalidate();
+    lcd.display();
+    return panel.image();
+}
+
+} // namespace
+
+HOST_TEST(single_glyph_sends_its_column_address_window) {
+    // 不透明绘制：0位也写背景色，整个 8x16 都算改动
+    auto draw = [](ST7306Driver& lcd) {
+        lcd.blitMono(100, 50, 8, 16, GLYPH, 1, ST7306Driver::COLOR_BLACK, ST7306Driver::COLOR_WHITE);
+    };
+    const auto expected = full_render(0, draw);
+
+    host::St7306Model panel(DC_PIN);
+    ST7306Driver lcd(DC_PIN, RES_PIN, CS_PIN, SCLK_PIN, SDIN_PIN);
+    settle(lcd, panel);
+    size_t before = panel.data_bytes();
+    draw(lcd);
+    lcd.display();
+
+    // 像素列 100..107 = 字节 50..53 = 列地址 16..17；像素行 50..65 = RAM行 25..32
+    REQUIRE(panel.writes().size() == 1u);
+    const auto& w = panel.writes()[0];
+    CHECK_EQ(w.col0, 16);
+    CHECK_EQ(w.col1, 17);
+    CHECK_EQ(w.row0, 25);
+    CHECK_EQ(w.row1, 32);
+    CHECK_EQ(w.bytes, 2u * 3 * 8);
+    CHECK_EQ(panel.data_bytes() - before, SETUP_BYTES + 48);
+    CHECK(panel.image() == expected);
+
+    // 奇数起点的 120x20 数值区：列地址 15..35 (63字节/行) x RAM行 50..60
+    panel.reset_writes();
+    lcd.fillRect(91, 101, 120, 20, ST7306Driver::COLOR_GRAY1);
+    lcd.display();
+    REQUIRE(panel.writes().size() == 1u);
+    CHECK_EQ(panel.writes()[0].col0, 15);
+    CHECK_EQ(panel.writes()[0].col1, 35);
+    CHECK_EQ(panel.writes()[0].row0, 50);
+    CHECK_EQ(panel.writes()[0].row1, 60);
+    CHECK_EQ(panel.writes()[0].bytes, 693u);
+}
+
+HOST_TEST(display_without_changes_sends_nothing_and_presents_no_frame) {
+    host::St7306Model panel(DC_PIN);
+    ST7306Driver lcd(DC_PIN, RES_PIN, CS_PIN, SCLK_PIN, SDIN_PIN);
+    settle(lcd, panel);
+
+    InputLatency::reset();
+    InputLatency::set_enabled(true);
+    InputLatency::input_dispatched(to_ms_since_boot(get_absolute_time()));
+    size_t before = panel.data_bytes();
+    lcd.display();
+    lcd.flushRegion(0, 0, ST7306Driver::LCD_WIDTH, ST7306Driver::LCD_HEIGHT);
+    CHECK_EQ(panel.data_bytes(), before);
+    CHECK(panel.writes().empty());
+    CHECK_EQ(InputLatency::histogram().count(), 0u);
+
+    // 有改动的推送才结束这次采样
+    lcd.drawPixelGray(3, 3, ST7306Driver::COLOR_BLACK);
+    lcd.display();
+    CHECK_EQ(InputLatency::histogram().count(), 1u);
+    InputLatency::set_enabled(false);
+}
+
+HOST_TEST(flush_region_pushes_only_changes_inside_the_region) {
+    auto draw = [](ST7306Driver& lcd) {
+        lcd.blitMono(10, 20, 8, 16, GLYPH, 1, ST7306Driver::COLOR_BLACK);
+        lcd.blitMono(200, 300, 8, 16, GLYPH, 1, ST7306Driver::COLOR_GRAY2);
+    };
+    const auto expected = full_render(0, draw);
+
+    host::St7306Model panel(DC_PIN);
+    ST7306Driver lcd(DC_PIN, RES_PIN, CS_PIN, SCLK_PIN, SDIN_PIN);
+    settle(lcd, panel);
+    draw(lcd);
+
+    // 改动矩形是两个字形的外接矩形：字节 5..103 (列地址 1..34) x RAM行 10..157。
+    // 只推送上面的行带：像素行 16..39 = RAM行 8..19，交集为行 10..19
+    lcd.flushRegion(0, 16, ST7306Driver::LCD_WIDTH, 24);
+    REQUIRE(panel.writes().size() == 1u);
+    CHECK_EQ(panel.writes()[0].col0, 1);
+    CHECK_EQ(panel.writes()[0].col1, 34);
+    CHECK_EQ(panel.writes()[0].row0, 10);
+    CHECK_EQ(panel.writes()[0].row1, 19);
+    CHECK(panel.image() != expected);
+
+    // 区域外的改动仍待推送
+    panel.reset_writes();
+    lcd.display();
+    REQUIRE(panel.writes().size() == 1u);
+    CHECK(panel.image() == expected);
+
+    // 覆盖全部改动的区域推送后清除改动矩形
+    panel.reset_writes();
+    lcd.fillRect(50, 60, 10, 10, ST7306Driver::COLOR_GRAY1);
+    lcd.flushRegion(40, 50, 30, 30);
+    lcd.display();
+    CHECK_EQ(panel.writes().size(), 1u);
+}
+
+HOST_TEST(flush_region_maps_rotated_regions) {
+    for (int rotation = 1; rotation < 4; rotation++) {
+        auto draw = [](ST7306Driver& lcd) { lcd.blitMono(200, 100, 8, 16, GLYPH, 1, ST7306Driver::COLOR_BLACK); };
+        const auto expected = full_render(rotation, draw);
+
+        host::St7306Model panel(DC_PIN);
+        ST7306Driver lcd(DC_PIN, RES_PIN, CS_PIN, SCLK_PIN, SDIN_PIN);
+        settle(lcd, panel, rotation);
+        draw(lcd);
+
+        // 与字形不相交的区域不发送
+        lcd.flushRegion(0, 0, 100, 50);
+        CHECK(panel.writes().empty());
+
+        // 恰好是字形的逻辑矩形：一次推送完，之后没有剩余改动
+        lcd.flushRegion(200, 100, 8, 16);
+        CHECK_EQ(panel.writes().size(), 1u);
+        CHECK(panel.image() == expected);
+        lcd.display();
+        CHECK_EQ(panel.writes().size(), 1u);
+    }
+}
+
+HOST_TEST_MAIN()
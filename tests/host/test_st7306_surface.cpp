@@ -0,0 +1,157 @@
+/**
+ * @file test_st7306_surface.cpp
+ * @brief ST7306 显示表面接口：fillRect 与 blitMono 的按字节快速路径同逐像素写入的结果一致
+ *        (奇数起点、长度1/2、4级灰度)，90°/270°旋转时按旋转后的宽高裁剪
+ */
+
+#include "host_test.hpp"
+#include "st7306_model.hpp"
+#include "hardware/display/st7306_driver.hpp"
+
+#include <vector>
+
+using st7306::ST7306Driver;
+
+namespace {
+
+constexpr uint DC_PIN = 20, RES_PIN = 15, CS_PIN = 17, SCLK_PIN = 18, SDIN_PIN = 19;
+
+// 在混合灰度的背景上绘制后整屏推送，返回面板RAM
+template<typename Draw>
+std::vector<uint8_t> render(int rotation, Draw draw) {
+    host::St7306Model panel(DC_PIN);
+    ST7306Driver lcd(DC_PIN, RES_PIN, CS_PIN, SCLK_PIN, SDIN_PIN);
+    lcd.setRotation(rotation);
+    lcd.fill(0x96);
+    draw(lcd);
+    lcd.invalidate();
+    lcd.display();
+    return panel.image();
+}
+
+// 逐像素的参考实现：drawPixelGray 按旋转换算并丢弃屏外像素
+void reference_rect(ST7306Driver& lcd, int x, int y, int w, int h, uint8_t color) {
+    for (int row = y; row < y + h; row++) {
+        for (int col = x; col < x + w; col++) {
+            lcd.drawPixelGray(col, row, color);
+        }
+    }
+}
+
+void reference_blit(ST7306Driver& lcd, int x, int y, int w, int h, const uint8_t* bits, int stride,
+                    uint8_t fg, int bg) {
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            bool on = bits[row * stride + (col >> 3)] & (0x80 >> (col & 7));
+            if (on || bg >= 0) lcd.drawPixelGray(x + col, y + row, on ? fg : (uint8_t)bg);
+        }
+    }
+}
+
+struct Rect {
+    uint16_t x, y, w, h;
+};
+
+// 奇偶起点、长度1和2、跨字节的长度、贴右/下边缘被裁剪
+const Rect RECTS[] = {
+    {7, 9, 1, 1}, {7, 9, 2, 1}, {8, 10, 1, 1}, {8, 10, 2, 1}, {7, 10, 2, 3},
+    {8, 9, 1, 4}, {3, 5, 37, 11}, {0, 0, 6, 2}, {297, 397, 8, 8}, {290, 0, 10, 400},
+};
+
+} // namespace
+
+HOST_TEST(fill_rect_matches_per_pixel_writes) {
+    int mismatches = 0;
+    for (uint8_t color = 0; color < 4; color++) {
+        for (const Rect& r : RECTS) {
+            auto fast = render(0, [&](ST7306Driver& lcd) { lcd.fillRect(r.x, r.y, r.w, r.h, color); });
+            auto slow = render(0, [&](ST7306Driver& lcd) { reference_rect(lcd, r.x, r.y, r.w, r.h, color); });
+            if (fast != slow && mismatches++ < 5) {
+                printf("  fillRect(%u,%u,%u,%u) 灰度%u 与逐像素结果不同\n", r.x, r.y, r.w, r.h, color);
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // fillSpan 是高度1的 fillRect
+    auto span = render(0, [](ST7306Driver& lcd) { lcd.fillSpan(5, 7, 3, ST7306Driver::COLOR_GRAY2); });
+    auto ref = render(0, [](ST7306Driver& lcd) { reference_rect(lcd, 5, 7, 3, 1, ST7306Driver::COLOR_GRAY2); });
+    CHECK(span == ref);
+}
+
+HOST_TEST(blit_mono_row_path_matches_per_pixel_writes) {
+    // 37x11 的伪随机位图，行跨度6字节
+    constexpr int W = 37, H = 11, STRIDE = 6;
+    uint8_t bits[H * STRIDE];
+    uint32_t seed = 99;
+    for (auto& b : bits) {
+        seed = seed * 1103515245u + 12345u;
+        b = (uint8_t)(seed >> 16);
+    }
+
+    int mismatches = 0;
+    const Rect origins[] = {{0, 0, W, H}, {1, 1, W, H}, {6, 3, W, H}, {7, 8, W, H},
+                            {280, 395, W, H}, {3, 4, 1, 1}, {5, 6, 2, 2}};
+    for (const Rect& o : origins) {
+        for (uint8_t fg = 0; fg < 4; fg++) {
+            for (int bg = -1; bg < 4; bg++) {
+                auto fast = render(0, [&](ST7306Driver& lcd) {
+                    if (bg < 0) lcd.blitMono(o.x, o.y, o.w, o.h, bits, STRIDE, fg);
+                    else lcd.blitMono(o.x, o.y, o.w, o.h, bits, STRIDE, fg, (uint8_t)bg);
+                });
+                auto slow = render(0, [&](ST7306Driver& lcd) {
+                    reference_blit(lcd, o.x, o.y, o.w, o.h, bits, STRIDE, fg, bg);
+                });
+                if (fast != slow && mismatches++ < 5) {
+                    printf("  blitMono at (%u,%u) %ux%u fg=%u bg=%d 与逐像素结果不同\n",
+                           o.x, o.y, o.w, o.h, fg, bg);
+                }
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+HOST_TEST(rotated_surfaces_clip_to_rotated_size) {
+    const auto blank = render(0, [](ST7306Driver&) {});
+    uint8_t glyph[16];
+    for (int i = 0; i < 16; i++) glyph[i] = (uint8_t)(0xA5 ^ (i * 17));
+    uint8_t window[20 * 6];
+    for (int i = 0; i < 20 * 6; i++) window[i] = (uint8_t)(i % 4);
+
+    for (int rotation : {1, 3}) {
+        // 横屏为 400x300：x >= 300 的内容要画出来，y 在 300 处裁掉
+        auto fast = render(rotation, [](ST7306Driver& lcd) { lcd.fillRect(350, 10, 40, 20, 3); });
+        auto slow = render(rotation, [](ST7306Driver& lcd) { reference_rect(lcd, 350, 10, 40, 20, 3); });
+        CHECK(fast == slow);
+        CHECK(fast != blank);
+
+        fast = render(rotation, [](ST7306Driver& lcd) { lcd.fillRect(390, 290, 30, 30, 2); });
+        slow = render(rotation, [](ST7306Driver& lcd) { reference_rect(lcd, 390, 290, 10, 10, 2); });
+        CHECK(fast == slow);
+
+        fast = render(rotation, [&](ST7306Driver& lcd) { lcd.blitMono(320, 100, 8, 16, glyph, 1, 3, 0); });
+        slow = render(rotation, [&](ST7306Driver& lcd) { reference_blit(lcd, 320, 100, 8, 16, glyph, 1, 3, 0); });
+        CHECK(fast == slow);
+        CHECK(fast != blank);
+
+        fast = render(rotation, [&](ST7306Driver& lcd) { lcd.blitMono(396, 296, 8, 16, glyph, 1, 3); });
+        slow = render(rotation, [&](ST7306Driver& lcd) { reference_blit(lcd, 396, 296, 4, 4, glyph, 1, 3, -1); });
+        CHECK(fast == slow);
+
+        fast = render(rotation, [&](ST7306Driver& lcd) { lcd.writeWindow(385, 295, 20, 6, window); });
+        slow = render(rotation, [&](ST7306Driver& lcd) {
+            for (int row = 0; row < 5; row++) {
+                for (int col = 0; col < 15; col++) lcd.drawPixelGray(385 + col, 295 + row, window[row * 20 + col]);
+            }
+        });
+        CHECK(fast == slow);
+        CHECK(fast != blank);
+
+        // 整个落在屏外时不画
+        fast = render(rotation, [](ST7306Driver& lcd) { lcd.fillRect(10, 300, 10, 10, 3); });
+        CHECK(fast == blank);
+    }
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,210 @@
+/**
+ * @file test_startup.cpp
+ * @brief 协作任务与启动编排：任务唤醒定时器与截止时间定时器共用槽位时不会互相取消、
+ *        超时步骤被取消而其他步骤继续、ST7306 初始化序列作为任务与其他步骤重叠
+ */
+
+#include "host_test.hpp"
+#include "loop_fixture.hpp"
+#include "StartupOrchestrator.hpp"
+#include "hardware/display/st7306_driver.hpp"
+
+#include <vector>
+
+using event_loop::EventLoop;
+using event_loop::StartupOrchestrator;
+using event_loop::TaskScheduler;
+
+namespace {
+
+// 等待 delay_ms 后完成
+class DelayTask : public event_loop::Task {
+public:
+    explicit DelayTask(uint32_t delay_ms) : delay_ms_(delay_ms) {}
+protected:
+    void run() override {
+        TASK_BEGIN();
+        TASK_DELAY_MS(delay_ms_);
+        TASK_END();
+    }
+private:
+    uint32_t delay_ms_;
+};
+
+// 每次恢复运行计数，用于确认超时后任务不再被调度
+class CountingTask : public event_loop::Task {
+public:
+    CountingTask(uint32_t period_ms, int periods) : period_ms_(period_ms), periods_(periods) {}
+    int resumes() const { return resumes_; }
+protected:
+    void run() override {
+        resumes_++;
+        TASK_BEGIN();
+        for (i_ = 0; i_ < periods_; i_++) {
+            TASK_DELAY_MS(period_ms_);
+        }
+        TASK_END();
+    }
+private:
+    uint32_t period_ms_;
+    int periods_;
+    int i_ = 0;
+    int resumes_ = 0;
+};
+
+// 面板模型：记录命令字节 (DC=0) 及其时间
+struct CommandLog {
+    bool dc = true;
+    std::vector<std::pair<uint8_t, uint64_t>> commands;
+};
+
+uint8_t log_spi_byte(void* ctx, uint8_t mosi) {
+    auto* log = static_cast<CommandLog*>(ctx);
+    if (!log->dc) log->commands.emplace_back(mosi, time_us_64());
+    return 0xFF;
+}
+
+void log_gpio(void* ctx, uint gpio, bool level) {
+    if (gpio == 20) static_cast<CommandLog*>(ctx)->dc = level;
+}
+
+uint32_t elapsed_ms(uint64_t t0) {
+    return static_cast<uint32_t>((time_us_64() - t0) / 1000);
+}
+
+} // namespace
+
+HOST_TEST(deadline_timer_survives_task_wakeup_timer_slot_reuse) {
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    TaskScheduler scheduler(loop);
+    StartupOrchestrator boot(loop, scheduler);
+    const uint64_t t0 = time_us_64();
+
+    // 复现：a 的唤醒定时器触发后 a 完成，hang 启动并登记截止时间定时器（复用刚释放的槽位），
+    // 调度器随后用旧ID取消自己的定时器，曾经把 hang 的截止时间一起取消，hang 跑满10秒
+    DelayTask slow(1000);
+    DelayTask a(200);
+    DelayTask hang(10000);
+    int slow_id = boot.add_step("slow", slow, 100, 0, false);
+    int a_id = boot.add_step("a", a, 1000);
+    int hang_id = boot.add_step("hang", hang, 50, StartupOrchestrator::dep(a_id));
+
+    bool completed = false;
+    bool ok = true;
+    uint32_t complete_ms = 0;
+    boot.start([&](bool result) {
+        completed = true;
+        ok = result;
+        complete_ms = elapsed_ms(t0);
+    });
+    platform.run_until(loop, t0 + 11000 * 1000ull);
+
+    REQUIRE(completed);
+    CHECK(!ok);
+    CHECK(boot.status(slow_id) == StartupOrchestrator::StepStatus::TIMED_OUT);
+    CHECK(boot.status(a_id) == StartupOrchestrator::StepStatus::DONE);
+    CHECK(boot.status(hang_id) == StartupOrchestrator::StepStatus::TIMED_OUT);
+    CHECK(complete_ms >= 250 && complete_ms <= 252);
+    CHECK(boot.first_failure() != nullptr);
+    CHECK_EQ(scheduler.active(), 0);
+}
+
+HOST_TEST(timed_out_step_is_cancelled_while_others_keep_running) {
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    TaskScheduler scheduler(loop);
+    StartupOrchestrator boot(loop, scheduler);
+    const uint64_t t0 = time_us_64();
+
+    // sensor（可选）超过截止时间；lcd → ui 与它并行，不受影响；
+    // probe（必需）超时后其后继 log 被跳过，启动失败但其余步骤照常完成
+    CountingTask sensor(50, 10);        // 需要500ms，截止100ms
+    CountingTask lcd(100, 3);           // 300ms
+    CountingTask ui(50, 2);             // 100ms
+    CountingTask probe(100, 5);         // 需要500ms，截止200ms
+    CountingTask log(10, 1);
+    int sensor_id = boot.add_step("sensor", sensor, 100, 0, false);
+    int lcd_id = boot.add_step("lcd", lcd, 1000);
+    int ui_id = boot.add_step("ui", ui, 1000, StartupOrchestrator::dep(lcd_id) | StartupOrchestrator::dep(sensor_id));
+    int probe_id = boot.add_step("probe", probe, 200);
+    int log_id = boot.add_step("log", log, 100, StartupOrchestrator::dep(probe_id));
+
+    bool completed = false;
+    bool ok = true;
+    uint32_t complete_ms = 0;
+    boot.start([&](bool result) {
+        completed = true;
+        ok = result;
+        complete_ms = elapsed_ms(t0);
+    });
+    platform.run_until(loop, t0 + 120 * 1000ull);
+    CHECK(boot.status(sensor_id) == StartupOrchestrator::StepStatus::TIMED_OUT);
+    CHECK(boot.status(lcd_id) == StartupOrchestrator::StepStatus::RUNNING);
+    int sensor_resumes = sensor.resumes();
+
+    platform.run_until(loop, t0 + 2000 * 1000ull);
+    REQUIRE(completed);
+    CHECK(!ok);
+    CHECK(boot.first_failure() != nullptr);
+    CHECK(boot.status(lcd_id) == StartupOrchestrator::StepStatus::DONE);
+    CHECK(boot.status(ui_id) == StartupOrchestrator::StepStatus::DONE);
+    CHECK(boot.status(probe_id) == StartupOrchestrator::StepStatus::TIMED_OUT);
+    CHECK(boot.status(log_id) == StartupOrchestrator::StepStatus::SKIPPED);
+    // 超时的任务被取消，之后不再运行
+    CHECK_EQ(sensor.resumes(), sensor_resumes);
+    CHECK(sensor.resumes() < 10);
+    CHECK(!probe.done());
+    CHECK_EQ(complete_ms, 400u);        // lcd 300ms + ui 100ms
+    CHECK_EQ(scheduler.active(), 0);
+}
+
+HOST_TEST(st7306_init_task_overlaps_other_steps) {
+    CommandLog panel_log;
+    panel_log.dc = gpio_get(20);        // 监听器只报告电平变化
+    host_set_spi_device(log_spi_byte, &panel_log);
+    host_set_gpio_listener(log_gpio, &panel_log);
+
+    host::VirtualLoopPlatform platform;
+    EventLoop loop(platform);
+    TaskScheduler scheduler(loop);
+    StartupOrchestrator boot(loop, scheduler);
+    st7306::ST7306Driver lcd(20, 15, 17, 18, 19);
+    st7306::ST7306Driver::InitTask lcd_init(lcd);
+    DelayTask sensor(150);
+    const uint64_t t0 = time_us_64();
+
+    int lcd_id = boot.add_step("lcd", lcd_init, 1500);
+    int sensor_id = boot.add_step("sensor", sensor, 1000);
+    bool ok = false;
+    uint32_t complete_ms = 0;
+    boot.start([&](bool result) {
+        ok = result;
+        complete_ms = elapsed_ms(t0);
+    });
+    platform.run_until(loop, t0 + 1000 * 1000ull);
+    host_set_gpio_listener(nullptr, nullptr);
+    host_set_spi_device(nullptr, nullptr);
+
+    REQUIRE(ok);
+    CHECK(boot.status(lcd_id) == StartupOrchestrator::StepStatus::DONE);
+    CHECK(boot.status(sensor_id) == StartupOrchestrator::StepStatus::DONE);
+    CHECK(lcd.is_initialized());
+    // 复位30ms + 退出睡眠120ms + 清RAM10ms 与传感器的150ms重叠，而不是相加
+    CHECK(complete_ms >= 160 && complete_ms < 200);
+
+    // 命令序列：退出睡眠 (0x11) 后至少等待120ms才发下一条命令，清RAM (0xBB) 后等待10ms
+    size_t sleep_out = panel_log.commands.size();
+    size_t clear_ram = panel_log.commands.size();
+    for (size_t i = 0; i < panel_log.commands.size(); i++) {
+        if (panel_log.commands[i].first == 0x11 && sleep_out == panel_log.commands.size()) sleep_out = i;
+        if (panel_log.commands[i].first == 0xBB) clear_ram = i;
+    }
+    REQUIRE(!panel_log.commands.empty() && panel_log.commands[0].first == 0xD6);
+    REQUIRE(sleep_out + 1 < panel_log.commands.size());
+    REQUIRE(clear_ram + 1 < panel_log.commands.size());
+    CHECK(panel_log.commands[sleep_out + 1].second - panel_log.commands[sleep_out].second >= 120000);
+    CHECK(panel_log.commands[clear_ram + 1].second - panel_log.commands[clear_ram].second >= 10000);
+}
+
+HOST_TEST_MAIN()
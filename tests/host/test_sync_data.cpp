@@ -0,0 +1,63 @@
+/**
+ * @file test_sync_data.cpp
+ * @brief FileHandle::sync_data (f_sync_data)：预分配文件内原位覆盖后关闭不再写目录项；
+ *        文件大小或簇链有变化时仍由 f_close 写目录项，掉电重启后大小正确
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+
+#include <vector>
+
+using MicroSD::RWSD;
+
+HOST_TEST(in_place_overwrite_skips_directory_entry_on_close) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    RWSD& sd = fx.sd();
+    {
+        auto opened = sd.open_file("/ring.bin", "w");
+        REQUIRE(opened.is_ok());
+        REQUIRE(opened->preallocate(64 * 1024).is_ok());
+        REQUIRE(opened->flush().is_ok());
+
+        REQUIRE(opened->seek(4096).is_ok());
+        REQUIRE(opened->write(std::vector<uint8_t>(512, 0x5A)).is_ok());
+        fx.card().reset_stats();
+        REQUIRE(opened->sync_data().is_ok());
+        CHECK_EQ(fx.card().stats().blocks_written, 1u);
+
+        // 目录项与文件一致：关闭和同步不再产生写入
+        fx.card().reset_stats();
+    }
+    REQUIRE(sd.sync().is_ok());
+    CHECK_EQ(fx.card().stats().blocks_written, 0u);
+
+    auto data = sd.read_file_chunk("/ring.bin", 4096, 512);
+    REQUIRE(data.is_ok());
+    CHECK(*data == std::vector<uint8_t>(512, 0x5A));
+}
+
+HOST_TEST(size_change_keeps_directory_update_pending) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    {
+        // 未 flush 就扩展文件再 sync_data：目录项仍是大小0，不能丢弃待写的目录更新
+        auto opened = fx.sd().open_file("/grow.bin", "w");
+        REQUIRE(opened.is_ok());
+        REQUIRE(opened->write(std::vector<uint8_t>(3000, 0x33)).is_ok());
+        REQUIRE(opened->sync_data().is_ok());
+    }
+    REQUIRE(fx.sd().sync().is_ok());
+    fx.power_loss();
+    REQUIRE(fx.start());
+
+    auto info = fx.sd().get_file_info("/grow.bin");
+    REQUIRE(info.is_ok());
+    CHECK_EQ(info->size, 3000u);
+    auto data = fx.sd().read_file("/grow.bin");
+    REQUIRE(data.is_ok());
+    CHECK(*data == std::vector<uint8_t>(3000, 0x33));
+}
+
+HOST_TEST_MAIN()
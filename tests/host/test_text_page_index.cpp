@@ -0,0 +1,155 @@
+/**
+ * @file test_text_page_index.cpp
+ * @brief 分页索引：后台扫描结果与整文件分页一致、关闭后续扫与复用、索引写入失败时作废并重建
+ */
+
+#include "host_test.hpp"
+#include "card_fixture.hpp"
+#include "hardware/storage/microsd/text_page_index.hpp"
+
+#include <string>
+#include <vector>
+
+using MicroSD::TextPageIndex;
+
+namespace {
+
+// 中英混排，行长不一：默认排版约30行一页，共约200页
+std::string make_text() {
+    std::string text;
+    for (int i = 0; i < 6000; i++) {
+        text += "line " + std::to_string(i);
+        if (i % 7 == 0) text += " 中文字符串跨越多个宽字符以便折行 abcdefghijklmnopqrstuvwxyz";
+        text += "\n";
+    }
+    return text;
+}
+
+std::vector<size_t> reference_pages(const std::string& text) {
+    std::vector<size_t> pages = {0};
+    hybrid_font::PageBreaker breaker;
+    breaker.reset(0);
+    breaker.feed(reinterpret_cast<const uint8_t*>(text.data()), text.size(), [&](size_t start) {
+        if (start < text.size()) pages.push_back(start);
+    });
+    return pages;
+}
+
+bool matches(TextPageIndex& index, const std::vector<size_t>& pages) {
+    if (index.page_count() != pages.size()) return false;
+    for (uint32_t p = 0; p < pages.size(); p++) {
+        auto offset = index.page_offset(p);
+        if (!offset.is_ok() || *offset != pages[p]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+HOST_TEST(background_scan_matches_full_pagination_and_is_reused) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    const std::string text = make_text();
+    REQUIRE(fx.sd().write_text_file("/book.txt", text).is_ok());
+    const auto pages = reference_pages(text);
+    REQUIRE(pages.size() > 2 * TEXT_INDEX_FLUSH_PAGES);
+
+    {
+        TextPageIndex index(fx.sd());
+        REQUIRE(index.open("/book.txt").is_ok());
+        CHECK(!index.is_complete());
+        // 扫描一部分后关闭：未保存的页写入索引
+        while (index.page_count() < TEXT_INDEX_FLUSH_PAGES + 10) REQUIRE(index.poll());
+        // 扫描中已写入索引文件的页可以读回
+        auto saved = index.page_offset(TEXT_INDEX_FLUSH_PAGES - 1);
+        REQUIRE(saved.is_ok());
+        CHECK_EQ(*saved, pages[TEXT_INDEX_FLUSH_PAGES - 1]);
+    }
+    {
+        TextPageIndex index(fx.sd());
+        REQUIRE(index.open("/book.txt").is_ok());
+        CHECK(index.page_count() >= TEXT_INDEX_FLUSH_PAGES + 10);
+        while (index.poll()) {
+        }
+        CHECK(index.is_complete());
+        CHECK(!index.is_failed());
+        CHECK(matches(index, pages));
+        auto page = index.page_of(pages[100] + 5);
+        REQUIRE(page.is_ok());
+        CHECK_EQ(*page, 100u);
+    }
+
+    // 完整的索引直接复用，不再读文本
+    TextPageIndex index(fx.sd());
+    REQUIRE(index.open("/book.txt").is_ok());
+    CHECK(index.is_complete());
+    CHECK_EQ(index.scanned_bytes(), 0u);
+    CHECK(!index.poll());
+    CHECK(matches(index, pages));
+}
+
+HOST_TEST(write_failure_mid_scan_stops_and_invalidates_index) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    const std::string text = make_text();
+    REQUIRE(fx.sd().write_text_file("/book.txt", text).is_ok());
+    const auto pages = reference_pages(text);
+
+    {
+        TextPageIndex index(fx.sd());
+        REQUIRE(index.open("/book.txt").is_ok());
+        fx.card().faults().reject_writes = 1000000;
+
+        // 第一批页写入失败：停止扫描，不会继续累积后面的页
+        int polls = 0;
+        while (index.poll()) polls++;
+        CHECK(index.is_failed());
+        CHECK(!index.is_complete());
+        CHECK(!index.is_open());
+        CHECK(index.scanned_bytes() < text.size());
+        CHECK(!index.page_offset(0).is_ok());
+        CHECK(!index.poll());
+        CHECK(!fx.sd().file_exists("/book.txt.pidx"));
+        fx.card().faults().reject_writes = 0;
+    }
+
+    // 卡恢复后重新打开：重新扫描得到正确的索引
+    TextPageIndex index(fx.sd());
+    REQUIRE(index.open("/book.txt").is_ok());
+    CHECK_EQ(index.page_count(), 1u);
+    while (index.poll()) {
+    }
+    CHECK(index.is_complete());
+    CHECK(matches(index, pages));
+}
+
+HOST_TEST(write_failure_on_completion_is_not_reported_complete) {
+    host::CardFixture fx;
+    REQUIRE(fx.format());
+    // 不足一批的短文本：唯一的一次写入发生在扫描结束时
+    std::string text;
+    for (int i = 0; i < 200; i++) text += "short line " + std::to_string(i) + "\n";
+    REQUIRE(fx.sd().write_text_file("/short.txt", text).is_ok());
+    const auto pages = reference_pages(text);
+    REQUIRE(pages.size() > 1 && pages.size() < TEXT_INDEX_FLUSH_PAGES);
+
+    {
+        TextPageIndex index(fx.sd());
+        REQUIRE(index.open("/short.txt").is_ok());
+        fx.card().faults().reject_writes = 1000000;
+        while (index.poll()) {
+        }
+        CHECK(!index.is_complete());
+        CHECK(index.is_failed());
+        fx.card().faults().reject_writes = 0;
+    }
+
+    TextPageIndex index(fx.sd());
+    REQUIRE(index.open("/short.txt").is_ok());
+    while (index.poll()) {
+    }
+    CHECK(index.is_complete());
+    CHECK(matches(index, pages));
+}
+
+HOST_TEST_MAIN()